@@ -52,6 +52,9 @@ unsigned int __swap(unsigned int key)
 #if CONFIG_KERNEL_EVENT_LOGGER_CONTEXT_SWITCH
 	_sys_k_event_logger_context_switch();
 #endif
+#if defined(CONFIG_THREAD_RUNTIME_STATS) || defined(CONFIG_TRACING)
+	_sched_switch_hook();
+#endif
 
 	posix_thread_status_t *ready_thread_ptr =
 		(posix_thread_status_t *)
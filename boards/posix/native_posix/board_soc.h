@@ -25,6 +25,13 @@ extern "C" {
 
 #define TIMER_TICK_IRQ 0
 
+/* Interrupts of the radio and RTC models, and a software interrupt for the
+ * low priority work of the Bluetooth controller
+ */
+#define RADIO_IRQ 1
+#define RTC0_IRQ 2
+#define SWI_IRQ 3
+
 /*
  * This interrupt will awake the CPU if IRQs are not locked,
  * This interrupt does not have an associated status bit or handler
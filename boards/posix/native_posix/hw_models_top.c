@@ -14,6 +14,10 @@
 #include "irq_ctrl.h"
 #include "posix_board_if.h"
 #include "posix_soc_if.h"
+#if defined(CONFIG_NATIVE_POSIX_RADIO)
+#include "rtc_model.h"
+#include "radio_model.h"
+#endif
 
 
 static u64_t device_time; /* The actual time as known by the device */
@@ -23,12 +27,24 @@ static u64_t end_of_time = NEVER; /* When will this device stop */
 extern u64_t hw_timer_timer; /* When should this timer_model be called */
 extern u64_t irq_ctrl_timer;
 
-static enum { HWTIMER = 0, IRQCNT, NUMBER_OF_TIMERS, NONE }
-	next_timer_index = NONE;
+static enum {
+	HWTIMER = 0,
+	IRQCNT,
+#if defined(CONFIG_NATIVE_POSIX_RADIO)
+	RTC,
+	RADIO,
+#endif
+	NUMBER_OF_TIMERS,
+	NONE
+} next_timer_index = NONE;
 
 static u64_t *Timer_list[NUMBER_OF_TIMERS] = {
 	&hw_timer_timer,
-	&irq_ctrl_timer
+	&irq_ctrl_timer,
+#if defined(CONFIG_NATIVE_POSIX_RADIO)
+	&hw_rtc_timer,
+	&hw_radio_timer,
+#endif
 };
 
 static u64_t next_timer_time;
@@ -79,6 +95,13 @@ void hwm_find_next_timer(void)
 void hwm_main_loop(void)
 {
 	while (1) {
+#if defined(CONFIG_NATIVE_POSIX_RADIO)
+		/* Wait for the other devices on the radio medium, which may
+		 * bring a packet reception before the next timer
+		 */
+		hw_radio_medium_sync(next_timer_time);
+		hwm_find_next_timer();
+#endif
 		hwm_sleep_until_next_timer();
 
 		switch (next_timer_index) {
@@ -88,6 +111,14 @@ void hwm_main_loop(void)
 		case IRQCNT:
 			hw_irq_ctrl_timer_triggered();
 			break;
+#if defined(CONFIG_NATIVE_POSIX_RADIO)
+		case RTC:
+			hw_rtc_timer_reached();
+			break;
+		case RADIO:
+			hw_radio_timer_reached();
+			break;
+#endif
 		default:
 			posix_print_error_and_exit(
 					"next_timer_index corrupted\n");
@@ -122,6 +153,10 @@ void hwm_init(void)
 {
 	hwtimer_init();
 	hw_irq_ctrl_init();
+#if defined(CONFIG_NATIVE_POSIX_RADIO)
+	hw_rtc_init();
+	hw_radio_init();
+#endif
 
 	hwm_find_next_timer();
 }
@@ -135,6 +170,10 @@ void hwm_cleanup(void)
 {
 	hwtimer_cleanup();
 	hw_irq_ctrl_cleanup();
+#if defined(CONFIG_NATIVE_POSIX_RADIO)
+	hw_rtc_cleanup();
+	hw_radio_cleanup();
+#endif
 }
 
 
@@ -16,6 +16,7 @@
 #include "board_soc.h"
 #include "sw_isr_table.h"
 #include "soc.h"
+#include "logging/tracing.h"
 
 
 typedef void (*normal_irq_f_ptr)(void *);
@@ -80,7 +81,9 @@ void posix_irq_handler(void)
 		hw_irq_ctrl_clear_irq(irq_nbr);
 
 		currently_running_irq = irq_nbr;
+		SYS_TRACE(SYS_TRACE_ISR_ENTER, irq_nbr, 0);
 		vector_to_irq(irq_nbr, &may_swap);
+		SYS_TRACE(SYS_TRACE_ISR_EXIT, irq_nbr, 0);
 		currently_running_irq = last_running_irq;
 
 		hw_irq_ctrl_set_cur_prio(last_current_running_prio);
@@ -0,0 +1,729 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Model of a Bluetooth Low Energy radio with its microsecond timer, and of
+ * the medium it shares with other devices.
+ *
+ * Unless the NATIVE_POSIX_RADIO_MEDIUM environment variable names a POSIX
+ * shared memory object, the device is alone on the medium. When it does, as
+ * many processes as NATIVE_POSIX_RADIO_DEVICES tells (2 by default) attach
+ * to that object and run in lockstep: a device only goes to a time earlier
+ * than the time of every other device plus the transmitter ramp-up, since a
+ * packet is on air that long after its sender enabled the radio. Devices
+ * which have not attached yet hold the others at the start.
+ *
+ * Packets are received whole when their sender, channel, access address and
+ * PHY match, with a CRC error if their CRC initial value differs or if another
+ * packet overlaps them on the channel.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "hw_models_top.h"
+#include "irq_ctrl.h"
+#include "board_soc.h"
+#include "posix_soc_if.h"
+#include "misc/util.h"
+#include "radio_model.h"
+
+#define MEDIUM_DEVICES_MAX 32
+
+/* Devices are at most a ramp-up apart and send packets a few hundred
+ * microseconds apart at least, so the others only look at the last few
+ * packets of a device.
+ */
+#define MEDIUM_PKTS 32
+
+#define LOOKAHEAD HW_RADIO_TX_RU_US
+
+#define RSSI_SAMPLE 40
+
+struct medium_pkt {
+	u64_t start;
+	u64_t end;
+	u32_t aa;
+	u32_t crc_init;
+	u8_t chan;
+	u8_t phy;
+	/* Header, length and payload, as sent */
+	u8_t data[2 + 255];
+};
+
+struct medium_dev {
+	/* Time the device goes to, it sends nothing before this plus the
+	 * ramp-up
+	 */
+	u64_t time;
+	u32_t count;
+	struct medium_pkt pkt[MEDIUM_PKTS];
+};
+
+struct medium {
+	u32_t joined;
+	u32_t left;
+	struct medium_dev dev[];
+};
+
+struct hw_radio_regs hw_radio;
+u64_t hw_radio_timer;
+
+static struct medium *medium;
+static const char *medium_name;
+static size_t medium_size;
+static unsigned int devices;
+static unsigned int dev_id;
+
+/* Packets of the others starting up to this time have been seen */
+static u64_t scan_time;
+
+static struct {
+	u64_t tmr_enable;
+	u64_t sw_enable;
+	u64_t ready;
+	u64_t rx_check;
+	u64_t address;
+	u64_t end;
+	u64_t hcto;
+	u64_t disabled;
+} t;
+
+static bool tmr_enable_tx;
+static bool sw_enable_tx;
+
+/* Enable the radio again after END */
+static bool switch_en;
+static bool switch_tx;
+static u32_t switch_offset;
+
+static u64_t tmr_start;
+static bool tmr_enable_armed;
+static u32_t tmr_enable_cc;
+static bool hcto_armed;
+static u32_t hcto_cc;
+
+static u64_t rx_ready_time;
+static bool rx_locked;
+static unsigned int rx_dev;
+static struct medium_pkt rx_pkt;
+
+static void radio_update_timer(void)
+{
+	u64_t *times = (u64_t *)&t;
+	unsigned int i;
+
+	hw_radio_timer = NEVER;
+	for (i = 0; i < sizeof(t) / sizeof(u64_t); i++) {
+		hw_radio_timer = min(hw_radio_timer, times[i]);
+	}
+}
+
+static u32_t addr_us(u8_t phy)
+{
+	switch (phy) {
+	case BIT(1):
+		return 24;
+	case BIT(2):
+		return 376;
+	default:
+		return 40;
+	}
+}
+
+/* Time on air of the header, payload and CRC */
+static u32_t pdu_us(u8_t phy, bool s8, u32_t len)
+{
+	u32_t bits = (2 + len + 3) * 8;
+
+	switch (phy) {
+	case BIT(1):
+		return bits / 2;
+	case BIT(2):
+		return (bits + 3) * (s8 ? 8 : 2);
+	default:
+		return bits;
+	}
+}
+
+/* Time up to which the other devices let this one go */
+static u64_t medium_allowed(void)
+{
+	u64_t time = NEVER;
+	unsigned int d;
+
+	for (d = 0; d < devices; d++) {
+		if (d != dev_id) {
+			time = min(time, __atomic_load_n(&medium->dev[d].time,
+							 __ATOMIC_ACQUIRE));
+		}
+	}
+
+	return time == NEVER ? NEVER : time + LOOKAHEAD - 1;
+}
+
+static void medium_publish(u64_t time)
+{
+	struct medium_dev *me = &medium->dev[dev_id];
+
+	if (time > me->time) {
+		__atomic_store_n(&me->time, time, __ATOMIC_RELEASE);
+	}
+}
+
+/* First packet of a device which is not overwritten while being read */
+static u32_t medium_first(u32_t count)
+{
+	return count > MEDIUM_PKTS - 1 ? count - (MEDIUM_PKTS - 1) : 0;
+}
+
+/* Start of the first packet of the others in (scan_time, until] */
+static u64_t medium_next_start(u64_t until)
+{
+	u64_t start = NEVER;
+	unsigned int d;
+
+	for (d = 0; d < devices; d++) {
+		struct medium_dev *md = &medium->dev[d];
+		u32_t count, i;
+
+		if (d == dev_id) {
+			continue;
+		}
+
+		count = __atomic_load_n(&md->count, __ATOMIC_ACQUIRE);
+		for (i = medium_first(count); i < count; i++) {
+			struct medium_pkt *pkt = &md->pkt[i % MEDIUM_PKTS];
+
+			if (pkt->start > scan_time && pkt->start <= until) {
+				start = min(start, pkt->start);
+			}
+		}
+	}
+
+	return start;
+}
+
+static void medium_send(u64_t start)
+{
+	struct medium_dev *me = &medium->dev[dev_id];
+	struct medium_pkt *pkt = &me->pkt[me->count % MEDIUM_PKTS];
+	u8_t *data = hw_radio.packet;
+	u8_t len = data[1];
+
+	pkt->start = start;
+	pkt->end = start + addr_us(hw_radio.phy) +
+		   pdu_us(hw_radio.phy, hw_radio.coded_s8, len);
+	pkt->aa = hw_radio.aa;
+	pkt->crc_init = hw_radio.crc_init;
+	pkt->chan = hw_radio.chan;
+	pkt->phy = hw_radio.phy;
+	pkt->data[0] = data[0];
+	pkt->data[1] = len;
+	memcpy(&pkt->data[2], &data[2 + hw_radio.s1_incl], len);
+
+	__atomic_store_n(&me->count, me->count + 1, __ATOMIC_RELEASE);
+
+	t.address = start + addr_us(hw_radio.phy);
+	t.end = pkt->end;
+}
+
+/* Lock on a packet of the others starting in (scan_time, now] */
+static void medium_receive(u64_t now)
+{
+	unsigned int d;
+
+	for (d = 0; d < devices; d++) {
+		struct medium_dev *md = &medium->dev[d];
+		u32_t count, i;
+
+		if (d == dev_id) {
+			continue;
+		}
+
+		count = __atomic_load_n(&md->count, __ATOMIC_ACQUIRE);
+		for (i = medium_first(count); i < count; i++) {
+			struct medium_pkt *pkt = &md->pkt[i % MEDIUM_PKTS];
+
+			if (pkt->start <= scan_time || pkt->start > now ||
+			    hw_radio.state != HW_RADIO_RX || rx_locked ||
+			    pkt->start < rx_ready_time ||
+			    pkt->chan != hw_radio.chan ||
+			    pkt->aa != hw_radio.aa ||
+			    pkt->phy != hw_radio.phy) {
+				continue;
+			}
+
+			rx_pkt = *pkt;
+			rx_dev = d;
+			rx_locked = true;
+
+			t.address = pkt->start + addr_us(pkt->phy);
+			t.end = pkt->end;
+		}
+	}
+
+	scan_time = now;
+}
+
+static bool medium_collision(void)
+{
+	unsigned int d;
+
+	for (d = 0; d < devices; d++) {
+		struct medium_dev *md = &medium->dev[d];
+		u32_t count, i;
+
+		if (d == dev_id) {
+			continue;
+		}
+
+		count = __atomic_load_n(&md->count, __ATOMIC_ACQUIRE);
+		for (i = medium_first(count); i < count; i++) {
+			struct medium_pkt *pkt = &md->pkt[i % MEDIUM_PKTS];
+
+			if (d == rx_dev && pkt->start == rx_pkt.start) {
+				continue;
+			}
+
+			if (pkt->chan == rx_pkt.chan &&
+			    pkt->start < rx_pkt.end && pkt->end > rx_pkt.start) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+static void medium_open(void)
+{
+	const char *count = getenv("NATIVE_POSIX_RADIO_DEVICES");
+	int fd;
+
+	medium_name = getenv("NATIVE_POSIX_RADIO_MEDIUM");
+	devices = medium_name ? (count ? atoi(count) : 2) : 1;
+	if (devices < 1 || devices > MEDIUM_DEVICES_MAX) {
+		posix_print_error_and_exit("Radio medium devices must be 1 to "
+					   "%u\n", MEDIUM_DEVICES_MAX);
+	}
+
+	medium_size = sizeof(struct medium) +
+		      devices * sizeof(struct medium_dev);
+
+	if (!medium_name) {
+		medium = calloc(1, medium_size);
+		if (!medium) {
+			posix_print_error_and_exit("No memory for the radio "
+						   "medium\n");
+		}
+
+		return;
+	}
+
+	fd = shm_open(medium_name, O_RDWR | O_CREAT, 0600);
+	if (fd < 0 || ftruncate(fd, medium_size)) {
+		posix_print_error_and_exit("Cannot open radio medium %s\n",
+					   medium_name);
+	}
+
+	medium = mmap(NULL, medium_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+		      fd, 0);
+	close(fd);
+	if (medium == MAP_FAILED) {
+		posix_print_error_and_exit("Cannot map radio medium %s\n",
+					   medium_name);
+	}
+
+	dev_id = __atomic_fetch_add(&medium->joined, 1, __ATOMIC_ACQ_REL);
+	if (dev_id >= devices) {
+		posix_print_error_and_exit("Radio medium %s already has %u "
+					   "devices\n", medium_name, devices);
+	}
+}
+
+static void radio_events_clear(void)
+{
+	t.tmr_enable = NEVER;
+	t.sw_enable = NEVER;
+	t.ready = NEVER;
+	t.rx_check = NEVER;
+	t.address = NEVER;
+	t.end = NEVER;
+	t.hcto = NEVER;
+	t.disabled = NEVER;
+}
+
+void hw_radio_init(void)
+{
+	memset(&hw_radio, 0, sizeof(hw_radio));
+	radio_events_clear();
+	tmr_start = NEVER;
+
+	medium_open();
+	radio_update_timer();
+}
+
+void hw_radio_cleanup(void)
+{
+	if (!medium) {
+		return;
+	}
+
+	__atomic_store_n(&medium->dev[dev_id].time, NEVER, __ATOMIC_RELEASE);
+
+	if (!medium_name) {
+		free(medium);
+	} else {
+		if (__atomic_add_fetch(&medium->left, 1, __ATOMIC_ACQ_REL) ==
+		    devices) {
+			shm_unlink(medium_name);
+		}
+
+		munmap(medium, medium_size);
+	}
+
+	medium = NULL;
+}
+
+unsigned int hw_radio_dev_id(void)
+{
+	return dev_id;
+}
+
+/**
+ * Wait until the other devices let this one go to the time of its next HW
+ * event, or to the start of a packet of theirs before it
+ */
+void hw_radio_medium_sync(u64_t next_time)
+{
+	u64_t allowed, limit, start;
+
+	for (;;) {
+		allowed = medium_allowed();
+		limit = min(next_time, allowed);
+
+		start = medium_next_start(limit);
+		if (start != NEVER) {
+			t.rx_check = start;
+			radio_update_timer();
+			medium_publish(start);
+			return;
+		}
+
+		/* Nothing the others send later starts before the limit */
+		scan_time = limit;
+
+		if (next_time <= allowed) {
+			medium_publish(next_time);
+			return;
+		}
+
+		medium_publish(limit);
+		sched_yield();
+	}
+}
+
+static u64_t tmr_time(u32_t cc)
+{
+	u64_t time;
+
+	if (tmr_start == NEVER) {
+		return NEVER;
+	}
+
+	time = tmr_start + cc;
+
+	return time < hwm_get_time() ? NEVER : time;
+}
+
+static void tmr_update(void)
+{
+	t.tmr_enable = tmr_enable_armed ? tmr_time(tmr_enable_cc) : NEVER;
+	t.hcto = hcto_armed ? tmr_time(hcto_cc) : NEVER;
+	radio_update_timer();
+}
+
+static void radio_enable(bool tx)
+{
+	u64_t now = hwm_get_time();
+
+	if (hw_radio.state != HW_RADIO_DISABLED) {
+		return;
+	}
+
+	if (tx) {
+		hw_radio.state = HW_RADIO_TXRU;
+		t.ready = now + HW_RADIO_TX_RU_US;
+		medium_send(t.ready);
+	} else {
+		hw_radio.state = HW_RADIO_RXRU;
+		t.ready = now + HW_RADIO_RX_RU_US;
+	}
+}
+
+static void radio_ready(u64_t now)
+{
+	hw_radio.events_ready = 1;
+	if (hw_radio.capture_ready) {
+		hw_radio.cc_ready = hw_radio_tmr_get();
+	}
+
+	if (hw_radio.state == HW_RADIO_TXRU) {
+		hw_radio.state = HW_RADIO_TX;
+	} else {
+		hw_radio.state = HW_RADIO_RX;
+		rx_ready_time = now;
+	}
+}
+
+static void radio_address(void)
+{
+	hw_radio.events_address = 1;
+	if (hw_radio.capture_address) {
+		hw_radio.cc_address = hw_radio_tmr_get();
+	}
+
+	if (hw_radio.state == HW_RADIO_RX) {
+		/* The address capture overwrites the header timeout */
+		hcto_armed = false;
+		t.hcto = NEVER;
+
+		if (hw_radio.rssi_start) {
+			hw_radio.events_rssiend = 1;
+			hw_radio.rssi_sample = RSSI_SAMPLE;
+		}
+	}
+}
+
+static void radio_filter(const u8_t *addr, u8_t txadd)
+{
+	unsigned int i;
+
+	for (i = 0; i < HW_RADIO_DAB_COUNT; i++) {
+		if ((hw_radio.dacnf_en & BIT(i)) &&
+		    ((hw_radio.dacnf_txadd >> i) & 1) == txadd &&
+		    !memcmp(hw_radio.dab[i], addr, 6)) {
+			hw_radio.events_devmatch = 1;
+			hw_radio.dai = i;
+			return;
+		}
+	}
+
+	hw_radio.events_devmiss = 1;
+}
+
+static void radio_rx_end(void)
+{
+	u8_t *data = hw_radio.packet;
+	u8_t len = rx_pkt.data[1];
+	bool crc_ok;
+
+	crc_ok = rx_pkt.crc_init == hw_radio.crc_init && !medium_collision();
+	if (len > hw_radio.max_len) {
+		len = hw_radio.max_len;
+		crc_ok = false;
+	}
+
+	data[0] = rx_pkt.data[0];
+	data[1] = len;
+	if (hw_radio.s1_incl) {
+		data[2] = 0;
+	}
+
+	memcpy(&data[2 + hw_radio.s1_incl], &rx_pkt.data[2], len);
+
+	hw_radio.crc_status = crc_ok;
+
+	if (hw_radio.dacnf_en && len >= 6) {
+		radio_filter(&rx_pkt.data[2], (rx_pkt.data[0] >> 6) & 1);
+	}
+
+	if (hw_radio.bcc && (2 + len) * 8 >= hw_radio.bcc) {
+		hw_radio.events_bcmatch = 1;
+	}
+
+	rx_locked = false;
+}
+
+static void radio_end(u64_t now)
+{
+	if (hw_radio.state == HW_RADIO_RX) {
+		radio_rx_end();
+	}
+
+	hw_radio.events_end = 1;
+	if (hw_radio.capture_end) {
+		hw_radio.cc_end = hw_radio_tmr_get();
+	}
+
+	hw_radio.state = HW_RADIO_DISABLED;
+	hw_radio.events_disabled = 1;
+	hw_irq_ctrl_set_irq(RADIO_IRQ);
+
+	if (switch_en) {
+		t.sw_enable = now + switch_offset;
+		sw_enable_tx = switch_tx;
+	}
+}
+
+void hw_radio_timer_reached(void)
+{
+	u64_t now = hw_radio_timer;
+
+	if (t.tmr_enable == now) {
+		t.tmr_enable = NEVER;
+		tmr_enable_armed = false;
+		radio_enable(tmr_enable_tx);
+	}
+
+	if (t.sw_enable == now) {
+		t.sw_enable = NEVER;
+		radio_enable(sw_enable_tx);
+	}
+
+	if (t.ready == now) {
+		t.ready = NEVER;
+		radio_ready(now);
+	}
+
+	if (t.rx_check == now) {
+		t.rx_check = NEVER;
+		medium_receive(now);
+	}
+
+	if (t.address == now) {
+		t.address = NEVER;
+		radio_address();
+	}
+
+	if (t.end == now) {
+		t.end = NEVER;
+		radio_end(now);
+	}
+
+	if (t.hcto == now) {
+		t.hcto = NEVER;
+		hcto_armed = false;
+		hw_radio_task_disable();
+	}
+
+	if (t.disabled == now) {
+		t.disabled = NEVER;
+		hw_radio.events_disabled = 1;
+		hw_irq_ctrl_set_irq(RADIO_IRQ);
+	}
+
+	radio_update_timer();
+}
+
+void hw_radio_task_enable(bool tx)
+{
+	radio_enable(tx);
+	radio_update_timer();
+}
+
+/**
+ * Disable the radio, which raises the DISABLED event unless it already was
+ */
+void hw_radio_task_disable(void)
+{
+	if (hw_radio.state == HW_RADIO_DISABLED) {
+		return;
+	}
+
+	hw_radio.state = HW_RADIO_DISABLED;
+	rx_locked = false;
+	t.ready = NEVER;
+	t.address = NEVER;
+	t.end = NEVER;
+	t.disabled = hwm_get_time();
+	radio_update_timer();
+}
+
+/**
+ * Set whether, and which way, the radio is enabled again an offset after
+ * the next END events
+ */
+void hw_radio_switch_set(bool enable, bool tx, u32_t offset)
+{
+	switch_en = enable;
+	switch_tx = tx;
+	switch_offset = offset;
+}
+
+/**
+ * Cancel the switch, including one an END event already started
+ */
+void hw_radio_switch_cancel(void)
+{
+	switch_en = false;
+	t.sw_enable = NEVER;
+	radio_update_timer();
+}
+
+/**
+ * Start the timer from zero at a device time
+ */
+void hw_radio_tmr_start(u64_t time)
+{
+	tmr_start = time;
+	tmr_update();
+}
+
+void hw_radio_tmr_stop(void)
+{
+	tmr_start = NEVER;
+	tmr_update();
+}
+
+u32_t hw_radio_tmr_get(void)
+{
+	u64_t now = hwm_get_time();
+
+	if (tmr_start == NEVER || now < tmr_start) {
+		return 0;
+	}
+
+	return now - tmr_start;
+}
+
+/**
+ * Enable the radio when the timer reaches a value
+ */
+void hw_radio_tmr_enable_at(bool tx, u32_t cc)
+{
+	tmr_enable_armed = true;
+	tmr_enable_tx = tx;
+	tmr_enable_cc = cc;
+	tmr_update();
+}
+
+/**
+ * Disable the radio when the timer reaches a value before an address is
+ * received
+ */
+void hw_radio_tmr_hcto_set(u32_t cc)
+{
+	hcto_armed = true;
+	hcto_cc = cc;
+	tmr_update();
+}
+
+/**
+ * Stop enabling the radio, timing out and capturing on timer events
+ */
+void hw_radio_tmr_clear(void)
+{
+	tmr_enable_armed = false;
+	hcto_armed = false;
+	hw_radio.capture_ready = false;
+	hw_radio.capture_address = false;
+	hw_radio.capture_end = false;
+	tmr_update();
+}
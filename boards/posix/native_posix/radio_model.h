@@ -0,0 +1,101 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _NATIVE_POSIX_RADIO_MODEL_H
+#define _NATIVE_POSIX_RADIO_MODEL_H
+
+#include <stdbool.h>
+#include "hw_models_top.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Time from the enable task to the READY event, in microseconds */
+#define HW_RADIO_TX_RU_US 140
+#define HW_RADIO_RX_RU_US 140
+
+#define HW_RADIO_DAB_COUNT 8
+
+enum hw_radio_state {
+	HW_RADIO_DISABLED,
+	HW_RADIO_RXRU,
+	HW_RADIO_RX,
+	HW_RADIO_TXRU,
+	HW_RADIO_TX,
+};
+
+/**
+ * Registers of the radio and of its timer
+ *
+ * Packets in memory hold the header, the length, an S1 byte which is not
+ * sent when s1_incl is set, and the payload. READY always starts the packet
+ * and END always disables the radio, as with the shortcuts the Bluetooth
+ * controller uses on every packet.
+ */
+struct hw_radio_regs {
+	/* Configuration */
+	u8_t phy;
+	u8_t coded_s8;
+	u8_t chan;
+	u8_t s1_incl;
+	u8_t max_len;
+	u32_t aa;
+	u32_t crc_init;
+	void *packet;
+	bool rssi_start;
+	u32_t bcc;
+	u8_t dacnf_en;
+	u8_t dacnf_txadd;
+	u8_t dab[HW_RADIO_DAB_COUNT][6];
+
+	/* Events and status */
+	u32_t events_ready;
+	u32_t events_address;
+	u32_t events_end;
+	u32_t events_disabled;
+	u32_t events_devmatch;
+	u32_t events_devmiss;
+	u32_t events_bcmatch;
+	u32_t events_rssiend;
+	u32_t crc_status;
+	u32_t dai;
+	u32_t rssi_sample;
+	enum hw_radio_state state;
+
+	/* Timer captures, enabled by the capture_* flags */
+	bool capture_ready;
+	bool capture_address;
+	bool capture_end;
+	u32_t cc_ready;
+	u32_t cc_address;
+	u32_t cc_end;
+};
+
+extern struct hw_radio_regs hw_radio;
+extern u64_t hw_radio_timer;
+
+void hw_radio_init(void);
+void hw_radio_cleanup(void);
+void hw_radio_timer_reached(void);
+void hw_radio_medium_sync(u64_t next_time);
+unsigned int hw_radio_dev_id(void);
+
+void hw_radio_task_enable(bool tx);
+void hw_radio_task_disable(void);
+void hw_radio_switch_set(bool enable, bool tx, u32_t offset);
+void hw_radio_switch_cancel(void);
+
+void hw_radio_tmr_start(u64_t time);
+void hw_radio_tmr_stop(void);
+u32_t hw_radio_tmr_get(void);
+void hw_radio_tmr_enable_at(bool tx, u32_t cc);
+void hw_radio_tmr_hcto_set(u32_t cc);
+void hw_radio_tmr_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _NATIVE_POSIX_RADIO_MODEL_H */
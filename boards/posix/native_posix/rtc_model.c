@@ -0,0 +1,126 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Model of a 24 bit counter clocked at 32768 Hz with compare channels which
+ * raise RTC0_IRQ, as the Bluetooth controller ticker uses it.
+ *
+ * The counter is derived from the device time, it runs from boot and never
+ * drifts from the rest of the HW models.
+ */
+
+#include <stdint.h>
+#include "hw_models_top.h"
+#include "irq_ctrl.h"
+#include "board_soc.h"
+#include "rtc_model.h"
+
+#define RTC_FREQ 32768
+#define RTC_WRAP (1ULL << 24)
+
+u64_t hw_rtc_timer;
+
+/* Ticks since boot at which each compare channel matches next */
+static u64_t cc_ticks[HW_RTC_CC_COUNT];
+static bool cc_event[HW_RTC_CC_COUNT];
+
+static u64_t ticks_at(u64_t time)
+{
+	return time * RTC_FREQ / 1000000;
+}
+
+static u64_t ticks_time(u64_t ticks)
+{
+	if (ticks == NEVER) {
+		return NEVER;
+	}
+
+	return (ticks * 1000000 + RTC_FREQ - 1) / RTC_FREQ;
+}
+
+/* Ticks since boot at which the counter next turns to a value */
+static u64_t ticks_next(u32_t value)
+{
+	u64_t now = ticks_at(hwm_get_time());
+	u64_t delta = (value - now) & (RTC_WRAP - 1);
+
+	return now + (delta ? delta : RTC_WRAP);
+}
+
+static void rtc_update_timer(void)
+{
+	unsigned int i;
+
+	hw_rtc_timer = NEVER;
+	for (i = 0; i < HW_RTC_CC_COUNT; i++) {
+		if (ticks_time(cc_ticks[i]) < hw_rtc_timer) {
+			hw_rtc_timer = ticks_time(cc_ticks[i]);
+		}
+	}
+}
+
+void hw_rtc_init(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < HW_RTC_CC_COUNT; i++) {
+		cc_ticks[i] = NEVER;
+		cc_event[i] = false;
+	}
+
+	rtc_update_timer();
+}
+
+void hw_rtc_cleanup(void)
+{
+
+}
+
+void hw_rtc_timer_reached(void)
+{
+	u64_t now = hw_rtc_timer;
+	unsigned int i;
+
+	for (i = 0; i < HW_RTC_CC_COUNT; i++) {
+		if (ticks_time(cc_ticks[i]) == now) {
+			cc_ticks[i] += RTC_WRAP;
+			cc_event[i] = true;
+		}
+	}
+
+	rtc_update_timer();
+	hw_irq_ctrl_set_irq(RTC0_IRQ);
+}
+
+u32_t hw_rtc_counter_get(void)
+{
+	return ticks_at(hwm_get_time()) & (RTC_WRAP - 1);
+}
+
+/**
+ * Set a compare channel, its event comes when the counter turns to the
+ * value, which is 2^24 ticks away if the counter is already at it
+ */
+void hw_rtc_cc_set(unsigned int cc, u32_t value)
+{
+	cc_ticks[cc] = ticks_next(value);
+	rtc_update_timer();
+}
+
+bool hw_rtc_cc_event_clear(unsigned int cc)
+{
+	bool event = cc_event[cc];
+
+	cc_event[cc] = false;
+
+	return event;
+}
+
+/**
+ * Return the device time at which the counter next turns to a value
+ */
+u64_t hw_rtc_tick_time(u32_t ticks)
+{
+	return ticks_time(ticks_next(ticks));
+}
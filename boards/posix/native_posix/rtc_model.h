@@ -0,0 +1,32 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _NATIVE_POSIX_RTC_MODEL_H
+#define _NATIVE_POSIX_RTC_MODEL_H
+
+#include <stdbool.h>
+#include "hw_models_top.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HW_RTC_CC_COUNT 2
+
+extern u64_t hw_rtc_timer;
+
+void hw_rtc_init(void);
+void hw_rtc_cleanup(void);
+void hw_rtc_timer_reached(void);
+
+u32_t hw_rtc_counter_get(void);
+void hw_rtc_cc_set(unsigned int cc, u32_t value);
+bool hw_rtc_cc_event_clear(unsigned int cc);
+u64_t hw_rtc_tick_time(u32_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _NATIVE_POSIX_RTC_MODEL_H */
@@ -18,6 +18,7 @@ void hwtimer_cleanup(void);
 void hwtimer_timer_reached(void);
 void hwtimer_wake_in_time(u64_t time);
 void hwtimer_set_silent_ticks(int sys_ticks);
+u64_t hwtimer_get_host_time_ns(void);
 
 #ifdef __cplusplus
 }
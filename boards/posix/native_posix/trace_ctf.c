@@ -0,0 +1,165 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Trace backend writing the tracing subsystem records to a host directory
+ * as a Common Trace Format (CTF 1.8) trace: a "metadata" file describing
+ * the layout, and one binary stream file per trace context. The records
+ * are written as they are, so each stream is a single packet made of a
+ * packet header followed by the records.
+ *
+ * The trace can be read with babeltrace, or opened in Trace Compass.
+ */
+
+#include <stdio.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+#include "posix_soc_if.h"
+#include "trace_ctf.h"
+
+#define CTF_MAGIC 0xC1FC1FC1
+#define MAX_STREAMS 4
+
+static FILE *stream_files[MAX_STREAMS];
+
+static const char metadata_header[] =
+	"/* CTF 1.8 */\n"
+	"\n"
+	"typealias integer { size = 8; align = 8; signed = false; } "
+	":= uint8_t;\n"
+	"typealias integer { size = 16; align = 8; signed = false; } "
+	":= uint16_t;\n"
+	"typealias integer { size = 32; align = 8; signed = false; } "
+	":= uint32_t;\n"
+	"typealias integer { size = 32; align = 8; signed = false; "
+	"base = hex; } := xint32_t;\n"
+	"\n"
+	"trace {\n"
+	"\tmajor = 1;\n"
+	"\tminor = 8;\n"
+	"\tbyte_order = le;\n"
+	"\tpacket.header := struct {\n"
+	"\t\tuint32_t magic;\n"
+	"\t\tuint8_t stream_id;\n"
+	"\t};\n"
+	"};\n"
+	"\n";
+
+static int write_metadata(const char *dir, u32_t freq,
+			  const char * const *names, int num_events,
+			  int num_streams)
+{
+	char path[256];
+	FILE *f;
+	int s, e;
+
+	snprintf(path, sizeof(path), "%s/metadata", dir);
+	f = fopen(path, "w");
+	if (!f) {
+		return -errno;
+	}
+
+	fputs(metadata_header, f);
+
+	fprintf(f, "clock {\n\tname = cycles;\n\tfreq = %u;\n};\n\n", freq);
+	fprintf(f, "typealias integer {\n"
+		   "\tsize = 32; align = 8; signed = false;\n"
+		   "\tmap = clock.cycles.value;\n"
+		   "} := cycles_t;\n\n");
+
+	for (s = 0; s < num_streams; s++) {
+		fprintf(f, "stream {\n"
+			   "\tid = %d;\n"
+			   "\tevent.header := struct {\n"
+			   "\t\tcycles_t timestamp;\n"
+			   "\t\tuint16_t id;\n"
+			   "\t};\n"
+			   "};\n\n", s);
+	}
+
+	for (s = 0; s < num_streams; s++) {
+		for (e = 0; e < num_events; e++) {
+			fprintf(f, "event {\n"
+				   "\tname = \"%s\";\n"
+				   "\tid = %d;\n"
+				   "\tstream_id = %d;\n"
+				   "\tfields := struct {\n"
+				   "\t\tuint16_t extra;\n"
+				   "\t\txint32_t arg;\n"
+				   "\t};\n"
+				   "};\n\n", names[e], e, s);
+		}
+	}
+
+	fclose(f);
+
+	return 0;
+}
+
+static FILE *open_stream(const char *dir, int stream)
+{
+	unsigned char header[5];
+	char path[256];
+	FILE *f;
+
+	snprintf(path, sizeof(path), "%s/stream%d", dir, stream);
+	f = fopen(path, "wb");
+	if (!f) {
+		return NULL;
+	}
+
+	/* Little endian packet header: magic, then the stream id */
+	header[0] = CTF_MAGIC & 0xff;
+	header[1] = (CTF_MAGIC >> 8) & 0xff;
+	header[2] = (CTF_MAGIC >> 16) & 0xff;
+	header[3] = (CTF_MAGIC >> 24) & 0xff;
+	header[4] = stream;
+	fwrite(header, sizeof(header), 1, f);
+
+	return f;
+}
+
+void posix_trace_ctf_open(const char *dir, u32_t freq,
+			  const char * const *names, int num_events,
+			  int num_streams)
+{
+	int s, err;
+
+	if (num_streams > MAX_STREAMS) {
+		num_streams = MAX_STREAMS;
+	}
+
+	if (mkdir(dir, 0755) && errno != EEXIST) {
+		posix_print_warning("trace: cannot create %s (%d)\n", dir,
+				    errno);
+		return;
+	}
+
+	err = write_metadata(dir, freq, names, num_events, num_streams);
+	if (err) {
+		posix_print_warning("trace: cannot write metadata (%d)\n",
+				    err);
+		return;
+	}
+
+	for (s = 0; s < num_streams; s++) {
+		stream_files[s] = open_stream(dir, s);
+		if (!stream_files[s]) {
+			posix_print_warning("trace: cannot open stream %d\n",
+					    s);
+		}
+	}
+}
+
+void posix_trace_ctf_write(int stream, const void *data, u32_t len)
+{
+	if (stream < 0 || stream >= MAX_STREAMS || !stream_files[stream]) {
+		return;
+	}
+
+	fwrite(data, len, 1, stream_files[stream]);
+	/* Keep the files usable if the process is killed */
+	fflush(stream_files[stream]);
+}
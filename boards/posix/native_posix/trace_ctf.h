@@ -0,0 +1,23 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _NATIVE_POSIX_TRACE_CTF_H
+#define _NATIVE_POSIX_TRACE_CTF_H
+
+#include "zephyr/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void posix_trace_ctf_open(const char *dir, u32_t freq,
+			  const char * const *names, int num_events,
+			  int num_streams);
+void posix_trace_ctf_write(int stream, const void *data, u32_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _NATIVE_POSIX_TRACE_CTF_H */
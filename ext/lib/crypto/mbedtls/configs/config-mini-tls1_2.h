@@ -82,6 +82,13 @@
 #define MBEDTLS_SSL_MAX_CONTENT_LEN  1500
 #endif
 
+#if defined(CONFIG_NET_APP_TLS_SESSION_RESUMPTION)
+#define MBEDTLS_GCM_C
+#define MBEDTLS_SSL_CACHE_C
+#define MBEDTLS_SSL_SESSION_TICKETS
+#define MBEDTLS_SSL_TICKET_C
+#endif
+
 #include "mbedtls/check_config.h"
 
 #endif /* MBEDTLS_CONFIG_H */
@@ -158,6 +158,48 @@ struct bt_conn_info {
  */
 int bt_conn_get_info(const struct bt_conn *conn, struct bt_conn_info *info);
 
+/** @brief Connection TX Statistics Structure
+ *
+ *  @param queued ACL packets waiting to be sent to the controller
+ *  @param queued_max Most ACL packets that were waiting at once
+ *  @param sent ACL packets sent to the controller
+ *  @param frags ACL fragments sent to the controller
+ *  @param latency_avg Average time in milliseconds from an ACL packet
+ *         reaching the head of the queue to its last fragment being sent
+ *  @param latency_max Longest such time in milliseconds
+ */
+struct bt_conn_tx_stats {
+	u16_t queued;
+	u16_t queued_max;
+	u32_t sent;
+	u32_t frags;
+	u32_t latency_avg;
+	u32_t latency_max;
+};
+
+/** @brief Get connection TX statistics
+ *
+ *  @param conn Connection object.
+ *  @param stats TX statistics object.
+ *
+ *  @return Zero on success or (negative) error code on failure.
+ */
+int bt_conn_get_tx_stats(const struct bt_conn *conn,
+			 struct bt_conn_tx_stats *stats);
+
+/** @brief Set the TX weight of a connection.
+ *
+ *  Connections with data to send take turns to send ACL fragments to the
+ *  controller, sending up to their weight in fragments per turn. A new
+ *  connection has a weight of 1.
+ *
+ *  @param conn Connection object.
+ *  @param weight Fragments per turn, at least 1.
+ *
+ *  @return Zero on success or (negative) error code on failure.
+ */
+int bt_conn_set_tx_weight(struct bt_conn *conn, u8_t weight);
+
 /** @brief Update the connection parameters.
  *
  *  @param conn Connection object.
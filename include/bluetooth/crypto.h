@@ -67,6 +67,40 @@ int bt_encrypt_le(const u8_t key[16], const u8_t plaintext[16],
 int bt_encrypt_be(const u8_t key[16], const u8_t plaintext[16],
 		  u8_t enc_data[16]);
 
+/** @brief AES-128 key with its round keys expanded.
+ *
+ *  Encrypting with an expanded key skips the key expansion that
+ *  bt_encrypt_be() does for every block, which pays off for modes
+ *  encrypting several blocks with one key, such as CCM and CMAC.
+ */
+struct bt_aes_key {
+	u32_t words[44];
+};
+
+/** @brief Expand an AES-128 key.
+ *
+ *  Unlike bt_encrypt_be(), the expanded key is always used by a software
+ *  AES implementation in the host.
+ *
+ *  @param key Key to expand into.
+ *  @param key_be 128 bit MS byte first key.
+ *
+ *  @return Zero on success or error code otherwise.
+ */
+int bt_aes_key_set(struct bt_aes_key *key, const u8_t key_be[16]);
+
+/** @brief AES encrypt big-endian data with an expanded key.
+ *
+ *  @param key Key expanded with bt_aes_key_set().
+ *  @param plaintext 128 bit MS byte first plaintext data block to be encrypted
+ *  @param enc_data 128 bit MS byte first encrypted data block, which may be
+ *  the same buffer as @p plaintext
+ *
+ *  @return Zero on success or error code otherwise.
+ */
+int bt_aes_encrypt_be(const struct bt_aes_key *key, const u8_t plaintext[16],
+		      u8_t enc_data[16]);
+
 #ifdef __cplusplus
 }
 #endif
@@ -253,6 +253,16 @@ struct bt_gatt_cep {
  */
 #define BT_GATT_CCC_INDICATE			0x0002
 
+/* Client Supported Features Values */
+
+/** @def BT_GATT_CLIENT_FEAT_MULTI_NOTIFY
+ *  @brief Client Supported Features Multiple Handle Value Notifications.
+ *
+ *  If set, the client accepts values of several characteristics in one
+ *  notification.
+ */
+#define BT_GATT_CLIENT_FEAT_MULTI_NOTIFY	BIT(2)
+
 /* Client Characteristic Configuration Attribute Value */
 struct bt_gatt_ccc {
 	/** Client Characteristic Configuration flags */
@@ -324,6 +334,20 @@ typedef u8_t (*bt_gatt_attr_func_t)(const struct bt_gatt_attr *attr,
 void bt_gatt_foreach_attr(u16_t start_handle, u16_t end_handle,
 			  bt_gatt_attr_func_t func, void *user_data);
 
+/** @brief Attribute iterator by type.
+ *
+ *  Iterate attributes of the given type in the given range.
+ *
+ *  @param start_handle Start handle.
+ *  @param end_handle End handle.
+ *  @param uuid Attribute type.
+ *  @param func Callback function.
+ *  @param user_data Data to pass to the callback.
+ */
+void bt_gatt_foreach_attr_type(u16_t start_handle, u16_t end_handle,
+			       const struct bt_uuid *uuid,
+			       bt_gatt_attr_func_t func, void *user_data);
+
 /** @brief Iterate to the next attribute
  *
  *  Iterate to the next attribute following a given attribute.
@@ -117,6 +117,8 @@ struct bt_l2cap_le_chan {
 	/** Segment SDU packet from upper layer */
 	struct net_buf			*_sdu;
 	u16_t				_sdu_len;
+	/** Received K-frames chained to SDUs not freed yet */
+	u16_t				_sdu_held;
 };
 
 /** @def BT_L2CAP_LE_CHAN(_ch)
@@ -191,7 +193,10 @@ struct bt_l2cap_chan_ops {
 	/** Channel alloc_buf callback
 	 *
 	 *  If this callback is provided the channel will use it to allocate
-	 *  buffers to store incoming data.
+	 *  buffers to store incoming data. Otherwise, with
+	 *  CONFIG_BT_L2CAP_RX_SDU_COUNT set, LE channels receive each SDU as
+	 *  an empty buffer with the received data chained to it as fragments,
+	 *  and the peer gets its credits back once the SDU is freed.
 	 *
 	 *  @param chan The channel requesting a buffer.
 	 *
@@ -316,6 +316,53 @@ int bt_mesh_lpn_poll(void);
  */
 void bt_mesh_lpn_set_cb(void (*cb)(u16_t friend_addr, bool established));
 
+/** @brief Replay protection list storage callbacks. */
+struct bt_mesh_rpl_store {
+	/** @brief Store the entry of a source address.
+	 *
+	 *  Replaces any entry previously stored for the same address.
+	 *  Called from the system workqueue, at most
+	 *  CONFIG_BT_MESH_RPL_STORE_TIMEOUT seconds after the entry changed.
+	 *
+	 *  @param src    Unicast source address.
+	 *  @param seq    Highest sequence number received from @p src.
+	 *  @param old_iv true if @p seq is from the previous IV Index.
+	 */
+	void (*store)(u16_t src, u32_t seq, bool old_iv);
+
+	/** @brief Remove all stored entries.
+	 *
+	 *  Called when the list is cleared, and on IV Index updates before
+	 *  the remaining entries are stored again.
+	 */
+	void (*clear)(void);
+};
+
+/** @brief Register callbacks for storing the replay protection list.
+ *
+ *  Entries are passed to the callbacks one by one as they change, which
+ *  suits storage that appends records. Messages received between a
+ *  change and its storage can be replayed to the node after a reboot,
+ *  so CONFIG_BT_MESH_RPL_STORE_TIMEOUT trades this window for fewer
+ *  writes.
+ *
+ *  @param store Callbacks, or NULL to stop storing.
+ */
+void bt_mesh_rpl_store_register(const struct bt_mesh_rpl_store *store);
+
+/** @brief Restore a stored replay protection list entry.
+ *
+ *  Called by the application for each stored entry after bt_mesh_init()
+ *  and bt_mesh_provision(), before messages are received.
+ *
+ *  @param src    Unicast source address.
+ *  @param seq    Highest sequence number received from @p src.
+ *  @param old_iv true if @p seq is from the previous IV Index.
+ *
+ *  @return Zero on success or (negative) error code otherwise.
+ */
+int bt_mesh_rpl_restore(u16_t src, u32_t seq, bool old_iv);
+
 /**
  * @}
  */
@@ -464,6 +464,11 @@ struct bt_uuid_128 {
  */
 #define BT_UUID_MESH_PROXY_DATA_OUT       BT_UUID_DECLARE_16(0x2ade)
 #define BT_UUID_MESH_PROXY_DATA_OUT_VAL   0x2ade
+/** @def BT_UUID_GATT_CLIENT_FEATURES
+ *  @brief GATT Characteristic Client Supported Features
+ */
+#define BT_UUID_GATT_CLIENT_FEATURES      BT_UUID_DECLARE_16(0x2b29)
+#define BT_UUID_GATT_CLIENT_FEATURES_VAL  0x2b29
 
 /*
  * Protocol UUIDs
@@ -165,9 +165,11 @@ enum k_objects {
 
 	/* Core kernel objects */
 	K_OBJ_ALERT,
+	K_OBJ_EVENT,
 	K_OBJ_MSGQ,
 	K_OBJ_MUTEX,
 	K_OBJ_PIPE,
+	K_OBJ_RWLOCK,
 	K_OBJ_SEM,
 	K_OBJ_STACK,
 	K_OBJ_THREAD,
@@ -211,6 +213,12 @@ struct _k_object_assignment {
 	void * const *objects;
 };
 
+struct _k_object_cache {
+	void *obj;
+	struct _k_object *ko;
+	u32_t gen;
+};
+
 /**
  * @brief Grant a static thread access to a list of kernel objects
  *
@@ -317,6 +325,35 @@ __syscall void k_object_access_revoke(void *object, struct k_thread *thread);
  */
 void k_object_access_all_grant(void *object);
 
+#ifdef CONFIG_DYNAMIC_OBJECTS
+/**
+ * Allocate a kernel object at runtime
+ *
+ * The object is taken from the kernel heap and registered so that it can
+ * be passed to system calls like a statically declared object. The calling
+ * thread is granted access to it; it may grant access to other threads
+ * with k_object_access_grant(). The object must still be initialized with
+ * its init function before use.
+ *
+ * Threads and thread stacks can not be allocated this way.
+ *
+ * @param otype Type of kernel object to allocate
+ * @return Address of the new object, or NULL if @a otype is not supported
+ *	   or the heap is exhausted
+ */
+__syscall void *k_object_alloc(enum k_objects otype);
+
+/**
+ * Free a kernel object allocated with k_object_alloc()
+ *
+ * The object must no longer be in use by any thread. Freeing an address
+ * that was not returned by k_object_alloc() has no effect.
+ *
+ * @param obj Address of the kernel object
+ */
+void k_object_free(void *obj);
+#endif /* CONFIG_DYNAMIC_OBJECTS */
+
 /* Using typedef deliberately here, this is quite intended to be an opaque
  * type. K_THREAD_STACK_BUFFER() should be used to access the data within.
  *
@@ -454,6 +491,24 @@ struct _thread_stack_info {
 typedef struct _thread_stack_info _thread_stack_info_t;
 #endif /* CONFIG_THREAD_STACK_INFO */
 
+/**
+ * @brief Runtime statistics of a thread
+ *
+ * @see k_thread_runtime_stats_get()
+ */
+struct k_thread_runtime_stats {
+	/** Hardware cycles spent running */
+	u64_t execution_cycles;
+	/** Hardware cycles spent ready but not running */
+	u64_t ready_cycles;
+	/** Number of times the thread was switched in */
+	u32_t switches_in;
+	/** Number of times the thread was switched out */
+	u32_t switches_out;
+	/** Peak stack usage in bytes, 0 if not tracked */
+	size_t stack_peak;
+};
+
 // KID 20170517
 // KID 20170519
 // KID 20170523
@@ -492,6 +547,12 @@ struct k_thread {
 	/* abort function */
 	void (*fn_abort)(void);
 
+	/* mutexes owned, for priority inheritance */
+	sys_dlist_t held_mutexes;
+
+	/* mutex the thread is waiting for, if any */
+	struct k_mutex *pended_mutex;
+
 #if defined(CONFIG_THREAD_MONITOR) // CONFIG_THREAD_MONITOR=n
 	/* thread entry and parameters description */
 	struct __thread_entry *entry;
@@ -515,11 +576,22 @@ struct k_thread {
 	struct _thread_stack_info stack_info;
 #endif /* CONFIG_THREAD_STACK_INFO */
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	/* runtime statistics, stack_peak is computed when read */
+	struct k_thread_runtime_stats rt_stats;
+	/* cycle count when last switched in or made ready */
+	u32_t rt_stamp;
+#endif
+
 #if defined(CONFIG_USERSPACE)
 	/* memory domain info of the thread */
 	struct _mem_domain_info mem_domain_info;
 	/* Base address of thread stack */
 	k_thread_stack_t *stack_obj;
+#ifdef CONFIG_KOBJECT_VALIDATION_CACHE
+	/* last kernel object that passed a system call check */
+	struct _k_object_cache kobj_cache;
+#endif
 #endif /* CONFIG_USERSPACE */
 
 	/* arch-specifics: must always be at the end */
@@ -561,6 +633,22 @@ enum execution_context_types {
  */
 extern void k_call_stacks_analyze(void);
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+/**
+ * @brief Get the runtime statistics of a thread
+ *
+ * The cycle counts include the time spent so far in the thread's current
+ * state, so the statistics of the calling thread are up to date.
+ *
+ * @param thread ID of thread to query.
+ * @param stats Address of structure receiving the statistics.
+ *
+ * @retval 0 Statistics returned.
+ */
+__syscall int k_thread_runtime_stats_get(k_tid_t thread,
+					 struct k_thread_runtime_stats *stats);
+#endif
+
 /**
  * @} end defgroup profiling_apis
  */
@@ -1424,6 +1512,8 @@ struct k_timer {
 	/* user-specific data, also used to support legacy features */
 	void *user_data;
 
+	_POLL_EVENT;
+
 	_OBJECT_TRACING_NEXT_PTR(k_timer);
 };
 
@@ -1438,6 +1528,7 @@ struct k_timer {
 	.stop_fn = stop, \
 	.status = 0, \
 	.user_data = 0, \
+	_POLL_EVENT_OBJ_INIT(obj) \
 	_OBJECT_TRACING_INIT \
 	}
 
@@ -1916,6 +2007,53 @@ extern void k_queue_merge_slist(struct k_queue *queue, sys_slist_t *list);
  */
 extern void *k_queue_get(struct k_queue *queue, s32_t timeout);
 
+/**
+ * @brief Get a batch of elements from a queue.
+ *
+ * This routine moves up to @a max data items from the head of @a queue to
+ * the tail of @a list in a single locked operation. If the queue is empty
+ * it waits for the first data item like k_queue_get(), then takes the
+ * items that were queued along with it.
+ *
+ * The data items keep their order, and the first 32 bits of each are
+ * reused as @a list link. @a list may already hold items.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param queue Address of the queue.
+ * @param list Address of the list that receives the data items.
+ * @param max Maximum number of data items to take.
+ * @param timeout Waiting period to obtain a data item (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Number of data items added to @a list; 0 if returned without
+ * waiting, or waiting period timed out.
+ */
+extern int k_queue_get_batch(struct k_queue *queue, sys_slist_t *list,
+			     unsigned int max, s32_t timeout);
+
+/**
+ * @brief Get all elements from a queue.
+ *
+ * Same as k_queue_get_batch() without a limit. The queued items are
+ * detached in constant time, whatever their number.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param queue Address of the queue.
+ * @param list Address of the list that receives the data items.
+ * @param timeout Waiting period to obtain a data item (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Number of data items added to @a list; 0 if returned without
+ * waiting, or waiting period timed out.
+ */
+static inline int k_queue_get_all(struct k_queue *queue, sys_slist_t *list,
+				  s32_t timeout)
+{
+	return k_queue_get_batch(queue, list, UINT_MAX, timeout);
+}
+
 /**
  * @brief Remove an element from a queue.
  *
@@ -2132,6 +2270,45 @@ struct k_fifo {
 #define k_fifo_get(fifo, timeout) \
 	k_queue_get((struct k_queue *) fifo, timeout)
 
+/**
+ * @brief Get a batch of elements from a fifo.
+ *
+ * This routine moves up to @a max data items from @a fifo to the tail of
+ * @a list in a single locked operation, waiting for the first one if the
+ * fifo is empty.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param fifo Address of the fifo.
+ * @param list Address of the sys_slist_t that receives the data items.
+ * @param max Maximum number of data items to take.
+ * @param timeout Waiting period to obtain a data item (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Number of data items added to @a list; 0 if returned without
+ * waiting, or waiting period timed out.
+ */
+#define k_fifo_get_batch(fifo, list, max, timeout) \
+	k_queue_get_batch((struct k_queue *) fifo, list, max, timeout)
+
+/**
+ * @brief Get all elements from a fifo.
+ *
+ * Same as k_fifo_get_batch() without a limit.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param fifo Address of the fifo.
+ * @param list Address of the sys_slist_t that receives the data items.
+ * @param timeout Waiting period to obtain a data item (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Number of data items added to @a list; 0 if returned without
+ * waiting, or waiting period timed out.
+ */
+#define k_fifo_get_all(fifo, list, timeout) \
+	k_queue_get_all((struct k_queue *) fifo, list, timeout)
+
 /**
  * @brief Query a fifo to see if it has data available.
  *
@@ -2478,12 +2655,20 @@ struct k_work {
 	void *_reserved;		/* Used by k_queue implementation. */
 	k_work_handler_t handler;
 	atomic_t flags[1];
+#ifdef CONFIG_WORK_POOL_STATS
+	u32_t submit_time;		/* Cycle count when queued to a pool */
+#endif
 };
 
+struct k_work_pool;
+
 struct k_delayed_work {
 	struct k_work work;
 	struct _timeout timeout;
 	struct k_work_q *work_q;
+#ifdef CONFIG_WORK_POOL
+	struct k_work_pool *work_pool;
+#endif
 };
 
 extern struct k_work_q k_sys_work_q;
@@ -2751,6 +2936,24 @@ static inline s32_t k_delayed_work_remaining_get(struct k_delayed_work *work)
  * @} end defgroup workqueue_apis
  */
 
+/**
+ * @brief Priority inversion statistics of a mutex
+ *
+ * An inversion lasts from the moment a thread of higher priority than the
+ * owner's own priority starts waiting for the mutex, until the owner hands
+ * it over or no such thread waits any more.
+ *
+ * @see k_mutex_inversion_stats_get()
+ */
+struct k_mutex_inversion_stats {
+	/** Number of inversions */
+	u32_t count;
+	/** Longest inversion, in hardware cycles */
+	u32_t max_cycles;
+	/** Total time spent in inversions, in hardware cycles */
+	u64_t total_cycles;
+};
+
 /**
  * @cond INTERNAL_HIDDEN
  */
@@ -2760,6 +2963,17 @@ struct k_mutex {
 	struct k_thread *owner;
 	u32_t lock_count;
 	int owner_orig_prio;
+	int ceiling;
+	/* node in the owner's list of held mutexes */
+	sys_dnode_t held_node;
+
+#ifdef CONFIG_MUTEX_INVERSION_STATS
+	struct k_mutex_inversion_stats inversion;
+	u32_t inversion_start;
+	u8_t inverted;
+#endif
+
+	_POLL_EVENT;
 
 	_OBJECT_TRACING_NEXT_PTR(k_mutex);
 };
@@ -2770,6 +2984,8 @@ struct k_mutex {
 	.owner = NULL, \
 	.lock_count = 0, \
 	.owner_orig_prio = K_LOWEST_THREAD_PRIO, \
+	.ceiling = K_LOWEST_THREAD_PRIO, \
+	_POLL_EVENT_OBJ_INIT(obj) \
 	_OBJECT_TRACING_INIT \
 	}
 
@@ -2848,6 +3064,41 @@ __syscall int k_mutex_lock(struct k_mutex *mutex, s32_t timeout);
  */
 __syscall void k_mutex_unlock(struct k_mutex *mutex);
 
+/**
+ * @brief Set the priority ceiling of a mutex.
+ *
+ * While a thread owns a mutex with a ceiling, it runs at least at the
+ * ceiling priority. Giving every mutex shared by a group of threads the
+ * priority of the highest priority thread of the group bounds the time
+ * those threads can be blocked by lower priority ones to a single
+ * critical section.
+ *
+ * A new mutex has no ceiling, which is the same as a ceiling of
+ * K_LOWEST_THREAD_PRIO.
+ *
+ * @param mutex Address of the mutex.
+ * @param prio Ceiling priority.
+ *
+ * @retval 0 Ceiling set.
+ * @retval -EBUSY The mutex is locked.
+ */
+__syscall int k_mutex_ceiling_set(struct k_mutex *mutex, int prio);
+
+#ifdef CONFIG_MUTEX_INVERSION_STATS
+/**
+ * @brief Get the priority inversion statistics of a mutex.
+ *
+ * An inversion in progress is included.
+ *
+ * @param mutex Address of the mutex.
+ * @param stats Address of structure receiving the statistics.
+ *
+ * @retval 0 Statistics returned.
+ */
+__syscall int k_mutex_inversion_stats_get(struct k_mutex *mutex,
+				struct k_mutex_inversion_stats *stats);
+#endif
+
 /**
  * @} end defgroup mutex_apis
  */
@@ -2989,190 +3240,712 @@ static inline unsigned int _impl_k_sem_count_get(struct k_sem *sem)
  * @} end defgroup semaphore_apis
  */
 
-/**
- * @defgroup alert_apis Alert APIs
- * @ingroup kernel_apis
- * @{
- */
-
-/**
- * @typedef k_alert_handler_t
- * @brief Alert handler function type.
- *
- * An alert's alert handler function is invoked by the system workqueue
- * when the alert is signaled. The alert handler function is optional,
- * and is only invoked if the alert has been initialized with one.
- *
- * @param alert Address of the alert.
- *
- * @return 0 if alert has been consumed; non-zero if alert should pend.
- */
-typedef int (*k_alert_handler_t)(struct k_alert *alert);
-
-/**
- * @} end defgroup alert_apis
- */
-
 /**
  * @cond INTERNAL_HIDDEN
  */
 
-#define K_ALERT_DEFAULT NULL
-#define K_ALERT_IGNORE ((void *)(-1))
-
-struct k_alert {
-	k_alert_handler_t handler;
-	atomic_t send_count;
-	struct k_work work_item;
-	struct k_sem sem;
+struct k_rwlock {
+	_wait_q_t read_q;
+	_wait_q_t write_q;
+	struct k_thread *writer;
+	unsigned int readers;
 
-	_OBJECT_TRACING_NEXT_PTR(k_alert);
+	_OBJECT_TRACING_NEXT_PTR(k_rwlock);
 };
 
-extern void _alert_deliver(struct k_work *work);
-
-#define _K_ALERT_INITIALIZER(obj, alert_handler, max_num_pending_alerts) \
+#define _K_RWLOCK_INITIALIZER(obj) \
 	{ \
-	.handler = (k_alert_handler_t)alert_handler, \
-	.send_count = ATOMIC_INIT(0), \
-	.work_item = _K_WORK_INITIALIZER(_alert_deliver), \
-	.sem = _K_SEM_INITIALIZER(obj.sem, 0, max_num_pending_alerts), \
+	.read_q = SYS_DLIST_STATIC_INIT(&obj.read_q), \
+	.write_q = SYS_DLIST_STATIC_INIT(&obj.write_q), \
+	.writer = NULL, \
+	.readers = 0, \
 	_OBJECT_TRACING_INIT \
 	}
 
-#define K_ALERT_INITIALIZER DEPRECATED_MACRO _K_ALERT_INITIALIZER
-
 /**
  * INTERNAL_HIDDEN @endcond
  */
 
 /**
- * @addtogroup alert_apis
+ * @defgroup rwlock_apis Reader-Writer Lock APIs
+ * @ingroup kernel_apis
  * @{
  */
 
 /**
- * @brief Statically define and initialize an alert.
+ * @brief Statically define and initialize a reader-writer lock.
  *
- * The alert can be accessed outside the module where it is defined using:
+ * The lock can be accessed outside the module where it is defined using:
  *
- * @code extern struct k_alert <name>; @endcode
+ * @code extern struct k_rwlock <name>; @endcode
  *
- * @param name Name of the alert.
- * @param alert_handler Action to take when alert is sent. Specify either
- *        the address of a function to be invoked by the system workqueue
- *        thread, K_ALERT_IGNORE (which causes the alert to be ignored), or
- *        K_ALERT_DEFAULT (which causes the alert to pend).
- * @param max_num_pending_alerts Maximum number of pending alerts.
+ * @param name Name of the reader-writer lock.
  */
-#define K_ALERT_DEFINE(name, alert_handler, max_num_pending_alerts) \
-	struct k_alert name \
-		__in_section(_k_alert, static, name) = \
-		_K_ALERT_INITIALIZER(name, alert_handler, \
-				    max_num_pending_alerts)
+#define K_RWLOCK_DEFINE(name) \
+	struct k_rwlock name \
+		__in_section(_k_rwlock, static, name) = \
+		_K_RWLOCK_INITIALIZER(name)
 
 /**
- * @brief Initialize an alert.
+ * @brief Initialize a reader-writer lock.
  *
- * This routine initializes an alert object, prior to its first use.
+ * This routine initializes a reader-writer lock, prior to its first use.
  *
- * @param alert Address of the alert.
- * @param handler Action to take when alert is sent. Specify either the address
- *                of a function to be invoked by the system workqueue thread,
- *                K_ALERT_IGNORE (which causes the alert to be ignored), or
- *                K_ALERT_DEFAULT (which causes the alert to pend).
- * @param max_num_pending_alerts Maximum number of pending alerts.
+ * Any number of readers may hold the lock at the same time, while a writer
+ * holds it alone. Waiting writers are preferred over new readers: a reader
+ * only gets in ahead of the waiting writers if it has a higher priority than
+ * all of them. Waiters of each kind are served in priority order.
+ *
+ * The lock is not recursive, and a reader cannot upgrade to a writer.
+ *
+ * @param rwlock Address of the reader-writer lock.
  *
  * @return N/A
  */
-extern void k_alert_init(struct k_alert *alert, k_alert_handler_t handler,
-			 unsigned int max_num_pending_alerts);
+__syscall void k_rwlock_init(struct k_rwlock *rwlock);
 
 /**
- * @brief Receive an alert.
+ * @brief Lock a reader-writer lock for reading.
  *
- * This routine receives a pending alert for @a alert.
+ * @param rwlock Address of the reader-writer lock.
+ * @param timeout Waiting period to lock the lock (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
  *
- * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ * @retval 0 Lock held for reading.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+__syscall int k_rwlock_read_lock(struct k_rwlock *rwlock, s32_t timeout);
+
+/**
+ * @brief Release a reader-writer lock held for reading.
  *
- * @param alert Address of the alert.
- * @param timeout Waiting period to receive the alert (in milliseconds),
+ * @param rwlock Address of the reader-writer lock.
+ *
+ * @return N/A
+ */
+__syscall void k_rwlock_read_unlock(struct k_rwlock *rwlock);
+
+/**
+ * @brief Lock a reader-writer lock for writing.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ * @param timeout Waiting period to lock the lock (in milliseconds),
  *                or one of the special values K_NO_WAIT and K_FOREVER.
  *
- * @retval 0 Alert received.
+ * @retval 0 Lock held for writing.
  * @retval -EBUSY Returned without waiting.
  * @retval -EAGAIN Waiting period timed out.
  */
-__syscall int k_alert_recv(struct k_alert *alert, s32_t timeout);
+__syscall int k_rwlock_write_lock(struct k_rwlock *rwlock, s32_t timeout);
 
 /**
- * @brief Signal an alert.
- *
- * This routine signals @a alert. The action specified for @a alert will
- * be taken, which may trigger the execution of an alert handler function
- * and/or cause the alert to pend (assuming the alert has not reached its
- * maximum number of pending alerts).
+ * @brief Release a reader-writer lock held for writing.
  *
- * @note Can be called by ISRs.
+ * The lock goes to the highest priority waiting writer, unless some waiting
+ * readers have a higher priority than it, in which case those readers get
+ * the lock.
  *
- * @param alert Address of the alert.
+ * @param rwlock Address of the reader-writer lock.
  *
  * @return N/A
  */
-__syscall void k_alert_send(struct k_alert *alert);
+__syscall void k_rwlock_write_unlock(struct k_rwlock *rwlock);
 
 /**
- * @} end addtogroup alert_apis
+ * @} end defgroup rwlock_apis
+ */
+
+/**
+ * @defgroup futex_apis Futex APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @brief Wait on a futex.
+ *
+ * A futex is an atomic variable that threads synchronize on without the
+ * kernel's help until they have to block. The variable lives in memory the
+ * threads can access directly; the kernel only keeps the threads waiting on
+ * it, see include/misc/futex_mutex.h for a lock built this way.
+ *
+ * This routine blocks the caller if the futex still holds @a expected,
+ * until k_futex_wake() is called on it. The check and the wait are atomic
+ * with respect to k_futex_wake().
+ *
+ * @param futex Address of the futex variable.
+ * @param expected Value the futex is expected to hold.
+ * @param timeout Waiting period (in milliseconds), or K_FOREVER.
+ *
+ * @retval 0 Woken by k_futex_wake().
+ * @retval -EAGAIN The futex did not hold @a expected.
+ * @retval -ETIMEDOUT Waiting period timed out.
+ */
+__syscall int k_futex_wait(atomic_t *futex, atomic_val_t expected,
+			   s32_t timeout);
+
+/**
+ * @brief Wake threads waiting on a futex.
+ *
+ * Waiters are woken in priority order.
+ *
+ * @param futex Address of the futex variable.
+ * @param wake_all Wake all the waiters if non-zero, otherwise only one.
+ *
+ * @return Number of threads woken.
+ */
+__syscall int k_futex_wake(atomic_t *futex, int wake_all);
+
+/**
+ * @} end defgroup futex_apis
  */
 
 /**
  * @cond INTERNAL_HIDDEN
  */
 
-struct k_msgq {
+struct k_event {
 	_wait_q_t wait_q;
-	size_t msg_size;
-	u32_t max_msgs;
-	char *buffer_start;
-	char *buffer_end;
-	char *read_ptr;
-	char *write_ptr;
-	u32_t used_msgs;
+	u32_t events;
 
-	_OBJECT_TRACING_NEXT_PTR(k_msgq);
+	_OBJECT_TRACING_NEXT_PTR(k_event);
 };
 
-#define _K_MSGQ_INITIALIZER(obj, q_buffer, q_msg_size, q_max_msgs) \
+#define _K_EVENT_INITIALIZER(obj) \
 	{ \
 	.wait_q = SYS_DLIST_STATIC_INIT(&obj.wait_q), \
-	.max_msgs = q_max_msgs, \
-	.msg_size = q_msg_size, \
-	.buffer_start = q_buffer, \
-	.buffer_end = q_buffer + (q_max_msgs * q_msg_size), \
-	.read_ptr = q_buffer, \
-	.write_ptr = q_buffer, \
-	.used_msgs = 0, \
+	.events = 0, \
 	_OBJECT_TRACING_INIT \
 	}
 
-#define K_MSGQ_INITIALIZER DEPRECATED_MACRO _K_MSGQ_INITIALIZER
-
 /**
  * INTERNAL_HIDDEN @endcond
  */
 
 /**
- * @defgroup msgq_apis Message Queue APIs
+ * @defgroup event_apis Event APIs
  * @ingroup kernel_apis
  * @{
  */
 
+/** Wake up once any of the requested events is set */
+#define K_EVENT_WAIT_ANY 0
+
+/** Wake up once all of the requested events are set */
+#define K_EVENT_WAIT_ALL BIT(0)
+
+/** Clear the matched events when waking up */
+#define K_EVENT_WAIT_CLEAR BIT(1)
+
 /**
- * @brief Statically define and initialize a message queue.
+ * @brief Statically define and initialize an event object.
  *
- * The message queue's ring buffer contains space for @a q_max_msgs messages,
- * each of which is @a q_msg_size bytes long. The buffer is aligned to a
- * @a q_align -byte boundary, which must be a power of 2. To ensure that each
+ * The event object can be accessed outside the module where it is defined
+ * using:
+ *
+ * @code extern struct k_event <name>; @endcode
+ *
+ * @param name Name of the event object.
+ */
+#define K_EVENT_DEFINE(name) \
+	struct k_event name \
+		__in_section(_k_event, static, name) = \
+		_K_EVENT_INITIALIZER(name)
+
+/**
+ * @brief Initialize an event object.
+ *
+ * An event object holds a group of 32 event flags. Threads wait for any or
+ * all of a subset of them to be set; setting flags wakes every waiter whose
+ * condition is met, in priority order.
+ *
+ * @param event Address of the event object.
+ *
+ * @return N/A
+ */
+__syscall void k_event_init(struct k_event *event);
+
+/**
+ * @brief Set events in an event object.
+ *
+ * The events are added to the ones already set.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param event Address of the event object.
+ * @param events Events to set.
+ *
+ * @return N/A
+ */
+__syscall void k_event_post(struct k_event *event, u32_t events);
+
+/**
+ * @brief Replace the events of an event object.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param event Address of the event object.
+ * @param events Events to set, the others are cleared.
+ *
+ * @return N/A
+ */
+__syscall void k_event_set(struct k_event *event, u32_t events);
+
+/**
+ * @brief Clear events in an event object.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param event Address of the event object.
+ * @param events Events to clear.
+ *
+ * @return N/A
+ */
+__syscall void k_event_clear(struct k_event *event, u32_t events);
+
+/**
+ * @brief Wait for events.
+ *
+ * Waits until any of @a events is set, or all of them with
+ * K_EVENT_WAIT_ALL. With K_EVENT_WAIT_CLEAR, the events that satisfied the
+ * wait are cleared atomically with it, so that each posting wakes only one
+ * waiter of those requesting them.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param event Address of the event object.
+ * @param events Events to wait for.
+ * @param options K_EVENT_WAIT_ANY or K_EVENT_WAIT_ALL, optionally ORed with
+ *                K_EVENT_WAIT_CLEAR.
+ * @param timeout Waiting period (in milliseconds), or one of the special
+ *                values K_NO_WAIT and K_FOREVER.
+ *
+ * @return The requested events that were set, 0 if the waiting period
+ *         timed out.
+ */
+__syscall u32_t k_event_wait(struct k_event *event, u32_t events,
+			     unsigned int options, s32_t timeout);
+
+/**
+ * @brief Get the events set in an event object.
+ *
+ * @param event Address of the event object.
+ *
+ * @return The events set.
+ */
+__syscall u32_t k_event_get(struct k_event *event);
+
+static inline u32_t _impl_k_event_get(struct k_event *event)
+{
+	return event->events;
+}
+
+/**
+ * @} end defgroup event_apis
+ */
+
+#ifdef CONFIG_WORK_POOL
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+struct k_work_pool_worker {
+	struct k_thread thread;
+	sys_slist_t queue;
+	struct k_work_pool *pool;
+};
+
+struct k_work_pool {
+	struct k_sem sem;
+	struct k_work_pool_worker *workers;
+	u8_t num_workers;
+	u8_t next;
+#ifdef CONFIG_WORK_POOL_STATS
+	struct k_work_pool_stats {
+		u32_t completed;
+		u32_t stolen;
+		u32_t wait_max;
+		u32_t run_max;
+		u64_t wait_total;
+		u64_t run_total;
+	} stats;
+#endif
+};
+
+struct k_work_class {
+	struct k_work runner;
+	sys_slist_t queue;
+	struct k_work_pool *pool;
+	bool active;
+};
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @defgroup workpool_apis Workqueue Pool APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @brief Statically define a workqueue pool.
+ *
+ * The pool still has to be started with k_work_pool_start_worker() for
+ * each of its workers, which allows every worker to get its own stack
+ * size and priority.
+ *
+ * @param name Name of the workqueue pool.
+ * @param count Number of worker threads.
+ */
+#define K_WORK_POOL_DEFINE(name, count) \
+	static struct k_work_pool_worker \
+		_k_work_pool_workers_##name[count]; \
+	struct k_work_pool name = { \
+		.sem = _K_SEM_INITIALIZER(name.sem, 0, UINT_MAX), \
+		.workers = _k_work_pool_workers_##name, \
+		.num_workers = count, \
+	}
+
+/**
+ * @brief Initialize a workqueue pool.
+ *
+ * This routine initializes a workqueue pool, prior to its first use. It is
+ * only used for pools not defined using K_WORK_POOL_DEFINE.
+ *
+ * @param pool Address of workqueue pool.
+ * @param workers Array of @a num_workers worker objects.
+ * @param num_workers Number of worker threads.
+ *
+ * @return N/A
+ */
+extern void k_work_pool_init(struct k_work_pool *pool,
+			     struct k_work_pool_worker *workers,
+			     u8_t num_workers);
+
+/**
+ * @brief Start a worker thread of a workqueue pool.
+ *
+ * Each worker owns a queue of work items. Items are spread over the
+ * workers as they are submitted, and a worker that runs out of items
+ * takes the oldest item of another worker's queue instead of sleeping.
+ * Workers of higher priority are woken first.
+ *
+ * @param pool Address of workqueue pool.
+ * @param idx Index of the worker, less than the pool's number of workers.
+ * @param stack Pointer to the worker's stack space, as defined by
+ *		K_THREAD_STACK_DEFINE()
+ * @param stack_size Size of the worker's stack (in bytes).
+ * @param prio Priority of the worker's thread.
+ *
+ * @return N/A
+ */
+extern void k_work_pool_start_worker(struct k_work_pool *pool, u8_t idx,
+				     k_thread_stack_t *stack,
+				     size_t stack_size, int prio);
+
+/**
+ * @brief Submit a work item to a workqueue pool.
+ *
+ * Behaves like k_work_submit_to_queue(), except that the item is run by
+ * whichever worker of @a pool gets to it first. Items submitted from a
+ * worker of the pool are queued to that worker.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param pool Address of workqueue pool.
+ * @param work Address of work item.
+ *
+ * @return N/A
+ */
+extern void k_work_pool_submit(struct k_work_pool *pool,
+			       struct k_work *work);
+
+/**
+ * @brief Initialize an ordered work class.
+ *
+ * Work items submitted through the same class run one at a time and in
+ * submission order, though not necessarily on the same worker. This
+ * replaces a mutex shared by their handlers.
+ *
+ * @param cls Address of work class.
+ * @param pool Address of the workqueue pool that runs the class.
+ *
+ * @return N/A
+ */
+extern void k_work_class_init(struct k_work_class *cls,
+			      struct k_work_pool *pool);
+
+/**
+ * @brief Submit a work item through an ordered work class.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param cls Address of work class.
+ * @param work Address of work item.
+ *
+ * @return N/A
+ */
+extern void k_work_class_submit(struct k_work_class *cls,
+				struct k_work *work);
+
+/**
+ * @brief Submit a delayed work item to a workqueue pool.
+ *
+ * Same as k_delayed_work_submit_to_queue(), but the item is submitted to
+ * @a pool once the delay expires. The item is canceled with
+ * k_delayed_work_cancel().
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param pool Address of workqueue pool.
+ * @param work Address of delayed work item.
+ * @param delay Delay before submitting the work item (in milliseconds).
+ *
+ * @retval 0 Work item countdown started.
+ * @retval -EINPROGRESS Work item is already pending.
+ * @retval -EINVAL Work item is being processed or has completed its work.
+ * @retval -EADDRINUSE Work item is pending on a different queue or pool.
+ */
+extern int k_delayed_work_submit_to_pool(struct k_work_pool *pool,
+					 struct k_delayed_work *work,
+					 s32_t delay);
+
+#ifdef CONFIG_WORK_POOL_STATS
+/**
+ * @brief Read the statistics of a workqueue pool.
+ *
+ * Times are in hardware cycles, see SYS_CLOCK_HW_CYCLES_TO_NS(). The wait
+ * time of an item runs from its submission to the start of its handler.
+ * Items of an ordered class are accounted as their class.
+ *
+ * @param pool Address of workqueue pool.
+ * @param stats Area to store the statistics.
+ * @param reset Clear the statistics after reading them.
+ *
+ * @return N/A
+ */
+extern void k_work_pool_stats_get(struct k_work_pool *pool,
+				  struct k_work_pool_stats *stats,
+				  bool reset);
+#endif
+
+/**
+ * @} end defgroup workpool_apis
+ */
+
+#endif /* CONFIG_WORK_POOL */
+
+/**
+ * @defgroup alert_apis Alert APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @typedef k_alert_handler_t
+ * @brief Alert handler function type.
+ *
+ * An alert's alert handler function is invoked by the system workqueue
+ * when the alert is signaled. The alert handler function is optional,
+ * and is only invoked if the alert has been initialized with one.
+ *
+ * @param alert Address of the alert.
+ *
+ * @return 0 if alert has been consumed; non-zero if alert should pend.
+ */
+typedef int (*k_alert_handler_t)(struct k_alert *alert);
+
+/**
+ * @} end defgroup alert_apis
+ */
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+#define K_ALERT_DEFAULT NULL
+#define K_ALERT_IGNORE ((void *)(-1))
+
+struct k_alert {
+	k_alert_handler_t handler;
+	atomic_t send_count;
+	struct k_work work_item;
+	struct k_sem sem;
+
+	_OBJECT_TRACING_NEXT_PTR(k_alert);
+};
+
+extern void _alert_deliver(struct k_work *work);
+
+#define _K_ALERT_INITIALIZER(obj, alert_handler, max_num_pending_alerts) \
+	{ \
+	.handler = (k_alert_handler_t)alert_handler, \
+	.send_count = ATOMIC_INIT(0), \
+	.work_item = _K_WORK_INITIALIZER(_alert_deliver), \
+	.sem = _K_SEM_INITIALIZER(obj.sem, 0, max_num_pending_alerts), \
+	_OBJECT_TRACING_INIT \
+	}
+
+#define K_ALERT_INITIALIZER DEPRECATED_MACRO _K_ALERT_INITIALIZER
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @addtogroup alert_apis
+ * @{
+ */
+
+/**
+ * @brief Statically define and initialize an alert.
+ *
+ * The alert can be accessed outside the module where it is defined using:
+ *
+ * @code extern struct k_alert <name>; @endcode
+ *
+ * @param name Name of the alert.
+ * @param alert_handler Action to take when alert is sent. Specify either
+ *        the address of a function to be invoked by the system workqueue
+ *        thread, K_ALERT_IGNORE (which causes the alert to be ignored), or
+ *        K_ALERT_DEFAULT (which causes the alert to pend).
+ * @param max_num_pending_alerts Maximum number of pending alerts.
+ */
+#define K_ALERT_DEFINE(name, alert_handler, max_num_pending_alerts) \
+	struct k_alert name \
+		__in_section(_k_alert, static, name) = \
+		_K_ALERT_INITIALIZER(name, alert_handler, \
+				    max_num_pending_alerts)
+
+/**
+ * @brief Initialize an alert.
+ *
+ * This routine initializes an alert object, prior to its first use.
+ *
+ * @param alert Address of the alert.
+ * @param handler Action to take when alert is sent. Specify either the address
+ *                of a function to be invoked by the system workqueue thread,
+ *                K_ALERT_IGNORE (which causes the alert to be ignored), or
+ *                K_ALERT_DEFAULT (which causes the alert to pend).
+ * @param max_num_pending_alerts Maximum number of pending alerts.
+ *
+ * @return N/A
+ */
+extern void k_alert_init(struct k_alert *alert, k_alert_handler_t handler,
+			 unsigned int max_num_pending_alerts);
+
+/**
+ * @brief Receive an alert.
+ *
+ * This routine receives a pending alert for @a alert.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param alert Address of the alert.
+ * @param timeout Waiting period to receive the alert (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Alert received.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+__syscall int k_alert_recv(struct k_alert *alert, s32_t timeout);
+
+/**
+ * @brief Signal an alert.
+ *
+ * This routine signals @a alert. The action specified for @a alert will
+ * be taken, which may trigger the execution of an alert handler function
+ * and/or cause the alert to pend (assuming the alert has not reached its
+ * maximum number of pending alerts).
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param alert Address of the alert.
+ *
+ * @return N/A
+ */
+__syscall void k_alert_send(struct k_alert *alert);
+
+/**
+ * @} end addtogroup alert_apis
+ */
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+struct k_msgq {
+	_wait_q_t wait_q;
+	size_t msg_size;
+	u32_t max_msgs;
+	char *buffer_start;
+	char *buffer_end;
+	char *read_ptr;
+	char *write_ptr;
+	u32_t used_msgs;
+	char *alloc_ptr;
+	size_t alloc_size;
+	u8_t claimed;
+	_POLL_EVENT;
+
+	_OBJECT_TRACING_NEXT_PTR(k_msgq);
+};
+
+#define _K_MSGQ_INITIALIZER(obj, q_buffer, q_msg_size, q_max_msgs) \
+	{ \
+	.wait_q = SYS_DLIST_STATIC_INIT(&obj.wait_q), \
+	.max_msgs = q_max_msgs, \
+	.msg_size = q_msg_size, \
+	.buffer_start = q_buffer, \
+	.buffer_end = q_buffer + (q_max_msgs * q_msg_size), \
+	.read_ptr = q_buffer, \
+	.write_ptr = q_buffer, \
+	.used_msgs = 0, \
+	.alloc_ptr = NULL, \
+	.claimed = 0, \
+	_POLL_EVENT_OBJ_INIT(obj) \
+	_OBJECT_TRACING_INIT \
+	}
+
+#define _K_MSGQ_VARLEN_INITIALIZER(obj, q_buffer, q_size) \
+	{ \
+	.wait_q = SYS_DLIST_STATIC_INIT(&obj.wait_q), \
+	.max_msgs = 0, \
+	.msg_size = 0, \
+	.buffer_start = q_buffer, \
+	.buffer_end = q_buffer + (q_size), \
+	.read_ptr = q_buffer, \
+	.write_ptr = q_buffer, \
+	.used_msgs = 0, \
+	.alloc_ptr = NULL, \
+	.claimed = 0, \
+	_POLL_EVENT_OBJ_INIT(obj) \
+	_OBJECT_TRACING_INIT \
+	}
+
+#define K_MSGQ_INITIALIZER DEPRECATED_MACRO _K_MSGQ_INITIALIZER
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @defgroup msgq_apis Message Queue APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @brief Statically define and initialize a message queue.
+ *
+ * The message queue's ring buffer contains space for @a q_max_msgs messages,
+ * each of which is @a q_msg_size bytes long. The buffer is aligned to a
+ * @a q_align -byte boundary, which must be a power of 2. To ensure that each
  * message is similarly aligned to this boundary, @a q_msg_size must also be
  * a multiple of @a q_align.
  *
@@ -3194,6 +3967,29 @@ struct k_msgq {
 	       _K_MSGQ_INITIALIZER(q_name, _k_fifo_buf_##q_name,     \
 				  q_msg_size, q_max_msgs)
 
+/**
+ * @brief Statically define and initialize a variable-length message queue.
+ *
+ * Messages are stored back to back in a @a q_size -byte ring buffer, each
+ * behind a 4-byte length header and padded to a multiple of 4 bytes, so
+ * short messages only use the space they need. Messages are aligned to a
+ * 4-byte boundary.
+ *
+ * A variable-length message queue is only accessed through the in-place
+ * APIs: k_msgq_alloc() and k_msgq_commit() to send, k_msgq_peek_claim()
+ * and k_msgq_release() to receive.
+ *
+ * @param q_name Name of the message queue.
+ * @param q_size Size of the ring buffer (in bytes).
+ */
+#define K_MSGQ_VARLEN_DEFINE(q_name, q_size)                       \
+	static char __noinit __aligned(4)                           \
+		_k_fifo_buf_##q_name[ROUND_UP(q_size, 4)];          \
+	struct k_msgq q_name                                        \
+		__in_section(_k_msgq, static, q_name) =             \
+	       _K_MSGQ_VARLEN_INITIALIZER(q_name, _k_fifo_buf_##q_name, \
+					  ROUND_UP(q_size, 4))
+
 /**
  * @brief Initialize a message queue.
  *
@@ -3215,6 +4011,22 @@ struct k_msgq {
 __syscall void k_msgq_init(struct k_msgq *q, char *buffer,
 			   size_t msg_size, u32_t max_msgs);
 
+/**
+ * @brief Initialize a variable-length message queue.
+ *
+ * This routine initializes a message queue object, prior to its first use,
+ * for messages of any length up to the size of the ring buffer. See
+ * K_MSGQ_VARLEN_DEFINE() for the storage layout.
+ *
+ * @param q Address of the message queue.
+ * @param buffer Ring buffer that holds queued messages, aligned to a
+ *               4-byte boundary.
+ * @param size Size of the ring buffer (in bytes).
+ *
+ * @return N/A
+ */
+extern void k_msgq_varlen_init(struct k_msgq *q, char *buffer, size_t size);
+
 /**
  * @brief Send a message to a message queue.
  *
@@ -3230,6 +4042,8 @@ __syscall void k_msgq_init(struct k_msgq *q, char *buffer,
  * @retval 0 Message sent.
  * @retval -ENOMSG Returned without waiting or queue purged.
  * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY A message allocated in place is not committed yet.
+ * @retval -EINVAL The message queue has variable-length messages.
  */
 __syscall int k_msgq_put(struct k_msgq *q, void *data, s32_t timeout);
 
@@ -3249,9 +4063,104 @@ __syscall int k_msgq_put(struct k_msgq *q, void *data, s32_t timeout);
  * @retval 0 Message received.
  * @retval -ENOMSG Returned without waiting.
  * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY The first message is claimed for reading in place.
+ * @retval -EINVAL The message queue has variable-length messages.
  */
 __syscall int k_msgq_get(struct k_msgq *q, void *data, s32_t timeout);
 
+/**
+ * @brief Allocate a message in place in a message queue.
+ *
+ * This routine reserves room for the next message in the ring buffer of
+ * message queue @a q, so the sender can build it directly there instead
+ * of copying it in with k_msgq_put(). The message is not visible to
+ * receivers until k_msgq_commit() is called.
+ *
+ * Only one allocation may be outstanding per message queue, and
+ * k_msgq_put() fails with -EBUSY until it has been committed.
+ *
+ * @note Can be called by ISRs. Not available to user mode threads.
+ *
+ * @param q Address of the message queue.
+ * @param data Set to the start of the message area.
+ * @param size Number of bytes needed. For a fixed-size message queue this
+ *             must not exceed the message size, and the full message size
+ *             is always reserved.
+ *
+ * @retval 0 Message allocated.
+ * @retval -ENOMSG Not enough free space in the message queue.
+ * @retval -EBUSY Another allocation is outstanding.
+ * @retval -EINVAL @a size can never fit in the message queue.
+ */
+extern int k_msgq_alloc(struct k_msgq *q, void **data, size_t size);
+
+/**
+ * @brief Send a message allocated in place.
+ *
+ * This routine makes the message obtained from k_msgq_alloc() visible to
+ * receivers, handing it directly to a waiting thread if there is one.
+ *
+ * For a variable-length message queue @a len is the actual length of the
+ * message, which may be shorter than the allocated size; the unused part
+ * of the allocation is given back. For a fixed-size message queue it is
+ * only checked against the message size. In both cases a length of 0
+ * discards the allocation without sending anything.
+ *
+ * @note Can be called by ISRs. Not available to user mode threads.
+ *
+ * @param q Address of the message queue.
+ * @param len Length of the message (in bytes).
+ *
+ * @retval 0 Message sent or allocation discarded.
+ * @retval -EINVAL No allocation is outstanding or @a len exceeds it.
+ */
+extern int k_msgq_commit(struct k_msgq *q, size_t len);
+
+/**
+ * @brief Read the first message of a message queue in place.
+ *
+ * This routine returns the address of the oldest message in the ring
+ * buffer of message queue @a q without removing it, so the receiver can
+ * process it where it lies instead of copying it out with k_msgq_get().
+ * The message stays claimed until k_msgq_release() is called; in the
+ * meantime k_msgq_get() and other claims fail with -EBUSY. Threads already
+ * waiting for a claim keep waiting, and get the following messages one at a
+ * time as the claims are released. A thread waiting in k_msgq_get() is given
+ * a new message before any waiting claimer.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *       Not available to user mode threads.
+ *
+ * @param q Address of the message queue.
+ * @param data Set to the start of the message.
+ * @param len Set to the length of the message (in bytes).
+ * @param timeout Waiting period to receive the message (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Message claimed.
+ * @retval -ENOMSG Returned without waiting or queue purged.
+ * @retval -EBUSY A message is already claimed.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+extern int k_msgq_peek_claim(struct k_msgq *q, void **data, size_t *len,
+			     s32_t timeout);
+
+/**
+ * @brief Remove a message read in place from a message queue.
+ *
+ * This routine discards the message claimed with k_msgq_peek_claim() and
+ * lets the first thread waiting to send a message (if any) into the freed
+ * space.
+ *
+ * @note Can be called by ISRs. Not available to user mode threads.
+ *
+ * @param q Address of the message queue.
+ *
+ * @retval 0 Message removed.
+ * @retval -EINVAL No message is claimed.
+ */
+extern int k_msgq_release(struct k_msgq *q);
+
 /**
  * @brief Purge a message queue.
  *
@@ -3269,7 +4178,8 @@ __syscall void k_msgq_purge(struct k_msgq *q);
  * @brief Get the amount of free space in a message queue.
  *
  * This routine returns the number of unused entries in a message queue's
- * ring buffer.
+ * ring buffer. A variable-length message queue always reports 0; use
+ * k_msgq_alloc() to find out whether a message fits.
  *
  * @param q Address of the message queue.
  *
@@ -3279,6 +4189,10 @@ __syscall u32_t k_msgq_num_free_get(struct k_msgq *q);
 
 static inline u32_t _impl_k_msgq_num_free_get(struct k_msgq *q)
 {
+	if (!q->msg_size) {
+		return 0;
+	}
+
 	return q->max_msgs - q->used_msgs;
 }
 
@@ -3541,6 +4455,8 @@ struct k_pipe {
 		_wait_q_t      writers; /* Writer wait queue */
 	} wait_q;
 
+	_POLL_EVENT;
+
 	_OBJECT_TRACING_NEXT_PTR(k_pipe);
 };
 
@@ -3553,6 +4469,7 @@ struct k_pipe {
 	.write_index = 0,                                             \
 	.wait_q.writers = SYS_DLIST_STATIC_INIT(&obj.wait_q.writers), \
 	.wait_q.readers = SYS_DLIST_STATIC_INIT(&obj.wait_q.readers), \
+	_POLL_EVENT_OBJ_INIT(obj)                                     \
 	_OBJECT_TRACING_INIT                            \
 	}
 
@@ -3666,6 +4583,70 @@ __syscall int k_pipe_get(struct k_pipe *pipe, void *data,
 extern void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
 			     size_t size, struct k_sem *sem);
 
+/**
+ * @brief Get a window for writing directly into a pipe's ring buffer.
+ *
+ * This routine returns the largest contiguous free area of the ring buffer
+ * of @a pipe, so a producer such as a DMA engine can fill it in place. The
+ * data becomes readable when k_pipe_put_commit() is called. Other writers
+ * must not use the pipe until then.
+ *
+ * @note Not available to user mode threads.
+ *
+ * @param pipe Address of the pipe.
+ * @param data Set to the start of the window.
+ *
+ * @return Size of the window (in bytes), 0 if the ring buffer is full.
+ */
+extern size_t k_pipe_put_window(struct k_pipe *pipe, void **data);
+
+/**
+ * @brief Commit data written through a write window.
+ *
+ * This routine adds @a bytes_written bytes at the start of the window
+ * returned by k_pipe_put_window() to the pipe and passes them on to
+ * readers waiting for data.
+ *
+ * @param pipe Address of the pipe.
+ * @param bytes_written Number of bytes written (at most the window size).
+ *
+ * @retval 0 Data committed.
+ * @retval -EINVAL @a bytes_written exceeds the window.
+ */
+extern int k_pipe_put_commit(struct k_pipe *pipe, size_t bytes_written);
+
+/**
+ * @brief Get a window for reading directly from a pipe's ring buffer.
+ *
+ * This routine returns the largest contiguous area of unread data in the
+ * ring buffer of @a pipe, so a consumer such as a DMA engine can take it
+ * in place. The data stays in the pipe until k_pipe_get_release() is
+ * called. Other readers must not use the pipe until then.
+ *
+ * @note Not available to user mode threads.
+ *
+ * @param pipe Address of the pipe.
+ * @param data Set to the start of the window.
+ *
+ * @return Size of the window (in bytes), 0 if the ring buffer is empty.
+ */
+extern size_t k_pipe_get_window(struct k_pipe *pipe, void **data);
+
+/**
+ * @brief Release data consumed through a read window.
+ *
+ * This routine removes @a bytes_read bytes at the start of the window
+ * returned by k_pipe_get_window() from the pipe and lets writers waiting
+ * for space fill the ring buffer again.
+ *
+ * @param pipe Address of the pipe.
+ * @param bytes_read Number of bytes consumed (at most the window size).
+ *
+ * @retval 0 Data released.
+ * @retval -EINVAL @a bytes_read exceeds the window.
+ */
+extern int k_pipe_get_release(struct k_pipe *pipe, size_t bytes_read);
+
 /**
  * @} end defgroup pipe_apis
  */
@@ -4047,6 +5028,15 @@ extern void *k_calloc(size_t nmemb, size_t size);
 /* private - implementation data created as needed, per-type */
 struct _poller {
 	struct k_thread *thread;
+
+	/* registrations of a struct k_poll_set, which outlive a wait */
+	u8_t persistent;
+
+	/* the thread is blocked in k_poll_set_wait() */
+	u8_t waiting;
+
+	/* an event was signaled while the thread was not waiting */
+	u8_t signaled;
 };
 
 /* private - types bit positions */
@@ -4063,6 +5053,18 @@ enum _poll_types_bits {
 	/* queue/fifo/lifo data availability */
 	_POLL_TYPE_DATA_AVAILABLE,
 
+	/* message queue data availability */
+	_POLL_TYPE_MSGQ_DATA_AVAILABLE,
+
+	/* pipe buffer data availability */
+	_POLL_TYPE_PIPE_DATA_AVAILABLE,
+
+	/* mutex availability */
+	_POLL_TYPE_MUTEX_AVAILABLE,
+
+	/* timer expiry */
+	_POLL_TYPE_TIMER_EXPIRED,
+
 	_POLL_NUM_TYPES
 };
 
@@ -4082,6 +5084,18 @@ enum _poll_states_bits {
 	/* data is available to read on queue/fifo/lifo */
 	_POLL_STATE_DATA_AVAILABLE,
 
+	/* a message is available to read on a message queue */
+	_POLL_STATE_MSGQ_DATA_AVAILABLE,
+
+	/* data is available to read from a pipe's buffer */
+	_POLL_STATE_PIPE_DATA_AVAILABLE,
+
+	/* mutex is unlocked */
+	_POLL_STATE_MUTEX_AVAILABLE,
+
+	/* timer has expired */
+	_POLL_STATE_TIMER_EXPIRED,
+
 	_POLL_NUM_STATES
 };
 
@@ -4112,6 +5126,12 @@ enum _poll_states_bits {
 #define K_POLL_TYPE_SEM_AVAILABLE _POLL_TYPE_BIT(_POLL_TYPE_SEM_AVAILABLE)
 #define K_POLL_TYPE_DATA_AVAILABLE _POLL_TYPE_BIT(_POLL_TYPE_DATA_AVAILABLE)
 #define K_POLL_TYPE_FIFO_DATA_AVAILABLE K_POLL_TYPE_DATA_AVAILABLE
+#define K_POLL_TYPE_MSGQ_DATA_AVAILABLE \
+	_POLL_TYPE_BIT(_POLL_TYPE_MSGQ_DATA_AVAILABLE)
+#define K_POLL_TYPE_PIPE_DATA_AVAILABLE \
+	_POLL_TYPE_BIT(_POLL_TYPE_PIPE_DATA_AVAILABLE)
+#define K_POLL_TYPE_MUTEX_AVAILABLE _POLL_TYPE_BIT(_POLL_TYPE_MUTEX_AVAILABLE)
+#define K_POLL_TYPE_TIMER_EXPIRED _POLL_TYPE_BIT(_POLL_TYPE_TIMER_EXPIRED)
 
 /* public - polling modes */
 enum k_poll_modes {
@@ -4127,6 +5147,13 @@ enum k_poll_modes {
 #define K_POLL_STATE_SEM_AVAILABLE _POLL_STATE_BIT(_POLL_STATE_SEM_AVAILABLE)
 #define K_POLL_STATE_DATA_AVAILABLE _POLL_STATE_BIT(_POLL_STATE_DATA_AVAILABLE)
 #define K_POLL_STATE_FIFO_DATA_AVAILABLE K_POLL_STATE_DATA_AVAILABLE
+#define K_POLL_STATE_MSGQ_DATA_AVAILABLE \
+	_POLL_STATE_BIT(_POLL_STATE_MSGQ_DATA_AVAILABLE)
+#define K_POLL_STATE_PIPE_DATA_AVAILABLE \
+	_POLL_STATE_BIT(_POLL_STATE_PIPE_DATA_AVAILABLE)
+#define K_POLL_STATE_MUTEX_AVAILABLE \
+	_POLL_STATE_BIT(_POLL_STATE_MUTEX_AVAILABLE)
+#define K_POLL_STATE_TIMER_EXPIRED _POLL_STATE_BIT(_POLL_STATE_TIMER_EXPIRED)
 
 /* public - poll signal object */
 struct k_poll_signal {
@@ -4179,9 +5206,22 @@ struct k_poll_event {
 		struct k_sem *sem;
 		struct k_fifo *fifo;
 		struct k_queue *queue;
+		struct k_msgq *msgq;
+		struct k_pipe *pipe;
+		struct k_mutex *mutex;
+		struct k_timer *timer;
 	};
 };
 
+/* public - set of persistently registered poll events */
+struct k_poll_set {
+	/* PRIVATE - DO NOT TOUCH */
+	struct _poller poller;
+
+	struct k_poll_event *events;
+	int num_events;
+};
+
 #define K_POLL_EVENT_INITIALIZER(event_type, event_mode, event_obj) \
 	{ \
 	.poller = NULL, \
@@ -4293,6 +5333,61 @@ extern void k_poll_signal_init(struct k_poll_signal *signal);
 
 extern int k_poll_signal(struct k_poll_signal *signal, int result);
 
+/**
+ * @brief Register poll events once, for repeated waits
+ *
+ * k_poll() registers its events with their objects on every call, and
+ * removes them before returning. For a thread that keeps waiting on the same
+ * events, such as an event loop, this routine registers them once, to be
+ * waited on with k_poll_set_wait() until k_poll_set_cleanup() is called.
+ * Only the calling thread may wait on the set.
+ *
+ * The events are edge triggered: an event's state is set when its object
+ * signals it, and stays set until the user resets it to
+ * K_POLL_STATE_NOT_READY. Objects only signal when they become available,
+ * so everything available should be consumed before waiting again. Events
+ * whose object is already available are marked ready here.
+ *
+ * While a set is registered, the objects it polls signal the set first:
+ * they should not be polled by other threads at the same time.
+ *
+ * @param set The poll set.
+ * @param events An array of events, initialized with k_poll_event_init().
+ *               It must stay valid until k_poll_set_cleanup().
+ * @param num_events The number of events in the array.
+ *
+ * @return N/A
+ */
+extern void k_poll_set_init(struct k_poll_set *set,
+			    struct k_poll_event *events, int num_events);
+
+/**
+ * @brief Wait for an event of a poll set
+ *
+ * Returns as soon as one of the events of @a set was signaled since the
+ * previous call. The caller should then loop on the events and check their
+ * state field, resetting those it handled.
+ *
+ * @param set The poll set.
+ * @param timeout Waiting period for an event to be signaled (in
+ *                milliseconds), or one of the special values K_NO_WAIT
+ *                and K_FOREVER.
+ *
+ * @retval 0 One or more events were signaled.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EINTR Poller thread has been interrupted.
+ */
+extern int k_poll_set_wait(struct k_poll_set *set, s32_t timeout);
+
+/**
+ * @brief Remove the registrations of a poll set
+ *
+ * @param set The poll set.
+ *
+ * @return N/A
+ */
+extern void k_poll_set_cleanup(struct k_poll_set *set);
+
 /* private internal function */
 extern int _handle_obj_poll_events(sys_dlist_t *events, u32_t state);
 
@@ -0,0 +1,265 @@
+/* lf_ring.h: Lock-free element ring buffer API */
+
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/** @file */
+
+#ifndef __LF_RING_H__
+#define __LF_RING_H__
+
+#include <kernel.h>
+#include <atomic.h>
+#include <misc/util.h>
+#include <errno.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup lf_ring_apis Lock-free Ring Buffer APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/** Ring buffer accepts concurrent producers (threads and/or ISRs). */
+#define SYS_LF_RING_MULTI_PRODUCER BIT(0)
+
+/**
+ * @brief A lock-free ring of fixed size elements.
+ *
+ * Indices are free-running 32-bit counters; the element count must be a
+ * power of two so that they can be reduced with a mask. The ring supports
+ * a single consumer and either a single producer or, if created with
+ * @ref SYS_LF_RING_MULTI_PRODUCER, any number of concurrent producers.
+ * None of the operations disable interrupts or take a lock, so they may
+ * be used from ISRs.
+ */
+struct sys_lf_ring {
+	atomic_t head;	  /**< Index of the next element to consume */
+	atomic_t tail;	  /**< Index past the last published element */
+	atomic_t reserve; /**< Index past the last reserved element */
+	atomic_t pending; /**< Producers currently inside the ring */
+	u32_t mask;	  /**< Element count minus one */
+	u16_t elem_size;  /**< Size of one element in bytes */
+	u8_t flags;	  /**< SYS_LF_RING_* flags */
+	u8_t *buf;	  /**< Element storage */
+};
+
+/**
+ * @brief Statically define and initialize a lock-free ring buffer.
+ *
+ * The ring buffer can be accessed outside the module where it is defined
+ * using:
+ *
+ * @code extern struct sys_lf_ring <name>; @endcode
+ *
+ * @param name Name of the ring buffer.
+ * @param elem Size of one element in bytes (1 for a byte ring).
+ * @param count Number of elements, must be a power of 2.
+ * @param ring_flags SYS_LF_RING_* flags.
+ */
+#define SYS_LF_RING_DEFINE(name, elem, count, ring_flags) \
+	BUILD_ASSERT_MSG(((count) & ((count) - 1)) == 0, \
+			 "lf_ring element count must be a power of 2"); \
+	static u8_t __aligned(4) _lf_ring_data_##name[(elem) * (count)]; \
+	struct sys_lf_ring name = { \
+		.mask = (count) - 1, \
+		.elem_size = (elem), \
+		.flags = (ring_flags), \
+		.buf = _lf_ring_data_##name \
+	}
+
+/**
+ * @brief Initialize a lock-free ring buffer.
+ *
+ * This routine initializes a ring buffer prior to its first use. It is
+ * only used for ring buffers not defined using SYS_LF_RING_DEFINE.
+ *
+ * @param ring Address of ring buffer.
+ * @param data Element storage, at least @a elem_size * @a count bytes.
+ * @param elem_size Size of one element in bytes.
+ * @param count Number of elements, must be a power of 2.
+ * @param flags SYS_LF_RING_* flags.
+ *
+ * @retval 0 Ring buffer was initialized.
+ * @retval -EINVAL @a count is not a power of 2 or @a elem_size is 0.
+ */
+static inline int sys_lf_ring_init(struct sys_lf_ring *ring, void *data,
+				   u16_t elem_size, u32_t count, u8_t flags)
+{
+	if (!elem_size || !count || !is_power_of_two(count)) {
+		return -EINVAL;
+	}
+
+	atomic_set(&ring->head, 0);
+	atomic_set(&ring->tail, 0);
+	atomic_set(&ring->reserve, 0);
+	atomic_set(&ring->pending, 0);
+	ring->mask = count - 1;
+	ring->elem_size = elem_size;
+	ring->flags = flags;
+	ring->buf = data;
+
+	return 0;
+}
+
+/**
+ * @brief Get the capacity of a ring buffer.
+ *
+ * @param ring Address of ring buffer.
+ *
+ * @return Number of elements the ring buffer can hold.
+ */
+static inline u32_t sys_lf_ring_capacity(struct sys_lf_ring *ring)
+{
+	return ring->mask + 1;
+}
+
+/**
+ * @brief Get the number of elements available to the consumer.
+ *
+ * @param ring Address of ring buffer.
+ *
+ * @return Number of published elements not yet consumed.
+ */
+static inline u32_t sys_lf_ring_used_get(struct sys_lf_ring *ring)
+{
+	return (u32_t)atomic_get(&ring->tail) - (u32_t)atomic_get(&ring->head);
+}
+
+/**
+ * @brief Get the number of elements available to producers.
+ *
+ * The value is only a snapshot when other contexts use the ring
+ * buffer concurrently.
+ *
+ * @param ring Address of ring buffer.
+ *
+ * @return Number of free elements.
+ */
+static inline u32_t sys_lf_ring_space_get(struct sys_lf_ring *ring)
+{
+	atomic_t *end = (ring->flags & SYS_LF_RING_MULTI_PRODUCER) ?
+			&ring->reserve : &ring->tail;
+
+	return sys_lf_ring_capacity(ring) -
+	       ((u32_t)atomic_get(end) - (u32_t)atomic_get(&ring->head));
+}
+
+/**
+ * @brief Determine if a ring buffer has nothing to consume.
+ *
+ * @param ring Address of ring buffer.
+ *
+ * @return 1 if the ring buffer is empty, or 0 if not.
+ */
+static inline int sys_lf_ring_is_empty(struct sys_lf_ring *ring)
+{
+	return atomic_get(&ring->tail) == atomic_get(&ring->head);
+}
+
+/**
+ * @brief Write elements to a ring buffer.
+ *
+ * As many elements as fit are copied; the call never blocks. In
+ * multi-producer mode the elements of one call are stored contiguously
+ * and become visible to the consumer once no other producer is in the
+ * middle of a write.
+ *
+ * @param ring Address of ring buffer.
+ * @param data Elements to write.
+ * @param count Number of elements in @a data.
+ *
+ * @return Number of elements written.
+ */
+u32_t sys_lf_ring_put(struct sys_lf_ring *ring, const void *data,
+		      u32_t count);
+
+/**
+ * @brief Read elements from a ring buffer.
+ *
+ * Only one context may consume from a ring buffer at a time.
+ *
+ * @param ring Address of ring buffer.
+ * @param data Area to store the elements.
+ * @param count Maximum number of elements to read.
+ *
+ * @return Number of elements read.
+ */
+u32_t sys_lf_ring_get(struct sys_lf_ring *ring, void *data, u32_t count);
+
+/**
+ * @brief Claim contiguous space in a ring buffer for writing in place.
+ *
+ * The returned span never wraps around the end of the storage, so it may
+ * be shorter than the free space. The caller fills the span and then calls
+ * sys_lf_ring_put_finish().
+ *
+ * In single-producer mode the claim does not modify the ring buffer and
+ * the caller may commit fewer elements than it claimed. In multi-producer
+ * mode the span is reserved, all of it must be committed, and elements
+ * written by other producers are not visible to the consumer until the
+ * claim is finished.
+ *
+ * @param ring Address of ring buffer.
+ * @param data Set to the start of the claimed span.
+ * @param count Maximum number of elements to claim.
+ *
+ * @return Number of elements claimed, 0 if the ring buffer is full.
+ */
+u32_t sys_lf_ring_put_claim(struct sys_lf_ring *ring, void **data,
+			    u32_t count);
+
+/**
+ * @brief Commit elements written in place to a ring buffer.
+ *
+ * In multi-producer mode the whole claimed span is committed, so @a count
+ * must be the number of elements claimed. Finishing a claim that returned
+ * 0 with a @a count of 0 does nothing.
+ *
+ * @param ring Address of ring buffer.
+ * @param count Number of elements to commit, at most the number claimed.
+ *
+ * @retval 0 Elements were committed.
+ * @retval -EINVAL @a count exceeds the free space.
+ */
+int sys_lf_ring_put_finish(struct sys_lf_ring *ring, u32_t count);
+
+/**
+ * @brief Claim contiguous elements in a ring buffer for reading in place.
+ *
+ * The returned span never wraps around the end of the storage. The
+ * elements stay in the ring buffer until sys_lf_ring_get_finish() is
+ * called.
+ *
+ * @param ring Address of ring buffer.
+ * @param data Set to the start of the claimed span.
+ * @param count Maximum number of elements to claim.
+ *
+ * @return Number of elements claimed, 0 if the ring buffer is empty.
+ */
+u32_t sys_lf_ring_get_claim(struct sys_lf_ring *ring, void **data,
+			    u32_t count);
+
+/**
+ * @brief Release elements consumed in place from a ring buffer.
+ *
+ * @param ring Address of ring buffer.
+ * @param count Number of elements to release.
+ *
+ * @retval 0 Elements were released.
+ * @retval -EINVAL @a count exceeds the number of available elements.
+ */
+int sys_lf_ring_get_finish(struct sys_lf_ring *ring, u32_t count);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LF_RING_H__ */
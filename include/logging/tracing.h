@@ -0,0 +1,128 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Binary tracing support.
+ *
+ * Trace points record fixed size, timestamped binary records into one
+ * buffer per execution context: one for threads and one for interrupts.
+ * Records are either read back with sys_trace_get(), or streamed by a
+ * backend, such as the native_posix one which writes a CTF trace to a
+ * host directory.
+ */
+
+#ifndef __TRACING_H__
+#define __TRACING_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef _ASMLANGUAGE
+
+#include <zephyr/types.h>
+
+/** Trace event identifiers */
+enum sys_trace_id {
+	SYS_TRACE_THREAD_SWITCHED_IN,
+	SYS_TRACE_ISR_ENTER,
+	SYS_TRACE_ISR_EXIT,
+	SYS_TRACE_SEM_GIVE,
+	SYS_TRACE_SEM_TAKE,
+	SYS_TRACE_MUTEX_LOCK,
+	SYS_TRACE_MUTEX_UNLOCK,
+	SYS_TRACE_QUEUE_PUT,
+	SYS_TRACE_QUEUE_GET,
+	SYS_TRACE_NET_RECV,
+	SYS_TRACE_NET_SEND,
+	SYS_TRACE_BT_RECV,
+	SYS_TRACE_BT_SEND,
+
+	SYS_TRACE_ID_COUNT
+};
+
+/** Trace buffers, one per execution context */
+enum sys_trace_context {
+	SYS_TRACE_CONTEXT_THREAD,
+	SYS_TRACE_CONTEXT_ISR,
+
+	SYS_TRACE_CONTEXT_COUNT
+};
+
+/**
+ * @brief A trace record.
+ *
+ * @a arg is usually the address of the object the event applies to, and
+ * @a extra an event specific value: the IRQ line for ISR events, the
+ * buffer length for network and Bluetooth events.
+ */
+struct sys_trace_record {
+	/** Hardware cycle count */
+	u32_t timestamp;
+	/** Event, one of enum sys_trace_id */
+	u16_t id;
+	/** Event specific value */
+	u16_t extra;
+	/** Event argument */
+	u32_t arg;
+};
+
+#ifdef CONFIG_TRACING
+/**
+ * @brief Record a trace event.
+ *
+ * The record goes to the buffer of the current execution context. It is
+ * dropped and counted if that buffer is full.
+ *
+ * @param id Event identifier.
+ * @param extra Event specific value.
+ * @param arg Event argument.
+ */
+extern void sys_trace_event(u16_t id, u16_t extra, u32_t arg);
+
+/**
+ * @brief Read trace records.
+ *
+ * Records of each context are returned in the order they were recorded.
+ * There must be a single reader; when a backend is enabled, that is the
+ * backend.
+ *
+ * @param context Buffer to read from, one of enum sys_trace_context.
+ * @param records Array receiving the records.
+ * @param count Maximum number of records to read.
+ *
+ * @return Number of records read.
+ */
+extern u32_t sys_trace_get(int context, struct sys_trace_record *records,
+			   u32_t count);
+
+/**
+ * @brief Get the number of records dropped because a buffer was full.
+ *
+ * @return Number of dropped records since boot.
+ */
+extern u32_t sys_trace_dropped_get(void);
+
+/**
+ * @brief Hand all buffered records to the backend.
+ *
+ * The backend thread does this periodically. Call this before inspecting
+ * a trace to make sure it is complete.
+ */
+extern void sys_trace_flush(void);
+
+#define SYS_TRACE(id, extra, arg) \
+	sys_trace_event(id, extra, (u32_t)(uintptr_t)(arg))
+#else
+#define SYS_TRACE(id, extra, arg) do { } while ((0))
+#endif /* CONFIG_TRACING */
+
+#endif /* _ASMLANGUAGE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TRACING_H__ */
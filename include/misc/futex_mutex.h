@@ -0,0 +1,113 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Mutex on a futex
+ *
+ * A lock whose state is a single atomic variable, taken and released with
+ * one atomic operation when there is no contention. The kernel is only
+ * entered to wait for the lock, or to wake a waiter when releasing it.
+ * Placed in memory a user thread can write, the uncontended paths take no
+ * system call.
+ *
+ * Unlike k_mutex, the lock is not recursive, has no owner and does not
+ * boost the priority of the thread holding it.
+ */
+
+#ifndef _FUTEX_MUTEX__H_
+#define _FUTEX_MUTEX__H_
+
+#include <kernel.h>
+#include <atomic.h>
+#include <errno.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* lock states */
+#define _FUTEX_MUTEX_UNLOCKED 0
+#define _FUTEX_MUTEX_LOCKED 1
+#define _FUTEX_MUTEX_CONTENDED 2
+
+struct sys_futex_mutex {
+	atomic_t val;
+};
+
+/**
+ * @brief Statically define and initialize a futex mutex.
+ *
+ * @param name Name of the mutex.
+ */
+#define SYS_FUTEX_MUTEX_DEFINE(name) \
+	struct sys_futex_mutex name = { .val = _FUTEX_MUTEX_UNLOCKED }
+
+/**
+ * @brief Initialize a futex mutex.
+ *
+ * @param mutex Address of the mutex.
+ */
+static inline void sys_futex_mutex_init(struct sys_futex_mutex *mutex)
+{
+	atomic_set(&mutex->val, _FUTEX_MUTEX_UNLOCKED);
+}
+
+/**
+ * @brief Lock a futex mutex.
+ *
+ * @param mutex Address of the mutex.
+ * @param timeout Waiting period to lock the mutex (in milliseconds), or one
+ *                of the special values K_NO_WAIT and K_FOREVER. Each wakeup
+ *                that does not get the mutex restarts the period.
+ *
+ * @retval 0 Mutex locked.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+static inline int sys_futex_mutex_lock(struct sys_futex_mutex *mutex,
+				       s32_t timeout)
+{
+	if (likely(atomic_cas(&mutex->val, _FUTEX_MUTEX_UNLOCKED,
+			      _FUTEX_MUTEX_LOCKED))) {
+		return 0;
+	}
+
+	if (timeout == K_NO_WAIT) {
+		return -EBUSY;
+	}
+
+	/*
+	 * Once marked contended, the mutex is only locked by swapping that
+	 * mark in, as other threads may be waiting behind this one.
+	 */
+	while (atomic_set(&mutex->val, _FUTEX_MUTEX_CONTENDED) !=
+	       _FUTEX_MUTEX_UNLOCKED) {
+		if (k_futex_wait(&mutex->val, _FUTEX_MUTEX_CONTENDED,
+				 timeout) == -ETIMEDOUT) {
+			return -EAGAIN;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Unlock a futex mutex.
+ *
+ * @param mutex Address of the mutex.
+ */
+static inline void sys_futex_mutex_unlock(struct sys_futex_mutex *mutex)
+{
+	if (atomic_set(&mutex->val, _FUTEX_MUTEX_UNLOCKED) ==
+	    _FUTEX_MUTEX_CONTENDED) {
+		k_futex_wake(&mutex->val, 0);
+	}
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FUTEX_MUTEX__H_ */
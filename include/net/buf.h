@@ -393,6 +393,13 @@ static inline void net_buf_simple_restore(struct net_buf_simple *buf,
   */
 #define NET_BUF_FRAGS        BIT(0)
 
+/** Flag indicating that the buffer data is not stored in the buffer pool
+  * but in memory owned by someone else, see net_buf_alloc_with_data().
+  * Such buffers have no headroom nor tailroom and their data must be
+  * treated as read-only.
+  */
+#define NET_BUF_EXTERNAL_DATA BIT(1)
+
 /** @brief Network buffer representation.
   *
   * This struct is used to represent network buffers. Such buffers are
@@ -589,6 +596,30 @@ struct net_buf *net_buf_alloc_debug(struct net_buf_pool *pool, s32_t timeout,
 struct net_buf *net_buf_alloc(struct net_buf_pool *pool, s32_t timeout);
 #endif
 
+/**
+ *  @brief Allocate a new buffer referring to external data.
+ *
+ *  Allocate a buffer from a pool and point it to data which is owned by
+ *  the caller instead of the data storage of the pool, so the pool should
+ *  be defined with a zero data size. The buffer is full, i.e. its length
+ *  is the size of the external data. The caller must keep the data valid
+ *  until the buffer is freed, which can be tracked with a destroy
+ *  callback of the pool.
+ *
+ *  @param pool Which pool to allocate the buffer from.
+ *  @param data External data the buffer refers to.
+ *  @param size Size of the external data.
+ *  @param timeout Affects the action taken should the pool be empty.
+ *         If K_NO_WAIT, then return immediately. If K_FOREVER, then
+ *         wait as long as necessary. Otherwise, wait up to the specified
+ *         number of milliseconds before timing out.
+ *
+ *  @return New buffer or NULL if out of buffers.
+ */
+struct net_buf *net_buf_alloc_with_data(struct net_buf_pool *pool,
+					void *data, u16_t size,
+					s32_t timeout);
+
 /**
  *  @brief Get a buffer from a FIFO.
  *
@@ -961,7 +992,6 @@ static inline void *net_buf_user_data(struct net_buf *buf)
 #define net_buf_pull_be32(buf) net_buf_simple_pull_be32(&(buf)->b)
 
 /**
- *  @def net_buf_tailroom
  *  @brief Check buffer tailroom.
  *
  *  Check how much free space there is at the end of the buffer.
@@ -970,19 +1000,32 @@ static inline void *net_buf_user_data(struct net_buf *buf)
  *
  *  @return Number of bytes available at the end of the buffer.
  */
-#define net_buf_tailroom(buf) net_buf_simple_tailroom(&(buf)->b)
+static inline size_t net_buf_tailroom(struct net_buf *buf)
+{
+	if (buf->flags & NET_BUF_EXTERNAL_DATA) {
+		return 0;
+	}
+
+	return net_buf_simple_tailroom(&buf->b);
+}
 
 /**
- *  @def net_buf_headroom
  *  @brief Check buffer headroom.
  *
  *  Check how much free space there is in the beginning of the buffer.
  *
- *  buf A valid pointer on a buffer
+ *  @param buf A valid pointer on a buffer
  *
  *  @return Number of bytes available in the beginning of the buffer.
  */
-#define net_buf_headroom(buf) net_buf_simple_headroom(&(buf)->b)
+static inline size_t net_buf_headroom(struct net_buf *buf)
+{
+	if (buf->flags & NET_BUF_EXTERNAL_DATA) {
+		return 0;
+	}
+
+	return net_buf_simple_headroom(&buf->b);
+}
 
 /**
  *  @def net_buf_tail
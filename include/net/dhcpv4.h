@@ -24,6 +24,7 @@ extern "C" {
 
 #include <misc/slist.h>
 #include <zephyr/types.h>
+#include <net/net_ip.h>
 
 /** Current state of DHCPv4 client address negotiation.
  *
@@ -35,11 +36,56 @@ enum net_dhcpv4_state {
 	NET_DHCPV4_INIT,
 	NET_DHCPV4_SELECTING,
 	NET_DHCPV4_REQUESTING,
+	NET_DHCPV4_REBOOTING,
 	NET_DHCPV4_RENEWING,
 	NET_DHCPV4_REBINDING,
 	NET_DHCPV4_BOUND,
 };
 
+/** DHCPv4 lease kept over reboots and restarts of the client. */
+struct net_dhcpv4_lease {
+	/** Leased IPv4 address */
+	struct in_addr addr;
+
+	/** Server which granted the lease */
+	struct in_addr server_id;
+
+	/** Remaining lease time in seconds */
+	u32_t lease_time;
+};
+
+/** Persistent storage of DHCPv4 leases.
+ *
+ * When a lease is found at start, the client confirms it with a single
+ * REQUEST (RFC2131 INIT-REBOOT state) instead of running a full
+ * DISCOVER / OFFER / REQUEST / ACK exchange.
+ */
+struct net_dhcpv4_lease_storage {
+	/** Load the lease of an interface. Return 0 if a lease was
+	 *  found, a negative errno otherwise.
+	 */
+	int (*load)(struct net_if *iface, struct net_dhcpv4_lease *lease);
+
+	/** Store the lease of an interface. This is called each time
+	 *  a lease is obtained or renewed, and with a NULL lease when
+	 *  the server refuses the stored one.
+	 */
+	int (*store)(struct net_if *iface,
+		     const struct net_dhcpv4_lease *lease);
+};
+
+/**
+ *  @brief Set the DHCPv4 lease storage
+ *
+ *  @details Lease storage is used by all interfaces. Leases which were
+ *  obtained before the client was stopped on an interface are reused
+ *  even without a storage.
+ *
+ *  @param storage Lease storage callbacks, or NULL to disable storage.
+ */
+void net_dhcpv4_set_lease_storage(
+	const struct net_dhcpv4_lease_storage *storage);
+
 /**
  *  @brief Start DHCPv4 client on an iface
  *
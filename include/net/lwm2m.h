@@ -198,6 +198,16 @@ bool  lwm2m_engine_get_bool(char *path);
 int   lwm2m_engine_get_float32(char *pathstr, float32_value_t *buf);
 int   lwm2m_engine_get_float64(char *pathstr, float64_value_t *buf);
 
+/*
+ * Numeric path variants of the setters / getters above: they skip path
+ * string parsing and look the resource up in the engine path index.
+ * value / buf must point to data of the resource's type.
+ */
+int lwm2m_engine_set_res(u16_t obj_id, u16_t obj_inst_id, u16_t res_id,
+			 void *value, u16_t len);
+int lwm2m_engine_get_res(u16_t obj_id, u16_t obj_inst_id, u16_t res_id,
+			 void *buf, u16_t buflen);
+
 int lwm2m_engine_register_read_callback(char *path,
 					lwm2m_engine_get_data_cb_t cb);
 int lwm2m_engine_register_pre_write_callback(char *path,
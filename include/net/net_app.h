@@ -37,6 +37,12 @@
 #include <mbedtls/ssl.h>
 #include <mbedtls/error.h>
 #include <mbedtls/debug.h>
+#if defined(MBEDTLS_SSL_CACHE_C)
+#include <mbedtls/ssl_cache.h>
+#endif
+#if defined(MBEDTLS_SSL_TICKET_C)
+#include <mbedtls/ssl_ticket.h>
+#endif
 #endif /* CONFIG_MBEDTLS */
 #endif /* CONFIG_NET_APP_TLS || CONFIG_NET_APP_DTLS */
 
@@ -385,6 +391,16 @@ struct net_app_ctx {
 #endif
 			u8_t *personalization_data;
 			size_t personalization_data_len;
+#if defined(CONFIG_NET_APP_TLS_SESSION_RESUMPTION)
+#if defined(CONFIG_NET_APP_SERVER) && defined(MBEDTLS_SSL_CACHE_C)
+			/** Session ID cache of the server */
+			mbedtls_ssl_cache_context cache;
+#endif
+#if defined(CONFIG_NET_APP_SERVER) && defined(MBEDTLS_SSL_TICKET_C)
+			/** Session ticket keys of the server */
+			mbedtls_ssl_ticket_context ticket;
+#endif
+#endif /* CONFIG_NET_APP_TLS_SESSION_RESUMPTION */
 		} mbedtls;
 
 		/** Have we called connect cb yet? */
@@ -403,6 +419,9 @@ struct net_app_ctx {
 
 		/** Is the connection closing */
 		u8_t connection_closing : 1;
+
+		/** Was a cached session offered in the current handshake */
+		u8_t session_offered : 1;
 	} tls;
 #endif /* CONFIG_NET_APP_TLS || CONFIG_NET_APP_DTLS */
 
@@ -292,6 +292,9 @@ struct net_if {
 		/** Requested IP addr */
 		struct in_addr requested_ip;
 
+		/** Uptime (in ms) when the lease was obtained */
+		s64_t timestamp;
+
 		/** Timer for DHCPv4 Client requests (DISCOVER,
 		 * REQUEST or RENEWAL)
 		 */
@@ -955,6 +955,47 @@ bool net_pkt_compact(struct net_pkt *pkt);
 u16_t net_pkt_append(struct net_pkt *pkt, u16_t len, const u8_t *data,
 		     s32_t timeout);
 
+/**
+ * @typedef net_pkt_ext_free_cb_t
+ * @brief Callback telling that the stack does not refer to external data
+ *        any more.
+ *
+ * @param data External data given to net_pkt_append_ext().
+ * @param user_data User data given to net_pkt_append_ext().
+ */
+typedef void (*net_pkt_ext_free_cb_t)(const u8_t *data, void *user_data);
+
+/**
+ * @brief Append external data to a packet without copying it
+ *
+ * @details Add a fragment which refers to the given data instead of
+ * copying it into the data pool. The data must not be modified nor
+ * released before the callback is called, which happens when the last
+ * reference to the fragment is dropped, typically after the packet has
+ * been sent (or acknowledged for TCP). The callback is called from the
+ * context releasing the packet, e.g. from the TX thread or from the
+ * driver. The external data can be in read-only memory.
+ *
+ * Requires CONFIG_NET_BUF_EXT_COUNT > 0.
+ *
+ * @param pkt Network packet.
+ * @param len Length of the data.
+ * @param data Data to be added.
+ * @param cb Callback to call when the data is not used any more, or NULL.
+ * @param user_data User data given to the callback.
+ * @param timeout Affects the action taken should there be no free external
+ *        fragments. If K_NO_WAIT, then return immediately. If K_FOREVER,
+ *        then wait as long as necessary. Otherwise, wait up to the
+ *        specified number of milliseconds before timing out.
+ *
+ * @return Length of data actually added. This may be less than input
+ *         length if the packet cannot carry more data because of MTU or
+ *         MSS. If nothing was added the callback will not be called.
+ */
+u16_t net_pkt_append_ext(struct net_pkt *pkt, u16_t len, const u8_t *data,
+			 net_pkt_ext_free_cb_t cb, void *user_data,
+			 s32_t timeout);
+
 /**
  * @brief Append all data to fragment list of a packet (or fail)
  *
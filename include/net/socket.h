@@ -40,6 +40,21 @@ struct zsock_pollfd {
 #define ZSOCK_POLLIN 1
 #define ZSOCK_POLLOUT 4
 
+struct zsock_iovec {
+	void *iov_base;
+	size_t iov_len;
+};
+
+struct zsock_msghdr {
+	void *msg_name;
+	socklen_t msg_namelen;
+	struct zsock_iovec *msg_iov;
+	size_t msg_iovlen;
+	void *msg_control;
+	size_t msg_controllen;
+	int msg_flags;
+};
+
 struct zsock_addrinfo {
 	struct zsock_addrinfo *ai_next;
 	int ai_flags;
@@ -64,6 +79,7 @@ ssize_t zsock_send(int sock, const void *buf, size_t len, int flags);
 ssize_t zsock_recv(int sock, void *buf, size_t max_len, int flags);
 ssize_t zsock_sendto(int sock, const void *buf, size_t len, int flags,
 		     const struct sockaddr *dest_addr, socklen_t addrlen);
+ssize_t zsock_sendmsg(int sock, const struct zsock_msghdr *msg, int flags);
 ssize_t zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
 		       struct sockaddr *src_addr, socklen_t *addrlen);
 int zsock_fcntl(int sock, int cmd, int flags);
@@ -84,6 +100,9 @@ int zsock_getaddrinfo(const char *host, const char *service,
 #define recv zsock_recv
 #define fcntl zsock_fcntl
 #define sendto zsock_sendto
+#define sendmsg zsock_sendmsg
+#define iovec zsock_iovec
+#define msghdr zsock_msghdr
 #define recvfrom zsock_recvfrom
 
 #define poll zsock_poll
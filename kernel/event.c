@@ -0,0 +1,235 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ *
+ * @brief Kernel event object.
+ *
+ * An event object is a group of 32 flags. A waiting thread describes what
+ * it waits for in a descriptor pointed to by its swap_data: setting flags
+ * walks the whole wait queue, since each waiter may want different ones,
+ * and records in the descriptor of every waiter it wakes the flags that
+ * satisfied it.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <debug/object_tracing_common.h>
+#include <toolchain.h>
+#include <linker/sections.h>
+#include <wait_q.h>
+#include <misc/dlist.h>
+#include <ksched.h>
+#include <init.h>
+#include <syscall_handler.h>
+
+extern struct k_event _k_event_list_start[];
+extern struct k_event _k_event_list_end[];
+
+struct event_waiter {
+	u32_t events;
+	unsigned int options;
+	u32_t matched;
+};
+
+#ifdef CONFIG_OBJECT_TRACING
+
+struct k_event *_trace_list_k_event;
+
+/*
+ * Complete initialization of statically defined event objects.
+ */
+static int init_event_module(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	struct k_event *event;
+
+	for (event = _k_event_list_start; event < _k_event_list_end;
+	     event++) {
+		SYS_TRACING_OBJ_INIT(k_event, event);
+	}
+	return 0;
+}
+
+SYS_INIT(init_event_module, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+
+#endif /* CONFIG_OBJECT_TRACING */
+
+void _impl_k_event_init(struct k_event *event)
+{
+	sys_dlist_init(&event->wait_q);
+	event->events = 0;
+
+	SYS_TRACING_OBJ_INIT(k_event, event);
+
+	_k_object_init(event);
+}
+
+#ifdef CONFIG_USERSPACE
+_SYSCALL_HANDLER(k_event_init, event)
+{
+	_SYSCALL_OBJ_INIT(event, K_OBJ_EVENT);
+	_impl_k_event_init((struct k_event *)event);
+
+	return 0;
+}
+#endif
+
+/* returns the events satisfying a wait, 0 if it is not satisfied */
+static inline u32_t events_match(u32_t current, u32_t events,
+				 unsigned int options)
+{
+	u32_t matched = current & events;
+
+	if ((options & K_EVENT_WAIT_ALL) && matched != events) {
+		return 0;
+	}
+
+	return matched;
+}
+
+/* keeps the events in @a keep and adds @a events, then wakes the waiters */
+static void event_update(struct k_event *event, u32_t keep, u32_t events)
+{
+	struct k_thread *thread, *next;
+	struct event_waiter *waiter;
+	unsigned int key;
+	int woken = 0;
+
+	key = irq_lock();
+
+	event->events = (event->events & keep) | events;
+
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&event->wait_q, thread, next,
+					  base.k_q_node) {
+		if (_is_thread_timeout_expired(thread)) {
+			continue;
+		}
+
+		waiter = thread->base.swap_data;
+		waiter->matched = events_match(event->events, waiter->events,
+					       waiter->options);
+		if (!waiter->matched) {
+			continue;
+		}
+
+		if (waiter->options & K_EVENT_WAIT_CLEAR) {
+			event->events &= ~waiter->matched;
+		}
+
+		_unpend_thread(thread);
+		(void)_abort_thread_timeout(thread);
+		_ready_thread(thread);
+		_set_thread_return_value(thread, 0);
+		woken = 1;
+	}
+
+	if (woken && !_is_in_isr()) {
+		_reschedule_threads(key);
+	} else {
+		irq_unlock(key);
+	}
+}
+
+void _impl_k_event_post(struct k_event *event, u32_t events)
+{
+	event_update(event, ~0, events);
+}
+
+#ifdef CONFIG_USERSPACE
+_SYSCALL_HANDLER(k_event_post, event, events)
+{
+	_SYSCALL_OBJ(event, K_OBJ_EVENT);
+	_impl_k_event_post((struct k_event *)event, events);
+
+	return 0;
+}
+#endif
+
+void _impl_k_event_set(struct k_event *event, u32_t events)
+{
+	event_update(event, 0, events);
+}
+
+#ifdef CONFIG_USERSPACE
+_SYSCALL_HANDLER(k_event_set, event, events)
+{
+	_SYSCALL_OBJ(event, K_OBJ_EVENT);
+	_impl_k_event_set((struct k_event *)event, events);
+
+	return 0;
+}
+#endif
+
+void _impl_k_event_clear(struct k_event *event, u32_t events)
+{
+	unsigned int key = irq_lock();
+
+	event->events &= ~events;
+
+	irq_unlock(key);
+}
+
+#ifdef CONFIG_USERSPACE
+_SYSCALL_HANDLER(k_event_clear, event, events)
+{
+	_SYSCALL_OBJ(event, K_OBJ_EVENT);
+	_impl_k_event_clear((struct k_event *)event, events);
+
+	return 0;
+}
+#endif
+
+u32_t _impl_k_event_wait(struct k_event *event, u32_t events,
+			 unsigned int options, s32_t timeout)
+{
+	__ASSERT(!_is_in_isr() || timeout == K_NO_WAIT, "");
+	__ASSERT(events != 0, "no events to wait for\n");
+
+	struct event_waiter waiter = {
+		.events = events,
+		.options = options,
+		.matched = 0,
+	};
+	unsigned int key = irq_lock();
+	u32_t matched;
+
+	matched = events_match(event->events, events, options);
+	if (matched) {
+		if (options & K_EVENT_WAIT_CLEAR) {
+			event->events &= ~matched;
+		}
+		irq_unlock(key);
+		return matched;
+	}
+
+	if (timeout == K_NO_WAIT) {
+		irq_unlock(key);
+		return 0;
+	}
+
+	_current->base.swap_data = &waiter;
+	_pend_current_thread(&event->wait_q, timeout);
+
+	if (_Swap(key) != 0) {
+		return 0;
+	}
+
+	return waiter.matched;
+}
+
+#ifdef CONFIG_USERSPACE
+_SYSCALL_HANDLER(k_event_wait, event, events, options, timeout)
+{
+	_SYSCALL_OBJ(event, K_OBJ_EVENT);
+	_SYSCALL_VERIFY(events != 0);
+
+	return _impl_k_event_wait((struct k_event *)event, events, options,
+				  timeout);
+}
+
+_SYSCALL_HANDLER1_SIMPLE(k_event_get, K_OBJ_EVENT, struct k_event *);
+#endif
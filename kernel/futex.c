@@ -0,0 +1,128 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ *
+ * @brief Futex wait and wake.
+ *
+ * The futex variables belong to the application, the kernel only keeps the
+ * threads waiting on them. Waiters are spread over a few wait queues by
+ * the address of the futex; a waiting thread records that address in its
+ * swap_data so the wake side can pick its own waiters out of the queue.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <toolchain.h>
+#include <wait_q.h>
+#include <misc/dlist.h>
+#include <ksched.h>
+#include <init.h>
+#include <errno.h>
+#include <syscall_handler.h>
+
+#define FUTEX_BUCKETS 8
+
+static _wait_q_t futex_wait_q[FUTEX_BUCKETS];
+
+static inline _wait_q_t *futex_bucket(atomic_t *futex)
+{
+	return &futex_wait_q[((uintptr_t)futex / sizeof(atomic_t)) %
+			     FUTEX_BUCKETS];
+}
+
+static int init_futex_module(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	int i;
+
+	for (i = 0; i < FUTEX_BUCKETS; i++) {
+		sys_dlist_init(&futex_wait_q[i]);
+	}
+	return 0;
+}
+
+SYS_INIT(init_futex_module, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+
+int _impl_k_futex_wait(atomic_t *futex, atomic_val_t expected,
+		       s32_t timeout)
+{
+	__ASSERT(!_is_in_isr(), "");
+
+	unsigned int key = irq_lock();
+
+	if (atomic_get(futex) != expected) {
+		irq_unlock(key);
+		return -EAGAIN;
+	}
+
+	if (timeout == K_NO_WAIT) {
+		irq_unlock(key);
+		return -ETIMEDOUT;
+	}
+
+	_current->base.swap_data = futex;
+	_pend_current_thread(futex_bucket(futex), timeout);
+
+	return _Swap(key) == 0 ? 0 : -ETIMEDOUT;
+}
+
+#ifdef CONFIG_USERSPACE
+_SYSCALL_HANDLER(k_futex_wait, futex, expected, timeout)
+{
+	_SYSCALL_MEMORY_WRITE(futex, sizeof(atomic_t));
+
+	return _impl_k_futex_wait((atomic_t *)futex, expected, timeout);
+}
+#endif
+
+int _impl_k_futex_wake(atomic_t *futex, int wake_all)
+{
+	_wait_q_t *wait_q = futex_bucket(futex);
+	struct k_thread *thread, *next;
+	unsigned int key;
+	int woken = 0;
+
+	key = irq_lock();
+
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(wait_q, thread, next,
+					  base.k_q_node) {
+		/* the bucket is shared with other futexes, and waiters whose
+		 * timeout is being handled are already on their way out
+		 */
+		if (thread->base.swap_data != futex ||
+		    _is_thread_timeout_expired(thread)) {
+			continue;
+		}
+
+		_unpend_thread(thread);
+		(void)_abort_thread_timeout(thread);
+		_ready_thread(thread);
+		_set_thread_return_value(thread, 0);
+		woken++;
+
+		if (!wake_all) {
+			break;
+		}
+	}
+
+	if (woken && !_is_in_isr()) {
+		_reschedule_threads(key);
+	} else {
+		irq_unlock(key);
+	}
+
+	return woken;
+}
+
+#ifdef CONFIG_USERSPACE
+_SYSCALL_HANDLER(k_futex_wake, futex, wake_all)
+{
+	_SYSCALL_MEMORY_WRITE(futex, sizeof(atomic_t));
+
+	return _impl_k_futex_wake((atomic_t *)futex, wake_all);
+}
+#endif
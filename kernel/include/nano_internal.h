@@ -49,6 +49,11 @@ static inline void _data_copy(void)
 #endif
 FUNC_NORETURN void _Cstart(void);
 
+#ifdef CONFIG_WORK_POOL
+extern bool _k_work_pool_remove(struct k_work_pool *pool,
+				struct k_work *work);
+#endif
+
 extern FUNC_NORETURN void _thread_entry(k_thread_entry_t entry,
 			  void *p1, void *p2, void *p3);
 
@@ -77,6 +82,10 @@ extern void _update_time_slice_before_swap(void);
 extern void _check_stack_sentinel(void);
 #endif
 
+#if defined(CONFIG_THREAD_RUNTIME_STATS) || defined(CONFIG_TRACING)
+extern void _sched_switch_hook(void);
+#endif
+
 // KID 20170618
 // irq_lock(): eflags 값
 // KID 20170718
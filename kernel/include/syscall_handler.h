@@ -12,6 +12,7 @@
 
 #ifndef _ASMLANGUAGE
 #include <kernel.h>
+#include <kernel_structs.h>
 #include <misc/printk.h>
 #include <nano_internal.h>
 
@@ -80,6 +81,17 @@ typedef void (*_wordlist_cb_func_t)(struct _k_object *ko, void *context);
  */
 extern void _k_object_wordlist_foreach(_wordlist_cb_func_t func, void *context);
 
+#ifdef CONFIG_DYNAMIC_OBJECTS
+/*
+ * With dynamic objects the gperf script footer provides these two under
+ * different names, and _k_object_find()/_k_object_wordlist_foreach() also
+ * search the table of objects allocated at runtime.
+ */
+extern struct _k_object *_k_object_gperf_find(void *obj);
+extern void _k_object_gperf_wordlist_foreach(_wordlist_cb_func_t func,
+					     void *context);
+#endif
+
 /**
  * Copy all kernel object permissions from the parent to the child
  *
@@ -256,10 +268,65 @@ static inline int _obj_validation_check(struct _k_object *ko,
 	return ret;
 }
 
+#ifdef CONFIG_KOBJECT_VALIDATION_CACHE
+/* Bumped whenever a successful check could stop being valid */
+extern atomic_t _k_object_gen;
+
+/**
+ * Invalidate the kernel object validation cache of every thread
+ *
+ * Must be called whenever a thread may lose access to an object, or an
+ * object stops being initialized or stops existing.
+ */
+static inline void _k_object_cache_flush(void)
+{
+	atomic_inc(&_k_object_gen);
+}
+#endif
+
+/**
+ * Look up and validate a kernel object passed to a system call
+ *
+ * Same as _obj_validation_check(_k_object_find(obj), obj, otype, init),
+ * but an initialized object that already passed the check for the
+ * current thread is accepted without searching for it again.
+ *
+ * @return See _k_object_validate()
+ */
+static inline int _k_object_check(void *obj, enum k_objects otype,
+				  enum _obj_init_check init)
+{
+	struct _k_object *ko;
+	int ret;
+
+#ifdef CONFIG_KOBJECT_VALIDATION_CACHE
+	struct _k_object_cache *cache = &_current->kobj_cache;
+	u32_t gen = (u32_t)atomic_get(&_k_object_gen);
+
+	if (init == _OBJ_INIT_TRUE && cache->obj == obj &&
+	    cache->gen == gen &&
+	    (otype == K_OBJ_ANY || cache->ko->type == otype)) {
+		return 0;
+	}
+#endif
+
+	ko = _k_object_find(obj);
+	ret = _obj_validation_check(ko, obj, otype, init);
+
+#ifdef CONFIG_KOBJECT_VALIDATION_CACHE
+	if (!ret && init == _OBJ_INIT_TRUE) {
+		cache->obj = obj;
+		cache->ko = ko;
+		cache->gen = gen;
+	}
+#endif
+
+	return ret;
+}
+
 #define _SYSCALL_IS_OBJ(ptr, type, init) \
-	_SYSCALL_VERIFY_MSG( \
-	    !_obj_validation_check(_k_object_find((void *)ptr), (void *)ptr, \
-				   type, init), "access denied")
+	_SYSCALL_VERIFY_MSG(!_k_object_check((void *)ptr, type, init), \
+			    "access denied")
 
 /**
  * @brief Runtime check kernel object pointer for non-init functions
@@ -414,6 +414,9 @@ static void prepare_multithreading(struct k_thread *dummy_thread)
 #ifdef CONFIG_USERSPACE
 	dummy_thread->mem_domain_info.mem_domain = 0;
 #endif
+	/* init functions may lock mutexes */
+	sys_dlist_init(&dummy_thread->held_mutexes);
+	dummy_thread->pended_mutex = NULL;
 #endif
 
 	/* _kernel.ready_q is all zeroes */
@@ -47,6 +47,194 @@ SYS_INIT(init_msgq_module, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
 
 #endif /* CONFIG_OBJECT_TRACING */
 
+/*
+ * A variable-length message queue has a msg_size of 0. Each message is a
+ * 32-bit length header followed by the payload, padded so the next header
+ * stays aligned. A message never wraps around the end of the buffer: when
+ * it does not fit there, the writer leaves a MSGQ_VARLEN_WRAP header (if
+ * there is room for one) and starts again at buffer_start. read_ptr and
+ * write_ptr are only equal with messages in the queue when it is full.
+ */
+#define MSGQ_VARLEN_HDR sizeof(u32_t)
+#define MSGQ_VARLEN_WRAP 0xffffffff
+
+static inline bool is_varlen(struct k_msgq *q)
+{
+	return q->msg_size == 0;
+}
+
+static inline size_t varlen_record_size(size_t len)
+{
+	return MSGQ_VARLEN_HDR + ROUND_UP(len, MSGQ_VARLEN_HDR);
+}
+
+/* Find room for a record of rec bytes and return its header address */
+static char *varlen_reserve(struct k_msgq *q, size_t rec)
+{
+	if (!q->used_msgs) {
+		q->read_ptr = q->buffer_start;
+		q->write_ptr = q->buffer_start;
+	}
+
+	if (!q->used_msgs || q->write_ptr > q->read_ptr) {
+		if (q->buffer_end - q->write_ptr >= rec) {
+			return q->write_ptr;
+		}
+
+		if (q->read_ptr - q->buffer_start < rec) {
+			return NULL;
+		}
+
+		if (q->buffer_end - q->write_ptr >= MSGQ_VARLEN_HDR) {
+			*(u32_t *)q->write_ptr = MSGQ_VARLEN_WRAP;
+		}
+
+		q->write_ptr = q->buffer_start;
+		return q->write_ptr;
+	}
+
+	if (q->read_ptr - q->write_ptr >= rec) {
+		return q->write_ptr;
+	}
+
+	return NULL;
+}
+
+/* Return the first message, skipping over a wrap marker */
+static char *msgq_head(struct k_msgq *q, size_t *len)
+{
+	if (!is_varlen(q)) {
+		*len = q->msg_size;
+		return q->read_ptr;
+	}
+
+	if (q->buffer_end - q->read_ptr < MSGQ_VARLEN_HDR ||
+	    *(u32_t *)q->read_ptr == MSGQ_VARLEN_WRAP) {
+		q->read_ptr = q->buffer_start;
+	}
+
+	*len = *(u32_t *)q->read_ptr;
+	return q->read_ptr + MSGQ_VARLEN_HDR;
+}
+
+static void msgq_consume(struct k_msgq *q)
+{
+	size_t len;
+
+	if (is_varlen(q)) {
+		msgq_head(q, &len);
+		q->read_ptr += varlen_record_size(len);
+	} else {
+		q->read_ptr += q->msg_size;
+		if (q->read_ptr == q->buffer_end) {
+			q->read_ptr = q->buffer_start;
+		}
+	}
+
+	q->used_msgs--;
+}
+
+static void msgq_wake(struct k_thread *thread)
+{
+	_set_thread_return_value(thread, 0);
+	_abort_thread_timeout(thread);
+	_ready_thread(thread);
+}
+
+/*
+ * Return the first thread pended on the queue that passed a buffer (senders,
+ * and receivers in k_msgq_get()), or that did not (receivers in
+ * k_msgq_peek_claim()). Threads whose timeout is being handled are skipped.
+ */
+static struct k_thread *msgq_first_waiter(struct k_msgq *q, int with_data)
+{
+	sys_dnode_t *node;
+
+	SYS_DLIST_FOR_EACH_NODE(&q->wait_q, node) {
+		struct k_thread *thread = (struct k_thread *)node;
+
+		if (_is_thread_timeout_expired(thread)) {
+			continue;
+		}
+
+		if (!thread->base.swap_data == !with_data) {
+			return thread;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * A message was just queued: if the queue is not claimed, hand the claim to
+ * the first thread blocked in k_msgq_peek_claim(). The others stay pended
+ * until the claim is released.
+ */
+static struct k_thread *msgq_grant_claim(struct k_msgq *q)
+{
+	struct k_thread *pending_thread;
+
+	if (q->claimed || !q->used_msgs) {
+		return NULL;
+	}
+
+	pending_thread = msgq_first_waiter(q, 0);
+	if (!pending_thread) {
+		return NULL;
+	}
+
+	_unpend_thread(pending_thread);
+	q->claimed = 1;
+	msgq_wake(pending_thread);
+
+	return pending_thread;
+}
+
+/* A message slot was just freed: let the first waiting sender in */
+static struct k_thread *msgq_admit_sender(struct k_msgq *q)
+{
+	struct k_thread *pending_thread;
+
+	pending_thread = msgq_first_waiter(q, 1);
+	if (!pending_thread) {
+		return NULL;
+	}
+
+	_unpend_thread(pending_thread);
+
+	memcpy(q->write_ptr, pending_thread->base.swap_data, q->msg_size);
+	q->write_ptr += q->msg_size;
+	if (q->write_ptr == q->buffer_end) {
+		q->write_ptr = q->buffer_start;
+	}
+	q->used_msgs++;
+
+	msgq_wake(pending_thread);
+
+	return pending_thread;
+}
+
+/* returns 1 if a reschedule must take place, 0 otherwise */
+static inline int handle_poll_events(struct k_msgq *q)
+{
+#ifdef CONFIG_POLL
+	return _handle_obj_poll_events(&q->poll_events,
+				       K_POLL_STATE_MSGQ_DATA_AVAILABLE);
+#else
+	return 0;
+#endif
+}
+
+static void msgq_reschedule(unsigned int key, struct k_thread *woken)
+{
+	if (woken && !_is_in_isr() && _must_switch_threads()) {
+		_Swap(key);
+		return;
+	}
+
+	irq_unlock(key);
+}
+
 void _impl_k_msgq_init(struct k_msgq *q, char *buffer,
 		       size_t msg_size, u32_t max_msgs)
 {
@@ -57,12 +245,26 @@ void _impl_k_msgq_init(struct k_msgq *q, char *buffer,
 	q->read_ptr = buffer;
 	q->write_ptr = buffer;
 	q->used_msgs = 0;
+	q->alloc_ptr = NULL;
+	q->claimed = 0;
 	sys_dlist_init(&q->wait_q);
+#if defined(CONFIG_POLL)
+	sys_dlist_init(&q->poll_events);
+#endif
 	SYS_TRACING_OBJ_INIT(k_msgq, q);
 
 	_k_object_init(q);
 }
 
+void k_msgq_varlen_init(struct k_msgq *q, char *buffer, size_t size)
+{
+	__ASSERT(((uintptr_t)buffer & (MSGQ_VARLEN_HDR - 1)) == 0,
+		 "unaligned message queue buffer");
+
+	_impl_k_msgq_init(q, buffer, 0, 0);
+	q->buffer_end = buffer + size;
+}
+
 #ifdef CONFIG_USERSPACE
 _SYSCALL_HANDLER(k_msgq_init, q, buffer, msg_size, max_msgs)
 {
@@ -83,21 +285,23 @@ int _impl_k_msgq_put(struct k_msgq *q, void *data, s32_t timeout)
 	struct k_thread *pending_thread;
 	int result;
 
-	if (q->used_msgs < q->max_msgs) {
-		/* message queue isn't full */
-		pending_thread = _unpend_first_thread(&q->wait_q);
+	if (is_varlen(q)) {
+		result = -EINVAL;
+	} else if (q->alloc_ptr) {
+		/* the next slot belongs to an uncommitted message */
+		result = -EBUSY;
+	} else if (q->used_msgs < q->max_msgs) {
+		/*
+		 * message queue isn't full, so any thread passing a buffer
+		 * is a receiver
+		 */
+		pending_thread = msgq_first_waiter(q, 1);
 		if (pending_thread) {
 			/* give message to waiting thread */
+			_unpend_thread(pending_thread);
 			memcpy(pending_thread->base.swap_data, data,
 			       q->msg_size);
-			/* wake up waiting thread */
-			_set_thread_return_value(pending_thread, 0);
-			_abort_thread_timeout(pending_thread);
-			_ready_thread(pending_thread);
-			if (!_is_in_isr() && _must_switch_threads()) {
-				_Swap(key);
-				return 0;
-			}
+			msgq_wake(pending_thread);
 		} else {
 			/* put message in queue */
 			memcpy(q->write_ptr, data, q->msg_size);
@@ -106,8 +310,18 @@ int _impl_k_msgq_put(struct k_msgq *q, void *data, s32_t timeout)
 				q->write_ptr = q->buffer_start;
 			}
 			q->used_msgs++;
+
+			/* a waiting thread may read it in place */
+			pending_thread = msgq_grant_claim(q);
+		}
+
+		if (!pending_thread && handle_poll_events(q)) {
+			(void)_Swap(key);
+			return 0;
 		}
-		result = 0;
+
+		msgq_reschedule(key, pending_thread);
+		return 0;
 	} else if (timeout == K_NO_WAIT) {
 		/* don't wait for message space to become available */
 		result = -ENOMSG;
@@ -143,37 +357,23 @@ int _impl_k_msgq_get(struct k_msgq *q, void *data, s32_t timeout)
 	struct k_thread *pending_thread;
 	int result;
 
-	if (q->used_msgs > 0) {
+	if (is_varlen(q)) {
+		result = -EINVAL;
+	} else if (q->claimed) {
+		/* the first message is being read in place */
+		result = -EBUSY;
+	} else if (q->used_msgs > 0) {
+		int full = (q->used_msgs == q->max_msgs);
+
 		/* take first available message from queue */
 		memcpy(data, q->read_ptr, q->msg_size);
-		q->read_ptr += q->msg_size;
-		if (q->read_ptr == q->buffer_end) {
-			q->read_ptr = q->buffer_start;
-		}
-		q->used_msgs--;
+		msgq_consume(q);
 
-		/* handle first thread waiting to write (if any) */
-		pending_thread = _unpend_first_thread(&q->wait_q);
-		if (pending_thread) {
-			/* add thread's message to queue */
-			memcpy(q->write_ptr, pending_thread->base.swap_data,
-			       q->msg_size);
-			q->write_ptr += q->msg_size;
-			if (q->write_ptr == q->buffer_end) {
-				q->write_ptr = q->buffer_start;
-			}
-			q->used_msgs++;
+		/* only a full queue has threads waiting to write */
+		pending_thread = full ? msgq_admit_sender(q) : NULL;
 
-			/* wake up waiting thread */
-			_set_thread_return_value(pending_thread, 0);
-			_abort_thread_timeout(pending_thread);
-			_ready_thread(pending_thread);
-			if (!_is_in_isr() && _must_switch_threads()) {
-				_Swap(key);
-				return 0;
-			}
-		}
-		result = 0;
+		msgq_reschedule(key, pending_thread);
+		return 0;
 	} else if (timeout == K_NO_WAIT) {
 		/* don't wait for a message to become available */
 		result = -ENOMSG;
@@ -215,10 +415,171 @@ void _impl_k_msgq_purge(struct k_msgq *q)
 
 	q->used_msgs = 0;
 	q->read_ptr = q->write_ptr;
+	q->claimed = 0;
 
 	_reschedule_threads(key);
 }
 
+int k_msgq_alloc(struct k_msgq *q, void **data, size_t size)
+{
+	unsigned int key;
+	char *rec;
+	int result = 0;
+
+	if (is_varlen(q)) {
+		if (varlen_record_size(size) >
+		    (size_t)(q->buffer_end - q->buffer_start)) {
+			return -EINVAL;
+		}
+	} else if (size > q->msg_size) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+
+	if (q->alloc_ptr) {
+		result = -EBUSY;
+	} else if (!is_varlen(q)) {
+		if (q->used_msgs < q->max_msgs) {
+			q->alloc_ptr = q->write_ptr;
+			q->alloc_size = q->msg_size;
+			*data = q->alloc_ptr;
+		} else {
+			result = -ENOMSG;
+		}
+	} else {
+		rec = varlen_reserve(q, varlen_record_size(size));
+		if (rec) {
+			q->alloc_ptr = rec;
+			q->alloc_size = size;
+			*data = rec + MSGQ_VARLEN_HDR;
+		} else {
+			result = -ENOMSG;
+		}
+	}
+
+	irq_unlock(key);
+
+	return result;
+}
+
+int k_msgq_commit(struct k_msgq *q, size_t len)
+{
+	unsigned int key = irq_lock();
+	struct k_thread *pending_thread;
+
+	if (!q->alloc_ptr || len > q->alloc_size) {
+		irq_unlock(key);
+		return -EINVAL;
+	}
+
+	if (!len) {
+		/* the space is simply handed out again by the next alloc */
+		q->alloc_ptr = NULL;
+		irq_unlock(key);
+		return 0;
+	}
+
+	if (is_varlen(q)) {
+		*(u32_t *)q->alloc_ptr = len;
+		q->write_ptr = q->alloc_ptr + varlen_record_size(len);
+	} else if ((pending_thread = msgq_first_waiter(q, 1)) != NULL) {
+		/* the queue is empty: copy to the waiting k_msgq_get() */
+		_unpend_thread(pending_thread);
+		memcpy(pending_thread->base.swap_data, q->alloc_ptr,
+		       q->msg_size);
+		msgq_wake(pending_thread);
+
+		q->alloc_ptr = NULL;
+		msgq_reschedule(key, pending_thread);
+		return 0;
+	} else {
+		q->write_ptr += q->msg_size;
+		if (q->write_ptr == q->buffer_end) {
+			q->write_ptr = q->buffer_start;
+		}
+	}
+
+	q->alloc_ptr = NULL;
+	q->used_msgs++;
+
+	pending_thread = msgq_grant_claim(q);
+	if (!pending_thread && handle_poll_events(q)) {
+		(void)_Swap(key);
+		return 0;
+	}
+	msgq_reschedule(key, pending_thread);
+
+	return 0;
+}
+
+int k_msgq_peek_claim(struct k_msgq *q, void **data, size_t *len,
+		      s32_t timeout)
+{
+	__ASSERT(!_is_in_isr() || timeout == K_NO_WAIT, "");
+
+	unsigned int key = irq_lock();
+	int result;
+
+	if (q->claimed) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	if (q->used_msgs > 0) {
+		q->claimed = 1;
+	} else if (timeout == K_NO_WAIT) {
+		irq_unlock(key);
+		return -ENOMSG;
+	} else {
+		/* the sender claims the message on our behalf */
+		_pend_current_thread(&q->wait_q, timeout);
+		_current->base.swap_data = NULL;
+		result = _Swap(key);
+		if (result) {
+			return result;
+		}
+
+		key = irq_lock();
+	}
+
+	*data = msgq_head(q, len);
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+int k_msgq_release(struct k_msgq *q)
+{
+	unsigned int key = irq_lock();
+	struct k_thread *sender = NULL;
+	struct k_thread *claimer;
+	int full;
+
+	if (!q->claimed) {
+		irq_unlock(key);
+		return -EINVAL;
+	}
+
+	full = !is_varlen(q) && q->used_msgs == q->max_msgs;
+
+	q->claimed = 0;
+	msgq_consume(q);
+
+	/* only a full queue has threads waiting to write */
+	if (full) {
+		sender = msgq_admit_sender(q);
+	}
+
+	/* the next message goes to the next claimer, if any */
+	claimer = msgq_grant_claim(q);
+
+	msgq_reschedule(key, claimer ? claimer : sender);
+
+	return 0;
+}
+
 #ifdef CONFIG_USERSPACE
 _SYSCALL_HANDLER1_SIMPLE_VOID(k_msgq_purge, K_OBJ_MSGQ, struct k_msgq *);
 _SYSCALL_HANDLER1_SIMPLE(k_msgq_num_free_get, K_OBJ_MSGQ, struct k_msgq *);
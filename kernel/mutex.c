@@ -13,17 +13,12 @@
  * level of the owning thread to match the priority level of the highest
  * priority thread waiting on the mutex.
  *
- * Each mutex that contributes to priority inheritance must be released in the
- * reverse order in which it was acquired.  Furthermore each subsequent mutex
- * that contributes to raising the owning thread's priority level must be
- * acquired at a point after the most recent "bumping" of the priority level.
- *
- * For example, if thread A has two mutexes contributing to the raising of its
- * priority level, the second mutex M2 must be acquired by thread A after
- * thread A's priority level was bumped due to owning the first mutex M1.
- * When releasing the mutex, thread A must release M2 before it releases M1.
- * Failure to follow this nested model may result in threads running at
- * unexpected priority levels (too high, or too low).
+ * Each thread keeps the list of mutexes it owns and the mutex it waits for.
+ * Whenever one of them changes, the priority of the owner is recomputed from
+ * its own priority, the ceilings of the mutexes it owns and their highest
+ * priority waiters, so mutexes can be released in any order. When the owner
+ * is itself waiting for a mutex, the change is carried over to the owner of
+ * that mutex, and so on down the chain.
  */
 
 #include <kernel.h>
@@ -34,8 +29,10 @@
 #include <misc/dlist.h>
 #include <debug/object_tracing_common.h>
 #include <errno.h>
+#include <string.h>
 #include <init.h>
 #include <syscall_handler.h>
+#include <logging/tracing.h>
 
 #define RECORD_STATE_CHANGE(mutex) do { } while ((0))
 #define RECORD_CONFLICT(mutex) do { } while ((0))
@@ -71,11 +68,20 @@ void _impl_k_mutex_init(struct k_mutex *mutex)
 {
 	mutex->owner = NULL;
 	mutex->lock_count = 0;
+	mutex->ceiling = K_LOWEST_THREAD_PRIO;
 
 	/* initialized upon first use */
 	/* mutex->owner_orig_prio = 0; */
 
 	sys_dlist_init(&mutex->wait_q);
+#if defined(CONFIG_POLL)
+	sys_dlist_init(&mutex->poll_events);
+#endif
+
+#ifdef CONFIG_MUTEX_INVERSION_STATS
+	memset(&mutex->inversion, 0, sizeof(mutex->inversion));
+	mutex->inverted = 0;
+#endif
 
 	SYS_TRACING_OBJ_INIT(k_mutex, mutex);
 	_k_object_init(mutex);
@@ -91,31 +97,151 @@ _SYSCALL_HANDLER(k_mutex_init, mutex)
 }
 #endif
 
-static int new_prio_for_inheritance(int target, int limit)
+/*
+ * The priority of a thread before inheritance and ceilings. Every mutex a
+ * thread owns records it, see mutex_take().
+ */
+static int thread_own_prio(struct k_thread *thread)
+{
+	struct k_mutex *held;
+
+	held = SYS_DLIST_PEEK_HEAD_CONTAINER(&thread->held_mutexes, held,
+					     held_node);
+
+	return held ? held->owner_orig_prio : thread->base.prio;
+}
+
+/* The priority an owner must run at, given the mutexes it owns */
+static int owner_prio(struct k_thread *owner)
 {
-	int new_prio = _is_prio_higher(target, limit) ? target : limit;
+	int prio = thread_own_prio(owner);
+	struct k_thread *waiter;
+	struct k_mutex *held;
+	int boost;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&owner->held_mutexes, held, held_node) {
+		if (_is_prio_higher(held->ceiling, prio)) {
+			prio = held->ceiling;
+		}
+
+		/* wait queues are sorted, the first waiter is the highest */
+		waiter = (struct k_thread *)sys_dlist_peek_head(&held->wait_q);
+		if (!waiter) {
+			continue;
+		}
+
+		boost = _get_new_prio_with_ceiling(waiter->base.prio);
+		if (_is_prio_higher(boost, prio)) {
+			prio = boost;
+		}
+	}
+
+	return prio;
+}
 
-	new_prio = _get_new_prio_with_ceiling(new_prio);
+/* Move a waiting thread back to its place after a priority change */
+static void wait_q_resort(_wait_q_t *wait_q, struct k_thread *thread)
+{
+	sys_dlist_t *list = (sys_dlist_t *)wait_q;
+	struct k_thread *pending;
+
+	sys_dlist_remove(&thread->base.k_q_node);
 
-	return new_prio;
+	SYS_DLIST_FOR_EACH_CONTAINER(list, pending, base.k_q_node) {
+		if (_is_t1_higher_prio_than_t2(thread, pending)) {
+			sys_dlist_insert_before(list, &pending->base.k_q_node,
+						&thread->base.k_q_node);
+			return;
+		}
+	}
+
+	sys_dlist_append(list, &thread->base.k_q_node);
 }
 
-static void adjust_owner_prio(struct k_mutex *mutex, int new_prio)
+/*
+ * Recompute the priority of an owner, then of the owner of the mutex it is
+ * waiting for, until a priority does not change.
+ *
+ * Must be called with interrupts locked.
+ */
+static void adjust_owner_prio(struct k_thread *owner)
 {
-	if (mutex->owner->base.prio != new_prio) {
+	struct k_mutex *mutex;
+	int new_prio;
+
+	while (owner) {
+		new_prio = owner_prio(owner);
+		if (new_prio == owner->base.prio) {
+			return;
+		}
 
 		K_DEBUG("%p (ready (y/n): %c) prio changed to %d (was %d)\n",
-			mutex->owner, _is_thread_ready(mutex->owner) ?
-			'y' : 'n',
-			new_prio, mutex->owner->base.prio);
+			owner, _is_thread_ready(owner) ? 'y' : 'n',
+			new_prio, owner->base.prio);
+
+		mutex = owner->pended_mutex;
+		if (!mutex || !_is_thread_pending(owner)) {
+			_thread_priority_set(owner, new_prio);
+			return;
+		}
+
+		owner->base.prio = new_prio;
+		wait_q_resort(&mutex->wait_q, owner);
+		owner = mutex->owner;
+	}
+}
 
-		_thread_priority_set(mutex->owner, new_prio);
+#ifdef CONFIG_MUTEX_INVERSION_STATS
+/*
+ * An inversion lasts while the first waiter has a higher priority than the
+ * owner had on its own. Start or stop timing it after the waiters or the
+ * owner changed.
+ */
+static void inversion_update(struct k_mutex *mutex)
+{
+	struct k_thread *waiter;
+	int inverted;
+	u32_t len;
+
+	waiter = (struct k_thread *)sys_dlist_peek_head(&mutex->wait_q);
+	inverted = mutex->owner && waiter &&
+		   _is_prio_higher(waiter->base.prio, mutex->owner_orig_prio);
+
+	if (inverted && !mutex->inverted) {
+		mutex->inverted = 1;
+		mutex->inversion_start = k_cycle_get_32();
+	} else if (!inverted && mutex->inverted) {
+		len = k_cycle_get_32() - mutex->inversion_start;
+
+		mutex->inverted = 0;
+		mutex->inversion.count++;
+		mutex->inversion.total_cycles += len;
+		mutex->inversion.max_cycles =
+			max(mutex->inversion.max_cycles, len);
 	}
 }
+#else
+#define inversion_update(mutex) do { } while ((0))
+#endif
+
+/* Hand a free mutex to a thread, interrupts locked */
+static void mutex_take(struct k_mutex *mutex, struct k_thread *owner)
+{
+	mutex->owner_orig_prio = thread_own_prio(owner);
+	mutex->lock_count = 1;
+	mutex->owner = owner;
+	sys_dlist_prepend(&owner->held_mutexes, &mutex->held_node);
+
+	/* the ceiling, or the waiters left behind, may boost the new owner */
+	adjust_owner_prio(owner);
+	inversion_update(mutex);
+}
 
 int _impl_k_mutex_lock(struct k_mutex *mutex, s32_t timeout)
 {
-	int new_prio, key;
+	int key;
+
+	SYS_TRACE(SYS_TRACE_MUTEX_LOCK, 0, mutex);
 
 	_sched_lock();
 
@@ -123,12 +249,13 @@ int _impl_k_mutex_lock(struct k_mutex *mutex, s32_t timeout)
 
 		RECORD_STATE_CHANGE();
 
-		mutex->owner_orig_prio = mutex->lock_count == 0 ?
-					_current->base.prio :
-					mutex->owner_orig_prio;
-
-		mutex->lock_count++;
-		mutex->owner = _current;
+		if (mutex->lock_count == 0) {
+			key = irq_lock();
+			mutex_take(mutex, _current);
+			irq_unlock(key);
+		} else {
+			mutex->lock_count++;
+		}
 
 		K_DEBUG("%p took mutex %p, count: %d, orig prio: %d\n",
 			_current, mutex, mutex->lock_count,
@@ -146,18 +273,14 @@ int _impl_k_mutex_lock(struct k_mutex *mutex, s32_t timeout)
 		return -EBUSY;
 	}
 
-	new_prio = new_prio_for_inheritance(_current->base.prio,
-					    mutex->owner->base.prio);
-
 	key = irq_lock();
 
 	K_DEBUG("adjusting prio up on mutex %p\n", mutex);
 
-	if (_is_prio_higher(new_prio, mutex->owner->base.prio)) {
-		adjust_owner_prio(mutex, new_prio);
-	}
-
+	_current->pended_mutex = mutex;
 	_pend_current_thread(&mutex->wait_q, timeout);
+	adjust_owner_prio(mutex->owner);
+	inversion_update(mutex);
 
 	int got_mutex = _Swap(key);
 
@@ -174,18 +297,12 @@ int _impl_k_mutex_lock(struct k_mutex *mutex, s32_t timeout)
 	/* timed out */
 
 	K_DEBUG("%p timeout on mutex %p\n", _current, mutex);
-
-	struct k_thread *waiter =
-		(struct k_thread *)sys_dlist_peek_head(&mutex->wait_q);
-
-	new_prio = mutex->owner_orig_prio;
-	new_prio = waiter ? new_prio_for_inheritance(waiter->base.prio,
-						     new_prio) : new_prio;
-
 	K_DEBUG("adjusting prio down on mutex %p\n", mutex);
 
 	key = irq_lock();
-	adjust_owner_prio(mutex, new_prio);
+	_current->pended_mutex = NULL;
+	adjust_owner_prio(mutex->owner);
+	inversion_update(mutex);
 	irq_unlock(key);
 
 	k_sched_unlock();
@@ -201,6 +318,14 @@ _SYSCALL_HANDLER(k_mutex_lock, mutex, timeout)
 }
 #endif
 
+static inline void handle_poll_events(struct k_mutex *mutex)
+{
+#ifdef CONFIG_POLL
+	(void)_handle_obj_poll_events(&mutex->poll_events,
+				      K_POLL_STATE_MUTEX_AVAILABLE);
+#endif
+}
+
 void _impl_k_mutex_unlock(struct k_mutex *mutex)
 {
 	int key;
@@ -208,6 +333,8 @@ void _impl_k_mutex_unlock(struct k_mutex *mutex)
 	__ASSERT(mutex->lock_count > 0, "");
 	__ASSERT(mutex->owner == _current, "");
 
+	SYS_TRACE(SYS_TRACE_MUTEX_UNLOCK, 0, mutex);
+
 	_sched_lock();
 
 	RECORD_STATE_CHANGE();
@@ -223,7 +350,15 @@ void _impl_k_mutex_unlock(struct k_mutex *mutex)
 
 	key = irq_lock();
 
-	adjust_owner_prio(mutex, mutex->owner_orig_prio);
+	mutex->owner = NULL;
+	inversion_update(mutex);
+
+	sys_dlist_remove(&mutex->held_node);
+	if (sys_dlist_is_empty(&_current->held_mutexes)) {
+		_thread_priority_set(_current, mutex->owner_orig_prio);
+	} else {
+		adjust_owner_prio(_current);
+	}
 
 	struct k_thread *new_owner = _unpend_first_thread(&mutex->wait_q);
 
@@ -233,27 +368,83 @@ void _impl_k_mutex_unlock(struct k_mutex *mutex)
 	if (new_owner) {
 		_abort_thread_timeout(new_owner);
 		_ready_thread(new_owner);
-
-		irq_unlock(key);
-
 		_set_thread_return_value(new_owner, 0);
 
-		/*
-		 * new owner is already of higher or equal prio than first
-		 * waiter since the wait queue is priority-based: no need to
-		 * ajust its priority
-		 */
-		mutex->owner = new_owner;
-		mutex->lock_count++;
-		mutex->owner_orig_prio = new_owner->base.prio;
+		new_owner->pended_mutex = NULL;
+		mutex_take(mutex, new_owner);
 	} else {
-		irq_unlock(key);
-		mutex->owner = NULL;
+		/* a woken poller runs once the scheduler is unlocked */
+		handle_poll_events(mutex);
 	}
 
+	irq_unlock(key);
+
 	k_sched_unlock();
 }
 
 #ifdef CONFIG_USERSPACE
 _SYSCALL_HANDLER1_SIMPLE_VOID(k_mutex_unlock, K_OBJ_MUTEX, struct k_mutex *);
 #endif
+
+int _impl_k_mutex_ceiling_set(struct k_mutex *mutex, int prio)
+{
+	__ASSERT(prio == K_LOWEST_THREAD_PRIO || _VALID_PRIO(prio, NULL),
+		 "invalid ceiling %d", prio);
+
+	if (mutex->lock_count != 0) {
+		return -EBUSY;
+	}
+
+	mutex->ceiling = prio;
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+_SYSCALL_HANDLER(k_mutex_ceiling_set, mutex, prio)
+{
+	_SYSCALL_OBJ(mutex, K_OBJ_MUTEX);
+	_SYSCALL_VERIFY_MSG((int)prio == K_LOWEST_THREAD_PRIO ||
+			    _VALID_PRIO(prio, NULL),
+			    "invalid ceiling %d", (int)prio);
+	/* no raising a thread above its own priority through a ceiling */
+	_SYSCALL_VERIFY_MSG((int)prio >= _current->base.prio,
+			    "ceiling %d above caller priority %d",
+			    (int)prio, _current->base.prio);
+
+	return _impl_k_mutex_ceiling_set((struct k_mutex *)mutex, prio);
+}
+#endif
+
+#ifdef CONFIG_MUTEX_INVERSION_STATS
+int _impl_k_mutex_inversion_stats_get(struct k_mutex *mutex,
+				      struct k_mutex_inversion_stats *stats)
+{
+	unsigned int key = irq_lock();
+	u32_t len;
+
+	*stats = mutex->inversion;
+
+	if (mutex->inverted) {
+		len = k_cycle_get_32() - mutex->inversion_start;
+		stats->count++;
+		stats->total_cycles += len;
+		stats->max_cycles = max(stats->max_cycles, len);
+	}
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+_SYSCALL_HANDLER(k_mutex_inversion_stats_get, mutex, stats)
+{
+	_SYSCALL_OBJ(mutex, K_OBJ_MUTEX);
+	_SYSCALL_MEMORY_WRITE(stats, sizeof(struct k_mutex_inversion_stats));
+
+	return _impl_k_mutex_inversion_stats_get((struct k_mutex *)mutex,
+				(struct k_mutex_inversion_stats *)stats);
+}
+#endif
+#endif /* CONFIG_MUTEX_INVERSION_STATS */
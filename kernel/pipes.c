@@ -18,6 +18,7 @@
 #include <wait_q.h>
 #include <misc/dlist.h>
 #include <init.h>
+#include <string.h>
 #include <syscall_handler.h>
 
 // KID 20170601
@@ -195,6 +196,9 @@ void _impl_k_pipe_init(struct k_pipe *pipe, unsigned char *buffer, size_t size)
 	pipe->write_index = 0;
 	sys_dlist_init(&pipe->wait_q.writers);
 	sys_dlist_init(&pipe->wait_q.readers);
+#if defined(CONFIG_POLL)
+	sys_dlist_init(&pipe->poll_events);
+#endif
 	SYS_TRACING_OBJ_INIT(k_pipe, pipe);
 	_k_object_init(pipe);
 }
@@ -220,17 +224,32 @@ static size_t _pipe_xfer(unsigned char *dest, size_t dest_size,
 			 const unsigned char *src, size_t src_size)
 {
 	size_t num_bytes = min(dest_size, src_size);
-	const unsigned char *end = src + num_bytes;
 
-	while (src != end) {
-		*dest = *src;
-		dest++;
-		src++;
-	}
+	memcpy(dest, src, num_bytes);
 
 	return num_bytes;
 }
 
+/**
+ * @brief Tell a poller that the pipe's circular buffer holds data
+ *
+ * Called with the scheduler locked: a woken poller runs once it is
+ * unlocked.
+ */
+static void _pipe_poll_signal(struct k_pipe *pipe)
+{
+#ifdef CONFIG_POLL
+	unsigned int key = irq_lock();
+
+	if (pipe->bytes_used) {
+		(void)_handle_obj_poll_events(&pipe->poll_events,
+					      K_POLL_STATE_PIPE_DATA_AVAILABLE);
+	}
+
+	irq_unlock(key);
+#endif
+}
+
 /**
  * @brief Put data from @a src into the pipe's circular buffer
  *
@@ -265,6 +284,10 @@ static size_t _pipe_buffer_put(struct k_pipe *pipe,
 		}
 	}
 
+	if (num_bytes_written) {
+		_pipe_poll_signal(pipe);
+	}
+
 	return num_bytes_written;
 }
 
@@ -453,6 +476,191 @@ static void _pipe_thread_ready(struct k_thread *thread)
 	irq_unlock(key);
 }
 
+/**
+ * @brief Write without building a transfer list
+ *
+ * Handles the common cases where the whole request completes at once
+ * and at most one reader is waiting: the data goes to that reader first
+ * and the rest fits in the pipe's circular buffer.
+ *
+ * @return true if all of the data was written, false if the caller must
+ *         take the general path (nothing was written)
+ */
+static bool _pipe_put_fast(struct k_pipe *pipe, unsigned char *data,
+			   size_t bytes_to_write)
+{
+	struct k_thread    *reader;
+	struct k_pipe_desc *desc = NULL;
+	unsigned int   key;
+	size_t         num_bytes = 0;
+
+	key = irq_lock();
+
+	reader = (struct k_thread *)sys_dlist_peek_head(&pipe->wait_q.readers);
+	if (reader) {
+		if (!sys_dlist_is_tail(&pipe->wait_q.readers,
+				       &reader->base.k_q_node)) {
+			irq_unlock(key);
+			return false;
+		}
+
+		desc = (struct k_pipe_desc *)reader->base.swap_data;
+		num_bytes = min(desc->bytes_to_xfer, bytes_to_write);
+	}
+
+	if (bytes_to_write - num_bytes > pipe->size - pipe->bytes_used) {
+		irq_unlock(key);
+		return false;
+	}
+
+	if (reader && num_bytes == desc->bytes_to_xfer) {
+		_unpend_thread(reader);
+		_abort_thread_timeout(reader);
+	} else {
+		/* A partially served reader stays on the wait_q */
+		reader = NULL;
+	}
+
+	_sched_lock();
+	irq_unlock(key);
+
+	if (desc) {
+		memcpy(desc->buffer, data, num_bytes);
+		desc->buffer        += num_bytes;
+		desc->bytes_to_xfer -= num_bytes;
+	}
+
+	if (reader) {
+		_pipe_thread_ready(reader);
+	}
+
+	_pipe_buffer_put(pipe, data + num_bytes, bytes_to_write - num_bytes);
+
+	k_sched_unlock();
+
+	return true;
+}
+
+/**
+ * @brief Read without building a transfer list
+ *
+ * Handles the common case where no writer is waiting and the pipe's
+ * circular buffer already holds all of the requested data.
+ *
+ * @return true if all of the data was read, false if the caller must
+ *         take the general path (nothing was read)
+ */
+static bool _pipe_get_fast(struct k_pipe *pipe, unsigned char *data,
+			   size_t bytes_to_read)
+{
+	unsigned int key = irq_lock();
+
+	if (!sys_dlist_is_empty(&pipe->wait_q.writers) ||
+	    pipe->bytes_used < bytes_to_read) {
+		irq_unlock(key);
+		return false;
+	}
+
+	_sched_lock();
+	irq_unlock(key);
+
+	_pipe_buffer_get(pipe, data, bytes_to_read);
+
+	k_sched_unlock();
+
+	return true;
+}
+
+/**
+ * @brief Hand newly buffered data to waiting readers
+ *
+ * Readers only wait while the circular buffer is empty, so data that was
+ * added to it without going through the transfer lists (a write window)
+ * must be passed on here. Must be called with the scheduler locked.
+ *
+ * @return N/A
+ */
+static void _pipe_feed_readers(struct k_pipe *pipe)
+{
+	struct k_thread    *reader;
+	struct k_pipe_desc *desc;
+	unsigned int   key;
+	size_t         bytes_copied;
+	bool           done;
+
+	do {
+		key = irq_lock();
+		reader = (struct k_thread *)
+			 sys_dlist_peek_head(&pipe->wait_q.readers);
+		if (!reader || !pipe->bytes_used) {
+			irq_unlock(key);
+			return;
+		}
+
+		desc = (struct k_pipe_desc *)reader->base.swap_data;
+		done = desc->bytes_to_xfer <= pipe->bytes_used;
+		if (done) {
+			_unpend_thread(reader);
+			_abort_thread_timeout(reader);
+		}
+		irq_unlock(key);
+
+		bytes_copied = _pipe_buffer_get(pipe, desc->buffer,
+						desc->bytes_to_xfer);
+		desc->buffer        += bytes_copied;
+		desc->bytes_to_xfer -= bytes_copied;
+
+		if (done) {
+			_pipe_thread_ready(reader);
+		}
+	} while (done);
+}
+
+/**
+ * @brief Refill the circular buffer from waiting writers
+ *
+ * Writers only wait while the circular buffer is full, so space that was
+ * freed without going through the transfer lists (a read window) must be
+ * offered to them here. Must be called with the scheduler locked.
+ *
+ * @return N/A
+ */
+static void _pipe_feed_buffer(struct k_pipe *pipe)
+{
+	struct k_thread    *writer;
+	struct k_pipe_desc *desc;
+	unsigned int   key;
+	size_t         bytes_copied;
+	bool           done;
+
+	do {
+		key = irq_lock();
+		writer = (struct k_thread *)
+			 sys_dlist_peek_head(&pipe->wait_q.writers);
+		if (!writer || pipe->bytes_used == pipe->size) {
+			irq_unlock(key);
+			return;
+		}
+
+		desc = (struct k_pipe_desc *)writer->base.swap_data;
+		done = desc->bytes_to_xfer <= pipe->size - pipe->bytes_used;
+		if (done) {
+			_unpend_thread(writer);
+			_abort_thread_timeout(writer);
+		}
+		irq_unlock(key);
+
+		bytes_copied = _pipe_buffer_put(pipe, desc->buffer,
+						desc->bytes_to_xfer);
+		desc->buffer        += bytes_copied;
+		desc->bytes_to_xfer -= bytes_copied;
+
+		if (done) {
+			_pipe_thread_ready(writer);
+		}
+	} while (done);
+}
+
 /**
  * @brief Internal API used to send data to a pipe
  */
@@ -472,6 +680,16 @@ int _k_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 	ARG_UNUSED(async_desc);
 #endif
 
+	if (_pipe_put_fast(pipe, data, bytes_to_write)) {
+		*bytes_written = bytes_to_write;
+#if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
+		if (async_desc != NULL) {
+			_pipe_async_finish(async_desc);
+		}
+#endif
+		return 0;
+	}
+
 	key = irq_lock();
 
 	/*
@@ -612,6 +830,11 @@ int _impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 	__ASSERT(min_xfer <= bytes_to_read, "");
 	__ASSERT(bytes_read != NULL, "");
 
+	if (_pipe_get_fast(pipe, data, bytes_to_read)) {
+		*bytes_read = bytes_to_read;
+		return 0;
+	}
+
 	key = irq_lock();
 
 	/*
@@ -796,7 +1019,15 @@ void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
 	struct k_pipe_async  *async_desc;
 	size_t                dummy_bytes_written;
 
-	/* For simplicity, always allocate an asynchronous descriptor */
+	/* Only take a descriptor if the data can not be written at once */
+	if (_pipe_put_fast(pipe, block->data, bytes_to_write)) {
+		k_mem_pool_free(block);
+		if (sem != NULL) {
+			k_sem_give(sem);
+		}
+		return;
+	}
+
 	_pipe_async_alloc(&async_desc);
 
 	async_desc->desc.block = &async_desc->desc.copy_block;
@@ -809,3 +1040,83 @@ void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
 				    bytes_to_write, K_FOREVER);
 }
 #endif
+
+size_t k_pipe_put_window(struct k_pipe *pipe, void **data)
+{
+	unsigned int key = irq_lock();
+	size_t window;
+
+	window = min(pipe->size - pipe->bytes_used,
+		     pipe->size - pipe->write_index);
+	*data = pipe->buffer + pipe->write_index;
+
+	irq_unlock(key);
+
+	return window;
+}
+
+int k_pipe_put_commit(struct k_pipe *pipe, size_t bytes_written)
+{
+	unsigned int key = irq_lock();
+
+	if (bytes_written > min(pipe->size - pipe->bytes_used,
+				pipe->size - pipe->write_index)) {
+		irq_unlock(key);
+		return -EINVAL;
+	}
+
+	pipe->bytes_used += bytes_written;
+	pipe->write_index += bytes_written;
+	if (pipe->write_index == pipe->size) {
+		pipe->write_index = 0;
+	}
+
+	_sched_lock();
+	irq_unlock(key);
+
+	_pipe_feed_readers(pipe);
+	_pipe_poll_signal(pipe);
+
+	k_sched_unlock();
+
+	return 0;
+}
+
+size_t k_pipe_get_window(struct k_pipe *pipe, void **data)
+{
+	unsigned int key = irq_lock();
+	size_t window;
+
+	window = min(pipe->bytes_used, pipe->size - pipe->read_index);
+	*data = pipe->buffer + pipe->read_index;
+
+	irq_unlock(key);
+
+	return window;
+}
+
+int k_pipe_get_release(struct k_pipe *pipe, size_t bytes_read)
+{
+	unsigned int key = irq_lock();
+
+	if (bytes_read > min(pipe->bytes_used,
+			     pipe->size - pipe->read_index)) {
+		irq_unlock(key);
+		return -EINVAL;
+	}
+
+	pipe->bytes_used -= bytes_read;
+	pipe->read_index += bytes_read;
+	if (pipe->read_index == pipe->size) {
+		pipe->read_index = 0;
+	}
+
+	_sched_lock();
+	irq_unlock(key);
+
+	_pipe_feed_buffer(pipe);
+
+	k_sched_unlock();
+
+	return 0;
+}
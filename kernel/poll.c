@@ -12,6 +12,11 @@
  * This polling mechanism allows waiting on multiple events concurrently,
  * either events triggered directly, or from kernel objects or other kernel
  * constructs.
+ *
+ * k_poll() registers its events with their objects for the duration of one
+ * call. A poll set keeps them registered across waits instead: an object
+ * signaling such an event leaves it in its list, and the set records the
+ * signal if its thread is not waiting at the time.
  */
 
 #include <kernel.h>
@@ -79,6 +84,30 @@ static inline int is_condition_met(struct k_poll_event *event, u32_t *state)
 			return 1;
 		}
 		break;
+	case K_POLL_TYPE_MSGQ_DATA_AVAILABLE:
+		if (event->msgq->used_msgs > 0) {
+			*state = K_POLL_STATE_MSGQ_DATA_AVAILABLE;
+			return 1;
+		}
+		break;
+	case K_POLL_TYPE_PIPE_DATA_AVAILABLE:
+		if (event->pipe->bytes_used > 0) {
+			*state = K_POLL_STATE_PIPE_DATA_AVAILABLE;
+			return 1;
+		}
+		break;
+	case K_POLL_TYPE_MUTEX_AVAILABLE:
+		if (event->mutex->lock_count == 0) {
+			*state = K_POLL_STATE_MUTEX_AVAILABLE;
+			return 1;
+		}
+		break;
+	case K_POLL_TYPE_TIMER_EXPIRED:
+		if (event->timer->status > 0) {
+			*state = K_POLL_STATE_TIMER_EXPIRED;
+			return 1;
+		}
+		break;
 	case K_POLL_TYPE_IGNORE:
 		return 0;
 	default:
@@ -113,29 +142,43 @@ static inline void add_event(sys_dlist_t *events, struct k_poll_event *event,
 	sys_dlist_append(events, &event->_node);
 }
 
-/* must be called with interrupts locked */
-static inline int register_event(struct k_poll_event *event,
-				 struct _poller *poller)
+/* returns the list of the object that signals @a event, NULL if none */
+static inline sys_dlist_t *event_poll_list(struct k_poll_event *event)
 {
+	__ASSERT(event->obj, "invalid object\n");
+
 	switch (event->type) {
 	case K_POLL_TYPE_SEM_AVAILABLE:
-		__ASSERT(event->sem, "invalid semaphore\n");
-		add_event(&event->sem->poll_events, event, poller);
-		break;
+		return &event->sem->poll_events;
 	case K_POLL_TYPE_DATA_AVAILABLE:
-		__ASSERT(event->queue, "invalid queue\n");
-		add_event(&event->queue->poll_events, event, poller);
-		break;
+		return &event->queue->poll_events;
 	case K_POLL_TYPE_SIGNAL:
-		__ASSERT(event->signal, "invalid poll signal\n");
-		add_event(&event->signal->poll_events, event, poller);
-		break;
+		return &event->signal->poll_events;
+	case K_POLL_TYPE_MSGQ_DATA_AVAILABLE:
+		return &event->msgq->poll_events;
+	case K_POLL_TYPE_PIPE_DATA_AVAILABLE:
+		return &event->pipe->poll_events;
+	case K_POLL_TYPE_MUTEX_AVAILABLE:
+		return &event->mutex->poll_events;
+	case K_POLL_TYPE_TIMER_EXPIRED:
+		return &event->timer->poll_events;
 	case K_POLL_TYPE_IGNORE:
 		/* nothing to do */
-		break;
+		return NULL;
 	default:
 		__ASSERT(0, "invalid event type\n");
-		break;
+		return NULL;
+	}
+}
+
+/* must be called with interrupts locked */
+static inline int register_event(struct k_poll_event *event,
+				 struct _poller *poller)
+{
+	sys_dlist_t *events = event_poll_list(event);
+
+	if (events) {
+		add_event(events, event, poller);
 	}
 
 	event->poller = poller;
@@ -148,25 +191,8 @@ static inline void clear_event_registration(struct k_poll_event *event)
 {
 	event->poller = NULL;
 
-	switch (event->type) {
-	case K_POLL_TYPE_SEM_AVAILABLE:
-		__ASSERT(event->sem, "invalid semaphore\n");
-		sys_dlist_remove(&event->_node);
-		break;
-	case K_POLL_TYPE_DATA_AVAILABLE:
-		__ASSERT(event->queue, "invalid queue\n");
+	if (event_poll_list(event)) {
 		sys_dlist_remove(&event->_node);
-		break;
-	case K_POLL_TYPE_SIGNAL:
-		__ASSERT(event->signal, "invalid poll signal\n");
-		sys_dlist_remove(&event->_node);
-		break;
-	case K_POLL_TYPE_IGNORE:
-		/* nothing to do */
-		break;
-	default:
-		__ASSERT(0, "invalid event type\n");
-		break;
 	}
 }
 
@@ -201,7 +227,7 @@ int k_poll(struct k_poll_event *events, int num_events, s32_t timeout)
 	set_polling_state(_current);
 	irq_unlock(key);
 
-	struct _poller poller = { .thread = _current };
+	struct _poller poller = { .thread = _current, .persistent = 0 };
 
 	/* find events whose condition is already fulfilled */
 	for (int ii = 0; ii < num_events; ii++) {
@@ -264,6 +290,36 @@ int k_poll(struct k_poll_event *events, int num_events, s32_t timeout)
 	return swap_rc;
 }
 
+/* must be called with interrupts locked */
+static int signal_persistent_event(struct k_poll_event *event, u32_t state,
+				   int *must_reschedule)
+{
+	struct _poller *poller = event->poller;
+	struct k_thread *thread = poller->thread;
+
+	event->state |= state;
+
+	/* a waiter whose timeout is being handled finds the signal next time */
+	if (!poller->waiting || !_is_thread_pending(thread) ||
+	    _is_thread_timeout_expired(thread)) {
+		poller->signaled = 1;
+		return 0;
+	}
+
+	poller->waiting = 0;
+	_unpend_thread(thread);
+	_abort_thread_timeout(thread);
+	_set_thread_return_value(thread,
+				 state == K_POLL_STATE_NOT_READY ? -EINTR : 0);
+
+	if (_is_thread_ready(thread)) {
+		_add_thread_to_ready_q(thread);
+		*must_reschedule = !_is_in_isr() && _must_switch_threads();
+	}
+
+	return 0;
+}
+
 /* must be called with interrupts locked */
 static int _signal_poll_event(struct k_poll_event *event, u32_t state,
 			      int *must_reschedule)
@@ -278,6 +334,10 @@ static int _signal_poll_event(struct k_poll_event *event, u32_t state,
 
 	__ASSERT(event->poller->thread, "poller should have a thread\n");
 
+	if (event->poller->persistent) {
+		return signal_persistent_event(event, state, must_reschedule);
+	}
+
 	clear_polling_state(thread);
 
 	if (!_is_thread_pending(thread)) {
@@ -305,18 +365,37 @@ ready_event:
 	return 0;
 }
 
-/* returns 1 if a reschedule must take place, 0 otherwise */
-int _handle_obj_poll_events(sys_dlist_t *events, u32_t state)
+/*
+ * Signals the first event of an object's list. An event registered by a poll
+ * set stays registered, but moves to the tail so that the object's other
+ * pollers get the next signals. Must be called with interrupts locked.
+ */
+static int signal_first_event(sys_dlist_t *events, u32_t state,
+			      int *must_reschedule)
 {
 	struct k_poll_event *poll_event;
-	int must_reschedule;
 
-	poll_event = (struct k_poll_event *)sys_dlist_get(events);
+	poll_event = (struct k_poll_event *)sys_dlist_peek_head(events);
 	if (!poll_event) {
+		*must_reschedule = 0;
 		return 0;
 	}
 
-	(void)_signal_poll_event(poll_event, state, &must_reschedule);
+	sys_dlist_remove(&poll_event->_node);
+
+	if (poll_event->poller && poll_event->poller->persistent) {
+		sys_dlist_append(events, &poll_event->_node);
+	}
+
+	return _signal_poll_event(poll_event, state, must_reschedule);
+}
+
+/* returns 1 if a reschedule must take place, 0 otherwise */
+int _handle_obj_poll_events(sys_dlist_t *events, u32_t state)
+{
+	int must_reschedule;
+
+	(void)signal_first_event(events, state, &must_reschedule);
 	return must_reschedule;
 }
 
@@ -330,20 +409,13 @@ void k_poll_signal_init(struct k_poll_signal *signal)
 int k_poll_signal(struct k_poll_signal *signal, int result)
 {
 	unsigned int key = irq_lock();
-	struct k_poll_event *poll_event;
 	int must_reschedule;
 
 	signal->result = result;
 	signal->signaled = 1;
 
-	poll_event = (struct k_poll_event *)sys_dlist_get(&signal->poll_events);
-	if (!poll_event) {
-		irq_unlock(key);
-		return 0;
-	}
-
-	int rc = _signal_poll_event(poll_event, K_POLL_STATE_SIGNALED,
-				    &must_reschedule);
+	int rc = signal_first_event(&signal->poll_events,
+				    K_POLL_STATE_SIGNALED, &must_reschedule);
 
 	if (must_reschedule) {
 		(void)_Swap(key);
@@ -353,3 +425,74 @@ int k_poll_signal(struct k_poll_signal *signal, int result)
 
 	return rc;
 }
+
+void k_poll_set_init(struct k_poll_set *set,
+		     struct k_poll_event *events, int num_events)
+{
+	__ASSERT(!_is_in_isr(), "");
+	__ASSERT(events, "NULL events\n");
+	__ASSERT(num_events > 0, "zero events\n");
+
+	unsigned int key;
+
+	set->poller.thread = _current;
+	set->poller.persistent = 1;
+	set->poller.waiting = 0;
+	set->poller.signaled = 0;
+	set->events = events;
+	set->num_events = num_events;
+
+	for (int ii = 0; ii < num_events; ii++) {
+		u32_t state;
+
+		key = irq_lock();
+		if (is_condition_met(&events[ii], &state)) {
+			events[ii].state |= state;
+			set->poller.signaled = 1;
+		}
+		(void)register_event(&events[ii], &set->poller);
+		irq_unlock(key);
+	}
+}
+
+int k_poll_set_wait(struct k_poll_set *set, s32_t timeout)
+{
+	__ASSERT(!_is_in_isr(), "");
+	__ASSERT(set->poller.thread == _current, "not the set's thread\n");
+
+	unsigned int key = irq_lock();
+
+	if (set->poller.signaled) {
+		set->poller.signaled = 0;
+		irq_unlock(key);
+		return 0;
+	}
+
+	if (timeout == K_NO_WAIT) {
+		irq_unlock(key);
+		return -EAGAIN;
+	}
+
+	_wait_q_t wait_q = _WAIT_Q_INIT(&wait_q);
+
+	set->poller.waiting = 1;
+	_pend_current_thread(&wait_q, timeout);
+
+	int swap_rc = _Swap(key);
+
+	/* still set if the wait timed out */
+	set->poller.waiting = 0;
+
+	return swap_rc;
+}
+
+void k_poll_set_cleanup(struct k_poll_set *set)
+{
+	unsigned int key;
+
+	for (int ii = 0; ii < set->num_events; ii++) {
+		key = irq_lock();
+		clear_event_registration(&set->events[ii]);
+		irq_unlock(key);
+	}
+}
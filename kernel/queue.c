@@ -20,6 +20,7 @@
 #include <ksched.h>
 #include <misc/slist.h>
 #include <init.h>
+#include <logging/tracing.h>
 
 extern struct k_queue _k_queue_list_start[];
 extern struct k_queue _k_queue_list_end[];
@@ -120,6 +121,8 @@ void k_queue_cancel_wait(struct k_queue *queue)
 
 void k_queue_insert(struct k_queue *queue, void *prev, void *data)
 {
+	SYS_TRACE(SYS_TRACE_QUEUE_PUT, 0, queue);
+
 	unsigned int key = irq_lock();
 #if !defined(CONFIG_POLL)
 	struct k_thread *first_pending_thread;
@@ -163,6 +166,8 @@ void k_queue_append_list(struct k_queue *queue, void *head, void *tail)
 {
 	__ASSERT(head && tail, "invalid head or tail");
 
+	SYS_TRACE(SYS_TRACE_QUEUE_PUT, 0, queue);
+
 	unsigned int key = irq_lock();
 #if !defined(CONFIG_POLL)
 	struct k_thread *first_thread, *thread;
@@ -249,6 +254,8 @@ void *k_queue_get(struct k_queue *queue, s32_t timeout)
 	unsigned int key;
 	void *data;
 
+	SYS_TRACE(SYS_TRACE_QUEUE_GET, 0, queue);
+
 	// irq_lock(): eflags 값
 	key = irq_lock();
 	// key: eflags 값
@@ -298,3 +305,95 @@ void *k_queue_get(struct k_queue *queue, s32_t timeout)
 	return _Swap(key) ? NULL : _current->base.swap_data;
 #endif /* CONFIG_POLL */
 }
+
+/* Move up to max items from the queue to list, called with irqs locked */
+static void queue_detach(struct k_queue *queue, sys_slist_t *list,
+			 unsigned int max)
+{
+	sys_snode_t *head = sys_slist_peek_head(&queue->data_q);
+	sys_snode_t *last = head;
+
+	if (!head || !max) {
+		return;
+	}
+
+	if (max == UINT_MAX) {
+		last = sys_slist_peek_tail(&queue->data_q);
+	} else {
+		while (--max && last != queue->data_q.tail) {
+			last = sys_slist_peek_next_no_check(last);
+		}
+	}
+
+	if (last == queue->data_q.tail) {
+		sys_slist_init(&queue->data_q);
+	} else {
+		queue->data_q.head = sys_slist_peek_next_no_check(last);
+		last->next = NULL;
+	}
+
+	sys_slist_append_list(list, head, last);
+}
+
+static int count_from(sys_slist_t *list, sys_snode_t *prev_tail)
+{
+	sys_snode_t *node;
+	int count = 0;
+
+	node = prev_tail ? sys_slist_peek_next_no_check(prev_tail) :
+			   sys_slist_peek_head(list);
+	for (; node; node = sys_slist_peek_next_no_check(node)) {
+		count++;
+	}
+
+	return count;
+}
+
+int k_queue_get_batch(struct k_queue *queue, sys_slist_t *list,
+		      unsigned int max, s32_t timeout)
+{
+	sys_snode_t *prev_tail = sys_slist_peek_tail(list);
+	unsigned int key;
+	void *data;
+
+	SYS_TRACE(SYS_TRACE_QUEUE_GET, 0, queue);
+
+	key = irq_lock();
+
+	if (likely(!sys_slist_is_empty(&queue->data_q)) || !max) {
+		queue_detach(queue, list, max);
+		irq_unlock(key);
+		/* Counting is left out of the locked section */
+		return count_from(list, prev_tail);
+	}
+
+	if (timeout == K_NO_WAIT) {
+		irq_unlock(key);
+		return 0;
+	}
+
+#if defined(CONFIG_POLL)
+	irq_unlock(key);
+
+	data = k_queue_poll(queue, timeout);
+#else
+	_pend_current_thread(&queue->wait_q, timeout);
+
+	data = _Swap(key) ? NULL : _current->base.swap_data;
+#endif /* CONFIG_POLL */
+
+	if (!data) {
+		return 0;
+	}
+
+	/* A producer that appended a list woke us up with its head; take
+	 * whatever it queued behind that in the same pass.
+	 */
+	sys_slist_append(list, data);
+
+	key = irq_lock();
+	queue_detach(queue, list, max - 1);
+	irq_unlock(key);
+
+	return count_from(list, prev_tail);
+}
@@ -0,0 +1,256 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ *
+ * @brief Kernel reader-writer lock object.
+ *
+ * The lock is held either by a count of readers or by a single writer.
+ * Readers and writers wait on separate, priority sorted, wait queues.
+ *
+ * A reader is let in while there is no writer, unless a writer waits with
+ * a priority at least as high as the reader's, so a stream of readers
+ * cannot starve writers. For the same reason, a released lock goes to the
+ * first waiting writer, except for the readers that outrank it.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <debug/object_tracing_common.h>
+#include <toolchain.h>
+#include <linker/sections.h>
+#include <wait_q.h>
+#include <misc/dlist.h>
+#include <ksched.h>
+#include <init.h>
+#include <syscall_handler.h>
+
+extern struct k_rwlock _k_rwlock_list_start[];
+extern struct k_rwlock _k_rwlock_list_end[];
+
+#ifdef CONFIG_OBJECT_TRACING
+
+struct k_rwlock *_trace_list_k_rwlock;
+
+/*
+ * Complete initialization of statically defined reader-writer locks.
+ */
+static int init_rwlock_module(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	struct k_rwlock *rwlock;
+
+	for (rwlock = _k_rwlock_list_start; rwlock < _k_rwlock_list_end;
+	     rwlock++) {
+		SYS_TRACING_OBJ_INIT(k_rwlock, rwlock);
+	}
+	return 0;
+}
+
+SYS_INIT(init_rwlock_module, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+
+#endif /* CONFIG_OBJECT_TRACING */
+
+void _impl_k_rwlock_init(struct k_rwlock *rwlock)
+{
+	sys_dlist_init(&rwlock->read_q);
+	sys_dlist_init(&rwlock->write_q);
+	rwlock->writer = NULL;
+	rwlock->readers = 0;
+
+	SYS_TRACING_OBJ_INIT(k_rwlock, rwlock);
+
+	_k_object_init(rwlock);
+}
+
+#ifdef CONFIG_USERSPACE
+_SYSCALL_HANDLER(k_rwlock_init, rwlock)
+{
+	_SYSCALL_OBJ_INIT(rwlock, K_OBJ_RWLOCK);
+	_impl_k_rwlock_init((struct k_rwlock *)rwlock);
+
+	return 0;
+}
+#endif
+
+/* returns 1 if a reader of priority @a prio may take the lock now */
+static int reader_may_enter(struct k_rwlock *rwlock, int prio)
+{
+	struct k_thread *writer;
+
+	if (rwlock->writer) {
+		return 0;
+	}
+
+	writer = _find_first_thread_to_unpend(&rwlock->write_q, NULL);
+
+	return !writer || _is_prio_higher(prio, writer->base.prio);
+}
+
+static void wake_waiter(struct k_thread *thread)
+{
+	_unpend_thread(thread);
+	(void)_abort_thread_timeout(thread);
+	_ready_thread(thread);
+	_set_thread_return_value(thread, 0);
+}
+
+/* returns the number of readers let in, must be called with irqs locked */
+static int wake_readers(struct k_rwlock *rwlock)
+{
+	struct k_thread *reader;
+	int woken = 0;
+
+	while (1) {
+		reader = _find_first_thread_to_unpend(&rwlock->read_q, NULL);
+		if (!reader || !reader_may_enter(rwlock, reader->base.prio)) {
+			return woken;
+		}
+
+		wake_waiter(reader);
+		rwlock->readers++;
+		woken++;
+	}
+}
+
+/* must be called with irqs locked */
+static void wake_writer(struct k_rwlock *rwlock)
+{
+	struct k_thread *writer;
+
+	writer = _find_first_thread_to_unpend(&rwlock->write_q, NULL);
+	if (writer) {
+		wake_waiter(writer);
+		rwlock->writer = writer;
+	}
+}
+
+int _impl_k_rwlock_read_lock(struct k_rwlock *rwlock, s32_t timeout)
+{
+	__ASSERT(!_is_in_isr(), "");
+
+	unsigned int key = irq_lock();
+
+	if (likely(reader_may_enter(rwlock, _current->base.prio))) {
+		rwlock->readers++;
+		irq_unlock(key);
+		return 0;
+	}
+
+	if (timeout == K_NO_WAIT) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	_pend_current_thread(&rwlock->read_q, timeout);
+
+	return _Swap(key);
+}
+
+#ifdef CONFIG_USERSPACE
+_SYSCALL_HANDLER(k_rwlock_read_lock, rwlock, timeout)
+{
+	_SYSCALL_OBJ(rwlock, K_OBJ_RWLOCK);
+	return _impl_k_rwlock_read_lock((struct k_rwlock *)rwlock, timeout);
+}
+#endif
+
+void _impl_k_rwlock_read_unlock(struct k_rwlock *rwlock)
+{
+	unsigned int key = irq_lock();
+
+	__ASSERT(rwlock->readers > 0, "");
+
+	rwlock->readers--;
+	if (rwlock->readers == 0) {
+		wake_writer(rwlock);
+	}
+
+	_reschedule_threads(key);
+}
+
+#ifdef CONFIG_USERSPACE
+_SYSCALL_HANDLER(k_rwlock_read_unlock, rwlock)
+{
+	struct k_rwlock *rw = (struct k_rwlock *)rwlock;
+
+	_SYSCALL_OBJ(rw, K_OBJ_RWLOCK);
+	_SYSCALL_VERIFY_MSG(rw->readers > 0, "rwlock not held for reading");
+	_impl_k_rwlock_read_unlock(rw);
+
+	return 0;
+}
+#endif
+
+int _impl_k_rwlock_write_lock(struct k_rwlock *rwlock, s32_t timeout)
+{
+	__ASSERT(!_is_in_isr(), "");
+	__ASSERT(rwlock->writer != _current, "");
+
+	unsigned int key = irq_lock();
+	int ret;
+
+	if (likely(!rwlock->writer && rwlock->readers == 0)) {
+		rwlock->writer = _current;
+		irq_unlock(key);
+		return 0;
+	}
+
+	if (timeout == K_NO_WAIT) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	_pend_current_thread(&rwlock->write_q, timeout);
+
+	ret = _Swap(key);
+	if (ret == 0) {
+		return 0;
+	}
+
+	/* readers held back by this writer may go now */
+	key = irq_lock();
+	wake_readers(rwlock);
+	_reschedule_threads(key);
+
+	return ret;
+}
+
+#ifdef CONFIG_USERSPACE
+_SYSCALL_HANDLER(k_rwlock_write_lock, rwlock, timeout)
+{
+	_SYSCALL_OBJ(rwlock, K_OBJ_RWLOCK);
+	return _impl_k_rwlock_write_lock((struct k_rwlock *)rwlock, timeout);
+}
+#endif
+
+void _impl_k_rwlock_write_unlock(struct k_rwlock *rwlock)
+{
+	unsigned int key = irq_lock();
+
+	__ASSERT(rwlock->writer == _current, "");
+
+	rwlock->writer = NULL;
+	if (!wake_readers(rwlock)) {
+		wake_writer(rwlock);
+	}
+
+	_reschedule_threads(key);
+}
+
+#ifdef CONFIG_USERSPACE
+_SYSCALL_HANDLER(k_rwlock_write_unlock, rwlock)
+{
+	struct k_rwlock *rw = (struct k_rwlock *)rwlock;
+
+	_SYSCALL_OBJ(rw, K_OBJ_RWLOCK);
+	_SYSCALL_VERIFY_MSG(rw->writer == _current,
+			    "rwlock not held for writing by caller");
+	_impl_k_rwlock_write_unlock(rw);
+
+	return 0;
+}
+#endif
@@ -10,6 +10,8 @@
 #include <ksched.h>
 #include <wait_q.h>
 #include <misc/util.h>
+#include <misc/stack.h>
+#include <logging/tracing.h>
 #include <syscall_handler.h>
 
 /* the only struct _kernel instance */
@@ -135,6 +137,12 @@ static struct k_thread *_get_ready_q_head(void)
 // thread: &(&k_sys_work_q)->thread
 void _add_thread_to_ready_q(struct k_thread *thread)
 {
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	/* the running thread keeps its switch in time */
+	if (thread != _current) {
+		thread->rt_stamp = k_cycle_get_32();
+	}
+#endif
 #ifdef CONFIG_MULTITHREADING // CONFIG_MULTITHREADING=y
 	// thread->base.prio: (&_main_thread_s)->base.prio: 0
 	// _get_ready_q_q_index(0): 16
@@ -701,3 +709,70 @@ int _impl_k_is_preempt_thread(void)
 #ifdef CONFIG_USERSPACE
 _SYSCALL_HANDLER0_SIMPLE(k_is_preempt_thread);
 #endif
+
+#if defined(CONFIG_THREAD_RUNTIME_STATS) || defined(CONFIG_TRACING)
+/*
+ * Called by the architecture's context switch code, with interrupts locked,
+ * while _current is still the outgoing thread and the ready queue cache
+ * holds the incoming one.
+ */
+void _sched_switch_hook(void)
+{
+	struct k_thread *next = _ready_q.cache;
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	struct k_thread *prev = _current;
+	u32_t now = k_cycle_get_32();
+
+	prev->rt_stats.execution_cycles += now - prev->rt_stamp;
+	prev->rt_stats.switches_out++;
+	/* starts its wait in the ready queue, if it is still there */
+	prev->rt_stamp = now;
+
+	next->rt_stats.ready_cycles += now - next->rt_stamp;
+	next->rt_stats.switches_in++;
+	next->rt_stamp = now;
+#endif
+
+	SYS_TRACE(SYS_TRACE_THREAD_SWITCHED_IN, 0, next);
+}
+#endif
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+
+int _impl_k_thread_runtime_stats_get(k_tid_t thread,
+				     struct k_thread_runtime_stats *stats)
+{
+	unsigned int key = irq_lock();
+	u32_t elapsed = k_cycle_get_32() - thread->rt_stamp;
+
+	*stats = thread->rt_stats;
+	if (thread == _current) {
+		stats->execution_cycles += elapsed;
+	} else if (_is_thread_ready(thread)) {
+		stats->ready_cycles += elapsed;
+	}
+
+	irq_unlock(key);
+
+#if defined(CONFIG_INIT_STACKS) && defined(CONFIG_THREAD_STACK_INFO)
+	stats->stack_peak = thread->stack_info.size -
+		stack_unused_space_get((char *)thread->stack_info.start,
+				       thread->stack_info.size);
+#else
+	stats->stack_peak = 0;
+#endif
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+_SYSCALL_HANDLER(k_thread_runtime_stats_get, thread, stats)
+{
+	_SYSCALL_OBJ(thread, K_OBJ_THREAD);
+	_SYSCALL_MEMORY_WRITE(stats, sizeof(struct k_thread_runtime_stats));
+
+	return _impl_k_thread_runtime_stats_get((k_tid_t)thread,
+				(struct k_thread_runtime_stats *)stats);
+}
+#endif
+#endif /* CONFIG_THREAD_RUNTIME_STATS */
@@ -27,6 +27,7 @@
 #include <ksched.h>
 #include <init.h>
 #include <syscall_handler.h>
+#include <logging/tracing.h>
 
 extern struct k_sem _k_sem_list_start[];
 extern struct k_sem _k_sem_list_end[];
@@ -144,6 +145,8 @@ void _impl_k_sem_give(struct k_sem *sem)
 {
 	unsigned int key;
 
+	SYS_TRACE(SYS_TRACE_SEM_GIVE, 0, sem);
+
 	key = irq_lock();
 
 	if (do_sem_give(sem)) {
@@ -161,6 +164,8 @@ int _impl_k_sem_take(struct k_sem *sem, s32_t timeout)
 {
 	__ASSERT(!_is_in_isr() || timeout == K_NO_WAIT, "");
 
+	SYS_TRACE(SYS_TRACE_SEM_TAKE, 0, sem);
+
 	unsigned int key = irq_lock();
 
 	if (likely(sem->count > 0)) {
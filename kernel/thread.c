@@ -12,6 +12,7 @@
  */
 
 #include <kernel.h>
+#include <string.h>
 
 #include <toolchain.h>
 #include <linker/sections.h>
@@ -366,10 +367,18 @@ void _setup_new_thread(struct k_thread *new_thread,
 {
 	_new_thread(new_thread, stack, stack_size, entry, p1, p2, p3,
 		    prio, options);
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	memset(&new_thread->rt_stats, 0, sizeof(new_thread->rt_stats));
+#endif
+	sys_dlist_init(&new_thread->held_mutexes);
+	new_thread->pended_mutex = NULL;
 #ifdef CONFIG_USERSPACE
 	_k_object_init(new_thread);
 	_k_object_init(stack);
 	new_thread->stack_obj = stack;
+#ifdef CONFIG_KOBJECT_VALIDATION_CACHE
+	new_thread->kobj_cache.obj = NULL;
+#endif
 
 	/* Any given thread has access to itself */
 	k_object_access_grant(new_thread, new_thread);
@@ -68,6 +68,14 @@ void _timer_expiration_handler(struct _timeout *t)
 		timer->expiry_fn(timer);
 	}
 
+#ifdef CONFIG_POLL
+	/* the thread is switched in when timeouts are done with */
+	key = irq_lock();
+	(void)_handle_obj_poll_events(&timer->poll_events,
+				      K_POLL_STATE_TIMER_EXPIRED);
+	irq_unlock(key);
+#endif
+
 	thread = (struct k_thread *)sys_dlist_peek_head(&timer->wait_q);
 
 	if (!thread) {
@@ -100,6 +108,9 @@ void k_timer_init(struct k_timer *timer,
 	timer->status = 0;
 
 	sys_dlist_init(&timer->wait_q);
+#if defined(CONFIG_POLL)
+	sys_dlist_init(&timer->poll_events);
+#endif
 	_init_timeout(&timer->timeout, _timer_expiration_handler);
 	SYS_TRACING_OBJ_INIT(k_timer, timer);
 
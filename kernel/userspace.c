@@ -27,12 +27,16 @@ const char *otype_to_str(enum k_objects otype)
 	/* Core kernel objects */
 	case K_OBJ_ALERT:
 		return "k_alert";
+	case K_OBJ_EVENT:
+		return "k_event";
 	case K_OBJ_MSGQ:
 		return "k_msgq";
 	case K_OBJ_MUTEX:
 		return "k_mutex";
 	case K_OBJ_PIPE:
 		return "k_pipe";
+	case K_OBJ_RWLOCK:
+		return "k_rwlock";
 	case K_OBJ_SEM:
 		return "k_sem";
 	case K_OBJ_STACK:
@@ -86,6 +90,161 @@ const char *otype_to_str(enum k_objects otype)
 #endif
 }
 
+#ifdef CONFIG_KOBJECT_VALIDATION_CACHE
+atomic_t _k_object_gen;
+#endif
+
+#ifdef CONFIG_DYNAMIC_OBJECTS
+/*
+ * Objects allocated at runtime carry their metadata in front of them and
+ * are chained in a small hash table keyed by object address. Lookups try
+ * the build-time gperf table first, so statically declared objects are
+ * found as fast as without dynamic objects.
+ */
+struct dyn_obj {
+	struct _k_object kobj;
+	sys_snode_t node;
+	u8_t data[] __aligned(8); /* The object itself */
+};
+
+#define DYN_OBJ_BUCKETS BIT(CONFIG_DYNAMIC_OBJECTS_HASH_BITS)
+
+static sys_slist_t dyn_obj_table[DYN_OBJ_BUCKETS];
+
+static inline sys_slist_t *dyn_obj_bucket(void *obj)
+{
+	/* Fibonacci hashing; allocations are 8-byte aligned */
+	u32_t key = (u32_t)((uintptr_t)obj >> 3) * 2654435761U;
+
+	return &dyn_obj_table[key >> (32 - CONFIG_DYNAMIC_OBJECTS_HASH_BITS)];
+}
+
+static size_t obj_size_get(enum k_objects otype)
+{
+	switch (otype) {
+	case K_OBJ_ALERT:
+		return sizeof(struct k_alert);
+	case K_OBJ_EVENT:
+		return sizeof(struct k_event);
+	case K_OBJ_MSGQ:
+		return sizeof(struct k_msgq);
+	case K_OBJ_MUTEX:
+		return sizeof(struct k_mutex);
+	case K_OBJ_PIPE:
+		return sizeof(struct k_pipe);
+	case K_OBJ_RWLOCK:
+		return sizeof(struct k_rwlock);
+	case K_OBJ_SEM:
+		return sizeof(struct k_sem);
+	case K_OBJ_STACK:
+		return sizeof(struct k_stack);
+	case K_OBJ_TIMER:
+		return sizeof(struct k_timer);
+	default:
+		/* Threads need a permission index assigned at build time */
+		return 0;
+	}
+}
+
+/* Must be called with interrupts locked */
+static struct dyn_obj *dyn_object_find(void *obj)
+{
+	struct dyn_obj *dyn;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(dyn_obj_bucket(obj), dyn, node) {
+		if (dyn->kobj.name == obj) {
+			return dyn;
+		}
+	}
+
+	return NULL;
+}
+
+struct _k_object *_k_object_find(void *obj)
+{
+	struct _k_object *ko;
+	struct dyn_obj *dyn;
+	unsigned int key;
+
+	ko = _k_object_gperf_find(obj);
+	if (ko) {
+		return ko;
+	}
+
+	key = irq_lock();
+	dyn = dyn_object_find(obj);
+	irq_unlock(key);
+
+	return dyn ? &dyn->kobj : NULL;
+}
+
+void _k_object_wordlist_foreach(_wordlist_cb_func_t func, void *context)
+{
+	struct dyn_obj *dyn;
+	unsigned int key;
+	int i;
+
+	_k_object_gperf_wordlist_foreach(func, context);
+
+	key = irq_lock();
+	for (i = 0; i < DYN_OBJ_BUCKETS; i++) {
+		SYS_SLIST_FOR_EACH_CONTAINER(&dyn_obj_table[i], dyn, node) {
+			func(&dyn->kobj, context);
+		}
+	}
+	irq_unlock(key);
+}
+
+void *_impl_k_object_alloc(enum k_objects otype)
+{
+	size_t size = obj_size_get(otype);
+	struct dyn_obj *dyn;
+	unsigned int key;
+
+	if (!size) {
+		return NULL;
+	}
+
+	dyn = k_malloc(sizeof(*dyn) + size);
+	if (!dyn) {
+		return NULL;
+	}
+
+	memset(&dyn->kobj, 0, sizeof(dyn->kobj));
+	dyn->kobj.name = (char *)dyn->data;
+	dyn->kobj.type = otype;
+
+	/* The caller owns what it allocates */
+	_thread_perms_set(&dyn->kobj, _current);
+
+	key = irq_lock();
+	sys_slist_append(dyn_obj_bucket(dyn->data), &dyn->node);
+	irq_unlock(key);
+
+	return dyn->data;
+}
+
+void k_object_free(void *obj)
+{
+	struct dyn_obj *dyn;
+	unsigned int key;
+
+	key = irq_lock();
+	dyn = dyn_object_find(obj);
+	if (dyn) {
+		sys_slist_find_and_remove(dyn_obj_bucket(obj), &dyn->node);
+	}
+	irq_unlock(key);
+
+	if (dyn) {
+#ifdef CONFIG_KOBJECT_VALIDATION_CACHE
+		_k_object_cache_flush();
+#endif
+		k_free(dyn);
+	}
+}
+#endif /* CONFIG_DYNAMIC_OBJECTS */
+
 struct perm_ctx {
 	int parent_id;
 	int child_id;
@@ -143,6 +302,9 @@ void _thread_perms_clear(struct _k_object *ko, struct k_thread *thread)
 
 	if (index != -1) {
 		sys_bitfield_clear_bit((mem_addr_t)&ko->perms, index);
+#ifdef CONFIG_KOBJECT_VALIDATION_CACHE
+		_k_object_cache_flush();
+#endif
 	}
 }
 
@@ -159,6 +321,9 @@ void _thread_perms_all_clear(struct k_thread *thread)
 
 	if (index != -1) {
 		_k_object_wordlist_foreach(clear_perms_cb, (void *)index);
+#ifdef CONFIG_KOBJECT_VALIDATION_CACHE
+		_k_object_cache_flush();
+#endif
 	}
 }
 
@@ -300,6 +465,9 @@ void _k_object_uninit(void *object)
 	}
 
 	ko->flags &= ~K_OBJ_FLAG_INITIALIZED;
+#ifdef CONFIG_KOBJECT_VALIDATION_CACHE
+	_k_object_cache_flush();
+#endif
 }
 
 static u32_t _handler_bad_syscall(u32_t bad_id, u32_t arg2, u32_t arg3,
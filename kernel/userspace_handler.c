@@ -58,3 +58,10 @@ _SYSCALL_HANDLER(k_object_access_revoke, object, thread)
 
 	return 0;
 }
+
+#ifdef CONFIG_DYNAMIC_OBJECTS
+_SYSCALL_HANDLER(k_object_alloc, otype)
+{
+	return (u32_t)_impl_k_object_alloc(otype);
+}
+#endif
@@ -0,0 +1,294 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ *
+ * Workqueue pool support functions
+ */
+
+#include <kernel_structs.h>
+#include <ksched.h>
+#include <nano_internal.h>
+#include <string.h>
+
+/*
+ * The pool semaphore holds one token per queued item. A worker takes a
+ * token before it looks for an item, first in its own queue and then in
+ * the queues of the other workers, so whichever worker wakes up first can
+ * run any pending item. Canceled items leave a stale token behind, which
+ * only causes one empty pass of a worker.
+ */
+
+static inline struct k_work_pool_worker *
+current_worker(struct k_work_pool *pool)
+{
+	struct k_work_pool_worker *w;
+
+	if (k_is_in_isr()) {
+		return NULL;
+	}
+
+	w = CONTAINER_OF(_current, struct k_work_pool_worker, thread);
+	if (w < pool->workers || w >= pool->workers + pool->num_workers) {
+		return NULL;
+	}
+
+	return w;
+}
+
+static struct k_work *pool_take(struct k_work_pool_worker *self)
+{
+	struct k_work_pool *pool = self->pool;
+	u8_t idx = self - pool->workers;
+	sys_snode_t *node;
+	int key, i;
+
+	key = irq_lock();
+
+	node = sys_slist_get(&self->queue);
+	for (i = 1; !node && i < pool->num_workers; i++) {
+		struct k_work_pool_worker *victim;
+
+		victim = &pool->workers[(idx + i) % pool->num_workers];
+		node = sys_slist_get(&victim->queue);
+#ifdef CONFIG_WORK_POOL_STATS
+		if (node) {
+			pool->stats.stolen++;
+		}
+#endif
+	}
+
+	irq_unlock(key);
+
+	return (struct k_work *)node;
+}
+
+#ifdef CONFIG_WORK_POOL_STATS
+static void stats_update(struct k_work_pool *pool, u32_t wait, u32_t run)
+{
+	int key = irq_lock();
+
+	pool->stats.completed++;
+	pool->stats.wait_total += wait;
+	pool->stats.run_total += run;
+
+	if (wait > pool->stats.wait_max) {
+		pool->stats.wait_max = wait;
+	}
+
+	if (run > pool->stats.run_max) {
+		pool->stats.run_max = run;
+	}
+
+	irq_unlock(key);
+}
+#endif
+
+static void work_pool_main(void *worker_ptr, void *p2, void *p3)
+{
+	struct k_work_pool_worker *self = worker_ptr;
+	struct k_work_pool *pool = self->pool;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		struct k_work *work;
+		k_work_handler_t handler;
+#ifdef CONFIG_WORK_POOL_STATS
+		u32_t start, wait;
+#endif
+
+		k_sem_take(&pool->sem, K_FOREVER);
+
+		work = pool_take(self);
+		if (!work) {
+			continue;
+		}
+
+		handler = work->handler;
+
+#ifdef CONFIG_WORK_POOL_STATS
+		/* Read before the item can be resubmitted */
+		start = k_cycle_get_32();
+		wait = start - work->submit_time;
+#endif
+
+		/* Reset pending state so it can be resubmitted by handler */
+		if (atomic_test_and_clear_bit(work->flags,
+					      K_WORK_STATE_PENDING)) {
+			handler(work);
+		}
+
+#ifdef CONFIG_WORK_POOL_STATS
+		stats_update(pool, wait, k_cycle_get_32() - start);
+#endif
+
+		/* Cooperative workers would otherwise keep the CPU for as
+		 * long as items are queued.
+		 */
+		if (_is_coop(_current)) {
+			k_yield();
+		}
+	}
+}
+
+void k_work_pool_init(struct k_work_pool *pool,
+		      struct k_work_pool_worker *workers, u8_t num_workers)
+{
+	int i;
+
+	__ASSERT(num_workers, "pool needs at least one worker");
+
+	k_sem_init(&pool->sem, 0, UINT_MAX);
+	pool->workers = workers;
+	pool->num_workers = num_workers;
+	pool->next = 0;
+
+	for (i = 0; i < num_workers; i++) {
+		sys_slist_init(&workers[i].queue);
+		workers[i].pool = pool;
+	}
+
+#ifdef CONFIG_WORK_POOL_STATS
+	memset(&pool->stats, 0, sizeof(pool->stats));
+#endif
+}
+
+void k_work_pool_start_worker(struct k_work_pool *pool, u8_t idx,
+			      k_thread_stack_t *stack, size_t stack_size,
+			      int prio)
+{
+	struct k_work_pool_worker *w = &pool->workers[idx];
+
+	__ASSERT(idx < pool->num_workers, "invalid worker %u", idx);
+
+	w->pool = pool;
+
+	k_thread_create(&w->thread, stack, stack_size, work_pool_main,
+			w, 0, 0, prio, 0, 0);
+}
+
+void k_work_pool_submit(struct k_work_pool *pool, struct k_work *work)
+{
+	struct k_work_pool_worker *w;
+	int key;
+
+	if (atomic_test_and_set_bit(work->flags, K_WORK_STATE_PENDING)) {
+		return;
+	}
+
+#ifdef CONFIG_WORK_POOL_STATS
+	work->submit_time = k_cycle_get_32();
+#endif
+
+	key = irq_lock();
+
+	/* Work spawned by a worker stays local, the rest is spread */
+	w = current_worker(pool);
+	if (!w) {
+		w = &pool->workers[pool->next];
+		pool->next = (pool->next + 1) % pool->num_workers;
+	}
+
+	sys_slist_append(&w->queue, (sys_snode_t *)work);
+
+	irq_unlock(key);
+
+	k_sem_give(&pool->sem);
+}
+
+bool _k_work_pool_remove(struct k_work_pool *pool, struct k_work *work)
+{
+	bool removed = false;
+	int key, i;
+
+	key = irq_lock();
+
+	for (i = 0; !removed && i < pool->num_workers; i++) {
+		removed = sys_slist_find_and_remove(&pool->workers[i].queue,
+						    (sys_snode_t *)work);
+	}
+
+	irq_unlock(key);
+
+	return removed;
+}
+
+static void class_run(struct k_work *runner)
+{
+	struct k_work_class *cls = CONTAINER_OF(runner, struct k_work_class,
+						runner);
+	struct k_work *work;
+	int key;
+
+	key = irq_lock();
+	work = (struct k_work *)sys_slist_get(&cls->queue);
+	irq_unlock(key);
+
+	if (work) {
+		k_work_handler_t handler = work->handler;
+
+		if (atomic_test_and_clear_bit(work->flags,
+					      K_WORK_STATE_PENDING)) {
+			handler(work);
+		}
+	}
+
+	/* Run one item per pass so that other work gets in between */
+	key = irq_lock();
+
+	if (sys_slist_is_empty(&cls->queue)) {
+		cls->active = false;
+	} else {
+		k_work_pool_submit(cls->pool, &cls->runner);
+	}
+
+	irq_unlock(key);
+}
+
+void k_work_class_init(struct k_work_class *cls, struct k_work_pool *pool)
+{
+	k_work_init(&cls->runner, class_run);
+	sys_slist_init(&cls->queue);
+	cls->pool = pool;
+	cls->active = false;
+}
+
+void k_work_class_submit(struct k_work_class *cls, struct k_work *work)
+{
+	int key;
+
+	if (atomic_test_and_set_bit(work->flags, K_WORK_STATE_PENDING)) {
+		return;
+	}
+
+	key = irq_lock();
+
+	sys_slist_append(&cls->queue, (sys_snode_t *)work);
+
+	if (!cls->active) {
+		cls->active = true;
+		k_work_pool_submit(cls->pool, &cls->runner);
+	}
+
+	irq_unlock(key);
+}
+
+#ifdef CONFIG_WORK_POOL_STATS
+void k_work_pool_stats_get(struct k_work_pool *pool,
+			   struct k_work_pool_stats *stats, bool reset)
+{
+	int key = irq_lock();
+
+	*stats = pool->stats;
+
+	if (reset) {
+		memset(&pool->stats, 0, sizeof(pool->stats));
+	}
+
+	irq_unlock(key);
+}
+#endif
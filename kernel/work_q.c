@@ -13,6 +13,7 @@
 
 #include <kernel_structs.h>
 #include <wait_q.h>
+#include <nano_internal.h>
 #include <errno.h>
 
 // KID 20170717
@@ -138,11 +139,24 @@ void k_work_q_start(struct k_work_q *work_q, k_thread_stack_t *stack,
 }
 
 #ifdef CONFIG_SYS_CLOCK_EXISTS
+#ifdef CONFIG_WORK_POOL
+#define delayed_work_pool(w) ((w)->work_pool)
+#else
+#define delayed_work_pool(w) NULL
+#endif
+
 static void work_timeout(struct _timeout *t)
 {
 	struct k_delayed_work *w = CONTAINER_OF(t, struct k_delayed_work,
 						   timeout);
 
+#ifdef CONFIG_WORK_POOL
+	if (w->work_pool) {
+		k_work_pool_submit(w->work_pool, &w->work);
+		return;
+	}
+#endif
+
 	/* submit work to workqueue */
 	k_work_submit_to_queue(w->work_q, &w->work);
 }
@@ -152,25 +166,30 @@ void k_delayed_work_init(struct k_delayed_work *work, k_work_handler_t handler)
 	k_work_init(&work->work, handler);
 	_init_timeout(&work->timeout, work_timeout);
 	work->work_q = NULL;
+#ifdef CONFIG_WORK_POOL
+	work->work_pool = NULL;
+#endif
 
 	_k_object_init(work);
 }
 
-int k_delayed_work_submit_to_queue(struct k_work_q *work_q,
-				   struct k_delayed_work *work,
-				   s32_t delay)
+static int delayed_work_submit(struct k_work_q *work_q,
+			       struct k_work_pool *work_pool,
+			       struct k_delayed_work *work, s32_t delay)
 {
 	int key = irq_lock();
 	int err;
 
 	/* Work cannot be active in multiple queues */
-	if (work->work_q && work->work_q != work_q) {
+	if ((work->work_q && work->work_q != work_q) ||
+	    (delayed_work_pool(work) && delayed_work_pool(work) != work_pool)) {
 		err = -EADDRINUSE;
 		goto done;
 	}
 
 	/* Cancel if work has been submitted */
-	if (work->work_q == work_q) {
+	if ((work_q && work->work_q == work_q) ||
+	    (work_pool && delayed_work_pool(work) == work_pool)) {
 		err = k_delayed_work_cancel(work);
 		if (err < 0) {
 			goto done;
@@ -179,10 +198,13 @@ int k_delayed_work_submit_to_queue(struct k_work_q *work_q,
 
 	/* Attach workqueue so the timeout callback can submit it */
 	work->work_q = work_q;
+#ifdef CONFIG_WORK_POOL
+	work->work_pool = work_pool;
+#endif
 
 	if (!delay) {
 		/* Submit work if no ticks is 0 */
-		k_work_submit_to_queue(work_q, &work->work);
+		work_timeout(&work->timeout);
 	} else {
 		/* Add timeout */
 		_add_timeout(NULL, &work->timeout, NULL,
@@ -197,18 +219,42 @@ done:
 	return err;
 }
 
+int k_delayed_work_submit_to_queue(struct k_work_q *work_q,
+				   struct k_delayed_work *work,
+				   s32_t delay)
+{
+	return delayed_work_submit(work_q, NULL, work, delay);
+}
+
+#ifdef CONFIG_WORK_POOL
+int k_delayed_work_submit_to_pool(struct k_work_pool *pool,
+				  struct k_delayed_work *work,
+				  s32_t delay)
+{
+	return delayed_work_submit(NULL, pool, work, delay);
+}
+#endif
+
 int k_delayed_work_cancel(struct k_delayed_work *work)
 {
 	int key = irq_lock();
 
-	if (!work->work_q) {
+	if (!work->work_q && !delayed_work_pool(work)) {
 		irq_unlock(key);
 		return -EINVAL;
 	}
 
 	if (k_work_pending(&work->work)) {
 		/* Remove from the queue if already submitted */
-		if (!k_queue_remove(&work->work_q->queue, &work->work)) {
+#ifdef CONFIG_WORK_POOL
+		if (work->work_pool &&
+		    !_k_work_pool_remove(work->work_pool, &work->work)) {
+			irq_unlock(key);
+			return -EINVAL;
+		}
+#endif
+		if (work->work_q &&
+		    !k_queue_remove(&work->work_q->queue, &work->work)) {
 			irq_unlock(key);
 			return -EINVAL;
 		}
@@ -218,6 +264,9 @@ int k_delayed_work_cancel(struct k_delayed_work *work)
 
 	/* Detach from workqueue */
 	work->work_q = NULL;
+#ifdef CONFIG_WORK_POOL
+	work->work_pool = NULL;
+#endif
 
 	irq_unlock(key);
 
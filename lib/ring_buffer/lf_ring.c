@@ -0,0 +1,253 @@
+/* lf_ring.c: Lock-free element ring buffer */
+
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lf_ring.h>
+#include <string.h>
+
+/*
+ * Single producer: the producer owns tail and the consumer owns head, so
+ * each side only reads the other's index and publishes its own with a
+ * plain atomic store.
+ *
+ * Multiple producers: space is reserved by moving reserve forward with a
+ * compare-and-swap. Every producer increments pending before it looks at
+ * reserve and decrements it when it is done. The producer that brings
+ * pending back to zero then reads reserve and checks pending once more:
+ * any reservation it read was made by a producer that raised pending
+ * first, so if pending is still zero all of them have been filled and
+ * tail can be moved up to it. If pending is not zero, a new producer got
+ * in and publishes on its own way out. Nobody ever waits for another
+ * producer, so a preempted producer (or an ISR interrupting one) only
+ * delays visibility of the data, never progress of the writers.
+ */
+
+static inline bool is_multi_producer(struct sys_lf_ring *ring)
+{
+	return (ring->flags & SYS_LF_RING_MULTI_PRODUCER) != 0;
+}
+
+static inline u8_t *elem_ptr(struct sys_lf_ring *ring, u32_t idx)
+{
+	return ring->buf + (idx & ring->mask) * ring->elem_size;
+}
+
+static void copy_in(struct sys_lf_ring *ring, u32_t idx, const u8_t *src,
+		    u32_t count)
+{
+	u32_t first = min(count, sys_lf_ring_capacity(ring) -
+			  (idx & ring->mask));
+
+	memcpy(elem_ptr(ring, idx), src, first * ring->elem_size);
+	if (count > first) {
+		memcpy(ring->buf, src + first * ring->elem_size,
+		       (count - first) * ring->elem_size);
+	}
+}
+
+static void copy_out(struct sys_lf_ring *ring, u32_t idx, u8_t *dst,
+		     u32_t count)
+{
+	u32_t first = min(count, sys_lf_ring_capacity(ring) -
+			  (idx & ring->mask));
+
+	memcpy(dst, elem_ptr(ring, idx), first * ring->elem_size);
+	if (count > first) {
+		memcpy(dst + first * ring->elem_size, ring->buf,
+		       (count - first) * ring->elem_size);
+	}
+}
+
+static void mp_leave(struct sys_lf_ring *ring)
+{
+	u32_t end, tail;
+
+	if (atomic_dec(&ring->pending) != 1) {
+		return;
+	}
+
+	/* Reading reserve before the decrement would miss the reservations
+	 * of producers that leave meanwhile, reading it after could take in
+	 * an unfilled one unless nobody has come in since.
+	 */
+	end = (u32_t)atomic_get(&ring->reserve);
+	if (atomic_get(&ring->pending)) {
+		return;
+	}
+
+	/* Everything up to end has been written. A later producer may
+	 * already have published past it, so tail only ever moves forward.
+	 */
+	do {
+		tail = (u32_t)atomic_get(&ring->tail);
+		if ((s32_t)(end - tail) <= 0) {
+			return;
+		}
+	} while (!atomic_cas(&ring->tail, (atomic_val_t)tail,
+			     (atomic_val_t)end));
+}
+
+/*
+ * Enter the ring and reserve up to count elements, optionally without
+ * wrapping. On success the caller leaves with mp_leave() once the elements
+ * are written. A producer finding the ring full does not enter, so that
+ * producers spinning on a full ring cannot keep the last one in from
+ * publishing what the consumer is waiting for.
+ */
+static u32_t mp_reserve(struct sys_lf_ring *ring, u32_t count,
+			bool contiguous, u32_t *start)
+{
+	u32_t pos, n;
+
+	if (!sys_lf_ring_space_get(ring)) {
+		return 0;
+	}
+
+	atomic_inc(&ring->pending);
+
+	do {
+		pos = (u32_t)atomic_get(&ring->reserve);
+		n = sys_lf_ring_capacity(ring) -
+		    (pos - (u32_t)atomic_get(&ring->head));
+		if (contiguous) {
+			n = min(n, sys_lf_ring_capacity(ring) -
+				(pos & ring->mask));
+		}
+
+		n = min(n, count);
+		if (!n) {
+			mp_leave(ring);
+			return 0;
+		}
+	} while (!atomic_cas(&ring->reserve, (atomic_val_t)pos,
+			     (atomic_val_t)(pos + n)));
+
+	*start = pos;
+
+	return n;
+}
+
+u32_t sys_lf_ring_put(struct sys_lf_ring *ring, const void *data,
+		      u32_t count)
+{
+	u32_t tail, n;
+
+	if (is_multi_producer(ring)) {
+		n = mp_reserve(ring, count, false, &tail);
+		if (n) {
+			copy_in(ring, tail, data, n);
+			mp_leave(ring);
+		}
+
+		return n;
+	}
+
+	tail = (u32_t)atomic_get(&ring->tail);
+	n = min(count, sys_lf_ring_space_get(ring));
+	if (!n) {
+		return 0;
+	}
+
+	copy_in(ring, tail, data, n);
+	atomic_set(&ring->tail, (atomic_val_t)(tail + n));
+
+	return n;
+}
+
+u32_t sys_lf_ring_get(struct sys_lf_ring *ring, void *data, u32_t count)
+{
+	u32_t head = (u32_t)atomic_get(&ring->head);
+	u32_t n;
+
+	n = min(count, sys_lf_ring_used_get(ring));
+	if (!n) {
+		return 0;
+	}
+
+	copy_out(ring, head, data, n);
+	atomic_set(&ring->head, (atomic_val_t)(head + n));
+
+	return n;
+}
+
+u32_t sys_lf_ring_put_claim(struct sys_lf_ring *ring, void **data,
+			    u32_t count)
+{
+	u32_t tail, n;
+
+	if (is_multi_producer(ring)) {
+		n = mp_reserve(ring, count, true, &tail);
+		if (!n) {
+			return 0;
+		}
+
+		/* pending stays raised until sys_lf_ring_put_finish() */
+		*data = elem_ptr(ring, tail);
+
+		return n;
+	}
+
+	tail = (u32_t)atomic_get(&ring->tail);
+	n = min(count, sys_lf_ring_space_get(ring));
+	n = min(n, sys_lf_ring_capacity(ring) - (tail & ring->mask));
+
+	*data = elem_ptr(ring, tail);
+
+	return n;
+}
+
+int sys_lf_ring_put_finish(struct sys_lf_ring *ring, u32_t count)
+{
+	u32_t tail;
+
+	if (is_multi_producer(ring)) {
+		/* The claimed span was reserved up front and is committed
+		 * whole. A claim of nothing never entered the ring, so there
+		 * is nothing to leave.
+		 */
+		if (count) {
+			mp_leave(ring);
+		}
+
+		return 0;
+	}
+
+	if (count > sys_lf_ring_space_get(ring)) {
+		return -EINVAL;
+	}
+
+	tail = (u32_t)atomic_get(&ring->tail);
+	atomic_set(&ring->tail, (atomic_val_t)(tail + count));
+
+	return 0;
+}
+
+u32_t sys_lf_ring_get_claim(struct sys_lf_ring *ring, void **data,
+			    u32_t count)
+{
+	u32_t head = (u32_t)atomic_get(&ring->head);
+	u32_t n;
+
+	n = min(count, sys_lf_ring_used_get(ring));
+	n = min(n, sys_lf_ring_capacity(ring) - (head & ring->mask));
+
+	*data = elem_ptr(ring, head);
+
+	return n;
+}
+
+int sys_lf_ring_get_finish(struct sys_lf_ring *ring, u32_t count)
+{
+	u32_t head;
+
+	if (count > sys_lf_ring_used_get(ring)) {
+		return -EINVAL;
+	}
+
+	head = (u32_t)atomic_get(&ring->head);
+	atomic_set(&ring->head, (atomic_val_t)(head + count));
+
+	return 0;
+}
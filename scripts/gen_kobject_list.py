@@ -22,9 +22,11 @@ if LooseVersion(elftools.__version__) < LooseVersion('0.24'):
 
 kobjects = [
         "k_alert",
+        "k_event",
         "k_msgq",
         "k_mutex",
         "k_pipe",
+        "k_rwlock",
         "k_sem",
         "k_stack",
         "k_thread",
@@ -517,6 +519,12 @@ header = """%compare-lengths
 #include <kernel.h>
 #include <syscall_handler.h>
 #include <string.h>
+
+#ifdef CONFIG_DYNAMIC_OBJECTS
+/* userspace.c wraps these to also search runtime allocated objects */
+#define _k_object_find _k_object_gperf_find
+#define _k_object_wordlist_foreach _k_object_gperf_wordlist_foreach
+#endif
 %}
 struct _k_object;
 %%
@@ -8,11 +8,21 @@
 #ifndef _CPU_H_
 #define _CPU_H_
 
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+#include <kernel.h>
+
+/* Waiting loops need time to pass for the HW models to make progress */
+static inline void cpu_sleep(void)
+{
+	k_busy_wait(1);
+}
+#else
 static inline void cpu_sleep(void)
 {
 	__WFE();
 	__SEV();
 	__WFE();
 }
+#endif
 
 #endif /* _CPU_H_ */
@@ -18,6 +18,10 @@ void bt_ctlr_assert_handle(char *file, u32_t line);
 #define LL_ASSERT(cond) BT_ASSERT(cond)
 #endif
 
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+#include "native_posix/debug.h"
+#else
 #include "nrf5/debug.h"
+#endif
 
 #endif /* _HAL_DEBUG_H_ */
@@ -0,0 +1,47 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <soc.h>
+#include "rtc_model.h"
+#include "hal/cntr.h"
+
+#include "common/log.h"
+#include "hal/debug.h"
+
+static u8_t _refcount;
+
+void cntr_init(void)
+{
+}
+
+/* The model counter always runs, only the users are counted */
+u32_t cntr_start(void)
+{
+	if (_refcount++) {
+		return 1;
+	}
+
+	return 0;
+}
+
+u32_t cntr_stop(void)
+{
+	LL_ASSERT(_refcount);
+
+	if (--_refcount) {
+		return 1;
+	}
+
+	return 0;
+}
+
+u32_t cntr_cnt_get(void)
+{
+	return hw_rtc_counter_get();
+}
+
+void cntr_cmp_set(u8_t cmp, u32_t value)
+{
+	hw_rtc_cc_set(cmp, value);
+}
@@ -0,0 +1,31 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _DEBUG_H_
+#define _DEBUG_H_
+
+#ifdef CONFIG_BT_CTLR_DEBUG_PINS
+#error BT_CTLR_DEBUG_PINS not supported on this board.
+#endif
+
+#define DEBUG_INIT()
+#define DEBUG_CPU_SLEEP(flag)
+#define DEBUG_TICKER_ISR(flag)
+#define DEBUG_TICKER_TASK(flag)
+#define DEBUG_TICKER_JOB(flag)
+#define DEBUG_RADIO_ISR(flag)
+#define DEBUG_RADIO_XTAL(flag)
+#define DEBUG_RADIO_ACTIVE(flag)
+#define DEBUG_RADIO_CLOSE(flag)
+#define DEBUG_RADIO_PREPARE_A(flag)
+#define DEBUG_RADIO_START_A(flag)
+#define DEBUG_RADIO_PREPARE_S(flag)
+#define DEBUG_RADIO_START_S(flag)
+#define DEBUG_RADIO_PREPARE_O(flag)
+#define DEBUG_RADIO_START_O(flag)
+#define DEBUG_RADIO_PREPARE_M(flag)
+#define DEBUG_RADIO_START_M(flag)
+#define DEBUG_RADIO_HCTO(flag)
+
+#endif /* _DEBUG_H_ */
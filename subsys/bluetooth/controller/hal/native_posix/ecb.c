@@ -0,0 +1,122 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <soc.h>
+#include <tinycrypt/aes.h>
+#include <tinycrypt/constants.h>
+
+#include "util/mem.h"
+#include "hal/ecb.h"
+
+#include "common/log.h"
+#include "hal/debug.h"
+
+void ecb_encrypt_be(u8_t const *const key_be, u8_t const *const clear_text_be,
+		    u8_t * const cipher_text_be)
+{
+	struct tc_aes_key_sched_struct s;
+	int err;
+
+	err = tc_aes128_set_encrypt_key(&s, key_be);
+	LL_ASSERT(err == TC_CRYPTO_SUCCESS);
+
+	err = tc_aes_encrypt(cipher_text_be, clear_text_be, &s);
+	LL_ASSERT(err == TC_CRYPTO_SUCCESS);
+}
+
+void ecb_encrypt(u8_t const *const key_le, u8_t const *const clear_text_le,
+		 u8_t * const cipher_text_le, u8_t * const cipher_text_be)
+{
+	u8_t key[16];
+	u8_t clear_text[16];
+	u8_t cipher_text[16];
+
+	mem_rcopy(key, key_le, sizeof(key));
+	mem_rcopy(clear_text, clear_text_le, sizeof(clear_text));
+
+	ecb_encrypt_be(key, clear_text, cipher_text);
+
+	if (cipher_text_le) {
+		mem_rcopy(cipher_text_le, cipher_text, sizeof(cipher_text));
+	}
+
+	if (cipher_text_be) {
+		memcpy(cipher_text_be, cipher_text, sizeof(cipher_text));
+	}
+}
+
+/* Encryption takes no time on this board, the callback is called before
+ * returning
+ */
+u32_t ecb_encrypt_nonblocking(struct ecb *ecb)
+{
+	if (ecb->in_key_le) {
+		mem_rcopy(&ecb->in_key_be[0], ecb->in_key_le,
+			  sizeof(ecb->in_key_be));
+	}
+
+	if (ecb->in_clear_text_le) {
+		mem_rcopy(&ecb->in_clear_text_be[0], ecb->in_clear_text_le,
+			  sizeof(ecb->in_clear_text_be));
+	}
+
+	ecb_encrypt_be(ecb->in_key_be, ecb->in_clear_text_be,
+		       ecb->out_cipher_text_be);
+
+	ecb->fp_ecb(0, &ecb->out_cipher_text_be[0], ecb->context);
+
+	return 0;
+}
+
+void isr_ecb(void *param)
+{
+	ARG_UNUSED(param);
+}
+
+struct ecb_ut_context {
+	u32_t volatile done;
+	u32_t status;
+	u8_t  cipher_text[16];
+};
+
+static void ecb_cb(u32_t status, u8_t *cipher_be, void *context)
+{
+	struct ecb_ut_context *ecb_ut_context =
+		(struct ecb_ut_context *)context;
+
+	ecb_ut_context->done = 1;
+	ecb_ut_context->status = status;
+	if (!status) {
+		mem_rcopy(ecb_ut_context->cipher_text, cipher_be,
+			  sizeof(ecb_ut_context->cipher_text));
+	}
+}
+
+u32_t ecb_ut(void)
+{
+	u8_t key[16] = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88,
+			 0x99, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55 };
+	u8_t clear_text[16] = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+				0x88, 0x99, 0x00, 0x11, 0x22, 0x33, 0x44,
+				0x55 };
+	u8_t cipher_text[16];
+	struct ecb ecb;
+	struct ecb_ut_context context;
+
+	ecb_encrypt(key, clear_text, cipher_text, NULL);
+
+	context.done = 0;
+	ecb.in_key_le = key;
+	ecb.in_clear_text_le = clear_text;
+	ecb.fp_ecb = ecb_cb;
+	ecb.context = &context;
+	ecb_encrypt_nonblocking(&ecb);
+
+	if (!context.done || context.status != 0) {
+		return 1;
+	}
+
+	return memcmp(cipher_text, context.cipher_text, sizeof(cipher_text));
+}
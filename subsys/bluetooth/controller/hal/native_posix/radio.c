@@ -0,0 +1,616 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include <soc.h>
+#include <misc/byteorder.h>
+#include <tinycrypt/aes.h>
+#include <tinycrypt/ccm_mode.h>
+#include <tinycrypt/constants.h>
+
+#include "irq_handler.h"
+#include "radio_model.h"
+#include "rtc_model.h"
+
+#include "util/mem.h"
+#include "hal/ccm.h"
+#include "hal/ecb.h"
+#include "hal/radio.h"
+#include "ll_sw/pdu.h"
+
+#include "common/log.h"
+#include "hal/debug.h"
+
+#define RADIO_PDU_LEN_MAX (BIT(8) - 1)
+
+/* Header, length and S1 byte in front of the payload of data channel PDUs */
+#define CCM_HDR_SIZE offsetof(struct pdu_data, payload)
+#define CCM_MIC_SIZE 4
+
+static radio_isr_fp sfp_radio_isr;
+
+static void ccm_rx_crypt(void);
+
+void isr_radio(void)
+{
+	/* The CCM works along the reception, its output is ready by the time
+	 * the radio has disabled.
+	 */
+	if (hw_radio.events_end) {
+		ccm_rx_crypt();
+	}
+
+	if (sfp_radio_isr) {
+		sfp_radio_isr();
+	}
+}
+
+void radio_isr_set(radio_isr_fp fp_radio_isr)
+{
+	sfp_radio_isr = fp_radio_isr;
+
+	posix_sw_clear_pending_IRQ(RADIO_IRQ);
+	irq_enable(RADIO_IRQ);
+}
+
+void radio_setup(void)
+{
+}
+
+void radio_reset(void)
+{
+	irq_disable(RADIO_IRQ);
+
+	hw_radio_switch_cancel();
+	hw_radio_task_disable();
+}
+
+void radio_phy_set(u8_t phy, u8_t flags)
+{
+	switch (phy) {
+	case BIT(1):
+	case BIT(2):
+		hw_radio.phy = phy;
+		break;
+
+	case BIT(0):
+	default:
+		hw_radio.phy = BIT(0);
+		break;
+	}
+
+	hw_radio.coded_s8 = flags & 0x01;
+}
+
+void radio_tx_power_set(u32_t power)
+{
+	ARG_UNUSED(power);
+}
+
+void radio_freq_chan_set(u32_t chan)
+{
+	hw_radio.chan = chan;
+}
+
+void radio_whiten_iv_set(u32_t iv)
+{
+	ARG_UNUSED(iv);
+}
+
+void radio_aa_set(u8_t *aa)
+{
+	hw_radio.aa = sys_get_le32(aa);
+}
+
+void radio_pkt_configure(u8_t bits_len, u8_t max_len, u8_t flags)
+{
+	u8_t dc = flags & 0x01; /* Adv or Data channel */
+
+	ARG_UNUSED(bits_len);
+
+	/* Same Data Channel PDU structure as with the nRF5 radio */
+	hw_radio.s1_incl = dc &&
+			   !IS_ENABLED(CONFIG_BT_CTLR_DATA_LENGTH_CLEAR);
+	hw_radio.max_len = max_len;
+}
+
+void radio_pkt_rx_set(void *rx_packet)
+{
+	hw_radio.packet = rx_packet;
+}
+
+void radio_pkt_tx_set(void *tx_packet)
+{
+	hw_radio.packet = tx_packet;
+}
+
+u32_t radio_tx_ready_delay_get(u8_t phy, u8_t flags)
+{
+	return HW_RADIO_TX_RU_US;
+}
+
+/* The model puts packets on air and takes them off without chain delays */
+u32_t radio_tx_chain_delay_get(u8_t phy, u8_t flags)
+{
+	return 0;
+}
+
+u32_t radio_rx_ready_delay_get(u8_t phy)
+{
+	return HW_RADIO_RX_RU_US;
+}
+
+u32_t radio_rx_chain_delay_get(u8_t phy, u8_t flags)
+{
+	return 0;
+}
+
+void radio_rx_enable(void)
+{
+	hw_radio_task_enable(false);
+}
+
+void radio_tx_enable(void)
+{
+	hw_radio_task_enable(true);
+}
+
+void radio_disable(void)
+{
+	hw_radio.rssi_start = false;
+	hw_radio.bcc = 0;
+
+	hw_radio_switch_cancel();
+	hw_radio_task_disable();
+}
+
+void radio_status_reset(void)
+{
+	hw_radio.events_ready = 0;
+	hw_radio.events_address = 0;
+	hw_radio.events_end = 0;
+	hw_radio.events_disabled = 0;
+}
+
+u32_t radio_is_ready(void)
+{
+	return (hw_radio.events_ready != 0);
+}
+
+u32_t radio_is_done(void)
+{
+	return (hw_radio.events_end != 0);
+}
+
+u32_t radio_has_disabled(void)
+{
+	return (hw_radio.events_disabled != 0);
+}
+
+u32_t radio_is_idle(void)
+{
+	return (hw_radio.state == HW_RADIO_DISABLED);
+}
+
+void radio_crc_configure(u32_t polynomial, u32_t iv)
+{
+	ARG_UNUSED(polynomial);
+
+	hw_radio.crc_init = iv;
+}
+
+u32_t radio_crc_is_valid(void)
+{
+	return (hw_radio.crc_status != 0);
+}
+
+static u8_t MALIGN(4) _pkt_empty[PDU_EM_SIZE_MAX];
+static u8_t MALIGN(4) _pkt_scratch[
+			((RADIO_PDU_LEN_MAX + 3) > PDU_AC_SIZE_MAX) ?
+			(RADIO_PDU_LEN_MAX + 3) : PDU_AC_SIZE_MAX];
+
+void *radio_pkt_empty_get(void)
+{
+	return _pkt_empty;
+}
+
+void *radio_pkt_scratch_get(void)
+{
+	return _pkt_scratch;
+}
+
+static u32_t tifs;
+
+/* Enable the radio the inter frame space after END, less its ramp-up */
+static void sw_switch(bool tx, u32_t delay)
+{
+	hw_radio.rssi_start = false;
+	hw_radio.bcc = 0;
+
+	hw_radio_switch_set(true, tx, (delay < tifs) ? (tifs - delay) : 1);
+}
+
+void radio_switch_complete_and_rx(u8_t phy_rx)
+{
+	sw_switch(false, radio_rx_ready_delay_get(phy_rx) -
+			 radio_tx_chain_delay_get(0, 0) +
+			 4); /* 4us as +/- active jitter */
+}
+
+void radio_switch_complete_and_tx(u8_t phy_rx, u8_t flags_rx, u8_t phy_tx,
+				  u8_t flags_tx)
+{
+	sw_switch(true, radio_tx_ready_delay_get(phy_tx, flags_tx) +
+			radio_rx_chain_delay_get(phy_rx, 1));
+}
+
+void radio_switch_complete_and_disable(void)
+{
+	hw_radio.rssi_start = false;
+	hw_radio.bcc = 0;
+
+	hw_radio_switch_set(false, false, 0);
+}
+
+void radio_rssi_measure(void)
+{
+	hw_radio.rssi_start = true;
+}
+
+u32_t radio_rssi_get(void)
+{
+	return hw_radio.rssi_sample;
+}
+
+void radio_rssi_status_reset(void)
+{
+	hw_radio.events_rssiend = 0;
+}
+
+u32_t radio_rssi_is_ready(void)
+{
+	return (hw_radio.events_rssiend != 0);
+}
+
+void radio_filter_configure(u8_t bitmask_enable, u8_t bitmask_addr_type,
+			    u8_t *bdaddr)
+{
+	u8_t index;
+
+	for (index = 0; index < HW_RADIO_DAB_COUNT; index++) {
+		memcpy(hw_radio.dab[index], bdaddr, 6);
+		bdaddr += 6;
+	}
+
+	hw_radio.dacnf_txadd = bitmask_addr_type;
+	hw_radio.dacnf_en = bitmask_enable;
+}
+
+void radio_filter_disable(void)
+{
+	hw_radio.dacnf_en = 0;
+}
+
+void radio_filter_status_reset(void)
+{
+	hw_radio.events_devmatch = 0;
+	hw_radio.events_devmiss = 0;
+}
+
+u32_t radio_filter_has_match(void)
+{
+	return (hw_radio.events_devmatch != 0);
+}
+
+u32_t radio_filter_match_get(void)
+{
+	return hw_radio.dai;
+}
+
+void radio_bc_configure(u32_t n)
+{
+	hw_radio.bcc = n;
+}
+
+void radio_bc_status_reset(void)
+{
+	hw_radio.events_bcmatch = 0;
+}
+
+u32_t radio_bc_has_match(void)
+{
+	return (hw_radio.events_bcmatch != 0);
+}
+
+void radio_tmr_status_reset(void)
+{
+	hw_radio_tmr_clear();
+}
+
+void radio_tmr_tifs_set(u32_t us)
+{
+	tifs = us;
+}
+
+u32_t radio_tmr_start(u8_t trx, u32_t ticks_start, u32_t remainder)
+{
+	if ((!(remainder / 1000000UL)) || (remainder & 0x80000000)) {
+		ticks_start--;
+		remainder += 30517578UL;
+	}
+	remainder /= 1000000UL;
+
+	hw_radio_tmr_start(hw_rtc_tick_time(ticks_start));
+	hw_radio_tmr_enable_at(trx, remainder);
+
+	return remainder;
+}
+
+void radio_tmr_start_us(u8_t trx, u32_t us)
+{
+	hw_radio_tmr_enable_at(trx, us);
+}
+
+u32_t radio_tmr_start_now(u8_t trx)
+{
+	u32_t start = hw_radio_tmr_get();
+
+	/* Setup compare event with min. 1 us offset */
+	hw_radio_tmr_enable_at(trx, start + 1);
+
+	return start;
+}
+
+void radio_tmr_stop(void)
+{
+	hw_radio_tmr_stop();
+}
+
+void radio_tmr_hcto_configure(u32_t hcto)
+{
+	hw_radio.capture_address = true;
+	hw_radio_tmr_hcto_set(hcto);
+}
+
+void radio_tmr_aa_capture(void)
+{
+	hw_radio.capture_ready = true;
+	hw_radio.capture_address = true;
+}
+
+u32_t radio_tmr_aa_get(void)
+{
+	return hw_radio.cc_address;
+}
+
+static u32_t radio_tmr_aa;
+
+void radio_tmr_aa_save(u32_t aa)
+{
+	radio_tmr_aa = aa;
+}
+
+u32_t radio_tmr_aa_restore(void)
+{
+	/* NOTE: we dont need to restore for now, but return the saved value. */
+	return radio_tmr_aa;
+}
+
+u32_t radio_tmr_ready_get(void)
+{
+	return hw_radio.cc_ready;
+}
+
+void radio_tmr_end_capture(void)
+{
+	hw_radio.capture_end = true;
+}
+
+u32_t radio_tmr_end_get(void)
+{
+	return hw_radio.cc_end;
+}
+
+static u32_t radio_tmr_sample_value;
+
+void radio_tmr_sample(void)
+{
+	radio_tmr_sample_value = hw_radio_tmr_get();
+}
+
+u32_t radio_tmr_sample_get(void)
+{
+	return radio_tmr_sample_value;
+}
+
+static struct {
+	struct ccm cnf;
+	u8_t *in;
+	u8_t *out;
+	bool rx;
+	bool mic_valid;
+} _ccm;
+
+static void ccm_setup(struct tc_ccm_mode_struct *c,
+		      struct tc_aes_key_sched_struct *sched, u8_t *nonce)
+{
+	int err;
+
+	sys_put_le32(_ccm.cnf.counter, &nonce[0]);
+	nonce[4] = ((_ccm.cnf.counter >> 32) & 0x7f) |
+		   (_ccm.cnf.direction << 7);
+	memcpy(&nonce[5], _ccm.cnf.iv, sizeof(_ccm.cnf.iv));
+
+	err = tc_aes128_set_encrypt_key(sched, _ccm.cnf.key);
+	LL_ASSERT(err == TC_CRYPTO_SUCCESS);
+
+	err = tc_ccm_config(c, sched, nonce, 13, CCM_MIC_SIZE);
+	LL_ASSERT(err == TC_CRYPTO_SUCCESS);
+}
+
+static void ccm_rx_crypt(void)
+{
+	struct tc_aes_key_sched_struct sched;
+	struct tc_ccm_mode_struct c;
+	u8_t nonce[13];
+	u8_t len, aad;
+
+	if (!_ccm.rx) {
+		return;
+	}
+
+	_ccm.rx = false;
+
+	len = _ccm.in[1];
+	memcpy(_ccm.out, _ccm.in, CCM_HDR_SIZE);
+
+	if (!len) {
+		_ccm.mic_valid = true;
+		return;
+	}
+
+	if (len < CCM_MIC_SIZE) {
+		_ccm.mic_valid = false;
+		return;
+	}
+
+	ccm_setup(&c, &sched, nonce);
+
+	aad = _ccm.in[0] & 0xE3;
+	_ccm.out[1] = len - CCM_MIC_SIZE;
+	_ccm.mic_valid = tc_ccm_decryption_verification(
+				&_ccm.out[CCM_HDR_SIZE], len - CCM_MIC_SIZE,
+				&aad, 1, &_ccm.in[CCM_HDR_SIZE], len, &c) ==
+			 TC_CRYPTO_SUCCESS;
+}
+
+void *radio_ccm_rx_pkt_set(struct ccm *ccm, u8_t phy, void *pkt)
+{
+	ARG_UNUSED(phy);
+
+	_ccm.cnf = *ccm;
+	_ccm.in = _pkt_scratch;
+	_ccm.out = pkt;
+	_ccm.rx = true;
+	_ccm.mic_valid = false;
+
+	return _pkt_scratch;
+}
+
+void *radio_ccm_tx_pkt_set(struct ccm *ccm, void *pkt)
+{
+	struct tc_aes_key_sched_struct sched;
+	struct tc_ccm_mode_struct c;
+	u8_t nonce[13];
+	u8_t len, aad;
+	int err;
+
+	_ccm.cnf = *ccm;
+	_ccm.in = pkt;
+	_ccm.out = _pkt_scratch;
+	_ccm.rx = false;
+
+	len = _ccm.in[1];
+	memcpy(_ccm.out, _ccm.in, CCM_HDR_SIZE);
+
+	if (len) {
+		ccm_setup(&c, &sched, nonce);
+
+		aad = _ccm.in[0] & 0xE3;
+		_ccm.out[1] = len + CCM_MIC_SIZE;
+		err = tc_ccm_generation_encryption(&_ccm.out[CCM_HDR_SIZE],
+						   len + CCM_MIC_SIZE, &aad, 1,
+						   &_ccm.in[CCM_HDR_SIZE], len,
+						   &c);
+		LL_ASSERT(err == TC_CRYPTO_SUCCESS);
+	}
+
+	return _pkt_scratch;
+}
+
+u32_t radio_ccm_is_done(void)
+{
+	ccm_rx_crypt();
+
+	return 1;
+}
+
+u32_t radio_ccm_mic_is_valid(void)
+{
+	return _ccm.mic_valid;
+}
+
+static struct {
+	u32_t nirk;
+	u8_t *irk;
+	u8_t *addr;
+	bool enabled;
+	bool done;
+	u32_t status;
+} _aar;
+
+void radio_ar_configure(u32_t nirk, void *irk)
+{
+	_aar.nirk = nirk;
+	_aar.irk = irk;
+	_aar.addr = (u8_t *)hw_radio.packet + 2;
+	_aar.enabled = true;
+	_aar.done = false;
+
+	radio_bc_configure(64);
+	radio_bc_status_reset();
+}
+
+/* Whether prand and hash of a resolvable private address match an IRK */
+static bool ar_resolve(u8_t *irk, u8_t *addr)
+{
+	u8_t clear_text[16] = { 0 };
+	u8_t cipher_text[16];
+
+	clear_text[13] = addr[5];
+	clear_text[14] = addr[4];
+	clear_text[15] = addr[3];
+
+	ecb_encrypt_be(irk, clear_text, cipher_text);
+
+	return cipher_text[13] == addr[2] && cipher_text[14] == addr[1] &&
+	       cipher_text[15] == addr[0];
+}
+
+u32_t radio_ar_match_get(void)
+{
+	return _aar.status;
+}
+
+void radio_ar_status_reset(void)
+{
+	radio_bc_status_reset();
+
+	_aar.enabled = false;
+}
+
+u32_t radio_ar_has_match(void)
+{
+	u32_t i;
+
+	if (!_aar.enabled || !radio_bc_has_match()) {
+		return 0;
+	}
+
+	/* Resolve once the address is received, as the AAR would have */
+	if (!_aar.done) {
+		_aar.done = true;
+		_aar.status = _aar.nirk;
+
+		for (i = 0; i < _aar.nirk; i++) {
+			if (ar_resolve(&_aar.irk[i * 16], _aar.addr)) {
+				_aar.status = i;
+				break;
+			}
+		}
+	}
+
+	return (_aar.status < _aar.nirk);
+}
@@ -0,0 +1,69 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <soc.h>
+#include "radio_model.h"
+
+#include "hal/rand.h"
+
+#include "common/log.h"
+#include "hal/debug.h"
+
+/* Numbers are drawn from a xorshift generator seeded with the position of
+ * the device on the radio medium, so runs repeat and devices differ.
+ */
+static u32_t state;
+
+static void init(void)
+{
+	if (!state) {
+		state = 0x9e3779b9 * (hw_radio_dev_id() + 1);
+	}
+}
+
+static u8_t next(void)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+
+	return state;
+}
+
+void rand_init(u8_t *context, u8_t context_len, u8_t threshold)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(context_len);
+	ARG_UNUSED(threshold);
+
+	init();
+}
+
+void rand_isr_init(u8_t *context, u8_t context_len, u8_t threshold)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(context_len);
+	ARG_UNUSED(threshold);
+
+	init();
+}
+
+size_t rand_get(size_t octets, u8_t *rand)
+{
+	while (octets) {
+		rand[--octets] = next();
+	}
+
+	return 0;
+}
+
+size_t rand_isr_get(size_t octets, u8_t *rand)
+{
+	return rand_get(octets, rand);
+}
+
+void isr_rand(void *param)
+{
+	ARG_UNUSED(param);
+}
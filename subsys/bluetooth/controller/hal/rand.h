@@ -8,6 +8,8 @@
 #ifndef _RAND_H_
 #define _RAND_H_
 
+#include <stddef.h>
+
 void rand_init(u8_t *context, u8_t context_len, u8_t threshold);
 void rand_isr_init(u8_t *context, u8_t context_len, u8_t threshold);
 size_t rand_get(size_t octets, u8_t *rand);
@@ -59,6 +59,9 @@
 #define RADIO_TICKER_PREEMPT_PART_MIN_US	0
 #define RADIO_TICKER_PREEMPT_PART_MAX_US	RADIO_TICKER_XTAL_OFFSET_US
 
+/* Connection events keep their slot over advertising and scanning */
+#define RADIO_TICKER_PRIORITY_CONN		(TICKER_PRIORITY_DEFAULT - 1)
+
 #if defined(CONFIG_BT_CTLR_CONN_RSSI)
 #define RADIO_RSSI_SAMPLE_COUNT	10
 #define RADIO_RSSI_THRESHOLD	4
@@ -238,6 +241,7 @@ static void ticker_stop_adv_assert(u32_t status, void *params);
 static void ticker_stop_scan_assert(u32_t status, void *params);
 static void ticker_update_adv_assert(u32_t status, void *params);
 static void ticker_update_slave_assert(u32_t status, void *params);
+static void ticker_conn_priority_set(struct connection *conn);
 static void event_inactive(u32_t ticks_at_expire, u32_t remainder,
 			   u16_t lazy, void *context);
 
@@ -1166,6 +1170,8 @@ static inline u32_t isr_rx_adv(u8_t devmatch_ok, u8_t devmatch_id,
 		LL_ASSERT((ticker_status == TICKER_STATUS_SUCCESS) ||
 			  (ticker_status == TICKER_STATUS_BUSY));
 
+		ticker_conn_priority_set(conn);
+
 		return 0;
 	}
 
@@ -1612,6 +1618,8 @@ static inline u32_t isr_rx_scan(u8_t devmatch_ok, u8_t devmatch_id,
 		LL_ASSERT((ticker_status == TICKER_STATUS_SUCCESS) ||
 			  (ticker_status == TICKER_STATUS_BUSY));
 
+		ticker_conn_priority_set(conn);
+
 		return 0;
 	}
 
@@ -4301,6 +4309,30 @@ static void ticker_update_slave_assert(u32_t status, void *params)
 		  (_radio.ticker_id_stop == ticker_id));
 }
 
+static void ticker_conn_priority_set(struct connection *conn)
+{
+	u32_t ticker_status;
+	u16_t lazy_max;
+
+	/* Between connections, one that lost its slot for a quarter of its
+	 * supervision timeout takes precedence over the others.
+	 */
+	lazy_max = conn->supervision_reload >> 2;
+	if (!lazy_max) {
+		lazy_max = 1;
+	}
+
+	ticker_status =
+		ticker_priority_set(RADIO_TICKER_INSTANCE_ID_RADIO,
+				    RADIO_TICKER_USER_ID_WORKER,
+				    RADIO_TICKER_ID_FIRST_CONNECTION +
+				    conn->handle, RADIO_TICKER_PRIORITY_CONN,
+				    lazy_max, ticker_success_assert,
+				    (void *)__LINE__);
+	LL_ASSERT((ticker_status == TICKER_STATUS_SUCCESS) ||
+		  (ticker_status == TICKER_STATUS_BUSY));
+}
+
 static void mayfly_radio_active(void *params)
 {
 	static u8_t s_active;
@@ -6594,6 +6626,9 @@ static inline u32_t event_conn_upd_prep(struct connection *conn,
 		LL_ASSERT((ticker_status == TICKER_STATUS_SUCCESS) ||
 			  (ticker_status == TICKER_STATUS_BUSY));
 
+		/* budget follows the new supervision timeout */
+		ticker_conn_priority_set(conn);
+
 		/* enable ticker job, if disabled in this function */
 		if (mayfly_was_enabled) {
 			mayfly_enable(RADIO_TICKER_USER_ID_WORKER,
@@ -115,7 +115,7 @@
 #define RADIO_TICKER_USER_ID_JOB	 MAYFLY_CALL_ID_1
 #define RADIO_TICKER_USER_ID_APP	 MAYFLY_CALL_ID_PROGRAM
 
-#define RADIO_TICKER_USER_WORKER_OPS	(7 + 1)
+#define RADIO_TICKER_USER_WORKER_OPS	(8 + 1)
 #define RADIO_TICKER_USER_JOB_OPS	(2 + 1)
 #define RADIO_TICKER_USER_APP_OPS	(1 + 1)
 #define RADIO_TICKER_USER_OPS		(RADIO_TICKER_USER_WORKER_OPS \
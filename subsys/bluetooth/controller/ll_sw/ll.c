@@ -14,6 +14,10 @@
 #ifdef CONFIG_CLOCK_CONTROL_NRF5
 #include <drivers/clock_control/nrf5_clock_control.h>
 #endif
+#ifdef CONFIG_BOARD_NATIVE_POSIX
+#include "irq_handler.h"
+#include "rtc_model.h"
+#endif
 #include <bluetooth/hci.h>
 
 #define BT_DBG_ENABLED IS_ENABLED(CONFIG_BT_DEBUG_HCI_DRIVER)
@@ -80,6 +84,32 @@ static struct {
 	u8_t rnd_addr[BDADDR_SIZE];
 } _ll_context;
 
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+#define RADIO_IRQn RADIO_IRQ
+#define RTC0_IRQn  RTC0_IRQ
+#define SWI4_IRQn  SWI_IRQ
+#define NVIC_SetPendingIRQ(irq) posix_sw_set_pending_IRQ(irq)
+
+/* The models run off the device time, no clock needs to be started */
+static int clk_native_on_off(struct device *dev, clock_control_subsys_t sys)
+{
+	return 0;
+}
+
+static const struct clock_control_driver_api clk_native_api = {
+	.on = clk_native_on_off,
+	.off = clk_native_on_off,
+};
+
+static struct device clk_native = {
+	.driver_api = &clk_native_api,
+};
+
+#define K32SRC_ACCURACY 7 /* 0 to 20 ppm */
+#else /* !CONFIG_BOARD_NATIVE_POSIX */
+#define K32SRC_ACCURACY CLOCK_CONTROL_NRF5_K32SRC_ACCURACY
+#endif /* !CONFIG_BOARD_NATIVE_POSIX */
+
 void mayfly_enable_cb(u8_t caller_id, u8_t callee_id, u8_t enable)
 {
 	(void)caller_id;
@@ -141,6 +171,13 @@ void mayfly_pend(u8_t caller_id, u8_t callee_id)
 	}
 }
 
+#if defined(CONFIG_BT_CTLR_MAYFLY_STATS)
+u32_t mayfly_cycles_get(void)
+{
+	return k_cycle_get_32();
+}
+#endif /* CONFIG_BT_CTLR_MAYFLY_STATS */
+
 void radio_active_callback(u8_t active)
 {
 }
@@ -158,6 +195,22 @@ ISR_DIRECT_DECLARE(radio_nrf5_isr)
 	return 1;
 }
 
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+static void rtc0_nrf5_isr(void *arg)
+{
+	/* On compare0 run ticker worker instance0 */
+	if (hw_rtc_cc_event_clear(0)) {
+		ticker_trigger(0);
+	}
+
+	/* On compare1 run ticker worker instance1 */
+	if (hw_rtc_cc_event_clear(1)) {
+		ticker_trigger(1);
+	}
+
+	mayfly_run(MAYFLY_CALL_ID_0);
+}
+#else /* !CONFIG_BOARD_NATIVE_POSIX */
 static void rtc0_nrf5_isr(void *arg)
 {
 	u32_t compare0, compare1;
@@ -182,11 +235,14 @@ static void rtc0_nrf5_isr(void *arg)
 
 	mayfly_run(MAYFLY_CALL_ID_0);
 }
+#endif /* !CONFIG_BOARD_NATIVE_POSIX */
 
+#if !defined(CONFIG_BOARD_NATIVE_POSIX)
 static void rng_nrf5_isr(void *arg)
 {
 	isr_rand(arg);
 }
+#endif /* !CONFIG_BOARD_NATIVE_POSIX */
 
 static void swi4_nrf5_isr(void *arg)
 {
@@ -195,7 +251,9 @@ static void swi4_nrf5_isr(void *arg)
 
 int ll_init(struct k_sem *sem_rx)
 {
+#if !defined(CONFIG_BOARD_NATIVE_POSIX)
 	struct device *clk_k32;
+#endif /* !CONFIG_BOARD_NATIVE_POSIX */
 	struct device *clk_m16;
 	u32_t err;
 
@@ -206,6 +264,9 @@ int ll_init(struct k_sem *sem_rx)
 	rand_isr_init(rand_isr_context, sizeof(rand_isr_context),
 		      RAND_ISR_THRESHOLD);
 
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+	clk_m16 = &clk_native;
+#else /* !CONFIG_BOARD_NATIVE_POSIX */
 	clk_k32 = device_get_binding(CONFIG_CLOCK_CONTROL_NRF5_K32SRC_DRV_NAME);
 	if (!clk_k32) {
 		return -ENODEV;
@@ -213,6 +274,12 @@ int ll_init(struct k_sem *sem_rx)
 
 	clock_control_on(clk_k32, (void *)CLOCK_CONTROL_NRF5_K32SRC);
 
+	clk_m16 = device_get_binding(CONFIG_CLOCK_CONTROL_NRF5_M16SRC_DRV_NAME);
+	if (!clk_m16) {
+		return -ENODEV;
+	}
+#endif /* !CONFIG_BOARD_NATIVE_POSIX */
+
 	/* TODO: bind and use counter driver */
 	cntr_init();
 
@@ -227,12 +294,7 @@ int ll_init(struct k_sem *sem_rx)
 		    &_ticker_nodes[0], MAYFLY_CALLER_COUNT, &_ticker_users[0],
 		    TICKER_USER_OPS, &_ticker_user_ops[0]);
 
-	clk_m16 = device_get_binding(CONFIG_CLOCK_CONTROL_NRF5_M16SRC_DRV_NAME);
-	if (!clk_m16) {
-		return -ENODEV;
-	}
-
-	err = radio_init(clk_m16, CLOCK_CONTROL_NRF5_K32SRC_ACCURACY,
+	err = radio_init(clk_m16, K32SRC_ACCURACY,
 			 RADIO_CONNECTION_CONTEXT_MAX,
 			 RADIO_PACKET_COUNT_RX_MAX,
 			 RADIO_PACKET_COUNT_TX_MAX,
@@ -246,6 +308,17 @@ int ll_init(struct k_sem *sem_rx)
 
 	ll_filter_reset(true);
 
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+	IRQ_DIRECT_CONNECT(RADIO_IRQ, CONFIG_BT_CTLR_WORKER_PRIO,
+			   radio_nrf5_isr, 0);
+	IRQ_CONNECT(RTC0_IRQ, CONFIG_BT_CTLR_WORKER_PRIO, rtc0_nrf5_isr, NULL,
+		    0);
+	IRQ_CONNECT(SWI_IRQ, CONFIG_BT_CTLR_JOB_PRIO, swi4_nrf5_isr, NULL, 0);
+
+	irq_enable(RADIO_IRQ);
+	irq_enable(RTC0_IRQ);
+	irq_enable(SWI_IRQ);
+#else /* !CONFIG_BOARD_NATIVE_POSIX */
 	IRQ_DIRECT_CONNECT(NRF5_IRQ_RADIO_IRQn, CONFIG_BT_CTLR_WORKER_PRIO,
 			   radio_nrf5_isr, 0);
 	IRQ_CONNECT(NRF5_IRQ_RTC0_IRQn, CONFIG_BT_CTLR_WORKER_PRIO,
@@ -258,6 +331,7 @@ int ll_init(struct k_sem *sem_rx)
 	irq_enable(NRF5_IRQ_RTC0_IRQn);
 	irq_enable(NRF5_IRQ_SWI4_IRQn);
 	irq_enable(NRF5_IRQ_RNG_IRQn);
+#endif /* !CONFIG_BOARD_NATIVE_POSIX */
 
 	return 0;
 }
@@ -46,6 +46,17 @@ struct ticker_node {
 	u16_t lazy_current;
 	u32_t remainder_periodic;
 	u32_t remainder_current;
+
+	/* Absolute expiry, the key of the timeline tree. The next chain is
+	 * the in-order thread of the tree.
+	 */
+	u32_t ticks_at;
+	u8_t  left;
+	u8_t  right;
+	u8_t  parent;
+	u8_t  height;	/* 0 if not in the timeline */
+	s8_t  priority;
+	u16_t lazy_max;
 };
 
 enum ticker_user_op_type {
@@ -55,6 +66,7 @@ enum ticker_user_op_type {
 	TICKER_USER_OP_TYPE_START,
 	TICKER_USER_OP_TYPE_UPDATE,
 	TICKER_USER_OP_TYPE_STOP,
+	TICKER_USER_OP_TYPE_PRIORITY_SET,
 };
 
 struct ticker_user_op_start {
@@ -83,13 +95,19 @@ struct ticker_user_op_slot_get {
 	u32_t *ticks_to_expire;
 };
 
+struct ticker_user_op_priority_set {
+	s8_t  priority;
+	u16_t lazy_max;
+};
+
 struct ticker_user_op {
-	enum ticker_user_op_type op;
+	u8_t op;	/* enum ticker_user_op_type, sized for a fixed layout */
 	u8_t id;
 	union {
 		struct ticker_user_op_start start;
 		struct ticker_user_op_update update;
 		struct ticker_user_op_slot_get slot_get;
+		struct ticker_user_op_priority_set priority_set;
 	} params;
 	u32_t status;
 	ticker_op_func fp_op_func;
@@ -114,6 +132,7 @@ struct ticker_instance {
 	u32_t ticks_elapsed[DOUBLE_BUFFER_SIZE];
 	u32_t ticks_current;
 	u8_t  ticker_id_head;
+	u8_t  ticker_id_root;
 	u8_t  ticker_id_slot_previous;
 	u16_t ticks_slot_previous;
 	u8_t  job_guard;
@@ -131,6 +150,263 @@ static struct ticker_instance _instance[2];
 /*****************************************************************************
  * Static Functions
  ****************************************************************************/
+/* Timeline tree: an AVL tree over the node array, ordered by the absolute
+ * expiry. It finds the position of a ticker in O(log n) where the list was
+ * walked from its head.
+ */
+static inline bool ticker_ticks_before(u32_t ticks_a, u32_t ticks_b)
+{
+	return ((ticks_a - ticks_b) & BIT(23)) != 0;
+}
+
+static inline u32_t ticker_ticks_base_get(struct ticker_instance *instance)
+{
+	struct ticker_node *ticker;
+
+	if (instance->ticker_id_head == TICKER_NULL) {
+		return instance->ticks_current;
+	}
+
+	/* the list is relative to the expiry the head was last reduced by */
+	ticker = &instance->node[instance->ticker_id_head];
+
+	return (ticker->ticks_at - ticker->ticks_to_expire) & 0x00FFFFFF;
+}
+
+static inline u8_t ticker_tree_height(struct ticker_node *node, u8_t id)
+{
+	return (id == TICKER_NULL) ? 0 : node[id].height;
+}
+
+static void ticker_tree_height_update(struct ticker_node *node, u8_t id)
+{
+	u8_t height_left = ticker_tree_height(node, node[id].left);
+	u8_t height_right = ticker_tree_height(node, node[id].right);
+
+	node[id].height = 1 + ((height_left > height_right) ?
+			       height_left : height_right);
+}
+
+static void ticker_tree_replace(struct ticker_instance *instance, u8_t parent,
+				u8_t id_old, u8_t id_new)
+{
+	struct ticker_node *node = &instance->node[0];
+
+	if (parent == TICKER_NULL) {
+		instance->ticker_id_root = id_new;
+	} else if (node[parent].left == id_old) {
+		node[parent].left = id_new;
+	} else {
+		node[parent].right = id_new;
+	}
+
+	if (id_new != TICKER_NULL) {
+		node[id_new].parent = parent;
+	}
+}
+
+static u8_t ticker_tree_rotate_left(struct ticker_instance *instance, u8_t id)
+{
+	struct ticker_node *node = &instance->node[0];
+	u8_t pivot = node[id].right;
+
+	node[id].right = node[pivot].left;
+	if (node[id].right != TICKER_NULL) {
+		node[node[id].right].parent = id;
+	}
+
+	ticker_tree_replace(instance, node[id].parent, id, pivot);
+
+	node[pivot].left = id;
+	node[id].parent = pivot;
+
+	ticker_tree_height_update(node, id);
+	ticker_tree_height_update(node, pivot);
+
+	return pivot;
+}
+
+static u8_t ticker_tree_rotate_right(struct ticker_instance *instance, u8_t id)
+{
+	struct ticker_node *node = &instance->node[0];
+	u8_t pivot = node[id].left;
+
+	node[id].left = node[pivot].right;
+	if (node[id].left != TICKER_NULL) {
+		node[node[id].left].parent = id;
+	}
+
+	ticker_tree_replace(instance, node[id].parent, id, pivot);
+
+	node[pivot].right = id;
+	node[id].parent = pivot;
+
+	ticker_tree_height_update(node, id);
+	ticker_tree_height_update(node, pivot);
+
+	return pivot;
+}
+
+static void ticker_tree_balance(struct ticker_instance *instance, u8_t id)
+{
+	struct ticker_node *node = &instance->node[0];
+
+	while (id != TICKER_NULL) {
+		u8_t height_left;
+		u8_t height_right;
+
+		ticker_tree_height_update(node, id);
+
+		height_left = ticker_tree_height(node, node[id].left);
+		height_right = ticker_tree_height(node, node[id].right);
+
+		if (height_right > (height_left + 1)) {
+			u8_t right = node[id].right;
+
+			if (ticker_tree_height(node, node[right].left) >
+			    ticker_tree_height(node, node[right].right)) {
+				ticker_tree_rotate_right(instance, right);
+			}
+
+			id = ticker_tree_rotate_left(instance, id);
+		} else if (height_left > (height_right + 1)) {
+			u8_t left = node[id].left;
+
+			if (ticker_tree_height(node, node[left].right) >
+			    ticker_tree_height(node, node[left].left)) {
+				ticker_tree_rotate_left(instance, left);
+			}
+
+			id = ticker_tree_rotate_right(instance, id);
+		}
+
+		id = node[id].parent;
+	}
+}
+
+/* Returns the ticker expiring last before ticks_at, and in parent the node
+ * to attach a new ticker at. Equal expiries sort before queued ones, as the
+ * list walk did.
+ */
+static u8_t ticker_tree_lookup(struct ticker_instance *instance, u32_t ticks_at,
+			       u8_t *parent)
+{
+	struct ticker_node *node = &instance->node[0];
+	u8_t previous;
+	u8_t current;
+
+	previous = TICKER_NULL;
+	*parent = TICKER_NULL;
+	current = instance->ticker_id_root;
+	while (current != TICKER_NULL) {
+		*parent = current;
+
+		if (ticker_ticks_before(node[current].ticks_at, ticks_at)) {
+			previous = current;
+			current = node[current].right;
+		} else {
+			current = node[current].left;
+		}
+	}
+
+	return previous;
+}
+
+static void ticker_tree_link(struct ticker_instance *instance, u8_t id,
+			     u8_t parent, u8_t previous)
+{
+	struct ticker_node *node = &instance->node[0];
+	struct ticker_node *ticker = &node[id];
+
+	ticker->left = TICKER_NULL;
+	ticker->right = TICKER_NULL;
+	ticker->parent = parent;
+	ticker->height = 1;
+
+	if (parent == TICKER_NULL) {
+		instance->ticker_id_root = id;
+	} else if (parent == previous) {
+		node[parent].right = id;
+	} else {
+		node[parent].left = id;
+	}
+
+	ticker_tree_balance(instance, parent);
+}
+
+static void ticker_tree_unlink(struct ticker_instance *instance, u8_t id)
+{
+	struct ticker_node *node = &instance->node[0];
+	struct ticker_node *ticker = &node[id];
+	u8_t rebalance;
+
+	if (ticker->left == TICKER_NULL) {
+		rebalance = ticker->parent;
+		ticker_tree_replace(instance, ticker->parent, id,
+				    ticker->right);
+	} else if (ticker->right == TICKER_NULL) {
+		rebalance = ticker->parent;
+		ticker_tree_replace(instance, ticker->parent, id,
+				    ticker->left);
+	} else {
+		/* in-order successor is the leftmost of the right subtree */
+		u8_t successor = ticker->next;
+
+		if (node[successor].parent != id) {
+			rebalance = node[successor].parent;
+			ticker_tree_replace(instance, rebalance, successor,
+					    node[successor].right);
+			node[successor].right = ticker->right;
+			node[ticker->right].parent = successor;
+		} else {
+			rebalance = successor;
+		}
+
+		ticker_tree_replace(instance, ticker->parent, id, successor);
+		node[successor].left = ticker->left;
+		node[ticker->left].parent = successor;
+	}
+
+	ticker->height = 0;
+
+	ticker_tree_balance(instance, rebalance);
+}
+
+static u8_t ticker_tree_previous(struct ticker_node *node, u8_t id)
+{
+	u8_t previous;
+
+	if (node[id].left != TICKER_NULL) {
+		id = node[id].left;
+		while (node[id].right != TICKER_NULL) {
+			id = node[id].right;
+		}
+
+		return id;
+	}
+
+	previous = node[id].parent;
+	while ((previous != TICKER_NULL) && (node[previous].left == id)) {
+		id = previous;
+		previous = node[id].parent;
+	}
+
+	return previous;
+}
+
+static void ticker_tree_rebase(struct ticker_instance *instance,
+			       u32_t ticks_delta)
+{
+	struct ticker_node *node = &instance->node[0];
+	u8_t id = instance->ticker_id_head;
+
+	while (id != TICKER_NULL) {
+		node[id].ticks_at = (node[id].ticks_at + ticks_delta) &
+				    0x00FFFFFF;
+		id = node[id].next;
+	}
+}
+
 static u8_t ticker_by_slot_get(struct ticker_node *node, u8_t ticker_id_head,
 			       u32_t ticks_slot)
 {
@@ -193,73 +469,92 @@ static void ticker_by_next_slot_get(struct ticker_instance *instance,
 	*ticks_to_expire = _ticks_to_expire;
 }
 
+static bool ticker_by_slot_previous_get(struct ticker_instance *instance,
+					 u8_t previous, u32_t ticks_at,
+					 u32_t ticks_base, u8_t *collide)
+{
+	struct ticker_node *node = &instance->node[0];
+
+	/* last ticker reserving a slot before this expiry */
+	while ((previous != TICKER_NULL) && (node[previous].ticks_slot == 0)) {
+		previous = ticker_tree_previous(node, previous);
+	}
+
+	if (previous == TICKER_NULL) {
+		/* slot of the ticker that expired last, if any */
+		*collide = TICKER_NULL;
+
+		return (instance->ticks_slot_previous >
+			ticker_ticks_diff_get(ticks_at, ticks_base));
+	}
+
+	*collide = previous;
+
+	return (node[previous].ticks_slot >
+		ticker_ticks_diff_get(ticks_at, node[previous].ticks_at));
+}
+
 static u8_t ticker_enqueue(struct ticker_instance *instance, u8_t id)
 {
-	struct ticker_node *ticker_current;
 	struct ticker_node *ticker_new;
-	u32_t ticks_to_expire_current;
-	u8_t ticker_id_slot_previous;
-	u32_t ticks_slot_previous;
 	struct ticker_node *node;
 	u32_t ticks_to_expire;
+	u32_t ticks_base;
+	u32_t ticks_at;
 	u8_t previous;
 	u8_t current;
 	u8_t collide;
+	u8_t parent;
 
 	node = &instance->node[0];
 	ticker_new = &node[id];
-	ticks_to_expire = ticker_new->ticks_to_expire;
-
-	collide = ticker_id_slot_previous = TICKER_NULL;
-	current = instance->ticker_id_head;
-	previous = current;
-	ticks_slot_previous = instance->ticks_slot_previous;
-	while ((current != TICKER_NULL) &&
-	       (ticks_to_expire >
-		(ticks_to_expire_current =
-		 (ticker_current = &node[current])->ticks_to_expire))) {
-		ticks_to_expire -= ticks_to_expire_current;
-
-		if (ticker_current->ticks_slot != 0) {
-			ticks_slot_previous = ticker_current->ticks_slot;
-			ticker_id_slot_previous = current;
-		} else {
-			if (ticks_slot_previous > ticks_to_expire_current) {
-				ticks_slot_previous -= ticks_to_expire_current;
-			} else {
-				ticks_slot_previous = 0;
-			}
-		}
-		previous = current;
-		current = ticker_current->next;
-	}
 
-	collide = ticker_by_slot_get(&node[0], current,
-				     ticks_to_expire + ticker_new->ticks_slot);
+	ticks_base = ticker_ticks_base_get(instance);
+	ticks_at = (ticks_base + ticker_new->ticks_to_expire) & 0x00FFFFFF;
 
-	if ((ticker_new->ticks_slot == 0) ||
-	    ((ticks_slot_previous <= ticks_to_expire) &&
-	     (collide == TICKER_NULL))) {
-		ticker_new->ticks_to_expire = ticks_to_expire;
-		ticker_new->next = current;
+	previous = ticker_tree_lookup(instance, ticks_at, &parent);
+	if (previous == TICKER_NULL) {
+		ticks_to_expire = ticker_ticks_diff_get(ticks_at, ticks_base);
+		current = instance->ticker_id_head;
+	} else {
+		struct ticker_node *ticker_previous = &node[previous];
 
-		if (previous == current) {
-			instance->ticker_id_head = id;
-		} else {
-			node[previous].next = id;
+		ticks_to_expire =
+			ticker_ticks_diff_get(ticks_at,
+					      ticker_previous->ticks_at);
+		current = ticker_previous->next;
+	}
+
+	if (ticker_new->ticks_slot != 0) {
+		if (ticker_by_slot_previous_get(instance, previous, ticks_at,
+						ticks_base, &collide)) {
+			return collide;
 		}
 
-		if (current != TICKER_NULL) {
-			node[current].ticks_to_expire -= ticks_to_expire;
+		collide = ticker_by_slot_get(&node[0], current,
+					     ticks_to_expire +
+					     ticker_new->ticks_slot);
+		if (collide != TICKER_NULL) {
+			return collide;
 		}
+	}
+
+	ticker_new->ticks_at = ticks_at;
+	ticker_new->ticks_to_expire = ticks_to_expire;
+	ticker_new->next = current;
+
+	if (previous == TICKER_NULL) {
+		instance->ticker_id_head = id;
 	} else {
-		if (ticks_slot_previous > ticks_to_expire) {
-			id = ticker_id_slot_previous;
-		} else {
-			id = collide;
-		}
+		node[previous].next = id;
 	}
 
+	if (current != TICKER_NULL) {
+		node[current].ticks_to_expire -= ticks_to_expire;
+	}
+
+	ticker_tree_link(instance, id, parent, previous);
+
 	return id;
 }
 
@@ -267,39 +562,22 @@ static u32_t ticker_dequeue(struct ticker_instance *instance, u8_t id)
 {
 	struct ticker_node *ticker_current;
 	struct ticker_node *node;
+	u32_t ticks_base;
 	u8_t previous;
 	u32_t timeout;
-	u8_t current;
-	u32_t total;
 
-	/* find the ticker's position in ticker list */
 	node = &instance->node[0];
-	previous = instance->ticker_id_head;
-	current = previous;
-	total = 0;
-	ticker_current = 0;
-	while (current != TICKER_NULL) {
-
-		ticker_current = &node[current];
-
-		if (current == id) {
-			break;
-		}
-
-		total += ticker_current->ticks_to_expire;
-		previous = current;
-		current = ticker_current->next;
-	}
+	ticker_current = &node[id];
 
 	/* ticker not in active list */
-	if (current == TICKER_NULL) {
+	if (ticker_current->height == 0) {
 		return 0;
 	}
 
-	/* ticker is the first in the list */
-	if (previous == current) {
-		instance->ticker_id_head = ticker_current->next;
-	}
+	ticks_base = ticker_ticks_base_get(instance);
+	previous = ticker_tree_previous(node, id);
+
+	ticker_tree_unlink(instance, id);
 
 	/* remaining timeout between next timeout */
 	timeout = ticker_current->ticks_to_expire;
@@ -307,7 +585,11 @@ static u32_t ticker_dequeue(struct ticker_instance *instance, u8_t id)
 	/* link previous ticker with next of this ticker
 	 * i.e. removing the ticker from list
 	 */
-	node[previous].next = ticker_current->next;
+	if (previous == TICKER_NULL) {
+		instance->ticker_id_head = ticker_current->next;
+	} else {
+		node[previous].next = ticker_current->next;
+	}
 
 	/* if this is not the last ticker, increment the
 	 * next ticker by this ticker timeout
@@ -316,7 +598,7 @@ static u32_t ticker_dequeue(struct ticker_instance *instance, u8_t id)
 		node[ticker_current->next].ticks_to_expire += timeout;
 	}
 
-	return (total + timeout);
+	return ticker_ticks_diff_get(ticker_current->ticks_at, ticks_base);
 }
 
 static inline void ticker_worker(struct ticker_instance *instance)
@@ -622,6 +904,18 @@ static inline u8_t ticker_job_list_manage(struct ticker_instance *instance,
 				continue;
 			}
 
+			/* priority applies to the next insert, in any state */
+			if (user_op->op == TICKER_USER_OP_TYPE_PRIORITY_SET) {
+				ticker->priority =
+					user_op->params.priority_set.priority;
+				ticker->lazy_max =
+					user_op->params.priority_set.lazy_max;
+
+				ticker_job_op_cb(user_op,
+						 TICKER_STATUS_SUCCESS);
+				continue;
+			}
+
 			/* determine the ticker state */
 			state = (ticker->req - ticker->ack) & 0xff;
 
@@ -719,6 +1013,7 @@ static inline void ticker_job_worker_bh(struct ticker_instance *instance,
 
 		/* remove the expired ticker from head */
 		instance->ticker_id_head = ticker->next;
+		ticker_tree_unlink(instance, id_expired);
 
 		/* ticker will be restarted if periodic */
 		if (ticker->ticks_periodic != 0) {
@@ -770,6 +1065,48 @@ static inline void ticker_job_op_start(struct ticker_node *ticker,
 	ticker->force = 1;
 }
 
+static inline u16_t ticker_skip_get(struct ticker_node *ticker)
+{
+	/* No. of times ticker has skipped its interval */
+	if (ticker->lazy_current > ticker->lazy_periodic) {
+		return ticker->lazy_current - ticker->lazy_periodic;
+	}
+
+	return 0;
+}
+
+static inline bool ticker_collide_resolve(struct ticker_node *ticker,
+					  struct ticker_node *ticker_collide)
+{
+	u16_t skip_collide;
+	u16_t skip;
+	bool over_collide;
+	bool over;
+
+	/* only a periodic ticker can yield to its next interval */
+	if (!ticker_collide->ticks_periodic) {
+		return false;
+	}
+
+	skip = ticker_skip_get(ticker);
+	skip_collide = ticker_skip_get(ticker_collide);
+
+	/* a ticker that has used up its latency budget goes first */
+	over = ticker->lazy_max && (skip >= ticker->lazy_max);
+	over_collide = ticker_collide->lazy_max &&
+		       (skip_collide >= ticker_collide->lazy_max);
+	if (over != over_collide) {
+		return over;
+	}
+
+	if (ticker->priority != ticker_collide->priority) {
+		return ticker->priority < ticker_collide->priority;
+	}
+
+	return (skip_collide <= skip) &&
+	       (ticker_collide->force < ticker->force);
+}
+
 static inline u32_t ticker_job_insert(struct ticker_instance *instance,
 				      u8_t id_insert,
 				      struct ticker_node *ticker,
@@ -777,41 +1114,18 @@ static inline u32_t ticker_job_insert(struct ticker_instance *instance,
 {
 	struct ticker_node *node = &instance->node[0];
 	u8_t id_collide;
-	u16_t skip;
 
 	/* Prepare to insert */
 	ticker->next = TICKER_NULL;
 
-	/* No. of times ticker has skipped its interval */
-	if (ticker->lazy_current > ticker->lazy_periodic) {
-		skip = ticker->lazy_current -
-		       ticker->lazy_periodic;
-	} else {
-		skip = 0;
-	}
-
 	/* If insert collides, remove colliding or advance to next interval */
 	while (id_insert !=
 	       (id_collide = ticker_enqueue(instance, id_insert))) {
 		/* check for collision */
 		if (id_collide != TICKER_NULL) {
 			struct ticker_node *ticker_collide = &node[id_collide];
-			u16_t skip_collide;
-
-			/* No. of times ticker colliding has skipped its
-			 * interval.
-			 */
-			if (ticker_collide->lazy_current >
-			    ticker_collide->lazy_periodic) {
-				skip_collide = ticker_collide->lazy_current -
-					       ticker_collide->lazy_periodic;
-			} else {
-				skip_collide = 0;
-			}
 
-			if (ticker_collide->ticks_periodic &&
-			    skip_collide <= skip &&
-			    ticker_collide->force < ticker->force) {
+			if (ticker_collide_resolve(ticker, ticker_collide)) {
 				/* dequeue and get the reminder of ticks
 				 * to expire.
 				 */
@@ -992,6 +1306,10 @@ static inline void ticker_job_compare_update(struct ticker_instance *instance,
 		ticks_current = cntr_cnt_get();
 
 		if (cntr_start() == 0) {
+			/* tickers just queued are relative to the new tick */
+			ticker_tree_rebase(instance,
+					   ticker_ticks_diff_get(ticks_current,
+						instance->ticks_current));
 			instance->ticks_current = ticks_current;
 		}
 	}
@@ -1219,7 +1537,8 @@ static void ticker_instance0_sched(u8_t caller_id, u8_t callee_id, u8_t chain)
 			static struct mayfly m = {
 				0, 0, &link,
 				(void *)&_instance[0],
-				(void *)ticker_job
+				(void *)ticker_job,
+				MAYFLY_PRIO_HIGH
 			};
 
 			mayfly_enqueue(MAYFLY_CALL_ID_0,
@@ -1345,7 +1664,8 @@ static void ticker_instance1_sched(u8_t caller_id, u8_t callee_id, u8_t chain)
 			static struct mayfly m = {
 				0, 0, &link,
 				(void *)&_instance[1],
-				(void *)ticker_job
+				(void *)ticker_job,
+				MAYFLY_PRIO_HIGH
 			};
 
 			mayfly_enqueue(MAYFLY_CALL_ID_2,
@@ -1478,6 +1798,12 @@ u32_t ticker_init(u8_t instance_index, u8_t count_node, void *node,
 	instance->count_node = count_node;
 	instance->node = node;
 
+	while (count_node--) {
+		instance->node[count_node].height = 0;
+		instance->node[count_node].priority = TICKER_PRIORITY_DEFAULT;
+		instance->node[count_node].lazy_max = TICKER_NULL_LAZY_MAX;
+	}
+
 	instance->count_user = count_user;
 	instance->user = user;
 
@@ -1495,6 +1821,7 @@ u32_t ticker_init(u8_t instance_index, u8_t count_node, void *node,
 	}
 
 	instance->ticker_id_head = TICKER_NULL;
+	instance->ticker_id_root = TICKER_NULL;
 	instance->ticker_id_slot_previous = TICKER_NULL;
 	instance->ticks_slot_previous = 0;
 	instance->ticks_current = 0;
@@ -1639,6 +1966,42 @@ u32_t ticker_stop(u8_t instance_index, u8_t user_id, u8_t ticker_id,
 	return user_op->status;
 }
 
+u32_t ticker_priority_set(u8_t instance_index, u8_t user_id, u8_t ticker_id,
+			  s8_t priority, u16_t lazy_max,
+			  ticker_op_func fp_op_func, void *op_context)
+{
+	struct ticker_instance *instance = &_instance[instance_index];
+	struct ticker_user_op *user_op;
+	struct ticker_user *user;
+	u8_t last;
+
+	user = &instance->user[user_id];
+
+	last = user->last + 1;
+	if (last >= user->count_user_op) {
+		last = 0;
+	}
+
+	if (last == user->first) {
+		return TICKER_STATUS_FAILURE;
+	}
+
+	user_op = &user->user_op[user->last];
+	user_op->op = TICKER_USER_OP_TYPE_PRIORITY_SET;
+	user_op->id = ticker_id;
+	user_op->params.priority_set.priority = priority;
+	user_op->params.priority_set.lazy_max = lazy_max;
+	user_op->status = TICKER_STATUS_BUSY;
+	user_op->fp_op_func = fp_op_func;
+	user_op->op_context = op_context;
+
+	user->last = last;
+
+	instance->fp_sched(instance->fp_caller_id_get(user_id), CALL_ID_JOB, 0);
+
+	return user_op->status;
+}
+
 u32_t ticker_next_slot_get(u8_t instance_index, u8_t user_id, u8_t *ticker_id,
 			   u32_t *ticks_current, u32_t *ticks_to_expire,
 			   ticker_op_func fp_op_func, void *op_context)
@@ -8,6 +8,8 @@
 #ifndef _TICKER_H_
 #define _TICKER_H_
 
+#include <stdbool.h>
+
 /** \brief Macro to translate microseconds to tick units.
 *
 * \note This returns the floor value.
@@ -62,9 +64,28 @@
 * @}
 */
 
+/** \defgroup Timer priorities.
+*
+* On a slot collision the ticker with the lower priority value keeps its
+* slot. Tickers default to TICKER_PRIORITY_DEFAULT.
+*
+* @{
+*/
+#define TICKER_PRIORITY_DEFAULT	0
+#define TICKER_NULL_LAZY_MAX	0
+/**
+* @}
+*/
+
+#if defined(__LP64__)
+/* 64-bit hosts, when the ticker is built for unit tests */
+#define TICKER_NODE_T_SIZE	64
+#define TICKER_USER_T_SIZE	16
+#define TICKER_USER_OP_T_SIZE	72
+#else
 /** \brief Timer node type size.
 */
-#define TICKER_NODE_T_SIZE	36
+#define TICKER_NODE_T_SIZE	48
 
 /** \brief Timer user type size.
 */
@@ -73,6 +94,7 @@
 /** \brief Timer user operation type size.
 */
 #define TICKER_USER_OP_T_SIZE	44
+#endif
 
 /** \brief Timer timeout function type.
 */
@@ -109,6 +131,20 @@ u32_t ticker_update(u8_t instance_index, u8_t user_id, u8_t ticker_id,
 		    u8_t force, ticker_op_func fp_op_func, void *op_context);
 u32_t ticker_stop(u8_t instance_index, u8_t user_id, u8_t ticker_id,
 		  ticker_op_func fp_op_func, void *op_context);
+
+/** \brief Set the slot collision priority and latency budget of a ticker.
+*
+* \param[in]  priority  Lower value keeps its slot on a collision.
+* \param[in]  lazy_max  Latency budget, max. no. of consecutive intervals
+*			 the ticker yields to colliding tickers before it
+*			 takes precedence over those within their budget.
+*			 TICKER_NULL_LAZY_MAX for no budget.
+*
+* The values persist over ticker stop and start.
+*/
+u32_t ticker_priority_set(u8_t instance_index, u8_t user_id, u8_t ticker_id,
+			  s8_t priority, u16_t lazy_max,
+			  ticker_op_func fp_op_func, void *op_context);
 u32_t ticker_next_slot_get(u8_t instance_index, u8_t user_id,
 			   u8_t *ticker_id_head, u32_t *ticks_current,
 			   u32_t *ticks_to_expire,
@@ -10,15 +10,64 @@
 #include "mayfly.h"
 
 static struct {
-	memq_link_t *head;
-	memq_link_t *tail;
+	struct {
+		memq_link_t *head;
+		memq_link_t *tail;
+	} q[MAYFLY_PRIO_COUNT];
 	u8_t        enable_req;
 	u8_t        enable_ack;
 	u8_t        disable_req;
 	u8_t        disable_ack;
+#if defined(CONFIG_BT_CTLR_MAYFLY_STATS)
+	struct mayfly_stats stats;
+#endif /* CONFIG_BT_CTLR_MAYFLY_STATS */
 } mft[MAYFLY_CALLEE_COUNT][MAYFLY_CALLER_COUNT];
 
-static memq_link_t mfl[MAYFLY_CALLEE_COUNT][MAYFLY_CALLER_COUNT];
+static memq_link_t mfl[MAYFLY_CALLEE_COUNT][MAYFLY_CALLER_COUNT]
+		      [MAYFLY_PRIO_COUNT];
+
+#if defined(CONFIG_BT_CTLR_MAYFLY_STATS)
+static void stats_record(struct mayfly_stats *stats, u32_t latency)
+{
+	u8_t bucket = 0;
+
+	while (latency >> bucket) {
+		bucket++;
+	}
+
+	if (bucket >= MAYFLY_STATS_BUCKETS) {
+		bucket = MAYFLY_STATS_BUCKETS - 1;
+	}
+
+	stats->histogram[bucket]++;
+
+	if (stats->latency_max < latency) {
+		stats->latency_max = latency;
+	}
+}
+
+void mayfly_stats_get(u8_t caller_id, u8_t callee_id,
+		      struct mayfly_stats *stats)
+{
+	*stats = mft[callee_id][caller_id].stats;
+}
+
+void mayfly_stats_clear(void)
+{
+	u8_t callee_id;
+
+	callee_id = MAYFLY_CALLEE_COUNT;
+	while (callee_id--) {
+		u8_t caller_id;
+
+		caller_id = MAYFLY_CALLER_COUNT;
+		while (caller_id--) {
+			mft[callee_id][caller_id].stats =
+				(struct mayfly_stats){ 0 };
+		}
+	}
+}
+#endif /* CONFIG_BT_CTLR_MAYFLY_STATS */
 
 void mayfly_init(void)
 {
@@ -30,9 +79,14 @@ void mayfly_init(void)
 
 		caller_id = MAYFLY_CALLER_COUNT;
 		while (caller_id--) {
-			memq_init(&mfl[callee_id][caller_id],
-				  &mft[callee_id][caller_id].head,
-				  &mft[callee_id][caller_id].tail);
+			u8_t prio;
+
+			prio = MAYFLY_PRIO_COUNT;
+			while (prio--) {
+				memq_init(&mfl[callee_id][caller_id][prio],
+					  &mft[callee_id][caller_id].q[prio].head,
+					  &mft[callee_id][caller_id].q[prio].tail);
+			}
 		}
 	}
 }
@@ -75,6 +129,10 @@ u32_t mayfly_enqueue(u8_t caller_id, u8_t callee_id, u8_t chain,
 	if (state != 0) {
 		if (chain) {
 			if (state != 1) {
+#if defined(CONFIG_BT_CTLR_MAYFLY_STATS)
+				m->_cycles_enqueue = mayfly_cycles_get();
+#endif /* CONFIG_BT_CTLR_MAYFLY_STATS */
+
 				/* mark as ready in queue */
 				m->_req = ack + 1;
 
@@ -94,15 +152,23 @@ u32_t mayfly_enqueue(u8_t caller_id, u8_t callee_id, u8_t chain,
 
 	/* handle mayfly(s) that can be inline */
 	if (!chain) {
+#if defined(CONFIG_BT_CTLR_MAYFLY_STATS)
+		stats_record(&mft[callee_id][caller_id].stats, 0);
+#endif /* CONFIG_BT_CTLR_MAYFLY_STATS */
+
 		/* call fp */
 		m->fp(m->param);
 
 		return 0;
 	}
 
+#if defined(CONFIG_BT_CTLR_MAYFLY_STATS)
+	m->_cycles_enqueue = mayfly_cycles_get();
+#endif /* CONFIG_BT_CTLR_MAYFLY_STATS */
+
 	/* new, add as ready in the queue */
 	m->_req = ack + 1;
-	memq_enqueue(m->_link, m, &mft[callee_id][caller_id].tail);
+	memq_enqueue(m->_link, m, &mft[callee_id][caller_id].q[m->prio].tail);
 
 	/* pend the callee for execution */
 	mayfly_pend(caller_id, callee_id);
@@ -110,72 +176,91 @@ u32_t mayfly_enqueue(u8_t caller_id, u8_t callee_id, u8_t chain,
 	return 0;
 }
 
+/* Runs the ready mayflies of one queue. A mayfly pended again while it ran
+ * is left at the head of the queue for the next mayfly_run(), so that one
+ * re-pending itself cannot hold the callee; returns non-zero in that case.
+ */
+static u8_t mayfly_queue_run(u8_t callee_id, u8_t caller_id, u8_t prio)
+{
+	memq_link_t **head = &mft[callee_id][caller_id].q[prio].head;
+	memq_link_t *tail = mft[callee_id][caller_id].q[prio].tail;
+	struct mayfly *m = 0;
+	memq_link_t *link;
+
+	/* fetch mayfly in callee queue, if any */
+	link = memq_peek(*head, tail, (void **)&m);
+	while (link) {
+		u8_t state;
+		u8_t req;
+
+		/* execute work if ready */
+		req = m->_req;
+		state = (req - m->_ack) & 0x03;
+		if (state == 1) {
+#if defined(CONFIG_BT_CTLR_MAYFLY_STATS)
+			stats_record(&mft[callee_id][caller_id].stats,
+				     mayfly_cycles_get() - m->_cycles_enqueue);
+#endif /* CONFIG_BT_CTLR_MAYFLY_STATS */
+
+			/* mark mayfly as ran */
+			m->_ack--;
+
+			/* call the mayfly function */
+			m->fp(m->param);
+		}
+
+		/* leave in queue if re-pended */
+		req = m->_req;
+		if (((req - m->_ack) & 0x03) == 1) {
+			return 1;
+		}
+
+		memq_dequeue(tail, head, 0);
+
+		/* release link into dequeued mayfly struct */
+		m->_link = link;
+
+		/* reset mayfly state to idle */
+		m->_ack = req;
+
+		/* fetch next mayfly in callee queue, if any, including those
+		 * enqueued by pre-empting callers meanwhile.
+		 */
+		tail = mft[callee_id][caller_id].q[prio].tail;
+		link = memq_peek(*head, tail, (void **)&m);
+	}
+
+	return 0;
+}
+
 void mayfly_run(u8_t callee_id)
 {
 	u8_t disable = 0;
 	u8_t enable = 0;
+	u8_t pending = 0;
 	u8_t caller_id;
+	u8_t prio;
 
-	/* iterate through each caller queue to this callee_id */
-	caller_id = MAYFLY_CALLER_COUNT;
-	while (caller_id--) {
-		memq_link_t *link;
-		struct mayfly *m = 0;
-
-		/* fetch mayfly in callee queue, if any */
-		link = memq_peek(mft[callee_id][caller_id].head,
-				 mft[callee_id][caller_id].tail,
-				 (void **)&m);
-		while (link) {
-			u8_t state;
-			u8_t req;
-
-			/* execute work if ready */
-			req = m->_req;
-			state = (req - m->_ack) & 0x03;
-			if (state == 1) {
-				/* mark mayfly as ran */
-				m->_ack--;
-
-				/* call the mayfly function */
-				m->fp(m->param);
-			}
-
-			/* dequeue if not re-pended */
-			req = m->_req;
-			if (((req - m->_ack) & 0x03) != 1) {
-				memq_dequeue(mft[callee_id][caller_id].tail,
-					     &mft[callee_id][caller_id].head,
-					     0);
-
-				/* release link into dequeued mayfly struct */
-				m->_link = link;
+	/* drain the queues of all callers to this callee_id, higher priority
+	 * first.
+	 */
+	prio = MAYFLY_PRIO_COUNT;
+	while (prio--) {
+		caller_id = MAYFLY_CALLER_COUNT;
+		while (caller_id--) {
+			pending |= mayfly_queue_run(callee_id, caller_id, prio);
+		}
+	}
 
-				/* reset mayfly state to idle */
-				m->_ack = req;
-			}
+	/* pend callee (tailchain) for mayflies re-pended while they ran */
+	if (pending) {
+		mayfly_pend(callee_id, callee_id);
 
-			/* fetch next mayfly in callee queue, if any */
-			link = memq_peek(mft[callee_id][caller_id].head,
-					 mft[callee_id][caller_id].tail,
-					 (void **)&m);
-
-			/* yield out of mayfly_run if a mayfly function was
-			 * called.
-			 */
-			if (state == 1) {
-				/* pend callee (tailchain) if mayfly queue is
-				 * not empty or all caller queues are not
-				 * processed.
-				 */
-				if (caller_id || link) {
-					mayfly_pend(callee_id, callee_id);
-
-					return;
-				}
-			}
-		}
+		return;
+	}
 
+	caller_id = MAYFLY_CALLER_COUNT;
+	while (caller_id--) {
 		if (mft[callee_id][caller_id].disable_req !=
 		    mft[callee_id][caller_id].disable_ack) {
 			disable = 1;
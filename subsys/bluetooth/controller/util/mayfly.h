@@ -15,13 +15,36 @@
 #define MAYFLY_CALLER_COUNT    4
 #define MAYFLY_CALLEE_COUNT    4
 
+/* A callee runs queued high priority mayflies of all its callers before the
+ * normal ones.
+ */
+#define MAYFLY_PRIO_NORMAL     0
+#define MAYFLY_PRIO_HIGH       1
+#define MAYFLY_PRIO_COUNT      2
+
 struct mayfly {
 	u8_t volatile _req;
 	u8_t _ack;
 	memq_link_t *_link;
 	void *param;
 	void (*fp)(void *);
+	u8_t prio;
+#if defined(CONFIG_BT_CTLR_MAYFLY_STATS)
+	u32_t _cycles_enqueue;
+#endif /* CONFIG_BT_CTLR_MAYFLY_STATS */
+};
+
+#if defined(CONFIG_BT_CTLR_MAYFLY_STATS)
+/* Bucket 0 counts mayflies run without deferral, bucket n > 0 latencies
+ * from 2^(n - 1) up to 2^n - 1 cycles, the last one all longer latencies.
+ */
+#define MAYFLY_STATS_BUCKETS   8
+
+struct mayfly_stats {
+	u32_t latency_max;
+	u32_t histogram[MAYFLY_STATS_BUCKETS];
 };
+#endif /* CONFIG_BT_CTLR_MAYFLY_STATS */
 
 void mayfly_init(void);
 void mayfly_enable(u8_t caller_id, u8_t callee_id, u8_t enable);
@@ -34,4 +57,12 @@ extern u32_t mayfly_is_enabled(u8_t caller_id, u8_t callee_id);
 extern u32_t mayfly_prio_is_equal(u8_t caller_id, u8_t callee_id);
 extern void mayfly_pend(u8_t caller_id, u8_t callee_id);
 
+#if defined(CONFIG_BT_CTLR_MAYFLY_STATS)
+void mayfly_stats_get(u8_t caller_id, u8_t callee_id,
+		      struct mayfly_stats *stats);
+void mayfly_stats_clear(void);
+
+extern u32_t mayfly_cycles_get(void);
+#endif /* CONFIG_BT_CTLR_MAYFLY_STATS */
+
 #endif /* _MAYFLY_H_ */
@@ -0,0 +1,142 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <errno.h>
+
+#include <zephyr.h>
+#include <misc/byteorder.h>
+
+#include <bluetooth/crypto.h>
+
+#include <tinycrypt/constants.h>
+#include <tinycrypt/aes.h>
+
+/* The expanded key is TinyCrypt's key schedule, whichever cipher uses it */
+BUILD_ASSERT(sizeof(struct bt_aes_key) ==
+	     sizeof(struct tc_aes_key_sched_struct));
+
+#if defined(CONFIG_BT_HOST_AES_TTABLE)
+/*
+ * Table driven AES: one lookup in te0, rotated for the row a byte comes
+ * from, does SubBytes and MixColumns for one byte of a round. The tables
+ * are computed on first use rather than stored, as in most table driven
+ * implementations for small devices.
+ */
+static u8_t sbox[256];
+static u32_t te0[256];
+static bool tables_ready;
+
+static inline u8_t xtime(u8_t x)
+{
+	return (x << 1) ^ ((x & 0x80) ? 0x1b : 0x00);
+}
+
+static inline u8_t rotl8(u8_t x, int n)
+{
+	return (x << n) | (x >> (8 - n));
+}
+
+static inline u32_t ror32(u32_t x, int n)
+{
+	return (x >> n) | (x << (32 - n));
+}
+
+static void tables_init(void)
+{
+	u8_t pow[256], log[256];
+	u8_t x, s;
+	int i;
+
+	/* powers of the generator 3 in GF(2^8), to find inverses */
+	for (i = 0, x = 1; i < 256; i++) {
+		pow[i] = x;
+		log[x] = i;
+		x ^= xtime(x);
+	}
+
+	for (i = 0; i < 256; i++) {
+		x = i ? pow[255 - log[i]] : 0;
+		s = x ^ rotl8(x, 1) ^ rotl8(x, 2) ^ rotl8(x, 3) ^
+		    rotl8(x, 4) ^ 0x63;
+
+		sbox[i] = s;
+		te0[i] = ((u32_t)xtime(s) << 24) | ((u32_t)s << 16) |
+			 ((u32_t)s << 8) | (u8_t)(xtime(s) ^ s);
+	}
+
+	/* concurrent first users compute the same values */
+	tables_ready = true;
+}
+
+#define TE(w, row) ror32(te0[((w) >> (24 - 8 * (row))) & 0xff], 8 * (row))
+#define SB(w, row) ((u32_t)sbox[((w) >> (24 - 8 * (row))) & 0xff] << \
+		    (24 - 8 * (row)))
+
+static void ttable_encrypt(const u32_t *rk, const u8_t in[16], u8_t out[16])
+{
+	u32_t s0, s1, s2, s3, t0, t1, t2, t3;
+	int round;
+
+	s0 = sys_get_be32(&in[0]) ^ rk[0];
+	s1 = sys_get_be32(&in[4]) ^ rk[1];
+	s2 = sys_get_be32(&in[8]) ^ rk[2];
+	s3 = sys_get_be32(&in[12]) ^ rk[3];
+
+	for (round = 1; round < 10; round++) {
+		rk += 4;
+		t0 = TE(s0, 0) ^ TE(s1, 1) ^ TE(s2, 2) ^ TE(s3, 3) ^ rk[0];
+		t1 = TE(s1, 0) ^ TE(s2, 1) ^ TE(s3, 2) ^ TE(s0, 3) ^ rk[1];
+		t2 = TE(s2, 0) ^ TE(s3, 1) ^ TE(s0, 2) ^ TE(s1, 3) ^ rk[2];
+		t3 = TE(s3, 0) ^ TE(s0, 1) ^ TE(s1, 2) ^ TE(s2, 3) ^ rk[3];
+		s0 = t0;
+		s1 = t1;
+		s2 = t2;
+		s3 = t3;
+	}
+
+	/* the last round has no MixColumns */
+	rk += 4;
+	sys_put_be32((SB(s0, 0) | SB(s1, 1) | SB(s2, 2) | SB(s3, 3)) ^ rk[0],
+		     &out[0]);
+	sys_put_be32((SB(s1, 0) | SB(s2, 1) | SB(s3, 2) | SB(s0, 3)) ^ rk[1],
+		     &out[4]);
+	sys_put_be32((SB(s2, 0) | SB(s3, 1) | SB(s0, 2) | SB(s1, 3)) ^ rk[2],
+		     &out[8]);
+	sys_put_be32((SB(s3, 0) | SB(s0, 1) | SB(s1, 2) | SB(s2, 3)) ^ rk[3],
+		     &out[12]);
+}
+#endif /* CONFIG_BT_HOST_AES_TTABLE */
+
+int bt_aes_key_set(struct bt_aes_key *key, const u8_t key_be[16])
+{
+#if defined(CONFIG_BT_HOST_AES_TTABLE)
+	if (!tables_ready) {
+		tables_init();
+	}
+#endif
+
+	if (tc_aes128_set_encrypt_key((struct tc_aes_key_sched_struct *)key,
+				      key_be) == TC_CRYPTO_FAIL) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+int bt_aes_encrypt_be(const struct bt_aes_key *key, const u8_t plaintext[16],
+		      u8_t enc_data[16])
+{
+#if defined(CONFIG_BT_HOST_AES_TTABLE)
+	ttable_encrypt(key->words, plaintext, enc_data);
+#else
+	if (tc_aes_encrypt(enc_data, plaintext,
+			   (struct tc_aes_key_sched_struct *)key) ==
+	    TC_CRYPTO_FAIL) {
+		return -EINVAL;
+	}
+#endif
+
+	return 0;
+}
@@ -88,6 +88,7 @@ struct bt_att {
 	sys_slist_t		reqs;
 	struct k_delayed_work	timeout_work;
 	struct k_sem            tx_sem;
+	struct k_sem            cmd_sem;
 #if CONFIG_BT_ATT_PREPARE_COUNT > 0
 	struct k_fifo		prep_queue;
 #endif
@@ -169,6 +170,15 @@ static void att_pdu_sent(struct bt_conn *conn)
 	k_sem_give(&att->tx_sem);
 }
 
+static void att_cmd_sent(struct bt_conn *conn)
+{
+	struct bt_att *att = att_get(conn);
+
+	BT_DBG("conn %p att %p", conn, att);
+
+	k_sem_give(&att->cmd_sem);
+}
+
 static bt_conn_tx_cb_t att_cb(struct net_buf *buf)
 {
 	switch (att_op_get_type(buf->data[0])) {
@@ -179,6 +189,8 @@ static bt_conn_tx_cb_t att_cb(struct net_buf *buf)
 	case ATT_REQUEST:
 	case ATT_INDICATION:
 		return att_req_sent;
+	case ATT_COMMAND:
+		return att_cmd_sent;
 	default:
 		return att_pdu_sent;
 	}
@@ -511,6 +523,7 @@ struct find_type_data {
 	struct bt_att_handle_group *group;
 	const void *value;
 	u8_t value_len;
+	u16_t end_handle;
 	u8_t err;
 };
 
@@ -522,20 +535,6 @@ static u8_t find_type_cb(const struct bt_gatt_attr *attr, void *user_data)
 	int read;
 	u8_t uuid[16];
 
-	/* Skip secondary services */
-	if (!bt_uuid_cmp(attr->uuid, BT_UUID_GATT_SECONDARY)) {
-		data->group = NULL;
-		return BT_GATT_ITER_CONTINUE;
-	}
-
-	/* Update group end_handle if not a primary service */
-	if (bt_uuid_cmp(attr->uuid, BT_UUID_GATT_PRIMARY)) {
-		if (data->group && attr->handle > data->group->end_handle) {
-			data->group->end_handle = sys_cpu_to_le16(attr->handle);
-		}
-		return BT_GATT_ITER_CONTINUE;
-	}
-
 	BT_DBG("handle 0x%04x", attr->handle);
 
 	/* stop if there is no space left */
@@ -550,13 +549,11 @@ static u8_t find_type_cb(const struct bt_gatt_attr *attr, void *user_data)
 		 * Since we don't know if it is the service with requested UUID,
 		 * we cannot respond with an error to this request.
 		 */
-		data->group = NULL;
 		return BT_GATT_ITER_CONTINUE;
 	}
 
 	/* Check if data matches */
 	if (read != data->value_len || memcmp(data->value, uuid, read)) {
-		data->group = NULL;
 		return BT_GATT_ITER_CONTINUE;
 	}
 
@@ -566,9 +563,9 @@ static u8_t find_type_cb(const struct bt_gatt_attr *attr, void *user_data)
 	/* Fast foward to next item position */
 	data->group = net_buf_add(data->buf, sizeof(*data->group));
 	data->group->start_handle = sys_cpu_to_le16(attr->handle);
-	data->group->end_handle = sys_cpu_to_le16(attr->handle);
+	data->group->end_handle =
+		sys_cpu_to_le16(bt_gatt_attr_group_end(attr, data->end_handle));
 
-	/* continue to find the end_handle */
 	return BT_GATT_ITER_CONTINUE;
 }
 
@@ -590,11 +587,13 @@ static u8_t att_find_type_rsp(struct bt_att *att, u16_t start_handle,
 	data.group = NULL;
 	data.value = value;
 	data.value_len = value_len;
+	data.end_handle = end_handle;
 
 	/* Pre-set error in case no service will be found */
 	data.err = BT_ATT_ERR_ATTRIBUTE_NOT_FOUND;
 
-	bt_gatt_foreach_attr(start_handle, end_handle, find_type_cb, &data);
+	bt_gatt_foreach_attr_type(start_handle, end_handle,
+				  BT_UUID_GATT_PRIMARY, find_type_cb, &data);
 
 	/* If error has not been cleared, no service has been found */
 	if (data.err) {
@@ -714,7 +713,6 @@ static u8_t err_to_att(int err)
 
 struct read_type_data {
 	struct bt_att *att;
-	struct bt_uuid *uuid;
 	struct net_buf *buf;
 	struct bt_att_read_type_rsp *rsp;
 	struct bt_att_data *item;
@@ -728,11 +726,6 @@ static u8_t read_type_cb(const struct bt_gatt_attr *attr, void *user_data)
 	struct bt_conn *conn = att->chan.chan.conn;
 	int read;
 
-	/* Skip if doesn't match */
-	if (bt_uuid_cmp(attr->uuid, data->uuid)) {
-		return BT_GATT_ITER_CONTINUE;
-	}
-
 	BT_DBG("handle 0x%04x", attr->handle);
 
 	/*
@@ -802,14 +795,14 @@ static u8_t att_read_type_rsp(struct bt_att *att, struct bt_uuid *uuid,
 	}
 
 	data.att = att;
-	data.uuid = uuid;
 	data.rsp = net_buf_add(data.buf, sizeof(*data.rsp));
 	data.rsp->len = 0;
 
 	/* Pre-set error if no attr will be found in handle */
 	data.err = BT_ATT_ERR_ATTRIBUTE_NOT_FOUND;
 
-	bt_gatt_foreach_attr(start_handle, end_handle, read_type_cb, &data);
+	bt_gatt_foreach_attr_type(start_handle, end_handle, uuid, read_type_cb,
+				  &data);
 
 	if (data.err) {
 		net_buf_unref(data.buf);
@@ -1021,12 +1014,89 @@ static u8_t att_read_mult_req(struct bt_att *att, struct net_buf *buf)
 	return 0;
 }
 
+static u8_t read_vl_cb(const struct bt_gatt_attr *attr, void *user_data)
+{
+	struct read_data *data = user_data;
+	struct bt_att *att = data->att;
+	struct bt_conn *conn = att->chan.chan.conn;
+	struct bt_att_read_mult_vl_rsp *rsp;
+	int read;
+
+	BT_DBG("handle 0x%04x", attr->handle);
+
+	data->err = check_perm(conn, attr, BT_GATT_PERM_READ_MASK);
+	if (data->err) {
+		return BT_GATT_ITER_STOP;
+	}
+
+	rsp = net_buf_add(data->buf, sizeof(*rsp));
+
+	read = attr->read(conn, attr, data->buf->data + data->buf->len,
+			  att->chan.tx.mtu - data->buf->len, 0);
+	if (read < 0) {
+		data->err = err_to_att(read);
+		return BT_GATT_ITER_STOP;
+	}
+
+	rsp->len = sys_cpu_to_le16(read);
+	net_buf_add(data->buf, read);
+
+	return BT_GATT_ITER_CONTINUE;
+}
+
+static u8_t att_read_mult_vl_req(struct bt_att *att, struct net_buf *buf)
+{
+	struct bt_conn *conn = att->chan.chan.conn;
+	struct read_data data;
+	u16_t handle;
+
+	memset(&data, 0, sizeof(data));
+
+	data.buf = bt_att_create_pdu(conn, BT_ATT_OP_READ_MULT_VL_RSP, 0);
+	if (!data.buf) {
+		return BT_ATT_ERR_UNLIKELY;
+	}
+
+	data.att = att;
+
+	while (buf->len >= sizeof(u16_t)) {
+		/* The list is truncated when no other length fits */
+		if (att->chan.tx.mtu - data.buf->len <
+		    sizeof(struct bt_att_read_mult_vl_rsp)) {
+			break;
+		}
+
+		handle = net_buf_pull_le16(buf);
+
+		BT_DBG("handle 0x%04x ", handle);
+
+		/* As for Read Multiple, any handle that is invalid or not
+		 * readable makes the whole request fail.
+		 */
+		data.err = BT_ATT_ERR_INVALID_HANDLE;
+
+		bt_gatt_foreach_attr(handle, handle, read_vl_cb, &data);
+
+		if (data.err) {
+			net_buf_unref(data.buf);
+			/* Respond here since handle is set */
+			send_err_rsp(conn, BT_ATT_OP_READ_MULT_VL_REQ, handle,
+				     data.err);
+			return 0;
+		}
+	}
+
+	bt_l2cap_send_cb(conn, BT_L2CAP_CID_ATT, data.buf, att_rsp_sent);
+
+	return 0;
+}
+
 struct read_group_data {
 	struct bt_att *att;
-	struct bt_uuid *uuid;
 	struct net_buf *buf;
 	struct bt_att_read_group_rsp *rsp;
 	struct bt_att_group_data *group;
+	u16_t end_handle;
 };
 
 static u8_t read_group_cb(const struct bt_gatt_attr *attr, void *user_data)
@@ -1036,21 +1106,6 @@ static u8_t read_group_cb(const struct bt_gatt_attr *attr, void *user_data)
 	struct bt_conn *conn = att->chan.chan.conn;
 	int read;
 
-	/* Update group end_handle if attribute is not a service */
-	if (bt_uuid_cmp(attr->uuid, BT_UUID_GATT_PRIMARY) &&
-	    bt_uuid_cmp(attr->uuid, BT_UUID_GATT_SECONDARY)) {
-		if (data->group && attr->handle > data->group->end_handle) {
-			data->group->end_handle = sys_cpu_to_le16(attr->handle);
-		}
-		return BT_GATT_ITER_CONTINUE;
-	}
-
-	/* If Group Type don't match skip */
-	if (bt_uuid_cmp(attr->uuid, data->uuid)) {
-		data->group = NULL;
-		return BT_GATT_ITER_CONTINUE;
-	}
-
 	BT_DBG("handle 0x%04x", attr->handle);
 
 	/* Stop if there is no space left */
@@ -1064,7 +1119,8 @@ static u8_t read_group_cb(const struct bt_gatt_attr *attr, void *user_data)
 
 	/* Initialize group handle range */
 	data->group->start_handle = sys_cpu_to_le16(attr->handle);
-	data->group->end_handle = sys_cpu_to_le16(attr->handle);
+	data->group->end_handle =
+		sys_cpu_to_le16(bt_gatt_attr_group_end(attr, data->end_handle));
 
 	/* Read attribute value and store in the buffer */
 	read = attr->read(conn, attr, data->buf->data + data->buf->len,
@@ -1085,7 +1141,6 @@ static u8_t read_group_cb(const struct bt_gatt_attr *attr, void *user_data)
 
 	net_buf_add(data->buf, read);
 
-	/* Continue to find the end handle */
 	return BT_GATT_ITER_CONTINUE;
 }
 
@@ -1104,12 +1159,13 @@ static u8_t att_read_group_rsp(struct bt_att *att, struct bt_uuid *uuid,
 	}
 
 	data.att = att;
-	data.uuid = uuid;
 	data.rsp = net_buf_add(data.buf, sizeof(*data.rsp));
 	data.rsp->len = 0;
 	data.group = NULL;
+	data.end_handle = end_handle;
 
-	bt_gatt_foreach_attr(start_handle, end_handle, read_group_cb, &data);
+	bt_gatt_foreach_attr_type(start_handle, end_handle, uuid, read_group_cb,
+				  &data);
 
 	if (!data.rsp->len) {
 		net_buf_unref(data.buf);
@@ -1677,6 +1733,32 @@ static u8_t att_notify(struct bt_att *att, struct net_buf *buf)
 	return 0;
 }
 
+static u8_t att_notify_mult(struct bt_att *att, struct net_buf *buf)
+{
+	struct bt_conn *conn = att->chan.chan.conn;
+
+	while (buf->len >= sizeof(struct bt_att_notify_mult)) {
+		struct bt_att_notify_mult *nfy = (void *)buf->data;
+		u16_t handle, len;
+
+		handle = sys_le16_to_cpu(nfy->handle);
+		len = sys_le16_to_cpu(nfy->len);
+		net_buf_pull(buf, sizeof(*nfy));
+
+		BT_DBG("handle 0x%04x len %u", handle, len);
+
+		if (len > buf->len) {
+			BT_ERR("Invalid notification length %u", len);
+			break;
+		}
+
+		bt_gatt_notification(conn, handle, buf->data, len);
+		net_buf_pull(buf, len);
+	}
+
+	return 0;
+}
+
 static u8_t att_indicate(struct bt_att *att, struct net_buf *buf)
 {
 	struct bt_conn *conn = att->chan.chan.conn;
@@ -1771,6 +1853,10 @@ static const struct att_handler {
 		sizeof(struct bt_att_read_mult_rsp),
 		ATT_RESPONSE,
 		att_handle_read_mult_rsp },
+	{ BT_ATT_OP_READ_MULT_VL_REQ,
+		BT_ATT_READ_MULT_VL_MIN_LEN_REQ,
+		ATT_REQUEST,
+		att_read_mult_vl_req },
 	{ BT_ATT_OP_READ_GROUP_REQ,
 		sizeof(struct bt_att_read_group_req),
 		ATT_REQUEST,
@@ -1807,6 +1893,10 @@ static const struct att_handler {
 		sizeof(struct bt_att_indicate),
 		ATT_INDICATION,
 		att_indicate },
+	{ BT_ATT_OP_NOTIFY_MULT,
+		sizeof(struct bt_att_notify_mult),
+		ATT_NOTIFICATION,
+		att_notify_mult },
 	{ BT_ATT_OP_CONFIRM,
 		0,
 		ATT_CONFIRMATION,
@@ -1969,6 +2059,10 @@ static void att_reset(struct bt_att *att)
 		k_sem_give(&att->tx_sem);
 	}
 
+	for (i = 0; i < CONFIG_BT_L2CAP_TX_BUF_COUNT; i++) {
+		k_sem_give(&att->cmd_sem);
+	}
+
 	/* Notify pending requests */
 	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&att->reqs, req, tmp, node) {
 		if (req->func) {
@@ -2088,6 +2182,16 @@ static void bt_att_encrypt_change(struct bt_l2cap_chan *chan,
 }
 #endif /* CONFIG_BT_SMP */
 
+/* Commands get no response, so as many of them may be in flight as the
+ * controller takes ACL packets, rather than CONFIG_BT_ATT_TX_MAX.
+ */
+static unsigned int att_cmd_window(struct bt_conn *conn)
+{
+	unsigned int window = bt_conn_get_pkts(conn)->limit;
+
+	return max(1, min(window, CONFIG_BT_L2CAP_TX_BUF_COUNT));
+}
+
 static int bt_att_accept(struct bt_conn *conn, struct bt_l2cap_chan **chan)
 {
 	int i;
@@ -2113,6 +2217,8 @@ static int bt_att_accept(struct bt_conn *conn, struct bt_l2cap_chan **chan)
 		atomic_set(att->flags, 0);
 		k_sem_init(&att->tx_sem, CONFIG_BT_ATT_TX_MAX,
 			   CONFIG_BT_ATT_TX_MAX);
+		k_sem_init(&att->cmd_sem, att_cmd_window(conn),
+			   att_cmd_window(conn));
 
 		*chan = &att->chan.chan;
 
@@ -2153,6 +2259,7 @@ int bt_att_send(struct bt_conn *conn, struct net_buf *buf)
 {
 	struct bt_att *att;
 	struct bt_att_hdr *hdr;
+	struct k_sem *sem;
 
 	if (!conn || !buf) {
 		return -EINVAL;
@@ -2163,24 +2270,30 @@ int bt_att_send(struct bt_conn *conn, struct net_buf *buf)
 		return -ENOTCONN;
 	}
 
-	k_sem_take(&att->tx_sem, K_FOREVER);
+	hdr = (void *)buf->data;
+
+	BT_DBG("code 0x%02x", hdr->code);
+
+	if (att_op_get_type(hdr->code) == ATT_COMMAND) {
+		sem = &att->cmd_sem;
+	} else {
+		sem = &att->tx_sem;
+	}
+
+	k_sem_take(sem, K_FOREVER);
 	if (!att_is_connected(att)) {
 		BT_WARN("Disconnected");
-		k_sem_give(&att->tx_sem);
+		k_sem_give(sem);
 		return -ENOTCONN;
 	}
 
-	hdr = (void *)buf->data;
-
-	BT_DBG("code 0x%02x", hdr->code);
-
 	if (hdr->code == BT_ATT_OP_SIGNED_WRITE_CMD) {
 		int err;
 
 		err = bt_smp_sign(conn, buf);
 		if (err) {
 			BT_ERR("Error signing data");
-			k_sem_give(&att->tx_sem);
+			k_sem_give(sem);
 			return err;
 		}
 	}
@@ -218,6 +218,29 @@ struct bt_att_indicate {
 /* Handle Value Confirm */
 #define BT_ATT_OP_CONFIRM			0x1e
 
+/* Read Multiple Variable Length Request */
+#define BT_ATT_READ_MULT_VL_MIN_LEN_REQ		0x04
+
+#define BT_ATT_OP_READ_MULT_VL_REQ		0x20
+struct bt_att_read_mult_vl_req {
+	u16_t handles[0];
+} __packed;
+
+/* Read Multiple Variable Length Respose */
+#define BT_ATT_OP_READ_MULT_VL_RSP		0x21
+struct bt_att_read_mult_vl_rsp {
+	u16_t len;
+	u8_t  value[0];
+} __packed;
+
+/* Multiple Handle Value Notification */
+#define BT_ATT_OP_NOTIFY_MULT			0x23
+struct bt_att_notify_mult {
+	u16_t handle;
+	u16_t len;
+	u8_t  value[0];
+} __packed;
+
 struct bt_att_signature {
 	u8_t  value[12];
 } __packed;
@@ -37,6 +37,13 @@ NET_BUF_POOL_DEFINE(acl_tx_pool, CONFIG_BT_L2CAP_TX_BUF_COUNT,
 		    BT_L2CAP_BUF_SIZE(CONFIG_BT_L2CAP_TX_MTU),
 		    CONFIG_BT_L2CAP_TX_USER_DATA_SIZE, NULL);
 
+#if CONFIG_BT_L2CAP_TX_FRAG_COUNT > 0
+/* Fragments of the packets longer than the controller takes */
+NET_BUF_POOL_DEFINE(frag_pool, CONFIG_BT_L2CAP_TX_FRAG_COUNT,
+		    BT_L2CAP_BUF_SIZE(CONFIG_BT_L2CAP_TX_MTU),
+		    CONFIG_BT_L2CAP_TX_USER_DATA_SIZE, NULL);
+#endif /* CONFIG_BT_L2CAP_TX_FRAG_COUNT > 0 */
+
 /* How long until we cancel HCI_LE_Create_Connection */
 #define CONN_TIMEOUT	K_SECONDS(3)
 
@@ -209,6 +216,7 @@ static struct bt_conn *conn_new(void)
 	memset(conn, 0, sizeof(*conn));
 
 	atomic_set(&conn->ref, 1);
+	conn->tx_weight = 1;
 
 	return conn;
 }
@@ -1056,6 +1064,7 @@ int bt_conn_send_cb(struct bt_conn *conn, struct net_buf *buf,
 		    bt_conn_tx_cb_t cb)
 {
 	struct net_buf_pool *pool;
+	atomic_val_t depth;
 
 	BT_DBG("conn handle %u buf len %u cb %p", conn->handle, buf->len, cb);
 
@@ -1074,6 +1083,16 @@ int bt_conn_send_cb(struct bt_conn *conn, struct net_buf *buf,
 
 	conn_tx(buf)->cb = cb;
 
+	/* A packet queued behind none starts waiting at the head now */
+	depth = atomic_inc(&conn->tx_depth);
+	if (!depth) {
+		conn->tx_head_time = k_uptime_get_32();
+	}
+
+	if (depth >= conn->tx_stats.queued_max) {
+		conn->tx_stats.queued_max = depth + 1;
+	}
+
 	net_buf_put(&conn->tx_queue, buf);
 	return 0;
 }
@@ -1145,8 +1164,29 @@ static void remove_pending_tx(struct bt_conn *conn, sys_snode_t *node)
 	tx_free(CONTAINER_OF(node, struct bt_conn_tx, node));
 }
 
-static bool send_frag(struct bt_conn *conn, struct net_buf *buf, u8_t flags,
-		      bool always_consume)
+static void tx_done(struct bt_conn *conn, bool sent)
+{
+	u32_t now = k_uptime_get_32();
+	u32_t latency = now - conn->tx_head_time;
+
+	if (sent) {
+		conn->tx_stats.sent++;
+		conn->tx_latency_sum += latency;
+		if (latency > conn->tx_stats.latency_max) {
+			conn->tx_stats.latency_max = latency;
+		}
+	}
+
+	/* The next packet waits at the head of the queue from now on */
+	if (atomic_dec(&conn->tx_depth) > 1) {
+		conn->tx_head_time = now;
+	}
+}
+
+/* Called with a controller buffer taken, which is given back on failure.
+ * The buffer is consumed in any case.
+ */
+static bool send_frag(struct bt_conn *conn, struct net_buf *buf, u8_t flags)
 {
 	struct bt_hci_acl_hdr *hdr;
 	bt_conn_tx_cb_t cb;
@@ -1156,17 +1196,9 @@ static bool send_frag(struct bt_conn *conn, struct net_buf *buf, u8_t flags,
 	BT_DBG("conn %p buf %p len %u flags 0x%02x", conn, buf, buf->len,
 	       flags);
 
-	/* Wait until the controller can accept ACL packets */
-	k_sem_take(bt_conn_get_pkts(conn), K_FOREVER);
-
 	/* Make sure we notify and free up any pending tx contexts */
 	notify_tx();
 
-	/* Check for disconnection while waiting for pkts_sem */
-	if (conn->state != BT_CONN_CONNECTED) {
-		goto fail;
-	}
-
 	hdr = net_buf_push(buf, sizeof(*hdr));
 	hdr->handle = sys_cpu_to_le16(bt_acl_handle_pack(conn->handle, flags));
 	hdr->len = sys_cpu_to_le16(buf->len - sizeof(*hdr));
@@ -1180,17 +1212,14 @@ static bool send_frag(struct bt_conn *conn, struct net_buf *buf, u8_t flags,
 	if (err) {
 		BT_ERR("Unable to send to driver (err %d)", err);
 		remove_pending_tx(conn, node);
-		goto fail;
+		k_sem_give(bt_conn_get_pkts(conn));
+		net_buf_unref(buf);
+		return false;
 	}
 
-	return true;
+	conn->tx_stats.frags++;
 
-fail:
-	k_sem_give(bt_conn_get_pkts(conn));
-	if (always_consume) {
-		net_buf_unref(buf);
-	}
-	return false;
+	return true;
 }
 
 static inline u16_t conn_mtu(struct bt_conn *conn)
@@ -1209,12 +1238,11 @@ static struct net_buf *create_frag(struct bt_conn *conn, struct net_buf *buf)
 	struct net_buf *frag;
 	u16_t frag_len;
 
+#if CONFIG_BT_L2CAP_TX_FRAG_COUNT > 0
+	frag = bt_conn_create_pdu(&frag_pool, 0);
+#else
 	frag = bt_conn_create_pdu(NULL, 0);
-
-	if (conn->state != BT_CONN_CONNECTED) {
-		net_buf_unref(frag);
-		return NULL;
-	}
+#endif
 
 	/* Fragments never have a TX completion callback */
 	conn_tx(frag)->cb = NULL;
@@ -1227,43 +1255,94 @@ static struct net_buf *create_frag(struct bt_conn *conn, struct net_buf *buf)
 	return frag;
 }
 
-static bool send_buf(struct bt_conn *conn, struct net_buf *buf)
+static bool conn_tx_pending(struct bt_conn *conn)
 {
-	struct net_buf *frag;
+	return conn->tx_buf || !k_fifo_is_empty(&conn->tx_queue);
+}
+
+/* Sends the next fragment of the connection, returns false if the
+ * controller has no buffer for it.
+ */
+static bool send_next_frag(struct bt_conn *conn)
+{
+	struct net_buf *buf, *frag;
+	u8_t flags;
+
+	if (k_sem_take(bt_conn_get_pkts(conn), K_NO_WAIT)) {
+		return false;
+	}
+
+	if (!conn->tx_buf) {
+		conn->tx_buf = net_buf_get(&conn->tx_queue, K_NO_WAIT);
+		conn->tx_flags = BT_ACL_START_NO_FLUSH;
+		BT_ASSERT(conn->tx_buf);
+	}
+
+	buf = conn->tx_buf;
+	flags = conn->tx_flags;
 
 	BT_DBG("conn %p buf %p len %u", conn, buf, buf->len);
 
-	/* Send directly if the packet fits the ACL MTU */
+	/* The last fragment is the original buffer, which works since
+	 * net_buf_pull has been used on it.
+	 */
 	if (buf->len <= conn_mtu(conn)) {
-		return send_frag(conn, buf, BT_ACL_START_NO_FLUSH, false);
+		conn->tx_buf = NULL;
+		tx_done(conn, send_frag(conn, buf, flags));
+		return true;
 	}
 
-	/* Create & enqueue first fragment */
 	frag = create_frag(conn, buf);
-	if (!frag) {
-		return false;
-	}
+	conn->tx_flags = BT_ACL_CONT;
 
-	if (!send_frag(conn, frag, BT_ACL_START_NO_FLUSH, true)) {
-		return false;
+	/* The rest of a packet is of no use once a fragment is lost */
+	if (!send_frag(conn, frag, flags)) {
+		conn->tx_buf = NULL;
+		net_buf_unref(buf);
+		tx_done(conn, false);
 	}
 
-	/*
-	 * Send the fragments. For the last one simply use the original
-	 * buffer (which works since we've used net_buf_pull on it.
+	return true;
+}
+
+/* Connection having the turn, and the fragments it sent in it */
+static u8_t tx_turn_conn;
+static u8_t tx_turn_frags;
+
+void bt_conn_process_tx(void)
+{
+	int i = tx_turn_conn;
+	int idle = 0;
+
+	/* Connections take turns to send up to their weight in fragments,
+	 * as long as the controller has buffers for them. One without data
+	 * or controller buffers passes its turn to the next.
 	 */
-	while (buf->len > conn_mtu(conn)) {
-		frag = create_frag(conn, buf);
-		if (!frag) {
-			return false;
+	while (idle < ARRAY_SIZE(conns)) {
+		struct bt_conn *conn = &conns[i];
+
+		if (!atomic_get(&conn->ref) ||
+		    conn->state != BT_CONN_CONNECTED ||
+		    !conn_tx_pending(conn) || !send_next_frag(conn)) {
+			i = (i + 1) % ARRAY_SIZE(conns);
+			idle++;
+			continue;
 		}
 
-		if (!send_frag(conn, frag, BT_ACL_CONT, true)) {
-			return false;
+		idle = 0;
+
+		if (i != tx_turn_conn) {
+			tx_turn_conn = i;
+			tx_turn_frags = 0;
 		}
-	}
 
-	return send_frag(conn, buf, BT_ACL_CONT, false);
+		if (++tx_turn_frags >= conn->tx_weight ||
+		    !conn_tx_pending(conn)) {
+			i = (i + 1) % ARRAY_SIZE(conns);
+			tx_turn_conn = i;
+			tx_turn_frags = 0;
+		}
+	}
 }
 
 static struct k_poll_signal conn_change =
@@ -1274,10 +1353,17 @@ static void conn_cleanup(struct bt_conn *conn)
 	struct net_buf *buf;
 
 	/* Give back any allocated buffers */
+	if (conn->tx_buf) {
+		net_buf_unref(conn->tx_buf);
+		conn->tx_buf = NULL;
+	}
+
 	while ((buf = net_buf_get(&conn->tx_queue, K_NO_WAIT))) {
 		net_buf_unref(buf);
 	}
 
+	atomic_set(&conn->tx_depth, 0);
+
 	__ASSERT(sys_slist_is_empty(&conn->tx_pending), "Pending TX packets");
 
 	bt_conn_notify_tx(conn);
@@ -1292,6 +1378,7 @@ static void conn_cleanup(struct bt_conn *conn)
 
 int bt_conn_prepare_events(struct k_poll_event events[])
 {
+	struct k_sem *pkts, *blocked[2] = { NULL, NULL };
 	int i, ev_count = 0;
 
 	BT_DBG("");
@@ -1325,6 +1412,18 @@ int bt_conn_prepare_events(struct k_poll_event events[])
 				  &conn->tx_notify);
 		events[ev_count++].tag = BT_EVENT_CONN_TX_NOTIFY;
 
+		/* Data left after bt_conn_process_tx() waits for the
+		 * controller rather than for more data.
+		 */
+		if (conn_tx_pending(conn)) {
+			pkts = bt_conn_get_pkts(conn);
+			if (blocked[0] != pkts && !blocked[1]) {
+				blocked[!!blocked[0]] = pkts;
+			}
+
+			continue;
+		}
+
 		k_poll_event_init(&events[ev_count],
 				  K_POLL_TYPE_FIFO_DATA_AVAILABLE,
 				  K_POLL_MODE_NOTIFY_ONLY,
@@ -1332,28 +1431,14 @@ int bt_conn_prepare_events(struct k_poll_event events[])
 		events[ev_count++].tag = BT_EVENT_CONN_TX_QUEUE;
 	}
 
-	return ev_count;
-}
-
-void bt_conn_process_tx(struct bt_conn *conn)
-{
-	struct net_buf *buf;
-
-	BT_DBG("conn %p", conn);
-
-	if (conn->state == BT_CONN_DISCONNECTED &&
-	    atomic_test_and_clear_bit(conn->flags, BT_CONN_CLEANUP)) {
-		BT_DBG("handle %u disconnected - cleaning up", conn->handle);
-		conn_cleanup(conn);
-		return;
+	for (i = 0; i < ARRAY_SIZE(blocked) && blocked[i]; i++) {
+		k_poll_event_init(&events[ev_count],
+				  K_POLL_TYPE_SEM_AVAILABLE,
+				  K_POLL_MODE_NOTIFY_ONLY, blocked[i]);
+		events[ev_count++].tag = BT_EVENT_CONN_TX_PKTS;
 	}
 
-	/* Get next ACL packet for connection */
-	buf = net_buf_get(&conn->tx_queue, K_NO_WAIT);
-	BT_ASSERT(buf);
-	if (!send_buf(conn, buf)) {
-		net_buf_unref(buf);
-	}
+	return ev_count;
 }
 
 struct bt_conn *bt_conn_add_le(const bt_addr_le_t *peer)
@@ -1681,6 +1766,29 @@ int bt_conn_get_info(const struct bt_conn *conn, struct bt_conn_info *info)
 	return -EINVAL;
 }
 
+int bt_conn_get_tx_stats(const struct bt_conn *conn,
+			 struct bt_conn_tx_stats *stats)
+{
+	*stats = conn->tx_stats;
+	stats->queued = atomic_get(&conn->tx_depth);
+	if (stats->sent) {
+		stats->latency_avg = conn->tx_latency_sum / stats->sent;
+	}
+
+	return 0;
+}
+
+int bt_conn_set_tx_weight(struct bt_conn *conn, u8_t weight)
+{
+	if (!weight) {
+		return -EINVAL;
+	}
+
+	conn->tx_weight = weight;
+
+	return 0;
+}
+
 static int bt_hci_disconnect(struct bt_conn *conn, u8_t reason)
 {
 	struct net_buf *buf;
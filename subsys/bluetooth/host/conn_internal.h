@@ -110,6 +110,21 @@ struct bt_conn {
 	/* Queue for outgoing ACL data */
 	struct k_fifo		tx_queue;
 
+	/* ACL packet being fragmented and the flags of its next fragment */
+	struct net_buf		*tx_buf;
+	u8_t			tx_flags;
+
+	/* Fragments sent per turn of the TX scheduler */
+	u8_t			tx_weight;
+
+	/* Queued ACL packets, including the one being fragmented, and
+	 * since when the first one is at the head of the queue.
+	 */
+	atomic_t		tx_depth;
+	u32_t			tx_head_time;
+	u32_t			tx_latency_sum;
+	struct bt_conn_tx_stats	tx_stats;
+
 	/* Active L2CAP channels */
 	sys_slist_t		channels;
 
@@ -217,5 +232,5 @@ struct k_sem *bt_conn_get_pkts(struct bt_conn *conn);
 
 /* k_poll related helpers for the TX thread */
 int bt_conn_prepare_events(struct k_poll_event events[]);
-void bt_conn_process_tx(struct bt_conn *conn);
+void bt_conn_process_tx(void);
 void bt_conn_notify_tx(struct bt_conn *conn);
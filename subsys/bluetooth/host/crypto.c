@@ -14,10 +14,10 @@
 #include <bluetooth/bluetooth.h>
 #include <bluetooth/hci.h>
 #include <bluetooth/conn.h>
+#include <bluetooth/crypto.h>
 
 #include <tinycrypt/constants.h>
 #include <tinycrypt/hmac_prng.h>
-#include <tinycrypt/aes.h>
 #include <tinycrypt/utils.h>
 
 #define BT_DBG_ENABLED IS_ENABLED(CONFIG_BT_DEBUG_HCI_CORE)
@@ -115,21 +115,24 @@ int bt_rand(void *buf, size_t len)
 int bt_encrypt_le(const u8_t key[16], const u8_t plaintext[16],
 		  u8_t enc_data[16])
 {
-	struct tc_aes_key_sched_struct s;
+	struct bt_aes_key s;
 	u8_t tmp[16];
+	int err;
 
 	BT_DBG("key %s plaintext %s", bt_hex(key, 16), bt_hex(plaintext, 16));
 
 	sys_memcpy_swap(tmp, key, 16);
 
-	if (tc_aes128_set_encrypt_key(&s, tmp) == TC_CRYPTO_FAIL) {
-		return -EINVAL;
+	err = bt_aes_key_set(&s, tmp);
+	if (err) {
+		return err;
 	}
 
 	sys_memcpy_swap(tmp, plaintext, 16);
 
-	if (tc_aes_encrypt(enc_data, tmp, &s) == TC_CRYPTO_FAIL) {
-		return -EINVAL;
+	err = bt_aes_encrypt_be(&s, tmp, enc_data);
+	if (err) {
+		return err;
 	}
 
 	sys_mem_swap(enc_data, 16);
@@ -142,16 +145,19 @@ int bt_encrypt_le(const u8_t key[16], const u8_t plaintext[16],
 int bt_encrypt_be(const u8_t key[16], const u8_t plaintext[16],
 		  u8_t enc_data[16])
 {
-	struct tc_aes_key_sched_struct s;
+	struct bt_aes_key s;
+	int err;
 
 	BT_DBG("key %s plaintext %s", bt_hex(key, 16), bt_hex(plaintext, 16));
 
-	if (tc_aes128_set_encrypt_key(&s, key) == TC_CRYPTO_FAIL) {
-		return -EINVAL;
+	err = bt_aes_key_set(&s, key);
+	if (err) {
+		return err;
 	}
 
-	if (tc_aes_encrypt(enc_data, plaintext, &s) == TC_CRYPTO_FAIL) {
-		return -EINVAL;
+	err = bt_aes_encrypt_be(&s, plaintext, enc_data);
+	if (err) {
+		return err;
 	}
 
 	BT_DBG("enc_data %s", bt_hex(enc_data, 16));
@@ -40,8 +40,6 @@ static sys_slist_t subscriptions;
 static const char *gap_name = CONFIG_BT_DEVICE_NAME;
 static const u16_t gap_appearance = CONFIG_BT_DEVICE_APPEARANCE;
 
-static sys_slist_t db;
-
 static ssize_t read_name(struct bt_conn *conn, const struct bt_gatt_attr *attr,
 			 void *buf, u16_t len, u16_t offset)
 {
@@ -79,32 +77,102 @@ static void sc_ccc_cfg_changed(const struct bt_gatt_attr *attr,
 	BT_DBG("value 0x%04x", value);
 }
 
+#if defined(CONFIG_BT_GATT_NOTIFY_MULTIPLE)
+/* Client Supported Features the host implements */
+#define CF_SUPPORTED BT_GATT_CLIENT_FEAT_MULTI_NOTIFY
+
+/* Features of a connected client and the Multiple Handle Value
+ * Notification PDU collecting its notifications.
+ */
+static struct gatt_cf_cfg {
+	struct bt_conn *conn;
+	u8_t data;
+	struct net_buf *nfy;
+	struct k_sem nfy_sem;
+	struct k_delayed_work nfy_work;
+} cf_cfg[CONFIG_BT_MAX_CONN];
+
+static void nfy_mult_timeout(struct k_work *work);
+
+static struct gatt_cf_cfg *cf_cfg_lookup(struct bt_conn *conn)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(cf_cfg); i++) {
+		if (cf_cfg[i].conn == conn) {
+			return &cf_cfg[i];
+		}
+	}
+
+	return NULL;
+}
+
+static ssize_t cf_read(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+		       void *buf, u16_t len, u16_t offset)
+{
+	struct gatt_cf_cfg *cfg = cf_cfg_lookup(conn);
+	u8_t data = cfg ? cfg->data : 0;
+
+	return bt_gatt_attr_read(conn, attr, buf, len, offset, &data,
+				 sizeof(data));
+}
+
+static ssize_t cf_write(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+			const void *buf, u16_t len, u16_t offset, u8_t flags)
+{
+	const u8_t *value = buf;
+	struct gatt_cf_cfg *cfg;
+
+	if (offset) {
+		return BT_GATT_ERR(BT_ATT_ERR_INVALID_OFFSET);
+	}
+
+	if (!len) {
+		return BT_GATT_ERR(BT_ATT_ERR_INVALID_ATTRIBUTE_LEN);
+	}
+
+	cfg = cf_cfg_lookup(conn);
+	if (!cfg) {
+		cfg = cf_cfg_lookup(NULL);
+		if (!cfg) {
+			return BT_GATT_ERR(BT_ATT_ERR_INSUFFICIENT_RESOURCES);
+		}
+
+		cfg->conn = conn;
+	}
+
+	/* A client cannot disable a feature, and unknown bits are ignored */
+	cfg->data |= value[0] & CF_SUPPORTED;
+
+	BT_DBG("conn %p features 0x%02x", conn, cfg->data);
+
+	return len;
+}
+#endif /* CONFIG_BT_GATT_NOTIFY_MULTIPLE */
+
 static struct bt_gatt_attr gatt_attrs[] = {
 	BT_GATT_PRIMARY_SERVICE(BT_UUID_GATT),
 	BT_GATT_CHARACTERISTIC(BT_UUID_GATT_SC, BT_GATT_CHRC_INDICATE),
 	BT_GATT_DESCRIPTOR(BT_UUID_GATT_SC, BT_GATT_PERM_NONE,
 			   NULL, NULL, NULL),
 	BT_GATT_CCC(sc_ccc_cfg, sc_ccc_cfg_changed),
+#if defined(CONFIG_BT_GATT_NOTIFY_MULTIPLE)
+	BT_GATT_CHARACTERISTIC(BT_UUID_GATT_CLIENT_FEATURES,
+			       BT_GATT_CHRC_READ | BT_GATT_CHRC_WRITE),
+	BT_GATT_DESCRIPTOR(BT_UUID_GATT_CLIENT_FEATURES,
+			   BT_GATT_PERM_READ | BT_GATT_PERM_WRITE,
+			   cf_read, cf_write, NULL),
+#endif /* CONFIG_BT_GATT_NOTIFY_MULTIPLE */
 };
 
 static struct bt_gatt_service gatt_svc = BT_GATT_SERVICE(gatt_attrs);
 
 static int gatt_register(struct bt_gatt_service *svc)
 {
-	struct bt_gatt_service *last;
-	u16_t handle;
+	u16_t handle = bt_gatt_db_last_handle();
 	struct bt_gatt_attr *attrs = svc->attrs;
 	u16_t count = svc->attr_count;
 
-	if (sys_slist_is_empty(&db)) {
-		handle = 0;
-		goto populate;
-	}
-
-	last = SYS_SLIST_PEEK_TAIL_CONTAINER(&db, last, node);
-	handle = last->attrs[last->attr_count - 1].handle;
-
-populate:
 	/* Populate the handles and append them to the list */
 	for (; attrs && count; attrs++, count--) {
 		if (!attrs->handle) {
@@ -125,7 +193,7 @@ populate:
 		       attrs->perm);
 	}
 
-	sys_slist_append(&db, &svc->node);
+	bt_gatt_db_add(svc);
 
 	return 0;
 }
@@ -192,11 +260,22 @@ static void sc_process(struct k_work *work)
 
 void bt_gatt_init(void)
 {
+#if defined(CONFIG_BT_GATT_NOTIFY_MULTIPLE)
+	int i;
+#endif
+
 	/* Register mandatory services */
 	gatt_register(&gap_svc);
 	gatt_register(&gatt_svc);
 
 	k_delayed_work_init(&gatt_sc.work, sc_process);
+
+#if defined(CONFIG_BT_GATT_NOTIFY_MULTIPLE)
+	for (i = 0; i < ARRAY_SIZE(cf_cfg); i++) {
+		k_sem_init(&cf_cfg[i].nfy_sem, 1, 1);
+		k_delayed_work_init(&cf_cfg[i].nfy_work, nfy_mult_timeout);
+	}
+#endif /* CONFIG_BT_GATT_NOTIFY_MULTIPLE */
 }
 
 static bool update_range(u16_t *start, u16_t *end, u16_t new_start,
@@ -271,10 +350,13 @@ int bt_gatt_service_register(struct bt_gatt_service *svc)
 
 int bt_gatt_service_unregister(struct bt_gatt_service *svc)
 {
+	int err;
+
 	__ASSERT(svc, "invalid parameters\n");
 
-	if (!sys_slist_find_and_remove(&db, &svc->node)) {
-		return -ENOENT;
+	err = bt_gatt_db_remove(svc);
+	if (err < 0) {
+		return err;
 	}
 
 	sc_indicate(&gatt_sc, svc->attrs[0].handle,
@@ -326,22 +408,6 @@ struct gatt_incl {
 	u16_t uuid16;
 } __packed;
 
-static u8_t get_service_handles(const struct bt_gatt_attr *attr,
-				   void *user_data)
-{
-	struct gatt_incl *include = user_data;
-
-	/* Stop if attribute is a service */
-	if (!bt_uuid_cmp(attr->uuid, BT_UUID_GATT_PRIMARY) ||
-	    !bt_uuid_cmp(attr->uuid, BT_UUID_GATT_SECONDARY)) {
-		return BT_GATT_ITER_STOP;
-	}
-
-	include->end_handle = attr->handle;
-
-	return BT_GATT_ITER_CONTINUE;
-}
-
 ssize_t bt_gatt_attr_read_included(struct bt_conn *conn,
 				   const struct bt_gatt_attr *attr,
 				   void *buf, u16_t len, u16_t offset)
@@ -366,8 +432,7 @@ ssize_t bt_gatt_attr_read_included(struct bt_conn *conn,
 	}
 
 	/* Lookup for service end handle */
-	bt_gatt_foreach_attr(incl->handle + 1, 0xffff, get_service_handles,
-			     &pdu);
+	pdu.end_handle = sys_cpu_to_le16(bt_gatt_attr_group_end(incl, 0xffff));
 
 	return bt_gatt_attr_read(conn, attr, buf, len, offset, &pdu, value_len);
 }
@@ -418,49 +483,6 @@ ssize_t bt_gatt_attr_read_chrc(struct bt_conn *conn,
 	return bt_gatt_attr_read(conn, attr, buf, len, offset, &pdu, value_len);
 }
 
-void bt_gatt_foreach_attr(u16_t start_handle, u16_t end_handle,
-			  bt_gatt_attr_func_t func, void *user_data)
-{
-	struct bt_gatt_service *svc;
-
-	SYS_SLIST_FOR_EACH_CONTAINER(&db, svc, node) {
-		int i;
-
-		for (i = 0; i < svc->attr_count; i++) {
-			struct bt_gatt_attr *attr = &svc->attrs[i];
-
-			/* Check if attribute handle is within range */
-			if (attr->handle < start_handle ||
-			    attr->handle > end_handle) {
-				continue;
-			}
-
-			if (func(attr, user_data) == BT_GATT_ITER_STOP) {
-				return;
-			}
-		}
-	}
-}
-
-static u8_t find_next(const struct bt_gatt_attr *attr, void *user_data)
-{
-	struct bt_gatt_attr **next = user_data;
-
-	*next = (struct bt_gatt_attr *)attr;
-
-	return BT_GATT_ITER_STOP;
-}
-
-struct bt_gatt_attr *bt_gatt_attr_next(const struct bt_gatt_attr *attr)
-{
-	struct bt_gatt_attr *next = NULL;
-
-	bt_gatt_foreach_attr(attr->handle + 1, attr->handle + 1, find_next,
-			     &next);
-
-	return next;
-}
-
 ssize_t bt_gatt_attr_read_ccc(struct bt_conn *conn,
 			      const struct bt_gatt_attr *attr, void *buf,
 			      u16_t len, u16_t offset)
@@ -609,11 +631,114 @@ struct notify_data {
 	struct bt_gatt_indicate_params *params;
 };
 
+#if defined(CONFIG_BT_GATT_NOTIFY_MULTIPLE)
+/* Called with nfy_sem taken */
+static void nfy_mult_send(struct gatt_cf_cfg *cfg)
+{
+	struct net_buf *buf = cfg->nfy;
+	struct bt_att_notify_mult *nfy;
+	u16_t len;
+
+	if (!buf) {
+		return;
+	}
+
+	cfg->nfy = NULL;
+	k_delayed_work_cancel(&cfg->nfy_work);
+
+	/* A single value goes out as a plain notification, which has no
+	 * length field.
+	 */
+	nfy = (void *)(buf->data + sizeof(struct bt_att_hdr));
+	len = sys_le16_to_cpu(nfy->len);
+	if (buf->len == sizeof(struct bt_att_hdr) + sizeof(*nfy) + len) {
+		((struct bt_att_hdr *)buf->data)->code = BT_ATT_OP_NOTIFY;
+		memmove(&nfy->len, nfy->value, len);
+		buf->len -= sizeof(nfy->len);
+	}
+
+	BT_DBG("conn %p len %u", cfg->conn, buf->len);
+
+	bt_l2cap_send(cfg->conn, BT_L2CAP_CID_ATT, buf);
+}
+
+static void nfy_mult_flush(struct gatt_cf_cfg *cfg)
+{
+	k_sem_take(&cfg->nfy_sem, K_FOREVER);
+	nfy_mult_send(cfg);
+	k_sem_give(&cfg->nfy_sem);
+}
+
+static void nfy_mult_timeout(struct k_work *work)
+{
+	struct gatt_cf_cfg *cfg = CONTAINER_OF(work, struct gatt_cf_cfg,
+					       nfy_work);
+
+	nfy_mult_flush(cfg);
+}
+
+static int nfy_mult_add(struct gatt_cf_cfg *cfg, u16_t handle,
+			const void *data, u16_t len)
+{
+	u16_t mtu = bt_att_get_mtu(cfg->conn);
+	struct bt_att_notify_mult *nfy;
+
+	k_sem_take(&cfg->nfy_sem, K_FOREVER);
+
+	if (cfg->nfy && cfg->nfy->len + sizeof(*nfy) + len > mtu) {
+		nfy_mult_send(cfg);
+	}
+
+	if (!cfg->nfy) {
+		cfg->nfy = bt_att_create_pdu(cfg->conn, BT_ATT_OP_NOTIFY_MULT,
+					     sizeof(*nfy) + len);
+		if (!cfg->nfy) {
+			k_sem_give(&cfg->nfy_sem);
+			BT_WARN("No buffer available to send notification");
+			return -ENOMEM;
+		}
+
+		k_delayed_work_submit(&cfg->nfy_work,
+				K_MSEC(CONFIG_BT_GATT_NOTIFY_MULTIPLE_LATENCY));
+	}
+
+	BT_DBG("conn %p handle 0x%04x", cfg->conn, handle);
+
+	nfy = net_buf_add(cfg->nfy, sizeof(*nfy));
+	nfy->handle = sys_cpu_to_le16(handle);
+	nfy->len = sys_cpu_to_le16(len);
+	net_buf_add_mem(cfg->nfy, data, len);
+
+	/* Don't wait for a value of the same length that would not fit */
+	if (cfg->nfy->len + sizeof(*nfy) + len > mtu) {
+		nfy_mult_send(cfg);
+	}
+
+	k_sem_give(&cfg->nfy_sem);
+
+	return 0;
+}
+#endif /* CONFIG_BT_GATT_NOTIFY_MULTIPLE */
+
 static int gatt_notify(struct bt_conn *conn, u16_t handle, const void *data,
 		       size_t len)
 {
 	struct net_buf *buf;
 	struct bt_att_notify *nfy;
+#if defined(CONFIG_BT_GATT_NOTIFY_MULTIPLE)
+	struct gatt_cf_cfg *cfg = cf_cfg_lookup(conn);
+
+	if (cfg && (cfg->data & BT_GATT_CLIENT_FEAT_MULTI_NOTIFY)) {
+		if (sizeof(struct bt_att_hdr) +
+		    sizeof(struct bt_att_notify_mult) + len <=
+		    bt_att_get_mtu(conn)) {
+			return nfy_mult_add(cfg, handle, data, len);
+		}
+
+		/* Keep the pending values ahead of this one */
+		nfy_mult_flush(cfg);
+	}
+#endif /* CONFIG_BT_GATT_NOTIFY_MULTIPLE */
 
 	buf = bt_att_create_pdu(conn, BT_ATT_OP_NOTIFY, sizeof(*nfy) + len);
 	if (!buf) {
@@ -673,6 +798,14 @@ static int gatt_indicate(struct bt_conn *conn,
 {
 	struct net_buf *buf;
 	struct bt_att_indicate *ind;
+#if defined(CONFIG_BT_GATT_NOTIFY_MULTIPLE)
+	struct gatt_cf_cfg *cfg = cf_cfg_lookup(conn);
+
+	/* Values notified before are not to arrive after the indication */
+	if (cfg) {
+		nfy_mult_flush(cfg);
+	}
+#endif /* CONFIG_BT_GATT_NOTIFY_MULTIPLE */
 
 	buf = bt_att_create_pdu(conn, BT_ATT_OP_INDICATE,
 				sizeof(*ind) + params->len);
@@ -2070,7 +2203,8 @@ static void add_subscriptions(struct bt_conn *conn)
 void bt_gatt_connected(struct bt_conn *conn)
 {
 	BT_DBG("conn %p", conn);
-	bt_gatt_foreach_attr(0x0001, 0xffff, connected_cb, conn);
+	bt_gatt_foreach_attr_type(0x0001, 0xffff, BT_UUID_GATT_CCC, connected_cb,
+				  conn);
 #if defined(CONFIG_BT_GATT_CLIENT)
 	add_subscriptions(conn);
 #endif /* CONFIG_BT_GATT_CLIENT */
@@ -2078,10 +2212,30 @@ void bt_gatt_connected(struct bt_conn *conn)
 
 void bt_gatt_disconnected(struct bt_conn *conn)
 {
+#if defined(CONFIG_BT_GATT_NOTIFY_MULTIPLE)
+	struct gatt_cf_cfg *cfg;
+#endif
+
 	BT_DBG("conn %p", conn);
-	bt_gatt_foreach_attr(0x0001, 0xffff, disconnected_cb, conn);
+	bt_gatt_foreach_attr_type(0x0001, 0xffff, BT_UUID_GATT_CCC,
+				  disconnected_cb, conn);
 
 #if defined(CONFIG_BT_GATT_CLIENT)
 	remove_subscriptions(conn);
 #endif /* CONFIG_BT_GATT_CLIENT */
+
+#if defined(CONFIG_BT_GATT_NOTIFY_MULTIPLE)
+	cfg = cf_cfg_lookup(conn);
+	if (cfg) {
+		k_sem_take(&cfg->nfy_sem, K_FOREVER);
+		k_delayed_work_cancel(&cfg->nfy_work);
+		if (cfg->nfy) {
+			net_buf_unref(cfg->nfy);
+			cfg->nfy = NULL;
+		}
+		cfg->conn = NULL;
+		cfg->data = 0;
+		k_sem_give(&cfg->nfy_sem);
+	}
+#endif /* CONFIG_BT_GATT_NOTIFY_MULTIPLE */
 }
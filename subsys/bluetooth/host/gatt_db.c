@@ -0,0 +1,399 @@
+/* gatt_db.c - Generic Attribute Profile database */
+
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <misc/byteorder.h>
+#include <misc/slist.h>
+#include <misc/util.h>
+
+#include <bluetooth/uuid.h>
+#include <bluetooth/gatt.h>
+
+#include "gatt_internal.h"
+
+/* Registered services, in handle order */
+static sys_slist_t db;
+
+#if CONFIG_BT_GATT_DB_INDEX > 0
+/*
+ * The index holds every registered attribute in handle order, so a handle
+ * range is found by binary search, and the attributes whose UUID has a
+ * 16-bit form ordered by that UUID and then by handle, so a request for one
+ * attribute type only visits the attributes of that type.
+ *
+ * Once the services outgrow it the index is dropped and lookups walk the
+ * services, until unregistering makes them fit again.
+ */
+struct attr_type {
+	u16_t uuid;
+	struct bt_gatt_attr *attr;
+};
+
+static struct bt_gatt_attr *attrs[CONFIG_BT_GATT_DB_INDEX];
+static struct attr_type types[CONFIG_BT_GATT_DB_INDEX];
+static u16_t attr_count;
+static u16_t type_count;
+static bool overflow;
+
+/* 16-bit form of a UUID derived from the Bluetooth Base UUID */
+static bool uuid_16(const struct bt_uuid *uuid, u16_t *val)
+{
+	struct bt_uuid_16 u16 = { .uuid.type = BT_UUID_TYPE_16 };
+
+	switch (uuid->type) {
+	case BT_UUID_TYPE_16:
+		*val = BT_UUID_16(uuid)->val;
+		return true;
+	case BT_UUID_TYPE_32:
+		if (BT_UUID_32(uuid)->val > 0xffff) {
+			return false;
+		}
+
+		*val = BT_UUID_32(uuid)->val;
+		return true;
+	case BT_UUID_TYPE_128:
+		u16.val = sys_get_le16(&BT_UUID_128(uuid)->val[12]);
+		if (bt_uuid_cmp(uuid, &u16.uuid)) {
+			return false;
+		}
+
+		*val = u16.val;
+		return true;
+	}
+
+	return false;
+}
+
+/* Position of the first attribute with a handle not below the given one */
+static int attr_find(u16_t handle)
+{
+	int lo = 0, hi = attr_count;
+
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+
+		if (attrs[mid]->handle < handle) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+/* Position of the first attribute of the type not below the given handle */
+static int type_find(u16_t uuid, u16_t handle)
+{
+	int lo = 0, hi = type_count;
+
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+
+		if (types[mid].uuid < uuid ||
+		    (types[mid].uuid == uuid &&
+		     types[mid].attr->handle < handle)) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+/* Handle of the first attribute of the type after a handle, 0 if none */
+static u16_t type_next(u16_t uuid, u16_t handle)
+{
+	int pos = type_find(uuid, handle + 1);
+
+	if (pos < type_count && types[pos].uuid == uuid) {
+		return types[pos].attr->handle;
+	}
+
+	return 0;
+}
+
+static bool index_add(struct bt_gatt_service *svc)
+{
+	int i, pos;
+	u16_t uuid;
+
+	if (attr_count + svc->attr_count > ARRAY_SIZE(attrs)) {
+		return false;
+	}
+
+	for (i = 0; i < svc->attr_count; i++) {
+		struct bt_gatt_attr *attr = &svc->attrs[i];
+
+		attrs[attr_count++] = attr;
+
+		if (!uuid_16(attr->uuid, &uuid)) {
+			continue;
+		}
+
+		/* Services are appended with growing handles, so this only
+		 * moves the entries of the types that sort after it.
+		 */
+		pos = type_find(uuid, attr->handle);
+		memmove(&types[pos + 1], &types[pos],
+			(type_count - pos) * sizeof(types[0]));
+		types[pos].uuid = uuid;
+		types[pos].attr = attr;
+		type_count++;
+	}
+
+	return true;
+}
+
+static void index_remove(struct bt_gatt_service *svc)
+{
+	int pos, i, j;
+
+	pos = attr_find(svc->attrs[0].handle);
+	memmove(&attrs[pos], &attrs[pos + svc->attr_count],
+		(attr_count - pos - svc->attr_count) * sizeof(attrs[0]));
+	attr_count -= svc->attr_count;
+
+	for (i = 0, j = 0; i < type_count; i++) {
+		if (types[i].attr >= svc->attrs &&
+		    types[i].attr < &svc->attrs[svc->attr_count]) {
+			continue;
+		}
+
+		types[j++] = types[i];
+	}
+
+	type_count = j;
+}
+
+static void index_rebuild(void)
+{
+	struct bt_gatt_service *svc;
+
+	attr_count = 0;
+	type_count = 0;
+	overflow = false;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&db, svc, node) {
+		if (!index_add(svc)) {
+			overflow = true;
+			return;
+		}
+	}
+}
+#endif /* CONFIG_BT_GATT_DB_INDEX > 0 */
+
+u16_t bt_gatt_db_last_handle(void)
+{
+	struct bt_gatt_service *last;
+
+	if (sys_slist_is_empty(&db)) {
+		return 0;
+	}
+
+	last = SYS_SLIST_PEEK_TAIL_CONTAINER(&db, last, node);
+
+	return last->attrs[last->attr_count - 1].handle;
+}
+
+void bt_gatt_db_add(struct bt_gatt_service *svc)
+{
+	sys_slist_append(&db, &svc->node);
+
+#if CONFIG_BT_GATT_DB_INDEX > 0
+	if (!overflow && !index_add(svc)) {
+		overflow = true;
+	}
+#endif
+}
+
+int bt_gatt_db_remove(struct bt_gatt_service *svc)
+{
+	if (!sys_slist_find_and_remove(&db, &svc->node)) {
+		return -ENOENT;
+	}
+
+#if CONFIG_BT_GATT_DB_INDEX > 0
+	if (overflow) {
+		index_rebuild();
+	} else {
+		index_remove(svc);
+	}
+#endif
+
+	return 0;
+}
+
+void bt_gatt_foreach_attr(u16_t start_handle, u16_t end_handle,
+			  bt_gatt_attr_func_t func, void *user_data)
+{
+	struct bt_gatt_service *svc;
+
+#if CONFIG_BT_GATT_DB_INDEX > 0
+	if (!overflow) {
+		int i;
+
+		for (i = attr_find(start_handle);
+		     i < attr_count && attrs[i]->handle <= end_handle; i++) {
+			if (func(attrs[i], user_data) == BT_GATT_ITER_STOP) {
+				return;
+			}
+		}
+
+		return;
+	}
+#endif
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&db, svc, node) {
+		int i;
+
+		for (i = 0; i < svc->attr_count; i++) {
+			struct bt_gatt_attr *attr = &svc->attrs[i];
+
+			/* Check if attribute handle is within range */
+			if (attr->handle < start_handle ||
+			    attr->handle > end_handle) {
+				continue;
+			}
+
+			if (func(attr, user_data) == BT_GATT_ITER_STOP) {
+				return;
+			}
+		}
+	}
+}
+
+struct type_filter {
+	const struct bt_uuid *uuid;
+	bt_gatt_attr_func_t func;
+	void *user_data;
+};
+
+static u8_t type_filter_cb(const struct bt_gatt_attr *attr, void *user_data)
+{
+	struct type_filter *filter = user_data;
+
+	if (bt_uuid_cmp(attr->uuid, filter->uuid)) {
+		return BT_GATT_ITER_CONTINUE;
+	}
+
+	return filter->func(attr, filter->user_data);
+}
+
+void bt_gatt_foreach_attr_type(u16_t start_handle, u16_t end_handle,
+			       const struct bt_uuid *uuid,
+			       bt_gatt_attr_func_t func, void *user_data)
+{
+	struct type_filter filter = {
+		.uuid = uuid,
+		.func = func,
+		.user_data = user_data,
+	};
+
+#if CONFIG_BT_GATT_DB_INDEX > 0
+	u16_t val;
+
+	if (!overflow && uuid_16(uuid, &val)) {
+		int i;
+
+		for (i = type_find(val, start_handle);
+		     i < type_count && types[i].uuid == val &&
+		     types[i].attr->handle <= end_handle; i++) {
+			if (func(types[i].attr, user_data) ==
+			    BT_GATT_ITER_STOP) {
+				return;
+			}
+		}
+
+		return;
+	}
+#endif
+
+	bt_gatt_foreach_attr(start_handle, end_handle, type_filter_cb,
+			     &filter);
+}
+
+static u8_t find_next(const struct bt_gatt_attr *attr, void *user_data)
+{
+	struct bt_gatt_attr **next = user_data;
+
+	*next = (struct bt_gatt_attr *)attr;
+
+	return BT_GATT_ITER_STOP;
+}
+
+struct bt_gatt_attr *bt_gatt_attr_next(const struct bt_gatt_attr *attr)
+{
+	struct bt_gatt_attr *next = NULL;
+
+	bt_gatt_foreach_attr(attr->handle + 1, attr->handle + 1, find_next,
+			     &next);
+
+	return next;
+}
+
+static u8_t find_group_end(const struct bt_gatt_attr *attr, void *user_data)
+{
+	u16_t *end = user_data;
+
+	/* Stop at the next service */
+	if (!bt_uuid_cmp(attr->uuid, BT_UUID_GATT_PRIMARY) ||
+	    !bt_uuid_cmp(attr->uuid, BT_UUID_GATT_SECONDARY)) {
+		return BT_GATT_ITER_STOP;
+	}
+
+	*end = attr->handle;
+
+	return BT_GATT_ITER_CONTINUE;
+}
+
+u16_t bt_gatt_attr_group_end(const struct bt_gatt_attr *attr,
+			     u16_t end_handle)
+{
+	u16_t end = attr->handle;
+
+	if (attr->handle >= end_handle) {
+		return end;
+	}
+
+#if CONFIG_BT_GATT_DB_INDEX > 0
+	if (!overflow) {
+		u16_t next;
+		int pos;
+
+		next = type_next(BT_UUID_GATT_PRIMARY_VAL, attr->handle);
+		if (next && next <= end_handle) {
+			end_handle = next - 1;
+		}
+
+		next = type_next(BT_UUID_GATT_SECONDARY_VAL, attr->handle);
+		if (next && next <= end_handle) {
+			end_handle = next - 1;
+		}
+
+		/* Last attribute up to the end of the group */
+		pos = attr_find(end_handle);
+		if (pos == attr_count || attrs[pos]->handle > end_handle) {
+			pos--;
+		}
+
+		if (pos >= 0 && attrs[pos]->handle > end) {
+			end = attrs[pos]->handle;
+		}
+
+		return end;
+	}
+#endif
+
+	bt_gatt_foreach_attr(attr->handle + 1, end_handle, find_group_end,
+			     &end);
+
+	return end;
+}
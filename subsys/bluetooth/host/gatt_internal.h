@@ -12,6 +12,17 @@ void bt_gatt_init(void);
 void bt_gatt_connected(struct bt_conn *conn);
 void bt_gatt_disconnected(struct bt_conn *conn);
 
+/* Attribute database, kept in handle order by gatt_db.c */
+u16_t bt_gatt_db_last_handle(void);
+void bt_gatt_db_add(struct bt_gatt_service *svc);
+int bt_gatt_db_remove(struct bt_gatt_service *svc);
+
+/* Handle of the last attribute, up to end_handle, of the group started by
+ * a service declaration.
+ */
+u16_t bt_gatt_attr_group_end(const struct bt_gatt_attr *attr,
+			     u16_t end_handle);
+
 #if defined(CONFIG_BT_GATT_CLIENT)
 void bt_gatt_notification(struct bt_conn *conn, u16_t handle,
 			  const void *data, u16_t length);
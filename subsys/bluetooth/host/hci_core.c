@@ -26,6 +26,7 @@
 #include <bluetooth/hci_vs.h>
 #include <bluetooth/hci_driver.h>
 #include <bluetooth/storage.h>
+#include <logging/tracing.h>
 
 #define BT_DBG_ENABLED IS_ENABLED(CONFIG_BT_DEBUG_HCI_CORE)
 #include "common/log.h"
@@ -3242,6 +3243,8 @@ static void send_cmd(void)
 
 static void process_events(struct k_poll_event *ev, int count)
 {
+	bool tx = false;
+
 	BT_DBG("count %d", count);
 
 	for (; count; ev++, count--) {
@@ -3262,13 +3265,14 @@ static void process_events(struct k_poll_event *ev, int count)
 							    tx_notify);
 					bt_conn_notify_tx(conn);
 				} else if (ev->tag == BT_EVENT_CONN_TX_QUEUE) {
-					conn = CONTAINER_OF(ev->fifo,
-							    struct bt_conn,
-							    tx_queue);
-					bt_conn_process_tx(conn);
+					tx = true;
 				}
 			}
 			break;
+		case K_POLL_STATE_SEM_AVAILABLE:
+			/* Controller buffers for queued ACL data */
+			tx = true;
+			break;
 		case K_POLL_STATE_NOT_READY:
 			break;
 		default:
@@ -3276,10 +3280,17 @@ static void process_events(struct k_poll_event *ev, int count)
 			break;
 		}
 	}
+
+	/* One pass sends for every connection, as fairly as it can */
+	if (IS_ENABLED(CONFIG_BT_CONN) && tx) {
+		bt_conn_process_tx();
+	}
 }
 
 #if defined(CONFIG_BT_CONN)
-/* command FIFO + conn_change signal + MAX_CONN * 2 (tx & tx_notify) */
+/* command FIFO + conn_change signal + MAX_CONN * 2 (tx & tx_notify), where
+ * connections waiting for controller buffers share one event per pool.
+ */
 #define EV_COUNT (2 + (CONFIG_BT_MAX_CONN * 2))
 #else
 /* command FIFO */
@@ -4279,6 +4290,8 @@ int bt_send(struct net_buf *buf)
 {
 	BT_DBG("buf %p len %u type %u", buf, buf->len, bt_buf_get_type(buf));
 
+	SYS_TRACE(SYS_TRACE_BT_SEND, buf->len, buf);
+
 	bt_monitor_send(bt_monitor_opcode(buf), buf->data, buf->len);
 
 	if (IS_ENABLED(CONFIG_BT_TINYCRYPT_ECC)) {
@@ -4292,6 +4305,8 @@ int bt_recv(struct net_buf *buf)
 {
 	struct net_buf_pool *pool;
 
+	SYS_TRACE(SYS_TRACE_BT_RECV, buf->len, buf);
+
 	bt_monitor_send(bt_monitor_opcode(buf), buf->data, buf->len);
 
 	BT_DBG("buf %p len %u", buf, buf->len);
@@ -4331,6 +4346,8 @@ int bt_recv_prio(struct net_buf *buf)
 {
 	struct bt_hci_evt_hdr *hdr = (void *)buf->data;
 
+	SYS_TRACE(SYS_TRACE_BT_RECV, buf->len, buf);
+
 	bt_monitor_send(bt_monitor_opcode(buf), buf->data, buf->len);
 
 	BT_ASSERT(bt_buf_get_type(buf) == BT_BUF_EVT);
@@ -640,6 +640,7 @@ static void l2cap_chan_rx_init(struct bt_l2cap_le_chan *chan)
 	 */
 	chan->rx.mps = min(chan->rx.mtu + 2, L2CAP_MAX_LE_MPS);
 	k_sem_init(&chan->rx.credits, 0, UINT_MAX);
+	chan->_sdu_held = 0;
 }
 
 static void l2cap_chan_tx_init(struct bt_l2cap_le_chan *chan)
@@ -1312,23 +1313,40 @@ static void l2cap_recv(struct bt_l2cap_chan *chan, struct net_buf *buf)
 }
 
 #if defined(CONFIG_BT_L2CAP_DYNAMIC_CHANNEL)
+/* Called from the RX thread and, once chained SDUs are freed, from the
+ * system work queue.
+ */
 static void l2cap_chan_update_credits(struct bt_l2cap_le_chan *chan,
-				      struct net_buf *buf)
+				      u16_t freed)
 {
 	struct bt_l2cap_le_credits *ev;
+	struct net_buf *buf;
+	unsigned int key;
 	u16_t credits;
 
+	key = irq_lock();
+
+	chan->_sdu_held -= min(chan->_sdu_held, freed);
+
 	/* Only give more credits if it went bellow the defined threshold */
 	if (k_sem_count_get(&chan->rx.credits) >
 	    L2CAP_LE_CREDITS_THRESHOLD(chan->rx.init_credits)) {
+		irq_unlock(key);
 		goto done;
 	}
 
-	/* Restore credits */
-	credits = chan->rx.init_credits - k_sem_count_get(&chan->rx.credits);
+	/* Restore credits, but not those of K-frames still held by SDUs */
+	credits = chan->rx.init_credits - k_sem_count_get(&chan->rx.credits) -
+		  chan->_sdu_held;
 	l2cap_chan_rx_give_credits(chan, credits);
 
-	buf = l2cap_create_le_sig_pdu(buf, BT_L2CAP_LE_CREDITS, get_ident(),
+	irq_unlock(key);
+
+	if (!credits) {
+		goto done;
+	}
+
+	buf = l2cap_create_le_sig_pdu(NULL, BT_L2CAP_LE_CREDITS, get_ident(),
 				      sizeof(*ev));
 
 	ev = net_buf_add(buf, sizeof(*ev));
@@ -1357,6 +1375,114 @@ static struct net_buf *l2cap_alloc_frag(struct bt_l2cap_le_chan *chan)
 	return frag;
 }
 
+#if CONFIG_BT_L2CAP_RX_SDU_COUNT > 0
+/* Channels without alloc_buf get their SDUs as an empty head buffer with
+ * the received K-frames chained to it, rather than copied. The credits of
+ * those K-frames go back to the peer once the SDU is freed.
+ */
+struct l2cap_sdu {
+	u8_t  conn_id;
+	u16_t cid;
+	u16_t credits;
+};
+
+#define l2cap_sdu(buf) ((struct l2cap_sdu *)net_buf_user_data(buf))
+
+static void l2cap_sdu_destroy(struct net_buf *buf);
+
+NET_BUF_POOL_DEFINE(sdu_pool, CONFIG_BT_L2CAP_RX_SDU_COUNT, 0,
+		    sizeof(struct l2cap_sdu), l2cap_sdu_destroy);
+
+static K_FIFO_DEFINE(sdu_freed);
+
+static void l2cap_sdu_freed(struct k_work *work)
+{
+	struct bt_l2cap_chan *chan;
+	struct l2cap_sdu sdu;
+	struct bt_conn *conn;
+	struct net_buf *buf;
+
+	while ((buf = k_fifo_get(&sdu_freed, K_NO_WAIT))) {
+		sdu = *l2cap_sdu(buf);
+		net_buf_destroy(buf);
+
+		BT_DBG("conn id %u cid 0x%04x credits %u", sdu.conn_id,
+		       sdu.cid, sdu.credits);
+
+		conn = bt_conn_lookup_id(sdu.conn_id);
+		if (!conn) {
+			continue;
+		}
+
+		chan = bt_l2cap_le_lookup_rx_cid(conn, sdu.cid);
+		if (chan && conn->state == BT_CONN_CONNECTED) {
+			l2cap_chan_update_credits(BT_L2CAP_LE_CHAN(chan),
+						  sdu.credits);
+		}
+
+		bt_conn_unref(conn);
+	}
+}
+
+static K_WORK_DEFINE(sdu_work, l2cap_sdu_freed);
+
+/* The last reference may be dropped in any context, so the credits are
+ * given from the system work queue.
+ */
+static void l2cap_sdu_destroy(struct net_buf *buf)
+{
+	k_fifo_put(&sdu_freed, buf);
+	k_work_submit(&sdu_work);
+}
+
+static struct net_buf *l2cap_sdu_alloc(struct bt_l2cap_le_chan *chan)
+{
+	struct net_buf *sdu;
+
+	sdu = net_buf_alloc(&sdu_pool, K_NO_WAIT);
+	if (!sdu) {
+		return NULL;
+	}
+
+	l2cap_sdu(sdu)->conn_id = bt_conn_get_id(chan->chan.conn);
+	l2cap_sdu(sdu)->cid = chan->rx.cid;
+	l2cap_sdu(sdu)->credits = 0;
+
+	return sdu;
+}
+
+static void l2cap_chan_le_chain_sdu(struct bt_l2cap_le_chan *chan,
+				    struct net_buf *buf)
+{
+	BT_DBG("chan %p len %u sdu %zu", chan, buf->len,
+	       net_buf_frags_len(chan->_sdu));
+
+	if (net_buf_frags_len(chan->_sdu) + buf->len > chan->_sdu_len) {
+		BT_ERR("SDU length mismatch");
+		bt_l2cap_chan_disconnect(&chan->chan);
+		return;
+	}
+
+	/* The K-frame, and its credit, now belong to the SDU */
+	net_buf_frag_add(chan->_sdu, net_buf_ref(buf));
+	l2cap_sdu(chan->_sdu)->credits++;
+	chan->_sdu_held++;
+
+	if (net_buf_frags_len(chan->_sdu) == chan->_sdu_len) {
+		struct net_buf *sdu = chan->_sdu;
+
+		/* Reset first, the callback may disconnect the channel */
+		chan->_sdu = NULL;
+		chan->_sdu_len = 0;
+
+		chan->chan.ops->recv(&chan->chan, sdu);
+		net_buf_unref(sdu);
+	}
+
+	l2cap_chan_update_credits(chan, 0);
+}
+#endif /* CONFIG_BT_L2CAP_RX_SDU_COUNT > 0 */
+
 static void l2cap_chan_le_recv_sdu(struct bt_l2cap_le_chan *chan,
 				   struct net_buf *buf)
 {
@@ -1401,7 +1527,7 @@ static void l2cap_chan_le_recv_sdu(struct bt_l2cap_le_chan *chan,
 		chan->_sdu_len = 0;
 	}
 
-	l2cap_chan_update_credits(chan, buf);
+	l2cap_chan_update_credits(chan, 0);
 }
 
 static void l2cap_chan_le_recv(struct bt_l2cap_le_chan *chan,
@@ -1417,6 +1543,12 @@ static void l2cap_chan_le_recv(struct bt_l2cap_le_chan *chan,
 
 	/* Check if segments already exist */
 	if (chan->_sdu) {
+#if CONFIG_BT_L2CAP_RX_SDU_COUNT > 0
+		if (!chan->chan.ops->alloc_buf) {
+			l2cap_chan_le_chain_sdu(chan, buf);
+			return;
+		}
+#endif /* CONFIG_BT_L2CAP_RX_SDU_COUNT > 0 */
 		l2cap_chan_le_recv_sdu(chan, buf);
 		return;
 	}
@@ -1444,9 +1576,21 @@ static void l2cap_chan_le_recv(struct bt_l2cap_le_chan *chan,
 		return;
 	}
 
+#if CONFIG_BT_L2CAP_RX_SDU_COUNT > 0
+	chan->_sdu = l2cap_sdu_alloc(chan);
+	if (!chan->_sdu) {
+		BT_ERR("Unable to allocate buffer for SDU");
+		bt_l2cap_chan_disconnect(&chan->chan);
+		return;
+	}
+
+	chan->_sdu_len = sdu_len;
+	l2cap_chan_le_chain_sdu(chan, buf);
+#else
 	chan->chan.ops->recv(&chan->chan, buf);
 
-	l2cap_chan_update_credits(chan, buf);
+	l2cap_chan_update_credits(chan, 0);
+#endif /* CONFIG_BT_L2CAP_RX_SDU_COUNT > 0 */
 }
 #endif /* CONFIG_BT_L2CAP_DYNAMIC_CHANNEL */
 
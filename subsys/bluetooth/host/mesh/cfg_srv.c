@@ -1965,6 +1965,8 @@ static void net_key_add(struct bt_mesh_model *model,
 
 	sub->net_idx = idx;
 
+	bt_mesh_net_creds_update();
+
 	/* Make sure we have valid beacon data to be sent */
 	bt_mesh_net_beacon_update(sub);
 
@@ -2038,6 +2040,7 @@ static void net_key_update(struct bt_mesh_model *model,
 
 	sub->kr_phase = BT_MESH_KR_PHASE_1;
 
+	bt_mesh_net_creds_update();
 	bt_mesh_net_beacon_update(sub);
 
 	send_net_key_status(model, ctx, idx, STATUS_SUCCESS);
@@ -2109,6 +2112,8 @@ static void net_key_del(struct bt_mesh_model *model,
 	memset(sub, 0, sizeof(*sub));
 	sub->net_idx = BT_MESH_KEY_UNUSED;
 
+	bt_mesh_net_creds_update();
+
 	status = STATUS_SUCCESS;
 
 send_status:
@@ -2649,6 +2654,7 @@ static void krp_set(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
 		}
 		sub->kr_phase = BT_MESH_KR_NORMAL;
 		sub->kr_flag = 0;
+		bt_mesh_net_creds_update();
 		bt_mesh_net_beacon_update(sub);
 	}
 
@@ -3115,6 +3121,8 @@ void bt_mesh_cfg_reset(void)
 		sub->net_idx = BT_MESH_KEY_UNUSED;
 	}
 
+	bt_mesh_net_creds_update();
+
 	memset(labels, 0, sizeof(labels));
 }
 
@@ -14,11 +14,7 @@
 #include <misc/byteorder.h>
 #include <misc/util.h>
 
-#include <tinycrypt/constants.h>
-#include <tinycrypt/utils.h>
-#include <tinycrypt/aes.h>
-#include <tinycrypt/cmac_mode.h>
-#include <tinycrypt/ccm_mode.h>
+#include <zephyr.h>
 
 #include <bluetooth/mesh.h>
 #include <bluetooth/crypto.h>
@@ -32,28 +28,193 @@
 #define NET_MIC_LEN(pdu) (((pdu)[1] & 0x80) ? 8 : 4)
 #define APP_MIC_LEN(aszmic) ((aszmic) ? 8 : 4)
 
+/*
+ * AES-128 with one key for a series of blocks. With the software AES, the
+ * key is expanded once per series, and expanded keys are cached for the
+ * keys that encrypt every PDU: NetKey derived and application keys. The
+ * cache is looked up by key value, so a key that changes simply misses.
+ */
+struct mesh_aes {
+#if defined(CONFIG_BT_MESH_CRYPTO_SW_AES)
+	struct bt_aes_key sched;
+#else
+	const u8_t *key;
+#endif
+};
+
+#if CONFIG_BT_MESH_CRYPTO_KEY_CACHE > 0
+static struct {
+	u8_t key[16];
+	struct bt_aes_key sched;
+	/* 0 for an unused entry */
+	u32_t last_used;
+} key_cache[CONFIG_BT_MESH_CRYPTO_KEY_CACHE];
+
+static u32_t key_cache_clock;
+
+static bool key_cache_get(const u8_t key[16], struct bt_aes_key *sched)
+{
+	unsigned int key_irq = irq_lock();
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(key_cache); i++) {
+		if (key_cache[i].last_used &&
+		    !memcmp(key_cache[i].key, key, 16)) {
+			key_cache[i].last_used = ++key_cache_clock;
+			memcpy(sched, &key_cache[i].sched, sizeof(*sched));
+			irq_unlock(key_irq);
+			return true;
+		}
+	}
+
+	irq_unlock(key_irq);
+
+	return false;
+}
+
+static void key_cache_add(const u8_t key[16], const struct bt_aes_key *sched)
+{
+	unsigned int key_irq = irq_lock();
+	int i, lru = 0;
+
+	for (i = 1; i < ARRAY_SIZE(key_cache); i++) {
+		if (key_cache[i].last_used < key_cache[lru].last_used) {
+			lru = i;
+		}
+	}
+
+	memcpy(key_cache[lru].key, key, 16);
+	memcpy(&key_cache[lru].sched, sched, sizeof(*sched));
+	key_cache[lru].last_used = ++key_cache_clock;
+
+	irq_unlock(key_irq);
+}
+#endif /* CONFIG_BT_MESH_CRYPTO_KEY_CACHE > 0 */
+
+void bt_mesh_crypto_cache_clear(void)
+{
+#if CONFIG_BT_MESH_CRYPTO_KEY_CACHE > 0
+	unsigned int key_irq = irq_lock();
+
+	memset(key_cache, 0, sizeof(key_cache));
+	key_cache_clock = 0;
+
+	irq_unlock(key_irq);
+#endif
+}
+
+static int mesh_aes_init(struct mesh_aes *aes, const u8_t key[16],
+			 bool cache)
+{
+#if defined(CONFIG_BT_MESH_CRYPTO_SW_AES)
+	int err;
+
+#if CONFIG_BT_MESH_CRYPTO_KEY_CACHE > 0
+	if (cache && key_cache_get(key, &aes->sched)) {
+		return 0;
+	}
+#endif
+
+	err = bt_aes_key_set(&aes->sched, key);
+
+#if CONFIG_BT_MESH_CRYPTO_KEY_CACHE > 0
+	if (!err && cache) {
+		key_cache_add(key, &aes->sched);
+	}
+#endif
+
+	return err;
+#else
+	aes->key = key;
+
+	return 0;
+#endif
+}
+
+static inline int mesh_aes_encrypt(const struct mesh_aes *aes,
+				   const u8_t in[16], u8_t out[16])
+{
+#if defined(CONFIG_BT_MESH_CRYPTO_SW_AES)
+	return bt_aes_encrypt_be(&aes->sched, in, out);
+#else
+	return bt_encrypt_be(aes->key, in, out);
+#endif
+}
+
+static inline void xor16(u8_t *dst, const u8_t *src)
+{
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		dst[i] ^= src[i];
+	}
+}
+
+/* doubling in GF(2^128), for the CMAC subkeys */
+static void cmac_dbl(u8_t out[16], const u8_t in[16])
+{
+	u8_t msb = in[0] & 0x80;
+	int i;
+
+	for (i = 0; i < 15; i++) {
+		out[i] = (in[i] << 1) | (in[i + 1] >> 7);
+	}
+
+	out[15] = (in[15] << 1) ^ (msb ? 0x87 : 0x00);
+}
+
 int bt_mesh_aes_cmac(const u8_t key[16], struct bt_mesh_sg *sg,
 		     size_t sg_len, u8_t mac[16])
 {
-	struct tc_aes_key_sched_struct sched;
-	struct tc_cmac_struct state;
+	u8_t x[16] = { 0 }, blk[16], subkey[16];
+	struct mesh_aes aes;
+	size_t n = 0, copy, off;
+	int err;
 
-	if (tc_cmac_setup(&state, key, &sched) == TC_CRYPTO_FAIL) {
-		return -EIO;
+	/* mostly intermediate keys of the key derivations, not cached */
+	err = mesh_aes_init(&aes, key, false);
+	if (err) {
+		return err;
 	}
 
+	/* the last block is held back until the data is known to end */
 	for (; sg_len; sg_len--, sg++) {
-		if (tc_cmac_update(&state, sg->data,
-				   sg->len) == TC_CRYPTO_FAIL) {
-			return -EIO;
+		for (off = 0; off < sg->len; off += copy) {
+			if (n == 16) {
+				xor16(x, blk);
+				err = mesh_aes_encrypt(&aes, x, x);
+				if (err) {
+					return err;
+				}
+
+				n = 0;
+			}
+
+			copy = min(16 - n, sg->len - off);
+			memcpy(&blk[n], (const u8_t *)sg->data + off, copy);
+			n += copy;
 		}
 	}
 
-	if (tc_cmac_final(mac, &state) == TC_CRYPTO_FAIL) {
-		return -EIO;
+	/* K1 = dbl(L) for a complete last block, K2 = dbl(K1) otherwise */
+	memset(subkey, 0, sizeof(subkey));
+	err = mesh_aes_encrypt(&aes, subkey, subkey);
+	if (err) {
+		return err;
 	}
 
-	return 0;
+	cmac_dbl(subkey, subkey);
+
+	if (n < 16) {
+		cmac_dbl(subkey, subkey);
+		blk[n++] = 0x80;
+		memset(&blk[n], 0, 16 - n);
+	}
+
+	xor16(x, blk);
+	xor16(x, subkey);
+
+	return mesh_aes_encrypt(&aes, x, mac);
 }
 
 int bt_mesh_k1(const u8_t *ikm, size_t ikm_len, const u8_t salt[16],
@@ -202,26 +363,28 @@ int bt_mesh_id128(const u8_t n[16], const char *s, u8_t out[16])
 	return bt_mesh_k1(n, 16, salt, id128, out);
 }
 
-static int bt_mesh_ccm_decrypt(const u8_t key[16], u8_t nonce[13],
-			       const u8_t *enc_msg, size_t msg_len,
-			       const u8_t *aad, size_t aad_len,
-			       u8_t *out_msg, size_t mic_size)
+/*
+ * CCM as used by mesh: CBC-MAC over the additional data and the plaintext,
+ * and CTR encryption with the same key, expanded once for the whole
+ * message. Encrypts, or decrypts if @a decrypt, msg_len bytes from in to
+ * out, which may be the same buffer, and leaves the MIC in @a mic.
+ */
+static int ccm_crypt(const struct mesh_aes *aes, const u8_t nonce[13],
+		     const u8_t *in, size_t msg_len, const u8_t *aad,
+		     size_t aad_len, u8_t *out, size_t mic_size, u8_t mic[16],
+		     bool decrypt)
 {
-	u8_t msg[16], pmsg[16], cmic[16], cmsg[16], Xn[16], mic[16];
-	u16_t last_blk, blk_cnt;
-	size_t i, j;
+	u8_t pmsg[16], cmic[16], cmsg[16], Xn[16];
+	size_t i, j, blk_len;
+	u8_t c, p;
 	int err;
 
-	if (msg_len < 1 || aad_len >= 0xff00) {
-		return -EINVAL;
-	}
-
 	/* C_mic = e(AppKey, 0x01 || nonce || 0x0000) */
 	pmsg[0] = 0x01;
 	memcpy(pmsg + 1, nonce, 13);
 	sys_put_be16(0x0000, pmsg + 14);
 
-	err = bt_encrypt_be(key, pmsg, cmic);
+	err = mesh_aes_encrypt(aes, pmsg, cmic);
 	if (err) {
 		return err;
 	}
@@ -233,124 +396,95 @@ static int bt_mesh_ccm_decrypt(const u8_t key[16], u8_t nonce[13],
 		pmsg[0] = 0x09 | (aad_len ? 0x40 : 0x00);
 	}
 
-	memcpy(pmsg + 1, nonce, 13);
 	sys_put_be16(msg_len, pmsg + 14);
 
-	err = bt_encrypt_be(key, pmsg, Xn);
+	err = mesh_aes_encrypt(aes, pmsg, Xn);
 	if (err) {
 		return err;
 	}
 
 	/* If AAD is being used to authenticate, include it here */
 	if (aad_len) {
-		sys_put_be16(aad_len, pmsg);
-
-		for (i = 0; i < sizeof(u16_t); i++) {
-			pmsg[i] = Xn[i] ^ pmsg[i];
+		Xn[0] ^= aad_len >> 8;
+		Xn[1] ^= aad_len;
+
+		for (i = sizeof(u16_t), j = 0; j < aad_len; j++) {
+			Xn[i++] ^= aad[j];
+			if (i == 16) {
+				err = mesh_aes_encrypt(aes, Xn, Xn);
+				if (err) {
+					return err;
+				}
+
+				i = 0;
+			}
 		}
 
-		j = 0;
-		aad_len += sizeof(u16_t);
-		while (aad_len > 16) {
-			do {
-				pmsg[i] = Xn[i] ^ aad[j];
-				i++, j++;
-			} while (i < 16);
-
-			aad_len -= 16;
-			i = 0;
-
-			err = bt_encrypt_be(key, pmsg, Xn);
+		if (i) {
+			err = mesh_aes_encrypt(aes, Xn, Xn);
 			if (err) {
 				return err;
 			}
 		}
+	}
+
+	/* C_N = e(AppKey, 0x01 || nonce || N) */
+	pmsg[0] = 0x01;
+
+	for (j = 0; j < msg_len; j += blk_len) {
+		blk_len = min(16, msg_len - j);
 
-		for (i = 0; i < aad_len; i++, j++) {
-			pmsg[i] = Xn[i] ^ aad[j];
+		sys_put_be16(j / 16 + 1, pmsg + 14);
+
+		err = mesh_aes_encrypt(aes, pmsg, cmsg);
+		if (err) {
+			return err;
 		}
 
-		for (i = aad_len; i < 16; i++) {
-			pmsg[i] = Xn[i];
+		/* X_N = e(AppKey, X_N-1 ^ Payload_N), Out_N = In_N ^ C_N */
+		for (i = 0; i < blk_len; i++) {
+			c = in[j + i] ^ cmsg[i];
+			p = decrypt ? c : in[j + i];
+			out[j + i] = c;
+			Xn[i] ^= p;
 		}
 
-		err = bt_encrypt_be(key, pmsg, Xn);
+		err = mesh_aes_encrypt(aes, Xn, Xn);
 		if (err) {
 			return err;
 		}
 	}
 
-	last_blk = msg_len % 16;
-	blk_cnt = (msg_len + 15) / 16;
-	if (!last_blk) {
-		last_blk = 16;
+	/* MIC = C_mic ^ X_N */
+	for (i = 0; i < 16; i++) {
+		mic[i] = cmic[i] ^ Xn[i];
 	}
 
-	for (j = 0; j < blk_cnt; j++) {
-		if (j + 1 == blk_cnt) {
-			/* C_1 = e(AppKey, 0x01 || nonce || 0x0001) */
-			pmsg[0] = 0x01;
-			memcpy(pmsg + 1, nonce, 13);
-			sys_put_be16(j + 1, pmsg + 14);
-
-			err = bt_encrypt_be(key, pmsg, cmsg);
-			if (err) {
-				return err;
-			}
-
-			/* Encrypted = Payload[0-15] ^ C_1 */
-			for (i = 0; i < last_blk; i++) {
-				msg[i] = enc_msg[(j * 16) + i] ^ cmsg[i];
-			}
-
-			memcpy(out_msg + (j * 16), msg, last_blk);
-
-			/* X_1 = e(AppKey, X_0 ^ Payload[0-15]) */
-			for (i = 0; i < last_blk; i++) {
-				pmsg[i] = Xn[i] ^ msg[i];
-			}
-
-			for (i = last_blk; i < 16; i++) {
-				pmsg[i] = Xn[i] ^ 0x00;
-			}
-
-			err = bt_encrypt_be(key, pmsg, Xn);
-			if (err) {
-				return err;
-			}
-
-			/* MIC = C_mic ^ X_1 */
-			for (i = 0; i < sizeof(mic); i++) {
-				mic[i] = cmic[i] ^ Xn[i];
-			}
-		} else {
-			/* C_1 = e(AppKey, 0x01 || nonce || 0x0001) */
-			pmsg[0] = 0x01;
-			memcpy(pmsg + 1, nonce, 13);
-			sys_put_be16(j + 1, pmsg + 14);
-
-			err = bt_encrypt_be(key, pmsg, cmsg);
-			if (err) {
-				return err;
-			}
+	return 0;
+}
 
-			/* Encrypted = Payload[0-15] ^ C_1 */
-			for (i = 0; i < 16; i++) {
-				msg[i] = enc_msg[(j * 16) + i] ^ cmsg[i];
-			}
+static int bt_mesh_ccm_decrypt(const u8_t key[16], u8_t nonce[13],
+			       const u8_t *enc_msg, size_t msg_len,
+			       const u8_t *aad, size_t aad_len,
+			       u8_t *out_msg, size_t mic_size)
+{
+	struct mesh_aes aes;
+	u8_t mic[16];
+	int err;
 
-			memcpy(out_msg + (j * 16), msg, 16);
+	if (msg_len < 1 || aad_len >= 0xff00) {
+		return -EINVAL;
+	}
 
-			/* X_1 = e(AppKey, X_0 ^ Payload[0-15]) */
-			for (i = 0; i < 16; i++) {
-				pmsg[i] = Xn[i] ^ msg[i];
-			}
+	err = mesh_aes_init(&aes, key, true);
+	if (err) {
+		return err;
+	}
 
-			err = bt_encrypt_be(key, pmsg, Xn);
-			if (err) {
-				return err;
-			}
-		}
+	err = ccm_crypt(&aes, nonce, enc_msg, msg_len, aad, aad_len, out_msg,
+			mic_size, mic, true);
+	if (err) {
+		return err;
 	}
 
 	if (memcmp(mic, enc_msg + msg_len, mic_size)) {
@@ -365,9 +499,8 @@ static int bt_mesh_ccm_encrypt(const u8_t key[16], u8_t nonce[13],
 			       const u8_t *aad, size_t aad_len,
 			       u8_t *out_msg, size_t mic_size)
 {
-	u8_t pmsg[16], cmic[16], cmsg[16], mic[16], Xn[16];
-	u16_t blk_cnt, last_blk;
-	size_t i, j;
+	struct mesh_aes aes;
+	u8_t mic[16];
 	int err;
 
 	BT_DBG("key %s", bt_hex(key, 16));
@@ -380,141 +513,17 @@ static int bt_mesh_ccm_encrypt(const u8_t key[16], u8_t nonce[13],
 		return -EINVAL;
 	}
 
-	/* C_mic = e(AppKey, 0x01 || nonce || 0x0000) */
-	pmsg[0] = 0x01;
-	memcpy(pmsg + 1, nonce, 13);
-	sys_put_be16(0x0000, pmsg + 14);
-
-	err = bt_encrypt_be(key, pmsg, cmic);
+	err = mesh_aes_init(&aes, key, true);
 	if (err) {
 		return err;
 	}
 
-	/* X_0 = e(AppKey, 0x09 || nonce || length) */
-	if (mic_size == sizeof(u64_t)) {
-		pmsg[0] = 0x19 | (aad_len ? 0x40 : 0x00);
-	} else {
-		pmsg[0] = 0x09 | (aad_len ? 0x40 : 0x00);
-	}
-
-	memcpy(pmsg + 1, nonce, 13);
-	sys_put_be16(msg_len, pmsg + 14);
-
-	err = bt_encrypt_be(key, pmsg, Xn);
+	err = ccm_crypt(&aes, nonce, msg, msg_len, aad, aad_len, out_msg,
+			mic_size, mic, false);
 	if (err) {
 		return err;
 	}
 
-	/* If AAD is being used to authenticate, include it here */
-	if (aad_len) {
-		sys_put_be16(aad_len, pmsg);
-
-		for (i = 0; i < sizeof(u16_t); i++) {
-			pmsg[i] = Xn[i] ^ pmsg[i];
-		}
-
-		j = 0;
-		aad_len += sizeof(u16_t);
-		while (aad_len > 16) {
-			do {
-				pmsg[i] = Xn[i] ^ aad[j];
-				i++, j++;
-			} while (i < 16);
-
-			aad_len -= 16;
-			i = 0;
-
-			err = bt_encrypt_be(key, pmsg, Xn);
-			if (err) {
-				return err;
-			}
-		}
-
-		for (i = 0; i < aad_len; i++, j++) {
-			pmsg[i] = Xn[i] ^ aad[j];
-		}
-
-		for (i = aad_len; i < 16; i++) {
-			pmsg[i] = Xn[i];
-		}
-
-		err = bt_encrypt_be(key, pmsg, Xn);
-		if (err) {
-			return err;
-		}
-	}
-
-	last_blk = msg_len % 16;
-	blk_cnt = (msg_len + 15) / 16;
-	if (!last_blk) {
-		last_blk = 16;
-	}
-
-	for (j = 0; j < blk_cnt; j++) {
-		if (j + 1 == blk_cnt) {
-			/* X_1 = e(AppKey, X_0 ^ Payload[0-15]) */
-			for (i = 0; i < last_blk; i++) {
-				pmsg[i] = Xn[i] ^ msg[(j * 16) + i];
-			}
-			for (i = last_blk; i < 16; i++) {
-				pmsg[i] = Xn[i] ^ 0x00;
-			}
-
-			err = bt_encrypt_be(key, pmsg, Xn);
-			if (err) {
-				return err;
-			}
-
-			/* MIC = C_mic ^ X_1 */
-			for (i = 0; i < sizeof(mic); i++) {
-				mic[i] = cmic[i] ^ Xn[i];
-			}
-
-			/* C_1 = e(AppKey, 0x01 || nonce || 0x0001) */
-			pmsg[0] = 0x01;
-			memcpy(pmsg + 1, nonce, 13);
-			sys_put_be16(j + 1, pmsg + 14);
-
-			err = bt_encrypt_be(key, pmsg, cmsg);
-			if (err) {
-				return err;
-			}
-
-			/* Encrypted = Payload[0-15] ^ C_1 */
-			for (i = 0; i < last_blk; i++) {
-				out_msg[(j * 16) + i] =
-					msg[(j * 16) + i] ^ cmsg[i];
-			}
-		} else {
-			/* X_1 = e(AppKey, X_0 ^ Payload[0-15]) */
-			for (i = 0; i < 16; i++) {
-				pmsg[i] = Xn[i] ^ msg[(j * 16) + i];
-			}
-
-			err = bt_encrypt_be(key, pmsg, Xn);
-			if (err) {
-				return err;
-			}
-
-			/* C_1 = e(AppKey, 0x01 || nonce || 0x0001) */
-			pmsg[0] = 0x01;
-			memcpy(pmsg + 1, nonce, 13);
-			sys_put_be16(j + 1, pmsg + 14);
-
-			err = bt_encrypt_be(key, pmsg, cmsg);
-			if (err) {
-				return err;
-			}
-
-			/* Encrypted = Payload[0-15] ^ C_N */
-			for (i = 0; i < 16; i++) {
-				out_msg[(j * 16) + i] =
-					msg[(j * 16) + i] ^ cmsg[i];
-			}
-
-		}
-	}
-
 	memcpy(out_msg + msg_len, mic, mic_size);
 
 	return 0;
@@ -578,6 +587,7 @@ int bt_mesh_net_obfuscate(u8_t *pdu, u32_t iv_index,
 			  const u8_t privacy_key[16])
 {
 	u8_t priv_rand[16] = { 0x00, 0x00, 0x00, 0x00, 0x00, };
+	struct mesh_aes aes;
 	u8_t tmp[16];
 	int err, i;
 
@@ -588,7 +598,12 @@ int bt_mesh_net_obfuscate(u8_t *pdu, u32_t iv_index,
 
 	BT_DBG("PrivacyRandom %s", bt_hex(priv_rand, 16));
 
-	err = bt_encrypt_be(privacy_key, priv_rand, tmp);
+	err = mesh_aes_init(&aes, privacy_key, true);
+	if (err) {
+		return err;
+	}
+
+	err = mesh_aes_encrypt(&aes, priv_rand, tmp);
 	if (err) {
 		return err;
 	}
@@ -29,6 +29,7 @@
 #include "access.h"
 #include "foundation.h"
 #include "proxy.h"
+#include "crypto.h"
 #include "mesh.h"
 
 static bool provisioned;
@@ -130,7 +131,9 @@ void bt_mesh_reset(void)
 
 	memset(bt_mesh.dev_key, 0, sizeof(bt_mesh.dev_key));
 
-	memset(bt_mesh.rpl, 0, sizeof(bt_mesh.rpl));
+	bt_mesh_rpl_clear();
+
+	bt_mesh_crypto_cache_clear();
 
 	provisioned = false;
 
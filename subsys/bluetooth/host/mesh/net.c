@@ -75,8 +75,40 @@
 static struct friend_cred friend_cred[FRIEND_CRED_COUNT];
 #endif
 
-static u64_t msg_cache[CONFIG_BT_MESH_MSG_CACHE_SIZE];
-static u16_t msg_cache_next;
+/* Credentials a received PDU may be encrypted with, sorted by NID so
+ * that only the ones whose NID matches the PDU get tried. Rebuilt by
+ * bt_mesh_net_creds_update() whenever keys or friendships change.
+ */
+#define NET_CRED_COUNT (2 * CONFIG_BT_MESH_SUBNET_COUNT + 2 * FRIEND_CRED_COUNT)
+
+static struct net_cred {
+	struct bt_mesh_subnet *sub;
+	const u8_t *enc;
+	const u8_t *privacy;
+	u8_t nid;
+	u8_t new_key:1,
+	     friend_cred:1;
+} net_creds[NET_CRED_COUNT];
+
+/* Credentials of NID n are net_creds[nid_first[n]] to [nid_first[n + 1]] */
+static u16_t nid_first[0x80 + 1];
+
+static struct bt_mesh_net_stats net_stats;
+
+/* The message cache is set associative: a message can only be in the set
+ * its hash selects, and each set replaces its oldest entry first.
+ */
+#if CONFIG_BT_MESH_MSG_CACHE_SIZE < 4
+#define MSG_CACHE_WAYS CONFIG_BT_MESH_MSG_CACHE_SIZE
+#else
+#define MSG_CACHE_WAYS 4
+#endif
+
+#define MSG_CACHE_SETS \
+	((CONFIG_BT_MESH_MSG_CACHE_SIZE + MSG_CACHE_WAYS - 1) / MSG_CACHE_WAYS)
+
+static u64_t msg_cache[MSG_CACHE_SETS][MSG_CACHE_WAYS];
+static u8_t msg_cache_next[MSG_CACHE_SETS];
 
 /* Singleton network context (the implementation only supports one) */
 struct bt_mesh_net bt_mesh = {
@@ -129,21 +161,26 @@ static u64_t msg_hash(struct bt_mesh_net_rx *rx, struct net_buf_simple *pdu)
 	return (u64_t)hash1 << 32 | (u64_t)hash2;
 }
 
-static bool msg_cache_match(struct bt_mesh_net_rx *rx,
-			    struct net_buf_simple *pdu)
+bool bt_mesh_msg_cache_check(struct bt_mesh_net_rx *rx,
+			     struct net_buf_simple *pdu)
 {
 	u64_t hash = msg_hash(rx, pdu);
-	u16_t i;
+	u32_t set;
+	int i;
 
-	for (i = 0; i < ARRAY_SIZE(msg_cache); i++) {
-		if (msg_cache[i] == hash) {
+	/* Fold SEQ and SRC, which vary the most between messages */
+	set = ((u32_t)hash ^ (u32_t)(hash >> 32)) * 2654435761U;
+	set = (set >> 16) % MSG_CACHE_SETS;
+
+	for (i = 0; i < MSG_CACHE_WAYS; i++) {
+		if (msg_cache[set][i] == hash) {
 			return true;
 		}
 	}
 
 	/* Add to the cache */
-	msg_cache[msg_cache_next++] = hash;
-	msg_cache_next %= ARRAY_SIZE(msg_cache);
+	msg_cache[set][msg_cache_next[set]++] = hash;
+	msg_cache_next[set] %= MSG_CACHE_WAYS;
 
 	return false;
 }
@@ -272,6 +309,8 @@ void friend_cred_refresh(u16_t net_idx)
 			       sizeof(cred->cred[0]));
 		}
 	}
+
+	bt_mesh_net_creds_update();
 }
 
 int friend_cred_update(struct bt_mesh_subnet *sub)
@@ -294,6 +333,8 @@ int friend_cred_update(struct bt_mesh_subnet *sub)
 		}
 	}
 
+	bt_mesh_net_creds_update();
+
 	return 0;
 }
 
@@ -338,6 +379,8 @@ struct friend_cred *friend_cred_create(struct bt_mesh_subnet *sub, u16_t addr,
 		}
 	}
 
+	bt_mesh_net_creds_update();
+
 	return cred;
 }
 
@@ -348,6 +391,8 @@ void friend_cred_clear(struct friend_cred *cred)
 	cred->lpn_counter = 0;
 	cred->frnd_counter = 0;
 	memset(cred->cred, 0, sizeof(cred->cred));
+
+	bt_mesh_net_creds_update();
 }
 
 int friend_cred_del(u16_t net_idx, u16_t addr)
@@ -458,7 +503,7 @@ int bt_mesh_net_create(u16_t idx, u8_t flags, const u8_t key[16],
 	}
 
 	memset(msg_cache, 0, sizeof(msg_cache));
-	msg_cache_next = 0;
+	memset(msg_cache_next, 0, sizeof(msg_cache_next));
 
 	sub = &bt_mesh.sub[0];
 
@@ -496,6 +541,8 @@ int bt_mesh_net_create(u16_t idx, u8_t flags, const u8_t key[16],
 	/* Make sure we have valid beacon data to be sent */
 	bt_mesh_net_beacon_update(sub);
 
+	bt_mesh_net_creds_update();
+
 	return 0;
 }
 
@@ -556,6 +603,7 @@ bool bt_mesh_kr_update(struct bt_mesh_subnet *sub, u8_t new_kr, bool new_key)
 				friend_cred_refresh(sub->net_idx);
 			}
 			sub->kr_phase = BT_MESH_KR_NORMAL;
+			bt_mesh_net_creds_update();
 			return true;
 		}
 	}
@@ -563,26 +611,6 @@ bool bt_mesh_kr_update(struct bt_mesh_subnet *sub, u8_t new_kr, bool new_key)
 	return false;
 }
 
-void bt_mesh_rpl_reset(void)
-{
-	int i;
-
-	/* Discard "old old" IV Index entries from RPL and flag
-	 * any other ones (which are valid) as old.
-	 */
-	for (i = 0; i < ARRAY_SIZE(bt_mesh.rpl); i++) {
-		struct bt_mesh_rpl *rpl = &bt_mesh.rpl[i];
-
-		if (rpl->src) {
-			if (rpl->old_iv) {
-				memset(rpl, 0, sizeof(*rpl));
-			} else {
-				rpl->old_iv = true;
-			}
-		}
-	}
-}
-
 #if defined(CONFIG_BT_MESH_IV_UPDATE_TEST)
 void bt_mesh_iv_update_test(bool enable)
 {
@@ -656,7 +684,7 @@ bool bt_mesh_net_iv_update(u32_t iv_index, bool iv_update)
 
 		if (iv_index > bt_mesh.iv_index + 1) {
 			BT_WARN("Performing IV Index Recovery");
-			memset(bt_mesh.rpl, 0, sizeof(bt_mesh.rpl));
+			bt_mesh_rpl_clear();
 			bt_mesh.iv_index = iv_index;
 			bt_mesh.seq = 0;
 			goto do_update;
@@ -993,7 +1021,8 @@ static int net_decrypt(struct bt_mesh_subnet *sub, const u8_t *enc,
 		return -ENOENT;
 	}
 
-	if (rx->net_if == BT_MESH_NET_IF_ADV && msg_cache_match(rx, buf)) {
+	if (rx->net_if == BT_MESH_NET_IF_ADV &&
+	    bt_mesh_msg_cache_check(rx, buf)) {
 		BT_WARN("Duplicate found in Network Message Cache");
 		return -EALREADY;
 	}
@@ -1015,15 +1044,31 @@ static int net_decrypt(struct bt_mesh_subnet *sub, const u8_t *enc,
 	return bt_mesh_net_decrypt(enc, buf, BT_MESH_NET_IVI_RX(rx), false);
 }
 
-#if (defined(CONFIG_BT_MESH_LOW_POWER) || \
-     defined(CONFIG_BT_MESH_FRIEND))
-static int friend_decrypt(struct bt_mesh_subnet *sub, const u8_t *data,
-			  size_t data_len, struct bt_mesh_net_rx *rx,
-			  struct net_buf_simple *buf)
+/* Counts the credential when pos is NULL, or stores it at its position */
+static void net_cred_add(u16_t *pos, struct bt_mesh_subnet *sub,
+			 const u8_t *enc, const u8_t *privacy, u8_t nid,
+			 bool new_key, bool friend_cred)
 {
-	int i;
+	struct net_cred *cred;
 
-	BT_DBG("NID 0x%02x net_idx 0x%04x", NID(data), sub->net_idx);
+	if (!pos) {
+		nid_first[nid]++;
+		return;
+	}
+
+	cred = &net_creds[pos[nid]++];
+	cred->sub = sub;
+	cred->enc = enc;
+	cred->privacy = privacy;
+	cred->nid = nid;
+	cred->new_key = new_key;
+	cred->friend_cred = friend_cred;
+}
+
+#if FRIEND_CRED_COUNT > 0
+static void friend_creds_walk(u16_t *pos, struct bt_mesh_subnet *sub)
+{
+	int i;
 
 	for (i = 0; i < ARRAY_SIZE(friend_cred); i++) {
 		struct friend_cred *cred = &friend_cred[i];
@@ -1032,78 +1077,115 @@ static int friend_decrypt(struct bt_mesh_subnet *sub, const u8_t *data,
 			continue;
 		}
 
-		if (NID(data) == cred->cred[0].nid &&
-		    !net_decrypt(sub, cred->cred[0].enc, cred->cred[0].privacy,
-				 data, data_len, rx, buf)) {
-			return 0;
-		}
-
-		if (sub->kr_phase == BT_MESH_KR_NORMAL) {
-			continue;
-		}
+		net_cred_add(pos, sub, cred->cred[0].enc, cred->cred[0].privacy,
+			     cred->cred[0].nid, false, true);
 
-		if (NID(data) == cred->cred[1].nid &&
-		    !net_decrypt(sub, cred->cred[1].enc, cred->cred[1].privacy,
-				 data, data_len, rx, buf)) {
-			rx->new_key = 1;
-			return 0;
+		if (sub->kr_phase != BT_MESH_KR_NORMAL) {
+			net_cred_add(pos, sub, cred->cred[1].enc,
+				     cred->cred[1].privacy, cred->cred[1].nid,
+				     true, true);
 		}
 	}
-
-	return -ENOENT;
 }
 #endif
 
-static bool net_find_and_decrypt(const u8_t *data, size_t data_len,
-				 struct bt_mesh_net_rx *rx,
-				 struct net_buf_simple *buf)
+/* Friend credentials come first within each subnet, and the new keys of
+ * a Key Refresh last, as each NID keeps this order.
+ */
+static void net_creds_walk(u16_t *pos)
 {
 	struct bt_mesh_subnet *sub;
 	int i;
 
-	BT_DBG("");
-
 	for (i = 0; i < ARRAY_SIZE(bt_mesh.sub); i++) {
 		sub = &bt_mesh.sub[i];
 		if (sub->net_idx == BT_MESH_KEY_UNUSED) {
 			continue;
 		}
 
-#if (defined(CONFIG_BT_MESH_LOW_POWER) || \
-     defined(CONFIG_BT_MESH_FRIEND))
-		if (!friend_decrypt(sub, data, data_len, rx, buf)) {
-			rx->friend_cred = 1;
-			rx->ctx.net_idx = sub->net_idx;
-			rx->sub = sub;
-			return true;
-		}
+#if FRIEND_CRED_COUNT > 0
+		friend_creds_walk(pos, sub);
 #endif
 
-		if (NID(data) == sub->keys[0].nid &&
-		    !net_decrypt(sub, sub->keys[0].enc, sub->keys[0].privacy,
-				 data, data_len, rx, buf)) {
-			rx->ctx.net_idx = sub->net_idx;
-			rx->sub = sub;
-			return true;
+		net_cred_add(pos, sub, sub->keys[0].enc, sub->keys[0].privacy,
+			     sub->keys[0].nid, false, false);
+
+		if (sub->kr_phase != BT_MESH_KR_NORMAL) {
+			net_cred_add(pos, sub, sub->keys[1].enc,
+				     sub->keys[1].privacy, sub->keys[1].nid,
+				     true, false);
 		}
+	}
+}
+
+void bt_mesh_net_creds_update(void)
+{
+	u16_t pos[0x80];
+	int i, count;
+
+	/* Counting sort by NID */
+	memset(nid_first, 0, sizeof(nid_first));
+	net_creds_walk(NULL);
+
+	for (i = 0, count = 0; i < ARRAY_SIZE(pos); i++) {
+		pos[i] = count;
+		count += nid_first[i];
+		nid_first[i] = pos[i];
+	}
+
+	nid_first[0x80] = count;
+
+	net_creds_walk(pos);
+
+	BT_DBG("%u credentials", count);
+}
+
+static bool net_find_and_decrypt(const u8_t *data, size_t data_len,
+				 struct bt_mesh_net_rx *rx,
+				 struct net_buf_simple *buf)
+{
+	struct net_cred *cred;
+	int i, err;
+
+	BT_DBG("");
+
+	net_stats.rx++;
+
+	for (i = nid_first[NID(data)]; i < nid_first[NID(data) + 1]; i++) {
+		cred = &net_creds[i];
+
+		net_stats.decrypt++;
+
+		err = net_decrypt(cred->sub, cred->enc, cred->privacy, data,
+				  data_len, rx, buf);
+		if (err) {
+			if (err != -EALREADY) {
+				net_stats.decrypt_failed++;
+			}
 
-		if (sub->kr_phase == BT_MESH_KR_NORMAL) {
 			continue;
 		}
 
-		if (NID(data) == sub->keys[1].nid &&
-		    !net_decrypt(sub, sub->keys[1].enc, sub->keys[1].privacy,
-				 data, data_len, rx, buf)) {
-			rx->new_key = 1;
-			rx->ctx.net_idx = sub->net_idx;
-			rx->sub = sub;
-			return true;
-		}
+		rx->new_key = cred->new_key;
+		rx->friend_cred = cred->friend_cred;
+		rx->ctx.net_idx = cred->sub->net_idx;
+		rx->sub = cred->sub;
+		return true;
 	}
 
 	return false;
 }
 
+void bt_mesh_net_stats_get(struct bt_mesh_net_stats *stats)
+{
+	*stats = net_stats;
+}
+
+void bt_mesh_net_stats_reset(void)
+{
+	memset(&net_stats, 0, sizeof(net_stats));
+}
+
 /* Relaying from advertising to the advertising bearer should only happen
  * if the Relay state is set to enabled. Locally originated packets always
  * get sent to the advertising bearer. If the packet came in through GATT,
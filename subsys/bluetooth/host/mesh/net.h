@@ -63,10 +63,16 @@ struct bt_mesh_subnet {
 
 struct bt_mesh_rpl {
 	u16_t src;
-	bool  old_iv;
+	u8_t  old_iv:1,
+	      store:1; /* Not yet passed to the storage callback */
 	u32_t seq;
 };
 
+/* The RPL is an open addressed hash table kept at most 2/3 full, so that
+ * lookups stay short and there always is a free slot to end them.
+ */
+#define RPL_SLOTS (CONFIG_BT_MESH_CRPL + CONFIG_BT_MESH_CRPL / 2)
+
 #if defined(CONFIG_BT_MESH_FRIEND)
 #define FRIEND_SEG_RX CONFIG_BT_MESH_FRIEND_SEG_RX
 #define FRIEND_SUB_LIST_SIZE CONFIG_BT_MESH_FRIEND_SUB_LIST_SIZE
@@ -214,7 +220,8 @@ struct bt_mesh_net {
 
 	struct bt_mesh_subnet sub[CONFIG_BT_MESH_SUBNET_COUNT];
 
-	struct bt_mesh_rpl rpl[CONFIG_BT_MESH_CRPL];
+	struct bt_mesh_rpl rpl[RPL_SLOTS];
+	u16_t rpl_count;
 };
 
 /* Network interface */
@@ -275,6 +282,20 @@ int bt_mesh_net_beacon_update(struct bt_mesh_subnet *sub);
 
 void bt_mesh_rpl_reset(void);
 
+bool bt_mesh_msg_cache_check(struct bt_mesh_net_rx *rx,
+			     struct net_buf_simple *pdu);
+
+void bt_mesh_net_creds_update(void);
+
+struct bt_mesh_net_stats {
+	u32_t rx;             /* PDUs looked up */
+	u32_t decrypt;        /* Decryption attempts */
+	u32_t decrypt_failed; /* Attempts failing authentication */
+};
+
+void bt_mesh_net_stats_get(struct bt_mesh_net_stats *stats);
+void bt_mesh_net_stats_reset(void);
+
 bool bt_mesh_net_iv_update(u32_t iv_index, bool iv_update);
 
 void bt_mesh_net_sec_update(struct bt_mesh_subnet *sub);
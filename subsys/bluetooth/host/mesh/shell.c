@@ -755,6 +755,23 @@ static int cmd_rpl_clear(int argc, char *argv[])
 	return 0;
 }
 
+static int cmd_net_stats(int argc, char *argv[])
+{
+	struct bt_mesh_net_stats stats;
+
+	bt_mesh_net_stats_get(&stats);
+
+	printk("Received PDUs:          %u\n", stats.rx);
+	printk("Decryption attempts:    %u\n", stats.decrypt);
+	printk("Failed decryptions:     %u\n", stats.decrypt_failed);
+
+	if (argc > 1 && !strcmp(argv[1], "reset")) {
+		bt_mesh_net_stats_reset();
+	}
+
+	return 0;
+}
+
 static int cmd_beacon(int argc, char *argv[])
 {
 	u8_t status;
@@ -1900,6 +1917,7 @@ static const struct shell_cmd mesh_commands[] = {
 	{ "iv-update", cmd_iv_update, NULL },
 	{ "iv-update-test", cmd_iv_update_test, "<value: off, on>" },
 	{ "rpl-clear", cmd_rpl_clear, NULL },
+	{ "net-stats", cmd_net_stats, "[reset]" },
 
 	/* Configuration Client Model operations */
 	{ "get-comp", cmd_get_comp, "[page]" },
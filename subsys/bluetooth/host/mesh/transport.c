@@ -497,42 +497,184 @@ int bt_mesh_trans_resend(struct bt_mesh_net_tx *tx, struct net_buf_simple *msg,
 	return err;
 }
 
-static bool is_replay(struct bt_mesh_net_rx *rx)
+static const struct bt_mesh_rpl_store *rpl_store;
+static struct k_delayed_work rpl_store_work;
+
+static void rpl_store_flush(struct k_work *work)
 {
 	int i;
 
-	for (i = 0; i < ARRAY_SIZE(bt_mesh.rpl); i++) {
+	if (!rpl_store) {
+		return;
+	}
+
+	for (i = 0; i < RPL_SLOTS; i++) {
 		struct bt_mesh_rpl *rpl = &bt_mesh.rpl[i];
 
-		/* Empty slot */
-		if (!rpl->src) {
-			rpl->src = rx->ctx.addr;
-			rpl->seq = rx->seq;
-			rpl->old_iv = rx->old_iv;
-			return false;
+		if (rpl->store) {
+			rpl->store = 0;
+			rpl_store->store(rpl->src, rpl->seq, rpl->old_iv);
 		}
+	}
+}
 
-		/* Existing slot for given address */
-		if (rpl->src == rx->ctx.addr) {
-			if (rx->old_iv && !rpl->old_iv) {
-				return true;
-			}
+static void rpl_set(struct bt_mesh_rpl *rpl, u16_t src, u32_t seq,
+		    bool old_iv)
+{
+	rpl->src = src;
+	rpl->seq = seq;
+	rpl->old_iv = old_iv;
 
-			if ((!rx->old_iv && rpl->old_iv) ||
-			    rpl->seq < rx->seq) {
-				rpl->seq = rx->seq;
-				rpl->old_iv = rx->old_iv;
-				return false;
-			} else {
-				return true;
-			}
+	if (!rpl_store) {
+		return;
+	}
+
+	rpl->store = 1;
+
+	/* Not postponed by further updates, so a busy source still gets
+	 * stored at least once per timeout.
+	 */
+	if (!k_delayed_work_remaining_get(&rpl_store_work)) {
+		k_delayed_work_submit(&rpl_store_work,
+				      K_SECONDS(CONFIG_BT_MESH_RPL_STORE_TIMEOUT));
+	}
+}
+
+/* Returns the entry of the source address, or the free slot to add it in.
+ * Unicast addresses are mostly allocated in sequence, which spreads them
+ * evenly over the table.
+ */
+static struct bt_mesh_rpl *rpl_lookup(u16_t src)
+{
+	int i = src % RPL_SLOTS;
+
+	while (bt_mesh.rpl[i].src && bt_mesh.rpl[i].src != src) {
+		i = (i + 1) % RPL_SLOTS;
+	}
+
+	return &bt_mesh.rpl[i];
+}
+
+/* Backward shift deletion: the entries after the removed one that would
+ * no longer be found across the gap are moved into it.
+ */
+static void rpl_remove(int i)
+{
+	int j, home;
+
+	for (j = (i + 1) % RPL_SLOTS; bt_mesh.rpl[j].src;
+	     j = (j + 1) % RPL_SLOTS) {
+		home = bt_mesh.rpl[j].src % RPL_SLOTS;
+
+		/* j can move into the gap unless it belongs in (i, j] */
+		if (i < j ? (home <= i || home > j) : (home <= i && home > j)) {
+			bt_mesh.rpl[i] = bt_mesh.rpl[j];
+			i = j;
+		}
+	}
+
+	memset(&bt_mesh.rpl[i], 0, sizeof(bt_mesh.rpl[i]));
+	bt_mesh.rpl_count--;
+}
+
+bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx)
+{
+	struct bt_mesh_rpl *rpl = rpl_lookup(rx->ctx.addr);
+
+	/* Empty slot */
+	if (!rpl->src) {
+		if (bt_mesh.rpl_count == CONFIG_BT_MESH_CRPL) {
+			BT_ERR("RPL is full!");
+			return true;
 		}
+
+		bt_mesh.rpl_count++;
+		rpl_set(rpl, rx->ctx.addr, rx->seq, rx->old_iv);
+		return false;
+	}
+
+	/* Existing slot for given address */
+	if (rx->old_iv && !rpl->old_iv) {
+		return true;
+	}
+
+	if ((!rx->old_iv && rpl->old_iv) || rpl->seq < rx->seq) {
+		rpl_set(rpl, rx->ctx.addr, rx->seq, rx->old_iv);
+		return false;
 	}
 
-	BT_ERR("RPL is full!");
 	return true;
 }
 
+void bt_mesh_rpl_reset(void)
+{
+	int start, n, i;
+
+	/* Discard "old old" IV Index entries from RPL and flag
+	 * any other ones (which are valid) as old. The walk starts
+	 * at a free slot, so that the entries removals move back
+	 * into the current slot are the only ones seen again.
+	 */
+	for (start = 0; bt_mesh.rpl[start].src; start++) {
+	}
+
+	for (n = 1; n < RPL_SLOTS; n++) {
+		struct bt_mesh_rpl *rpl;
+
+		i = (start + n) % RPL_SLOTS;
+		rpl = &bt_mesh.rpl[i];
+
+		while (rpl->src && rpl->old_iv) {
+			rpl_remove(i);
+		}
+
+		if (rpl->src) {
+			rpl->old_iv = 1;
+		}
+	}
+
+	if (rpl_store) {
+		rpl_store->clear();
+
+		for (i = 0; i < RPL_SLOTS; i++) {
+			if (bt_mesh.rpl[i].src) {
+				rpl_set(&bt_mesh.rpl[i], bt_mesh.rpl[i].src,
+					bt_mesh.rpl[i].seq, true);
+			}
+		}
+	}
+}
+
+int bt_mesh_rpl_restore(u16_t src, u32_t seq, bool old_iv)
+{
+	struct bt_mesh_rpl *rpl;
+
+	if (!BT_MESH_ADDR_IS_UNICAST(src)) {
+		return -EINVAL;
+	}
+
+	rpl = rpl_lookup(src);
+	if (!rpl->src) {
+		if (bt_mesh.rpl_count == CONFIG_BT_MESH_CRPL) {
+			return -ENOMEM;
+		}
+
+		bt_mesh.rpl_count++;
+	}
+
+	/* Already in storage */
+	rpl->src = src;
+	rpl->seq = seq;
+	rpl->old_iv = old_iv;
+
+	return 0;
+}
+
+void bt_mesh_rpl_store_register(const struct bt_mesh_rpl_store *store)
+{
+	rpl_store = store;
+}
+
 static int sdu_recv(struct bt_mesh_net_rx *rx, u8_t hdr, u8_t aszmic,
 		    struct net_buf_simple *buf)
 {
@@ -828,7 +970,7 @@ static int trans_unseg(struct net_buf_simple *buf, struct bt_mesh_net_rx *rx,
 		return -EINVAL;
 	}
 
-	if (rx->local_match && is_replay(rx)) {
+	if (rx->local_match && bt_mesh_rpl_check(rx)) {
 		BT_WARN("Replay: src 0x%04x dst 0x%04x seq 0x%06x",
 			rx->ctx.addr, rx->dst, rx->seq);
 		return -EINVAL;
@@ -1227,7 +1369,7 @@ found_rx:
 
 	BT_DBG("Complete SDU");
 
-	if (net_rx->local_match && is_replay(net_rx)) {
+	if (net_rx->local_match && bt_mesh_rpl_check(net_rx)) {
 		BT_WARN("Replay: src 0x%04x dst 0x%04x seq 0x%06x",
 			net_rx->ctx.addr, net_rx->dst, net_rx->seq);
 		/* Clear the segment's bit */
@@ -1380,10 +1522,18 @@ void bt_mesh_trans_init(void)
 	for (i = 0; i < ARRAY_SIZE(seg_rx); i++) {
 		k_delayed_work_init(&seg_rx[i].ack, seg_ack);
 	}
+
+	k_delayed_work_init(&rpl_store_work, rpl_store_flush);
 }
 
 void bt_mesh_rpl_clear(void)
 {
 	BT_DBG("");
 	memset(bt_mesh.rpl, 0, sizeof(bt_mesh.rpl));
+	bt_mesh.rpl_count = 0;
+
+	if (rpl_store) {
+		k_delayed_work_cancel(&rpl_store_work);
+		rpl_store->clear();
+	}
 }
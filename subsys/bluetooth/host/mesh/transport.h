@@ -94,4 +94,6 @@ int bt_mesh_trans_recv(struct net_buf_simple *buf, struct bt_mesh_net_rx *rx);
 
 void bt_mesh_trans_init(void);
 
+bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx);
+
 void bt_mesh_rpl_clear(void);
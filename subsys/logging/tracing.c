@@ -0,0 +1,162 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Binary tracing
+ *
+ * Each execution context records into its own ring of fixed size records.
+ * Producers are serialized by locking interrupts for the few instructions
+ * it takes to claim a slot and fill it, which also keeps the timestamps of
+ * a ring in order. The rings have a single consumer: sys_trace_get(), or
+ * the backend when one is enabled.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <lf_ring.h>
+#include <logging/tracing.h>
+#include <init.h>
+
+#ifdef CONFIG_TRACING_BACKEND_NATIVE_POSIX
+#include "trace_ctf.h"
+#endif
+
+SYS_LF_RING_DEFINE(trace_thread_ring, sizeof(struct sys_trace_record),
+		   CONFIG_TRACING_BUFFER_SIZE, 0);
+SYS_LF_RING_DEFINE(trace_isr_ring, sizeof(struct sys_trace_record),
+		   CONFIG_TRACING_BUFFER_SIZE, 0);
+
+static struct sys_lf_ring *const trace_rings[SYS_TRACE_CONTEXT_COUNT] = {
+	[SYS_TRACE_CONTEXT_THREAD] = &trace_thread_ring,
+	[SYS_TRACE_CONTEXT_ISR] = &trace_isr_ring,
+};
+
+static u32_t trace_dropped;
+
+void sys_trace_event(u16_t id, u16_t extra, u32_t arg)
+{
+	struct sys_lf_ring *ring;
+	struct sys_trace_record *rec;
+	unsigned int key;
+
+	key = irq_lock();
+
+	ring = trace_rings[_is_in_isr() ? SYS_TRACE_CONTEXT_ISR :
+			   SYS_TRACE_CONTEXT_THREAD];
+
+	if (!sys_lf_ring_put_claim(ring, (void **)&rec, 1)) {
+		trace_dropped++;
+		irq_unlock(key);
+		return;
+	}
+
+	rec->timestamp = k_cycle_get_32();
+	rec->id = id;
+	rec->extra = extra;
+	rec->arg = arg;
+	sys_lf_ring_put_finish(ring, 1);
+
+	irq_unlock(key);
+}
+
+u32_t sys_trace_get(int context, struct sys_trace_record *records,
+		    u32_t count)
+{
+	__ASSERT(context >= 0 && context < SYS_TRACE_CONTEXT_COUNT,
+		 "invalid trace context");
+
+	return sys_lf_ring_get(trace_rings[context], records, count);
+}
+
+u32_t sys_trace_dropped_get(void)
+{
+	return trace_dropped;
+}
+
+#ifdef CONFIG_TRACING_BACKEND_NATIVE_POSIX
+static const char * const trace_event_names[SYS_TRACE_ID_COUNT] = {
+	[SYS_TRACE_THREAD_SWITCHED_IN] = "thread_switched_in",
+	[SYS_TRACE_ISR_ENTER] = "isr_enter",
+	[SYS_TRACE_ISR_EXIT] = "isr_exit",
+	[SYS_TRACE_SEM_GIVE] = "sem_give",
+	[SYS_TRACE_SEM_TAKE] = "sem_take",
+	[SYS_TRACE_MUTEX_LOCK] = "mutex_lock",
+	[SYS_TRACE_MUTEX_UNLOCK] = "mutex_unlock",
+	[SYS_TRACE_QUEUE_PUT] = "queue_put",
+	[SYS_TRACE_QUEUE_GET] = "queue_get",
+	[SYS_TRACE_NET_RECV] = "net_recv",
+	[SYS_TRACE_NET_SEND] = "net_send",
+	[SYS_TRACE_BT_RECV] = "bt_recv",
+	[SYS_TRACE_BT_SEND] = "bt_send",
+};
+
+static void trace_drain(void)
+{
+	struct sys_trace_record *recs;
+	u32_t n, ctx, budget;
+
+	/* The scheduler lock is not traced, so draining adds no records.
+	 * Only what is buffered on entry is drained, as the switches into
+	 * this thread keep adding records.
+	 */
+	k_sched_lock();
+
+	for (ctx = 0; ctx < SYS_TRACE_CONTEXT_COUNT; ctx++) {
+		budget = sys_lf_ring_used_get(trace_rings[ctx]);
+
+		while (budget) {
+			n = sys_lf_ring_get_claim(trace_rings[ctx],
+						  (void **)&recs, budget);
+			if (!n) {
+				break;
+			}
+
+			posix_trace_ctf_write(ctx, recs, n * sizeof(*recs));
+			sys_lf_ring_get_finish(trace_rings[ctx], n);
+			budget -= n;
+		}
+	}
+
+	k_sched_unlock();
+}
+
+void sys_trace_flush(void)
+{
+	trace_drain();
+}
+
+static int trace_backend_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	posix_trace_ctf_open(CONFIG_TRACING_NATIVE_POSIX_DIR,
+			     sys_clock_hw_cycles_per_sec, trace_event_names,
+			     SYS_TRACE_ID_COUNT, SYS_TRACE_CONTEXT_COUNT);
+
+	return 0;
+}
+
+SYS_INIT(trace_backend_init, PRE_KERNEL_1, 0);
+
+static void trace_backend_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		trace_drain();
+		k_sleep(CONFIG_TRACING_FLUSH_INTERVAL);
+	}
+}
+
+K_THREAD_DEFINE(trace_backend, CONFIG_TRACING_BACKEND_STACK_SIZE,
+		trace_backend_thread, NULL, NULL, NULL,
+		K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_NO_WAIT);
+#else
+void sys_trace_flush(void)
+{
+}
+#endif /* CONFIG_TRACING_BACKEND_NATIVE_POSIX */
@@ -191,6 +191,27 @@ success:
 	return buf;
 }
 
+struct net_buf *net_buf_alloc_with_data(struct net_buf_pool *pool,
+					void *data, u16_t size,
+					s32_t timeout)
+{
+	struct net_buf *buf;
+
+	buf = net_buf_alloc(pool, timeout);
+	if (!buf) {
+		return NULL;
+	}
+
+	/* The size is left to the pool data size as it locates the user
+	 * data, external buffers have no tailroom anyway.
+	 */
+	buf->flags = NET_BUF_EXTERNAL_DATA;
+	buf->data = data;
+	buf->len = size;
+
+	return buf;
+}
+
 #if defined(CONFIG_NET_BUF_LOG)
 struct net_buf *net_buf_get_debug(struct k_fifo *fifo, s32_t timeout,
 				  const char *func, int line)
@@ -358,6 +379,7 @@ struct net_buf *net_buf_clone(struct net_buf *buf, s32_t timeout)
 	struct net_buf *clone;
 
 	NET_BUF_ASSERT(buf);
+	NET_BUF_ASSERT(!(buf->flags & NET_BUF_EXTERNAL_DATA));
 
 	pool = net_buf_pool_get(buf->pool_id);
 
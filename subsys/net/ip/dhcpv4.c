@@ -87,6 +87,7 @@ enum dhcpv4_msg_type {
 #define DHCPV4_OPTIONS_REQ_LIST		55
 #define DHCPV4_OPTIONS_RENEWAL		58
 #define DHCPV4_OPTIONS_REBINDING	59
+#define DHCPV4_OPTIONS_RAPID_COMMIT	80
 #define DHCPV4_OPTIONS_END		255
 
 /* TODO:
@@ -100,6 +101,12 @@ enum dhcpv4_msg_type {
  */
 #define DHCPV4_MAX_NUMBER_OF_ATTEMPTS	3
 
+/* Maximum number of REQUEST retransmits in INIT-REBOOT before giving
+ * up on the old lease. This is kept low as the previous server may not
+ * be reachable at all any more.
+ */
+#define DHCPV4_MAX_NUMBER_OF_REBOOT_ATTEMPTS	2
+
 /* Initial message retry timeout (s).  This timeout increases
  * exponentially on each retransmit.
  * RFC2131 4.1
@@ -116,6 +123,8 @@ enum dhcpv4_msg_type {
 /* RFC 1497 [17] */
 static const u8_t magic_cookie[4] = { 0x63, 0x82, 0x53, 0x63 };
 
+static const struct net_dhcpv4_lease_storage *lease_storage;
+
 static void dhcpv4_timeout(struct k_work *work);
 
 static const char *
@@ -128,6 +137,7 @@ const char *net_dhcpv4_state_name(enum net_dhcpv4_state state)
 		"init",
 		"selecting",
 		"requesting",
+		"rebooting",
 		"renewing",
 		"rebinding",
 		"bound",
@@ -213,6 +223,17 @@ static bool add_req_ipaddr(struct net_pkt *pkt, const struct in_addr *addr)
 				       addr->s4_addr);
 }
 
+#if defined(CONFIG_NET_DHCPV4_RAPID_COMMIT)
+/* RFC4039 2: the rapid commit option has no data */
+static bool add_rapid_commit(struct net_pkt *pkt)
+{
+	return net_pkt_append_u8(pkt, DHCPV4_OPTIONS_RAPID_COMMIT) &&
+		net_pkt_append_u8(pkt, 0);
+}
+#else
+#define add_rapid_commit(...) true
+#endif
+
 /* Add DHCPv4 Options end, rest of the message can be padded wit zeros */
 static inline bool add_end(struct net_pkt *pkt)
 {
@@ -372,6 +393,13 @@ static void send_request(struct net_if *iface)
 		with_server_id = true;
 		with_requested_ip = true;
 		break;
+	case NET_DHCPV4_REBOOTING:
+		/* RFC2131 4.3.2 Client MUST NOT include server
+		 * identifier nor fill in ciaddr in INIT-REBOOT, the
+		 * address is given in the requested IP option.
+		 */
+		with_requested_ip = true;
+		break;
 	case NET_DHCPV4_RENEWING:
 		/* Since we have an address populate the ciaddr field.
 		 */
@@ -465,6 +493,7 @@ static void send_discover(struct net_if *iface)
 	}
 
 	if (!add_req_options(pkt) ||
+	    !add_rapid_commit(pkt) ||
 	    !add_end(pkt)) {
 		goto fail;
 	}
@@ -519,6 +548,82 @@ static void enter_requesting(struct net_if *iface)
 	send_request(iface);
 }
 
+static void enter_rebooting(struct net_if *iface)
+{
+	iface->dhcpv4.attempts = 0;
+	iface->dhcpv4.state = NET_DHCPV4_REBOOTING;
+	NET_DBG("enter state=%s requested=%s",
+		net_dhcpv4_state_name(iface->dhcpv4.state),
+		net_sprint_ipv4_addr(&iface->dhcpv4.requested_ip));
+
+	send_request(iface);
+}
+
+/* Find a lease to confirm with INIT-REBOOT. The lease the client had
+ * when it was stopped is preferred over the one in the storage.
+ */
+static bool lease_restore(struct net_if *iface)
+{
+	struct net_dhcpv4_lease lease;
+	s64_t elapsed;
+
+	if (iface->dhcpv4.lease_time &&
+	    !net_is_ipv4_addr_unspecified(&iface->dhcpv4.requested_ip)) {
+		elapsed = (k_uptime_get() - iface->dhcpv4.timestamp) /
+			MSEC_PER_SEC;
+		if (elapsed < iface->dhcpv4.lease_time) {
+			NET_DBG("reuse lease, %"PRIu32"s left",
+				iface->dhcpv4.lease_time - (u32_t)elapsed);
+			return true;
+		}
+	}
+
+	if (!lease_storage || !lease_storage->load) {
+		return false;
+	}
+
+	memset(&lease, 0, sizeof(lease));
+
+	if (lease_storage->load(iface, &lease) < 0 ||
+	    !lease.lease_time ||
+	    net_is_ipv4_addr_unspecified(&lease.addr)) {
+		return false;
+	}
+
+	NET_DBG("stored lease, %"PRIu32"s left", lease.lease_time);
+
+	net_ipaddr_copy(&iface->dhcpv4.requested_ip, &lease.addr);
+	net_ipaddr_copy(&iface->dhcpv4.server_id, &lease.server_id);
+
+	return true;
+}
+
+static void lease_store(struct net_if *iface)
+{
+	struct net_dhcpv4_lease lease;
+
+	if (!lease_storage || !lease_storage->store) {
+		return;
+	}
+
+	net_ipaddr_copy(&lease.addr, &iface->dhcpv4.requested_ip);
+	net_ipaddr_copy(&lease.server_id, &iface->dhcpv4.server_id);
+	lease.lease_time = iface->dhcpv4.lease_time;
+
+	if (lease_storage->store(iface, &lease) < 0) {
+		NET_DBG("Cannot store lease");
+	}
+}
+
+static void lease_forget(struct net_if *iface)
+{
+	iface->dhcpv4.lease_time = 0;
+
+	if (lease_storage && lease_storage->store) {
+		lease_storage->store(iface, NULL);
+	}
+}
+
 static void dhcpv4_t1_timeout(struct k_work *work)
 {
 	struct net_if *iface = CONTAINER_OF(work, struct net_if,
@@ -531,6 +636,7 @@ static void dhcpv4_t1_timeout(struct k_work *work)
 	case NET_DHCPV4_INIT:
 	case NET_DHCPV4_SELECTING:
 	case NET_DHCPV4_REQUESTING:
+	case NET_DHCPV4_REBOOTING:
 	case NET_DHCPV4_RENEWING:
 	case NET_DHCPV4_REBINDING:
 		/* This path cannot happen. */
@@ -559,6 +665,7 @@ static void dhcpv4_t2_timeout(struct k_work *work)
 	case NET_DHCPV4_INIT:
 	case NET_DHCPV4_SELECTING:
 	case NET_DHCPV4_REQUESTING:
+	case NET_DHCPV4_REBOOTING:
 	case NET_DHCPV4_REBINDING:
 		NET_ASSERT_INFO(0, "Invalid state %s",
 				net_dhcpv4_state_name(iface->dhcpv4.state));
@@ -598,6 +705,9 @@ static void enter_bound(struct net_if *iface)
 		rebinding_time = iface->dhcpv4.lease_time * 875 / 1000;
 	}
 
+	iface->dhcpv4.timestamp = k_uptime_get();
+	lease_store(iface);
+
 	iface->dhcpv4.state = NET_DHCPV4_BOUND;
 	NET_DBG("enter state=%s renewal=%"PRIu32"s "
 		"rebinding=%"PRIu32"s",
@@ -641,6 +751,17 @@ static void dhcpv4_timeout(struct k_work *work)
 			send_request(iface);
 		}
 
+		break;
+	case NET_DHCPV4_REBOOTING:
+		/* The old server did not answer, get a new lease */
+		if (iface->dhcpv4.attempts >=
+		    DHCPV4_MAX_NUMBER_OF_REBOOT_ATTEMPTS) {
+			NET_DBG("no answer to reboot request, restart");
+			enter_selecting(iface);
+		} else {
+			send_request(iface);
+		}
+
 		break;
 	case NET_DHCPV4_BOUND:
 		break;
@@ -670,7 +791,8 @@ static void dhcpv4_timeout(struct k_work *work)
 static enum net_verdict parse_options(struct net_if *iface,
 				      struct net_buf *frag,
 				      u16_t offset,
-				      enum dhcpv4_msg_type *msg_type)
+				      enum dhcpv4_msg_type *msg_type,
+				      bool *rapid_commit)
 {
 	u8_t cookie[4];
 	u8_t length;
@@ -813,6 +935,15 @@ static enum net_verdict parse_options(struct net_if *iface,
 			*msg_type = v;
 			break;
 		}
+		case DHCPV4_OPTIONS_RAPID_COMMIT:
+			if (length != 0) {
+				NET_DBG("options_rapid_commit, bad length");
+				return NET_DROP;
+			}
+
+			NET_DBG("options_rapid_commit");
+			*rapid_commit = true;
+			break;
 		default:
 			NET_DBG("option unknown: %d", type);
 			frag = net_frag_skip(frag, pos, &pos, length);
@@ -834,6 +965,7 @@ static inline void handle_offer(struct net_if *iface)
 	case NET_DHCPV4_DISABLED:
 	case NET_DHCPV4_INIT:
 	case NET_DHCPV4_REQUESTING:
+	case NET_DHCPV4_REBOOTING:
 	case NET_DHCPV4_RENEWING:
 	case NET_DHCPV4_REBINDING:
 	case NET_DHCPV4_BOUND:
@@ -845,15 +977,25 @@ static inline void handle_offer(struct net_if *iface)
 	}
 }
 
-static void handle_ack(struct net_if *iface)
+static void handle_ack(struct net_if *iface, bool rapid_commit)
 {
 	switch (iface->dhcpv4.state) {
 	case NET_DHCPV4_DISABLED:
 	case NET_DHCPV4_INIT:
-	case NET_DHCPV4_SELECTING:
 	case NET_DHCPV4_BOUND:
 		break;
+	case NET_DHCPV4_SELECTING:
+		/* RFC4039 3.1 An ACK with the rapid commit option
+		 * answers our DISCOVER directly.
+		 */
+		if (!IS_ENABLED(CONFIG_NET_DHCPV4_RAPID_COMMIT) ||
+		    !rapid_commit) {
+			break;
+		}
+
+		/* Fall through */
 	case NET_DHCPV4_REQUESTING:
+	case NET_DHCPV4_REBOOTING:
 		NET_INFO("Received: %s",
 			 net_sprint_ipv4_addr(&iface->dhcpv4.requested_ip));
 		if (!net_if_ipv4_addr_add(iface,
@@ -886,6 +1028,11 @@ static void handle_nak(struct net_if *iface)
 	case NET_DHCPV4_RENEWING:
 	case NET_DHCPV4_BOUND:
 		break;
+	case NET_DHCPV4_REBOOTING:
+		/* RFC2131 3.2 The stored lease is not valid any more */
+		lease_forget(iface);
+
+		/* Fall through */
 	case NET_DHCPV4_REQUESTING:
 	case NET_DHCPV4_REBINDING:
 		/* Restart the configuration process. */
@@ -900,7 +1047,8 @@ static void handle_nak(struct net_if *iface)
 }
 
 static void handle_dhcpv4_reply(struct net_if *iface,
-				enum dhcpv4_msg_type msg_type)
+				enum dhcpv4_msg_type msg_type,
+				bool rapid_commit)
 {
 	NET_DBG("state=%s msg=%s",
 		net_dhcpv4_state_name(iface->dhcpv4.state),
@@ -911,7 +1059,7 @@ static void handle_dhcpv4_reply(struct net_if *iface,
 		handle_offer(iface);
 		break;
 	case DHCPV4_MSG_TYPE_ACK:
-		handle_ack(iface);
+		handle_ack(iface, rapid_commit);
 		break;
 	case DHCPV4_MSG_TYPE_NAK:
 		handle_nak(iface);
@@ -930,6 +1078,7 @@ static enum net_verdict net_dhcpv4_input(struct net_conn *conn,
 	struct net_buf *frag;
 	struct net_if *iface;
 	enum dhcpv4_msg_type msg_type = 0;
+	bool rapid_commit = false;
 	u8_t min;
 	u16_t pos;
 
@@ -994,14 +1143,15 @@ static enum net_verdict net_dhcpv4_input(struct net_conn *conn,
 		goto drop;
 	}
 
-	if (parse_options(iface, frag, pos, &msg_type) == NET_DROP) {
+	if (parse_options(iface, frag, pos, &msg_type,
+			  &rapid_commit) == NET_DROP) {
 		NET_DBG("Invalid Options");
 		goto drop;
 	}
 
 	net_pkt_unref(pkt);
 
-	handle_dhcpv4_reply(iface, msg_type);
+	handle_dhcpv4_reply(iface, msg_type, rapid_commit);
 
 	return NET_OK;
 
@@ -1020,11 +1170,6 @@ void net_dhcpv4_start(struct net_if *iface)
 		NET_DBG("state=%s", net_dhcpv4_state_name(iface->dhcpv4.state));
 
 		iface->dhcpv4.attempts = 0;
-		iface->dhcpv4.lease_time = 0;
-		iface->dhcpv4.renewal_time = 0;
-
-		iface->dhcpv4.server_id.s_addr = 0;
-		iface->dhcpv4.requested_ip.s_addr = 0;
 
 		k_delayed_work_init(&iface->dhcpv4.timer, dhcpv4_timeout);
 		k_delayed_work_init(&iface->dhcpv4.t1_timer, dhcpv4_t1_timeout);
@@ -1042,6 +1187,20 @@ void net_dhcpv4_start(struct net_if *iface)
 		 */
 		iface->dhcpv4.xid = entropy;
 
+		/* A known lease is confirmed right away, without
+		 * the initial random delay.
+		 */
+		if (lease_restore(iface)) {
+			enter_rebooting(iface);
+			break;
+		}
+
+		iface->dhcpv4.lease_time = 0;
+		iface->dhcpv4.renewal_time = 0;
+
+		iface->dhcpv4.server_id.s_addr = 0;
+		iface->dhcpv4.requested_ip.s_addr = 0;
+
 
 		/* RFC2131 4.1.1 requires we wait a random period
 		 * between 1 and 10 seconds before sending the initial
@@ -1059,6 +1218,7 @@ void net_dhcpv4_start(struct net_if *iface)
 	case NET_DHCPV4_INIT:
 	case NET_DHCPV4_SELECTING:
 	case NET_DHCPV4_REQUESTING:
+	case NET_DHCPV4_REBOOTING:
 	case NET_DHCPV4_RENEWING:
 	case NET_DHCPV4_REBINDING:
 	case NET_DHCPV4_BOUND:
@@ -1068,6 +1228,14 @@ void net_dhcpv4_start(struct net_if *iface)
 
 void net_dhcpv4_stop(struct net_if *iface)
 {
+	/* Only a lease which was bound is confirmed on the next start */
+	if (iface->dhcpv4.state != NET_DHCPV4_DISABLED &&
+	    iface->dhcpv4.state != NET_DHCPV4_BOUND &&
+	    iface->dhcpv4.state != NET_DHCPV4_RENEWING &&
+	    iface->dhcpv4.state != NET_DHCPV4_REBINDING) {
+		iface->dhcpv4.lease_time = 0;
+	}
+
 	switch (iface->dhcpv4.state) {
 	case NET_DHCPV4_DISABLED:
 		break;
@@ -1082,6 +1250,7 @@ void net_dhcpv4_stop(struct net_if *iface)
 	case NET_DHCPV4_INIT:
 	case NET_DHCPV4_SELECTING:
 	case NET_DHCPV4_REQUESTING:
+	case NET_DHCPV4_REBOOTING:
 	case NET_DHCPV4_RENEWING:
 	case NET_DHCPV4_REBINDING:
 		iface->dhcpv4.state = NET_DHCPV4_DISABLED;
@@ -1094,6 +1263,12 @@ void net_dhcpv4_stop(struct net_if *iface)
 	}
 }
 
+void net_dhcpv4_set_lease_storage(
+	const struct net_dhcpv4_lease_storage *storage)
+{
+	lease_storage = storage;
+}
+
 int dhcpv4_init(void)
 {
 	struct sockaddr local_addr;
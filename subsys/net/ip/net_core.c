@@ -29,6 +29,7 @@
 #include <net/net_pkt.h>
 #include <net/net_core.h>
 #include <net/dns_resolve.h>
+#include <logging/tracing.h>
 
 #include "net_private.h"
 #include "net_shell.h"
@@ -138,9 +139,13 @@ static void processing_data(struct net_pkt *pkt, bool is_loopback)
 	}
 }
 
+/* Packets taken from the RX queue per wakeup */
+#define NET_RX_BATCH 8
+
 static void net_rx_thread(void)
 {
 	struct net_pkt *pkt;
+	sys_slist_t pkts;
 
 	NET_DBG("Starting RX thread (stack %zu bytes)",
 		K_THREAD_STACK_SIZEOF(rx_stack));
@@ -158,12 +163,22 @@ static void net_rx_thread(void)
 	/* This will take the interface up and start everything. */
 	net_if_post_init();
 
+	sys_slist_init(&pkts);
+
 	while (1) {
 #if defined(CONFIG_NET_STATISTICS) || defined(CONFIG_NET_DEBUG_CORE)
 		size_t pkt_len;
 #endif
 
-		pkt = k_fifo_get(&rx_queue, K_FOREVER);
+		if (sys_slist_is_empty(&pkts)) {
+			k_fifo_get_batch(&rx_queue, &pkts, NET_RX_BATCH,
+					 K_FOREVER);
+		}
+
+		pkt = (struct net_pkt *)sys_slist_get(&pkts);
+		if (!pkt) {
+			continue;
+		}
 
 		net_analyze_stack("RX thread", K_THREAD_STACK_BUFFER(rx_stack),
 				  K_THREAD_STACK_SIZEOF(rx_stack));
@@ -180,7 +195,9 @@ static void net_rx_thread(void)
 		net_print_statistics();
 		net_pkt_print();
 
-		k_yield();
+		if (sys_slist_is_empty(&pkts)) {
+			k_yield();
+		}
 	}
 }
 
@@ -296,6 +313,8 @@ int net_send_data(struct net_pkt *pkt)
 		return -ENODATA;
 	}
 
+	SYS_TRACE(SYS_TRACE_NET_SEND, net_pkt_get_len(pkt), pkt);
+
 	if (!net_pkt_iface(pkt)) {
 		return -EINVAL;
 	}
@@ -340,6 +359,8 @@ int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
 		return -ENODATA;
 	}
 
+	SYS_TRACE(SYS_TRACE_NET_RECV, net_pkt_get_len(pkt), pkt);
+
 	if (!atomic_test_bit(iface->flags, NET_IF_UP)) {
 		return -ENETDOWN;
 	}
@@ -87,6 +87,31 @@ NET_PKT_SLAB_DEFINE(tx_pkts, CONFIG_NET_PKT_TX_COUNT);
 NET_PKT_DATA_POOL_DEFINE(rx_bufs, CONFIG_NET_BUF_RX_COUNT);
 NET_PKT_DATA_POOL_DEFINE(tx_bufs, CONFIG_NET_BUF_TX_COUNT);
 
+#if CONFIG_NET_BUF_EXT_COUNT > 0
+/* Stored in the user data of fragments referring to external data. The
+ * data pointer is kept here as net_buf_pull() may move frag->data.
+ */
+struct ext_data {
+	const u8_t *data;
+	net_pkt_ext_free_cb_t cb;
+	void *user_data;
+};
+
+static void ext_frag_destroy(struct net_buf *frag)
+{
+	struct ext_data ext = *(struct ext_data *)net_buf_user_data(frag);
+
+	net_buf_destroy(frag);
+
+	if (ext.cb) {
+		ext.cb(ext.data, ext.user_data);
+	}
+}
+
+NET_BUF_POOL_DEFINE(ext_bufs, CONFIG_NET_BUF_EXT_COUNT, 0,
+		    sizeof(struct ext_data), ext_frag_destroy);
+#endif /* CONFIG_NET_BUF_EXT_COUNT > 0 */
+
 #if defined(CONFIG_NET_DEBUG_NET_PKT)
 
 #define NET_FRAG_CHECK_IF_NOT_IN_USE(frag, ref)				\
@@ -115,6 +140,7 @@ struct net_pkt_alloc {
 			    CONFIG_NET_PKT_TX_COUNT + \
 			    CONFIG_NET_BUF_RX_COUNT + \
 			    CONFIG_NET_BUF_TX_COUNT + \
+			    CONFIG_NET_BUF_EXT_COUNT + \
 			    CONFIG_NET_DEBUG_NET_PKT_EXTERNALS)
 
 static struct net_pkt_alloc net_pkt_allocs[MAX_NET_PKT_ALLOCS];
@@ -1124,11 +1150,16 @@ bool net_pkt_compact(struct net_pkt *pkt)
 			memcpy(net_buf_tail(frag), frag->frags->data, copy_len);
 			net_buf_add(frag, copy_len);
 
-			memmove(frag->frags->data,
-				frag->frags->data + copy_len,
-				frag->frags->len - copy_len);
+			if (frag->frags->flags & NET_BUF_EXTERNAL_DATA) {
+				/* External data is read-only */
+				net_buf_pull(frag->frags, copy_len);
+			} else {
+				memmove(frag->frags->data,
+					frag->frags->data + copy_len,
+					frag->frags->len - copy_len);
 
-			frag->frags->len -= copy_len;
+				frag->frags->len -= copy_len;
+			}
 
 			/* Is there any more space in this fragment */
 			if (net_buf_tailroom(frag)) {
@@ -1244,6 +1275,74 @@ u16_t net_pkt_append(struct net_pkt *pkt, u16_t len, const u8_t *data,
 	return appended;
 }
 
+u16_t net_pkt_append_ext(struct net_pkt *pkt, u16_t len, const u8_t *data,
+			 net_pkt_ext_free_cb_t cb, void *user_data,
+			 s32_t timeout)
+{
+#if CONFIG_NET_BUF_EXT_COUNT > 0
+	struct net_context *ctx;
+	struct ext_data *ext;
+	struct net_buf *frag;
+
+	if (!pkt || !data || !len) {
+		return 0;
+	}
+
+	ctx = net_pkt_context(pkt);
+	if (ctx) {
+		/* Same limits as in net_pkt_append() */
+		if (len > pkt->data_len) {
+			len = pkt->data_len;
+		}
+
+#if defined(CONFIG_NET_TCP)
+		if (ctx->tcp && ctx->tcp->send_mss < len) {
+			len = ctx->tcp->send_mss;
+		}
+#endif
+
+		if (!len) {
+			return 0;
+		}
+	}
+
+	if (k_is_in_isr()) {
+		timeout = K_NO_WAIT;
+	}
+
+	frag = net_buf_alloc_with_data(&ext_bufs, (u8_t *)data, len, timeout);
+	if (!frag) {
+		return 0;
+	}
+
+#if defined(CONFIG_NET_DEBUG_NET_PKT)
+	net_pkt_alloc_add(frag, false, __func__, __LINE__);
+#endif
+
+	ext = net_buf_user_data(frag);
+	ext->data = data;
+	ext->cb = cb;
+	ext->user_data = user_data;
+
+	net_pkt_frag_add(pkt, frag);
+
+	if (ctx) {
+		pkt->data_len -= len;
+	}
+
+	return len;
+#else
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(len);
+	ARG_UNUSED(data);
+	ARG_UNUSED(cb);
+	ARG_UNUSED(user_data);
+	ARG_UNUSED(timeout);
+
+	return 0;
+#endif /* CONFIG_NET_BUF_EXT_COUNT > 0 */
+}
+
 /* Helper routine to retrieve single byte from fragment and move
  * offset. If required byte is last byte in framgent then return
  * next fragment and set offset = 0.
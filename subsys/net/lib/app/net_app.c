@@ -1899,6 +1899,323 @@ int _net_app_entropy_source(void *data, unsigned char *output, size_t len,
 	return 0;
 }
 
+#if defined(CONFIG_NET_APP_TLS_SESSION_RESUMPTION)
+#define TLS_SESSION_LIFETIME K_SECONDS(CONFIG_NET_APP_TLS_SESSION_LIFETIME)
+
+#if defined(CONFIG_NET_APP_CLIENT) && defined(MBEDTLS_SSL_CLI_C)
+/* Sessions of client connections. These are kept here instead of in the
+ * net_app context so that a client which releases its context and
+ * connects again to the same peer can still resume the old session.
+ */
+struct tls_session_entry {
+	struct sockaddr remote;
+	mbedtls_ssl_session session;
+	s64_t timestamp;
+	bool used;
+};
+
+static struct tls_session_entry
+		tls_sessions[CONFIG_NET_APP_TLS_SESSION_CACHE_SIZE];
+static K_MUTEX_DEFINE(tls_sessions_lock);
+
+static bool tls_session_addr_cmp(const struct sockaddr *a,
+				 const struct sockaddr *b)
+{
+	if (a->sa_family != b->sa_family) {
+		return false;
+	}
+
+#if defined(CONFIG_NET_IPV6)
+	if (a->sa_family == AF_INET6) {
+		return net_sin6(a)->sin6_port == net_sin6(b)->sin6_port &&
+			net_ipv6_addr_cmp(&net_sin6(a)->sin6_addr,
+					  &net_sin6(b)->sin6_addr);
+	}
+#endif
+
+#if defined(CONFIG_NET_IPV4)
+	if (a->sa_family == AF_INET) {
+		return net_sin(a)->sin_port == net_sin(b)->sin_port &&
+			net_ipv4_addr_cmp(&net_sin(a)->sin_addr,
+					  &net_sin(b)->sin_addr);
+	}
+#endif
+
+	return false;
+}
+
+static struct tls_session_entry *tls_session_find(struct net_app_ctx *ctx)
+{
+	int i;
+
+	if (!ctx->default_ctx) {
+		return NULL;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(tls_sessions); i++) {
+		if (tls_sessions[i].used &&
+		    tls_session_addr_cmp(&tls_sessions[i].remote,
+					 &ctx->default_ctx->remote)) {
+			return &tls_sessions[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void tls_session_release(struct tls_session_entry *entry)
+{
+	mbedtls_ssl_session_free(&entry->session);
+	entry->used = false;
+}
+
+/* Offer the last session negotiated with this peer, if any. */
+static void tls_session_load(struct net_app_ctx *ctx)
+{
+	struct tls_session_entry *entry;
+	int ret;
+
+	ctx->tls.session_offered = false;
+
+	k_mutex_lock(&tls_sessions_lock, K_FOREVER);
+
+	entry = tls_session_find(ctx);
+	if (!entry) {
+		goto out;
+	}
+
+	if (k_uptime_get() - entry->timestamp > TLS_SESSION_LIFETIME) {
+		tls_session_release(entry);
+		goto out;
+	}
+
+	ret = mbedtls_ssl_set_session(&ctx->tls.mbedtls.ssl, &entry->session);
+	if (ret != 0) {
+		NET_DBG("Cannot resume TLS session (-0x%x)", -ret);
+		tls_session_release(entry);
+		goto out;
+	}
+
+	ctx->tls.session_offered = true;
+
+out:
+	k_mutex_unlock(&tls_sessions_lock);
+}
+
+/* Remember the session negotiated in the handshake that just finished. */
+static void tls_session_store(struct net_app_ctx *ctx)
+{
+	struct tls_session_entry *entry;
+	int i, ret;
+
+	if (!ctx->default_ctx) {
+		return;
+	}
+
+	k_mutex_lock(&tls_sessions_lock, K_FOREVER);
+
+	entry = tls_session_find(ctx);
+	if (!entry) {
+		/* Take a free slot or replace the oldest session */
+		entry = &tls_sessions[0];
+
+		for (i = 0; i < ARRAY_SIZE(tls_sessions); i++) {
+			if (!tls_sessions[i].used) {
+				entry = &tls_sessions[i];
+				break;
+			}
+
+			if (tls_sessions[i].timestamp < entry->timestamp) {
+				entry = &tls_sessions[i];
+			}
+		}
+	}
+
+	if (entry->used) {
+		tls_session_release(entry);
+	}
+
+	mbedtls_ssl_session_init(&entry->session);
+
+	ret = mbedtls_ssl_get_session(&ctx->tls.mbedtls.ssl, &entry->session);
+	if (ret != 0) {
+		NET_DBG("Cannot save TLS session (-0x%x)", -ret);
+		mbedtls_ssl_session_free(&entry->session);
+		goto out;
+	}
+
+	memcpy(&entry->remote, &ctx->default_ctx->remote,
+	       sizeof(entry->remote));
+	entry->timestamp = k_uptime_get();
+	entry->used = true;
+
+out:
+	k_mutex_unlock(&tls_sessions_lock);
+}
+
+/* The peer did not accept the session we offered, do not try it again. */
+static void tls_session_forget(struct net_app_ctx *ctx)
+{
+	struct tls_session_entry *entry;
+
+	k_mutex_lock(&tls_sessions_lock, K_FOREVER);
+
+	entry = tls_session_find(ctx);
+	if (entry) {
+		tls_session_release(entry);
+	}
+
+	k_mutex_unlock(&tls_sessions_lock);
+}
+#else
+#define tls_session_load(...)
+#define tls_session_store(...)
+#define tls_session_forget(...)
+#endif /* CONFIG_NET_APP_CLIENT && MBEDTLS_SSL_CLI_C */
+
+static int tls_session_setup(struct net_app_ctx *ctx, int client_or_server)
+{
+	int ret = 0;
+
+	if (client_or_server == MBEDTLS_SSL_IS_CLIENT) {
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+		mbedtls_ssl_conf_session_tickets(
+				&ctx->tls.mbedtls.conf,
+				MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+		return 0;
+	}
+
+#if defined(CONFIG_NET_APP_SERVER) && defined(MBEDTLS_SSL_CACHE_C)
+	mbedtls_ssl_cache_init(&ctx->tls.mbedtls.cache);
+	mbedtls_ssl_cache_set_max_entries(&ctx->tls.mbedtls.cache,
+					  CONFIG_NET_APP_TLS_SESSION_CACHE_SIZE);
+#if defined(MBEDTLS_HAVE_TIME)
+	mbedtls_ssl_cache_set_timeout(&ctx->tls.mbedtls.cache,
+				      CONFIG_NET_APP_TLS_SESSION_LIFETIME);
+#endif
+	mbedtls_ssl_conf_session_cache(&ctx->tls.mbedtls.conf,
+				       &ctx->tls.mbedtls.cache,
+				       mbedtls_ssl_cache_get,
+				       mbedtls_ssl_cache_set);
+#endif /* CONFIG_NET_APP_SERVER && MBEDTLS_SSL_CACHE_C */
+
+#if defined(CONFIG_NET_APP_SERVER) && defined(MBEDTLS_SSL_TICKET_C)
+	mbedtls_ssl_ticket_init(&ctx->tls.mbedtls.ticket);
+
+	ret = mbedtls_ssl_ticket_setup(&ctx->tls.mbedtls.ticket,
+				       mbedtls_ctr_drbg_random,
+				       &ctx->tls.mbedtls.ctr_drbg,
+				       MBEDTLS_CIPHER_AES_128_GCM,
+				       CONFIG_NET_APP_TLS_SESSION_LIFETIME);
+	if (ret != 0) {
+		_net_app_print_error("mbedtls_ssl_ticket_setup "
+				     "returned -0x%x", ret);
+		return ret;
+	}
+
+	mbedtls_ssl_conf_session_tickets_cb(&ctx->tls.mbedtls.conf,
+					    mbedtls_ssl_ticket_write,
+					    mbedtls_ssl_ticket_parse,
+					    &ctx->tls.mbedtls.ticket);
+#endif /* CONFIG_NET_APP_SERVER && MBEDTLS_SSL_TICKET_C */
+
+	return ret;
+}
+
+static void tls_session_cleanup(struct net_app_ctx *ctx)
+{
+	if (ctx->app_type != NET_APP_SERVER) {
+		return;
+	}
+
+#if defined(CONFIG_NET_APP_SERVER) && defined(MBEDTLS_SSL_CACHE_C)
+	mbedtls_ssl_cache_free(&ctx->tls.mbedtls.cache);
+#endif
+#if defined(CONFIG_NET_APP_SERVER) && defined(MBEDTLS_SSL_TICKET_C)
+	mbedtls_ssl_ticket_free(&ctx->tls.mbedtls.ticket);
+#endif
+}
+#else
+#define tls_session_load(...)
+#define tls_session_store(...)
+#define tls_session_forget(...)
+#define tls_session_setup(...) 0
+#define tls_session_cleanup(...)
+#endif /* CONFIG_NET_APP_TLS_SESSION_RESUMPTION */
+
+/* Read the decrypted application data straight into the fragments of a
+ * new RX packet instead of going through the request buffer.
+ */
+static struct net_pkt *tls_read_pkt(struct net_app_ctx *ctx,
+				    struct net_context *net_ctx,
+				    size_t len)
+{
+	struct net_pkt *pkt;
+	struct net_buf *frag, *data = NULL;
+	int ret;
+
+	pkt = net_pkt_get_rx(net_ctx, BUF_ALLOC_TIMEOUT);
+	if (!pkt) {
+		return NULL;
+	}
+
+	/* Add the IP + UDP/TCP headers if found. This is done
+	 * just in case the application needs to get some info
+	 * from the IP header.
+	 */
+	if (ctx->tls.mbedtls.ssl_ctx.hdr) {
+		net_pkt_frag_add(pkt, ctx->tls.mbedtls.ssl_ctx.hdr);
+#if defined(CONFIG_NET_IPV6)
+		if (net_pkt_family(pkt) == AF_INET6) {
+			net_pkt_set_ip_hdr_len(pkt,
+					       sizeof(struct net_ipv6_hdr));
+		}
+#endif
+#if defined(CONFIG_NET_IPV4)
+		if (net_pkt_family(pkt) == AF_INET) {
+			net_pkt_set_ip_hdr_len(pkt,
+					       sizeof(struct net_ipv4_hdr));
+		}
+#endif
+		ctx->tls.mbedtls.ssl_ctx.hdr = NULL;
+	}
+
+	net_pkt_set_appdatalen(pkt, len);
+
+	while (len) {
+		frag = net_pkt_get_frag(pkt, BUF_ALLOC_TIMEOUT);
+		if (!frag) {
+			goto fail;
+		}
+
+		net_pkt_frag_add(pkt, frag);
+
+		if (!data) {
+			data = frag;
+		}
+
+		/* The record is already decrypted so this does not block */
+		ret = mbedtls_ssl_read(&ctx->tls.mbedtls.ssl,
+				       net_buf_tail(frag),
+				       min(len, net_buf_tailroom(frag)));
+		if (ret <= 0) {
+			goto fail;
+		}
+
+		net_buf_add(frag, ret);
+		len -= ret;
+	}
+
+	net_pkt_set_appdata(pkt, data->data);
+
+	return pkt;
+
+fail:
+	net_pkt_unref(pkt);
+	return NULL;
+}
+
 int _net_app_ssl_mainloop(struct net_app_ctx *ctx)
 {
 	size_t len;
@@ -1937,6 +2254,10 @@ reset:
 	mbedtls_ssl_set_bio(&ctx->tls.mbedtls.ssl, ctx,
 			    _net_app_ssl_tx, _net_app_ssl_mux, NULL);
 
+	if (ctx->app_type == NET_APP_CLIENT) {
+		tls_session_load(ctx);
+	}
+
 	/* SSL handshake. The ssl_rx() function will be called next by
 	 * mbedtls library. The ssl_rx() will block and wait that data is
 	 * received by ssl_received() and passed to it via fifo. After
@@ -1963,6 +2284,11 @@ reset:
 			}
 
 			if (ret < 0) {
+				/* Do a full handshake next time */
+				if (ctx->tls.session_offered) {
+					tls_session_forget(ctx);
+				}
+
 				goto close;
 			}
 		}
@@ -1972,6 +2298,10 @@ reset:
 
 	NET_DBG("TLS handshake done");
 
+	if (ctx->app_type == NET_APP_CLIENT) {
+		tls_session_store(ctx);
+	}
+
 	/* We call the connect cb only once for each connection. The TLS
 	 * might require new handshakes etc, but application does not need
 	 * to care about that.
@@ -1984,17 +2314,17 @@ reset:
 
 	do {
 	again:
-		len = ctx->tls.request_buf_len - 1;
-		memset(ctx->tls.request_buf, 0, ctx->tls.request_buf_len);
-
+		/* Process the next record without copying it anywhere, the
+		 * data is then read straight into the RX packet.
+		 */
 		ret = mbedtls_ssl_read(&ctx->tls.mbedtls.ssl,
-				       ctx->tls.request_buf, len);
+				       ctx->tls.request_buf, 0);
 		if (ret == MBEDTLS_ERR_SSL_WANT_READ ||
 		    ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
 			continue;
 		}
 
-		if (ret <= 0) {
+		if (ret < 0) {
 			switch (ret) {
 			case MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY:
 				NET_DBG("Connection was closed gracefully");
@@ -2018,12 +2348,15 @@ reset:
 			goto close;
 		}
 
+		len = mbedtls_ssl_get_bytes_avail(&ctx->tls.mbedtls.ssl);
+		if (len == 0) {
+			goto again;
+		}
+
 		if (ctx->cb.recv) {
 			struct sockaddr dst = { 0 };
 			struct net_context *net_ctx;
 			struct net_pkt *pkt;
-			int len = ret;
-			int hdr_len = 0;
 
 			dst.sa_family = AF_UNSPEC;
 
@@ -2037,66 +2370,21 @@ reset:
 				goto close;
 			}
 
-			pkt = net_pkt_get_rx(net_ctx, BUF_ALLOC_TIMEOUT);
+			pkt = tls_read_pkt(ctx, net_ctx, len);
 			if (!pkt) {
 				ret = -ENOMEM;
 				goto close;
 			}
 
-			/* Add the IP + UDP/TCP headers if found. This is done
-			 * just in case the application needs to get some info
-			 * from the IP header.
-			 */
-			if (ctx->tls.mbedtls.ssl_ctx.hdr) {
-				/* Needed to skip the protocol header */
-				hdr_len = ctx->tls.mbedtls.ssl_ctx.hdr->len;
-
-				net_pkt_frag_add(pkt,
-						 ctx->tls.mbedtls.ssl_ctx.hdr);
-#if defined(CONFIG_NET_IPV6)
-				if (net_pkt_family(pkt) == AF_INET6) {
-					net_pkt_set_ip_hdr_len(pkt,
-						sizeof(struct net_ipv6_hdr));
-				}
-#endif
-#if defined(CONFIG_NET_IPV4)
-				if (net_pkt_family(pkt) == AF_INET) {
-					net_pkt_set_ip_hdr_len(pkt,
-						sizeof(struct net_ipv4_hdr));
-				}
-#endif
-				ctx->tls.mbedtls.ssl_ctx.hdr = NULL;
-			}
-
-			ret = net_pkt_append_all(pkt, len,
-						 ctx->tls.request_buf,
-						 BUF_ALLOC_TIMEOUT);
-			if (!ret) {
-				/* Not all data was appended */
-				net_pkt_unref(pkt);
-				ret = -ENOMEM;
-				goto close;
-			}
-
-			net_pkt_set_appdatalen(pkt, len);
-
-			if (hdr_len) {
-				struct net_buf *frag;
-				u16_t pos;
-
-				frag = net_frag_get_pos(pkt, hdr_len, &pos);
-				NET_ASSERT(frag);
-
-				net_pkt_set_appdata(pkt, frag->data + pos);
-			} else {
-				net_pkt_set_appdata(pkt, pkt->frags->data);
-			}
-
 			ctx->cb.recv(ctx, pkt, 0, ctx->user_data);
 
 			goto again;
 		}
 
+		/* Nobody wants the data, just consume it */
+		ret = mbedtls_ssl_read(&ctx->tls.mbedtls.ssl,
+				       ctx->tls.request_buf,
+				       min(len, ctx->tls.request_buf_len));
 	} while (ret < 0);
 
 	/* Read another message */
@@ -2204,6 +2492,11 @@ int _net_app_tls_init(struct net_app_ctx *ctx, int client_or_server)
 			     mbedtls_ctr_drbg_random,
 			     &ctx->tls.mbedtls.ctr_drbg);
 
+	ret = tls_session_setup(ctx, client_or_server);
+	if (ret != 0) {
+		goto exit;
+	}
+
 #if defined(CONFIG_NET_APP_DTLS)
 	if (sock_type == MBEDTLS_SSL_TRANSPORT_DATAGRAM) {
 		ret = mbedtls_ssl_cookie_setup(&ctx->tls.mbedtls.cookie_ctx,
@@ -2297,6 +2590,7 @@ exit:
 
 void _net_app_tls_handler_stop(struct net_app_ctx *ctx)
 {
+	tls_session_cleanup(ctx);
 	mbedtls_ssl_free(&ctx->tls.mbedtls.ssl);
 	mbedtls_ssl_config_free(&ctx->tls.mbedtls.conf);
 	mbedtls_ctr_drbg_free(&ctx->tls.mbedtls.ctr_drbg);
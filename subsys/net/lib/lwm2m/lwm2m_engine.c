@@ -84,11 +84,14 @@
 
 struct observe_node {
 	sys_snode_t node;
+	sys_snode_t index_node;
+	sys_dnode_t wheel_node;
 	struct lwm2m_ctx *ctx;
 	struct lwm2m_obj_path path;
 	u8_t  token[MAX_TOKEN_LEN];
 	s64_t event_timestamp;
 	s64_t last_timestamp;
+	s64_t next_timestamp;
 	u32_t min_period_sec;
 	u32_t max_period_sec;
 	u32_t counter;
@@ -115,6 +118,30 @@ static sys_slist_t engine_obj_inst_list;
 static sys_slist_t engine_observer_list;
 static sys_slist_t engine_service_list;
 
+/*
+ * Numeric path index: object instances and observers are hashed on
+ * (obj_id, obj_inst_id), resources on (obj_id, obj_inst_id, res_id).
+ */
+#define INDEX_BUCKETS		CONFIG_LWM2M_ENGINE_INDEX_BUCKETS
+
+static sys_slist_t obj_inst_index[INDEX_BUCKETS];
+static sys_slist_t res_index[INDEX_BUCKETS];
+static sys_slist_t observer_index[INDEX_BUCKETS];
+
+/*
+ * Observation scheduler: a hashed timer wheel holding each observer in
+ * the slot of its next pmin / pmax deadline.
+ */
+#define WHEEL_SLOTS		CONFIG_LWM2M_ENGINE_OBSERVE_WHEEL_SLOTS
+#define WHEEL_TICK		K_MSEC(250)
+#define NOTIFY_BATCH_WINDOW	K_MSEC(CONFIG_LWM2M_ENGINE_NOTIFY_BATCH_WINDOW)
+
+static sys_dlist_t observe_wheel[WHEEL_SLOTS];
+static s64_t observe_wheel_tick;
+
+/* uptime at which the engine thread will wake up on its own */
+static s64_t engine_wakeup_timestamp;
+
 #define NUM_BLOCK1_CONTEXT	CONFIG_LWM2M_NUM_BLOCK1_CONTEXT
 
 /* TODO: figure out what's correct value */
@@ -286,29 +313,100 @@ static void free_block_ctx(struct block_context *ctx)
 	ctx->tkl = 0;
 }
 
+/* path index functions */
+
+static inline u32_t index_hash(u16_t obj_id, u16_t obj_inst_id, u16_t res_id)
+{
+	u32_t hash = obj_id;
+
+	hash = hash * 31 + obj_inst_id;
+	hash = hash * 31 + res_id;
+
+	return hash % INDEX_BUCKETS;
+}
+
+/* observation scheduler functions (called with interrupts locked) */
+
+static void observe_unschedule(struct observe_node *obs)
+{
+	if (obs->wheel_node.next) {
+		sys_dlist_remove(&obs->wheel_node);
+		obs->wheel_node.next = NULL;
+		obs->wheel_node.prev = NULL;
+	}
+}
+
+static void observe_schedule(struct observe_node *obs, s64_t timestamp)
+{
+	s64_t tick = timestamp / WHEEL_TICK;
+
+	observe_unschedule(obs);
+
+	/* deadlines which already passed are handled on the next pass */
+	if (tick < observe_wheel_tick) {
+		tick = observe_wheel_tick;
+	}
+
+	obs->next_timestamp = timestamp;
+	sys_dlist_append(&observe_wheel[tick % WHEEL_SLOTS], &obs->wheel_node);
+}
+
+static s64_t observe_deadline(struct observe_node *obs)
+{
+	/* pending change: notify once pmin has elapsed */
+	if (obs->event_timestamp > obs->last_timestamp) {
+		return obs->last_timestamp + K_SECONDS(obs->min_period_sec);
+	}
+
+	/* no change: notify when pmax expires */
+	return obs->last_timestamp + K_SECONDS(obs->max_period_sec);
+}
+
 /* observer functions */
 
 int lwm2m_notify_observer(u16_t obj_id, u16_t obj_inst_id, u16_t res_id)
 {
 	struct observe_node *obs;
-	int ret = 0;
+	s64_t timestamp, deadline;
+	bool wakeup = false;
+	int key, ret = 0;
+
+	timestamp = k_uptime_get();
+	key = irq_lock();
 
 	/* look for observers which match our resource */
-	SYS_SLIST_FOR_EACH_CONTAINER(&engine_observer_list, obs, node) {
+	SYS_SLIST_FOR_EACH_CONTAINER(
+			&observer_index[index_hash(obj_id, obj_inst_id, 0)],
+			obs, index_node) {
 		if (obs->path.obj_id == obj_id &&
 		    obs->path.obj_inst_id == obj_inst_id &&
 		    (obs->path.level < 3 ||
 		     obs->path.res_id == res_id)) {
 			/* update the event time for this observer */
-			obs->event_timestamp = k_uptime_get();
+			obs->event_timestamp = timestamp;
 
-			SYS_LOG_DBG("NOTIFY EVENT %u/%u/%u",
-				    obj_id, obj_inst_id, res_id);
+			/* bring the notification forward to pmin */
+			deadline = observe_deadline(obs);
+			if (deadline < obs->next_timestamp) {
+				observe_schedule(obs, deadline);
+				wakeup |= deadline < engine_wakeup_timestamp;
+			}
 
 			ret++;
 		}
 	}
 
+	irq_unlock(key);
+
+	if (ret > 0) {
+		SYS_LOG_DBG("NOTIFY EVENT %u/%u/%u", obj_id, obj_inst_id,
+			    res_id);
+	}
+
+	if (wakeup) {
+		k_wakeup(&engine_thread_data);
+	}
+
 	return ret;
 }
 
@@ -326,7 +424,7 @@ static int engine_add_observer(struct lwm2m_message *msg,
 	struct lwm2m_engine_obj_inst *obj_inst = NULL;
 	struct observe_node *obs;
 	struct sockaddr *addr;
-	int i;
+	int i, key;
 
 	if (!msg || !msg->ctx) {
 		SYS_LOG_ERR("valid lwm2m message is required");
@@ -418,8 +516,16 @@ static int engine_add_observer(struct lwm2m_message *msg,
 	observe_node_data[i].max_period_sec = 60;
 	observe_node_data[i].format = format;
 	observe_node_data[i].counter = 1;
+
+	key = irq_lock();
 	sys_slist_append(&engine_observer_list,
 			 &observe_node_data[i].node);
+	sys_slist_append(&observer_index[index_hash(path->obj_id,
+						    path->obj_inst_id, 0)],
+			 &observe_node_data[i].index_node);
+	observe_schedule(&observe_node_data[i],
+			 observe_deadline(&observe_node_data[i]));
+	irq_unlock(key);
 
 	SYS_LOG_DBG("OBSERVER ADDED %u/%u/%u(%u) token:'%s' addr:%s",
 		    path->obj_id, path->obj_inst_id, path->res_id, path->level,
@@ -428,6 +534,23 @@ static int engine_add_observer(struct lwm2m_message *msg,
 	return 0;
 }
 
+static void engine_release_observer(struct observe_node *obs,
+				    sys_snode_t *prev_node)
+{
+	int key;
+
+	key = irq_lock();
+	sys_slist_remove(&engine_observer_list, prev_node, &obs->node);
+	sys_slist_find_and_remove(
+		&observer_index[index_hash(obs->path.obj_id,
+					   obs->path.obj_inst_id, 0)],
+		&obs->index_node);
+	observe_unschedule(obs);
+	irq_unlock(key);
+
+	memset(obs, 0, sizeof(*obs));
+}
+
 static int engine_remove_observer(const u8_t *token, u8_t tkl)
 {
 	struct observe_node *obs, *found_obj = NULL;
@@ -453,8 +576,7 @@ static int engine_remove_observer(const u8_t *token, u8_t tkl)
 		return -ENOENT;
 	}
 
-	sys_slist_remove(&engine_observer_list, prev_node, &found_obj->node);
-	memset(found_obj, 0, sizeof(*found_obj));
+	engine_release_observer(found_obj, prev_node);
 
 	SYS_LOG_DBG("observer '%s' removed", sprint_token(token, tkl));
 
@@ -476,8 +598,7 @@ static void engine_remove_observer_by_id(u16_t obj_id, s32_t obj_inst_id)
 			continue;
 		}
 
-		sys_slist_remove(&engine_observer_list, prev_node, &obs->node);
-		memset(obs, 0, sizeof(*obs));
+		engine_release_observer(obs, prev_node);
 	}
 }
 
@@ -527,13 +648,44 @@ lwm2m_get_engine_obj_field(struct lwm2m_engine_obj *obj, int res_id)
 
 static void engine_register_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
 {
+	struct lwm2m_engine_res_inst *res;
+	u16_t obj_id = obj_inst->obj->obj_id;
+	int i;
+
 	sys_slist_append(&engine_obj_inst_list, &obj_inst->node);
+	sys_slist_append(&obj_inst_index[index_hash(obj_id,
+						    obj_inst->obj_inst_id, 0)],
+			 &obj_inst->index_node);
+
+	for (i = 0; i < obj_inst->resource_count; i++) {
+		res = &obj_inst->resources[i];
+		res->obj_inst = obj_inst;
+		sys_slist_append(&res_index[index_hash(obj_id,
+						       obj_inst->obj_inst_id,
+						       res->res_id)],
+				 &res->index_node);
+	}
 }
 
 static void engine_unregister_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
 {
-	engine_remove_observer_by_id(
-			obj_inst->obj->obj_id, obj_inst->obj_inst_id);
+	struct lwm2m_engine_res_inst *res;
+	u16_t obj_id = obj_inst->obj->obj_id;
+	int i;
+
+	engine_remove_observer_by_id(obj_id, obj_inst->obj_inst_id);
+
+	for (i = 0; i < obj_inst->resource_count; i++) {
+		res = &obj_inst->resources[i];
+		sys_slist_find_and_remove(
+			&res_index[index_hash(obj_id, obj_inst->obj_inst_id,
+					      res->res_id)],
+			&res->index_node);
+	}
+
+	sys_slist_find_and_remove(
+		&obj_inst_index[index_hash(obj_id, obj_inst->obj_inst_id, 0)],
+		&obj_inst->index_node);
 	sys_slist_find_and_remove(&engine_obj_inst_list, &obj_inst->node);
 }
 
@@ -542,8 +694,9 @@ static struct lwm2m_engine_obj_inst *get_engine_obj_inst(int obj_id,
 {
 	struct lwm2m_engine_obj_inst *obj_inst;
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&engine_obj_inst_list, obj_inst,
-				     node) {
+	SYS_SLIST_FOR_EACH_CONTAINER(
+			&obj_inst_index[index_hash(obj_id, obj_inst_id, 0)],
+			obj_inst, index_node) {
 		if (obj_inst->obj->obj_id == obj_id &&
 		    obj_inst->obj_inst_id == obj_inst_id) {
 			return obj_inst;
@@ -553,6 +706,25 @@ static struct lwm2m_engine_obj_inst *get_engine_obj_inst(int obj_id,
 	return NULL;
 }
 
+static struct lwm2m_engine_res_inst *
+get_engine_res_inst(struct lwm2m_obj_path *path)
+{
+	struct lwm2m_engine_res_inst *res;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(
+			&res_index[index_hash(path->obj_id, path->obj_inst_id,
+					      path->res_id)],
+			res, index_node) {
+		if (res->res_id == path->res_id &&
+		    res->obj_inst->obj_inst_id == path->obj_inst_id &&
+		    res->obj_inst->obj->obj_id == path->obj_id) {
+			return res;
+		}
+	}
+
+	return NULL;
+}
+
 static struct lwm2m_engine_obj_inst *
 next_engine_obj_inst(struct lwm2m_engine_obj_inst *last,
 		     int obj_id, int obj_inst_id)
@@ -1130,59 +1302,28 @@ int lwm2m_engine_create_obj_inst(char *pathstr)
 	return lwm2m_create_obj_inst(path.obj_id, path.obj_inst_id, &obj_inst);
 }
 
-static int lwm2m_engine_set(char *pathstr, void *value, u16_t len)
+static int engine_set(struct lwm2m_obj_path *path, void *value, u16_t len)
 {
-	int ret = 0, i;
-	struct lwm2m_obj_path path;
+	int ret = 0;
 	struct lwm2m_engine_obj_inst *obj_inst;
 	struct lwm2m_engine_obj_field *obj_field;
-	struct lwm2m_engine_res_inst *res = NULL;
+	struct lwm2m_engine_res_inst *res;
 	bool changed = false;
 	void *data_ptr = NULL;
 	size_t data_len = 0;
 
-	SYS_LOG_DBG("path:%s, value:%p, len:%d", pathstr, value, len);
-
-	/* translate path -> path_obj */
-	memset(&path, 0, sizeof(path));
-	ret = string_to_path(pathstr, &path, '/');
-	if (ret < 0) {
-		return ret;
-	}
-
-	if (path.level < 3) {
-		SYS_LOG_ERR("path must have 3 parts");
-		return -EINVAL;
-	}
-
 	/* find obj_inst/res_id */
-	obj_inst = get_engine_obj_inst(path.obj_id, path.obj_inst_id);
-	if (!obj_inst) {
-		SYS_LOG_ERR("obj instance %d/%d not found",
-			    path.obj_id, path.obj_inst_id);
+	res = get_engine_res_inst(path);
+	if (!res) {
+		SYS_LOG_ERR("res instance %d/%d/%d not found",
+			    path->obj_id, path->obj_inst_id, path->res_id);
 		return -ENOENT;
 	}
 
-	if (!obj_inst->resources || obj_inst->resource_count == 0) {
-		SYS_LOG_ERR("obj instance has no resources");
-		return -EINVAL;
-	}
-
-	obj_field = lwm2m_get_engine_obj_field(obj_inst->obj, path.res_id);
+	obj_inst = res->obj_inst;
+	obj_field = lwm2m_get_engine_obj_field(obj_inst->obj, path->res_id);
 	if (!obj_field) {
-		SYS_LOG_ERR("obj field %d not found", path.res_id);
-		return -ENOENT;
-	}
-
-	for (i = 0; i < obj_inst->resource_count; i++) {
-		if (obj_inst->resources[i].res_id == path.res_id) {
-			res = &obj_inst->resources[i];
-			break;
-		}
-	}
-
-	if (!res) {
-		SYS_LOG_ERR("res instance %d not found", path.res_id);
+		SYS_LOG_ERR("obj field %d not found", path->res_id);
 		return -ENOENT;
 	}
 
@@ -1204,7 +1345,7 @@ static int lwm2m_engine_set(char *pathstr, void *value, u16_t len)
 	if (len > res->data_len -
 		(obj_field->data_type == LWM2M_RES_TYPE_STRING ? 1 : 0)) {
 		SYS_LOG_ERR("length %u is too long for resource %d data",
-			    len, path.res_id);
+			    len, path->res_id);
 		return -ENOMEM;
 	}
 
@@ -1287,12 +1428,47 @@ static int lwm2m_engine_set(char *pathstr, void *value, u16_t len)
 	}
 
 	if (changed) {
-		NOTIFY_OBSERVER_PATH(&path);
+		NOTIFY_OBSERVER_PATH(path);
 	}
 
 	return ret;
 }
 
+static int lwm2m_engine_set(char *pathstr, void *value, u16_t len)
+{
+	int ret = 0;
+	struct lwm2m_obj_path path;
+
+	SYS_LOG_DBG("path:%s, value:%p, len:%d", pathstr, value, len);
+
+	/* translate path -> path_obj */
+	memset(&path, 0, sizeof(path));
+	ret = string_to_path(pathstr, &path, '/');
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (path.level < 3) {
+		SYS_LOG_ERR("path must have 3 parts");
+		return -EINVAL;
+	}
+
+	return engine_set(&path, value, len);
+}
+
+int lwm2m_engine_set_res(u16_t obj_id, u16_t obj_inst_id, u16_t res_id,
+			 void *value, u16_t len)
+{
+	struct lwm2m_obj_path path = {
+		.obj_id = obj_id,
+		.obj_inst_id = obj_inst_id,
+		.res_id = res_id,
+		.level = 3,
+	};
+
+	return engine_set(&path, value, len);
+}
+
 int lwm2m_engine_set_opaque(char *pathstr, char *data_ptr, u16_t data_len)
 {
 	return lwm2m_engine_set(pathstr, data_ptr, data_len);
@@ -1362,58 +1538,26 @@ int lwm2m_engine_set_float64(char *pathstr, float64_value_t *value)
 
 /* user data getter functions */
 
-static int lwm2m_engine_get(char *pathstr, void *buf, u16_t buflen)
+static int engine_get(struct lwm2m_obj_path *path, void *buf, u16_t buflen)
 {
-	int ret = 0, i;
-	struct lwm2m_obj_path path;
 	struct lwm2m_engine_obj_inst *obj_inst;
 	struct lwm2m_engine_obj_field *obj_field;
-	struct lwm2m_engine_res_inst *res = NULL;
+	struct lwm2m_engine_res_inst *res;
 	void *data_ptr = NULL;
 	size_t data_len = 0;
 
-	SYS_LOG_DBG("path:%s, buf:%p, buflen:%d", pathstr, buf, buflen);
-
-	/* translate path -> path_obj */
-	memset(&path, 0, sizeof(path));
-	ret = string_to_path(pathstr, &path, '/');
-	if (ret < 0) {
-		return ret;
-	}
-
-	if (path.level < 3) {
-		SYS_LOG_ERR("path must have 3 parts");
-		return -EINVAL;
-	}
-
 	/* find obj_inst/res_id */
-	obj_inst = get_engine_obj_inst(path.obj_id, path.obj_inst_id);
-	if (!obj_inst) {
-		SYS_LOG_ERR("obj instance %d/%d not found",
-			    path.obj_id, path.obj_inst_id);
+	res = get_engine_res_inst(path);
+	if (!res) {
+		SYS_LOG_ERR("res instance %d/%d/%d not found",
+			    path->obj_id, path->obj_inst_id, path->res_id);
 		return -ENOENT;
 	}
 
-	if (!obj_inst->resources || obj_inst->resource_count == 0) {
-		SYS_LOG_ERR("obj instance has no resources");
-		return -EINVAL;
-	}
-
-	obj_field = lwm2m_get_engine_obj_field(obj_inst->obj, path.res_id);
+	obj_inst = res->obj_inst;
+	obj_field = lwm2m_get_engine_obj_field(obj_inst->obj, path->res_id);
 	if (!obj_field) {
-		SYS_LOG_ERR("obj field %d not found", path.res_id);
-		return -ENOENT;
-	}
-
-	for (i = 0; i < obj_inst->resource_count; i++) {
-		if (obj_inst->resources[i].res_id == path.res_id) {
-			res = &obj_inst->resources[i];
-			break;
-		}
-	}
-
-	if (!res) {
-		SYS_LOG_ERR("res instance %d not found", path.res_id);
+		SYS_LOG_ERR("obj field %d not found", path->res_id);
 		return -ENOENT;
 	}
 
@@ -1505,6 +1649,41 @@ static int lwm2m_engine_get(char *pathstr, void *buf, u16_t buflen)
 	return 0;
 }
 
+static int lwm2m_engine_get(char *pathstr, void *buf, u16_t buflen)
+{
+	int ret = 0;
+	struct lwm2m_obj_path path;
+
+	SYS_LOG_DBG("path:%s, buf:%p, buflen:%d", pathstr, buf, buflen);
+
+	/* translate path -> path_obj */
+	memset(&path, 0, sizeof(path));
+	ret = string_to_path(pathstr, &path, '/');
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (path.level < 3) {
+		SYS_LOG_ERR("path must have 3 parts");
+		return -EINVAL;
+	}
+
+	return engine_get(&path, buf, buflen);
+}
+
+int lwm2m_engine_get_res(u16_t obj_id, u16_t obj_inst_id, u16_t res_id,
+			 void *buf, u16_t buflen)
+{
+	struct lwm2m_obj_path path = {
+		.obj_id = obj_id,
+		.obj_inst_id = obj_inst_id,
+		.res_id = res_id,
+		.level = 3,
+	};
+
+	return engine_get(&path, buf, buflen);
+}
+
 int lwm2m_engine_get_opaque(char *pathstr, void *buf, u16_t buflen)
 {
 	return lwm2m_engine_get(pathstr, buf, buflen);
@@ -1598,35 +1777,14 @@ int   lwm2m_engine_get_float64(char *pathstr, float64_value_t *buf)
 static int engine_get_resource(struct lwm2m_obj_path *path,
 			       struct lwm2m_engine_res_inst **res)
 {
-	int i;
-	struct lwm2m_engine_obj_inst *obj_inst;
-
 	if (!path) {
 		return -EINVAL;
 	}
 
-	/* find obj_inst/res_id */
-	obj_inst = get_engine_obj_inst(path->obj_id, path->obj_inst_id);
-	if (!obj_inst) {
-		SYS_LOG_ERR("obj instance %d/%d not found",
-			    path->obj_id, path->obj_inst_id);
-		return -ENOENT;
-	}
-
-	if (!obj_inst->resources || obj_inst->resource_count == 0) {
-		SYS_LOG_ERR("obj instance has no resources");
-		return -EINVAL;
-	}
-
-	for (i = 0; i < obj_inst->resource_count; i++) {
-		if (obj_inst->resources[i].res_id == path->res_id) {
-			*res = &obj_inst->resources[i];
-			break;
-		}
-	}
-
+	*res = get_engine_res_inst(path);
 	if (!*res) {
-		SYS_LOG_ERR("res instance %d not found", path->res_id);
+		SYS_LOG_ERR("res instance %d/%d/%d not found",
+			    path->obj_id, path->obj_inst_id, path->res_id);
 		return -ENOENT;
 	}
 
@@ -3139,44 +3297,180 @@ int lwm2m_engine_add_service(void (*service)(void), u32_t period_ms)
 	return 0;
 }
 
-/* TODO: this needs to be triggered via work_queue */
-static void lwm2m_engine_service(void)
+static void observe_wheel_expire(s64_t timestamp, sys_dlist_t *expired)
+{
+	struct observe_node *obs, *tmp;
+	s64_t tick, now_tick = timestamp / WHEEL_TICK;
+	int key, slots;
+
+	key = irq_lock();
+
+	for (tick = observe_wheel_tick, slots = 0;
+	     tick <= now_tick && slots < WHEEL_SLOTS; tick++, slots++) {
+		SYS_DLIST_FOR_EACH_CONTAINER_SAFE(
+				&observe_wheel[tick % WHEEL_SLOTS],
+				obs, tmp, wheel_node) {
+			if (obs->next_timestamp <= timestamp) {
+				sys_dlist_remove(&obs->wheel_node);
+				sys_dlist_append(expired, &obs->wheel_node);
+			}
+		}
+	}
+
+	/* the current slot may still hold deadlines later in this tick */
+	observe_wheel_tick = now_tick;
+
+	irq_unlock(key);
+}
+
+static bool observe_batchable(struct observe_node *obs, s64_t timestamp,
+			      sys_dlist_t *expired)
+{
+	struct observe_node *exp;
+	bool same_ctx = false;
+
+	if (!obs->used || !obs->wheel_node.next ||
+	    timestamp < obs->last_timestamp + K_SECONDS(obs->min_period_sec)) {
+		return false;
+	}
+
+	if (obs->event_timestamp <= obs->last_timestamp &&
+	    obs->next_timestamp > timestamp + NOTIFY_BATCH_WINDOW) {
+		return false;
+	}
+
+	SYS_DLIST_FOR_EACH_CONTAINER(expired, exp, wheel_node) {
+		if (exp == obs) {
+			return false;
+		}
+
+		if (exp->ctx == obs->ctx) {
+			same_ctx = true;
+		}
+	}
+
+	return same_ctx;
+}
+
+static void observe_batch(s64_t timestamp, sys_dlist_t *expired)
 {
 	struct observe_node *obs;
-	struct service_node *srv;
-	s64_t timestamp, service_due_timestamp;
+	int i, key;
+
+	if (NOTIFY_BATCH_WINDOW == 0 || sys_dlist_is_empty(expired)) {
+		return;
+	}
+
+	/*
+	 * Piggyback notifications which are allowed to go out now on the
+	 * ones already due for the same server.
+	 */
+	key = irq_lock();
+
+	for (i = 0; i < CONFIG_LWM2M_ENGINE_MAX_OBSERVER; i++) {
+		obs = &observe_node_data[i];
+		if (observe_batchable(obs, timestamp, expired)) {
+			sys_dlist_remove(&obs->wheel_node);
+			sys_dlist_append(expired, &obs->wheel_node);
+		}
+	}
+
+	irq_unlock(key);
+}
+
+static void observe_service(s64_t timestamp)
+{
+	struct observe_node *obs;
+	sys_dlist_t expired;
+	sys_dnode_t *node;
+	bool manual_trigger;
+	int key;
+
+	sys_dlist_init(&expired);
+	observe_wheel_expire(timestamp, &expired);
+	observe_batch(timestamp, &expired);
 
 	while (true) {
+		key = irq_lock();
+		node = sys_dlist_get(&expired);
+		if (node) {
+			node->next = NULL;
+			node->prev = NULL;
+		}
+
+		irq_unlock(key);
+
+		if (!node) {
+			break;
+		}
+
+		obs = CONTAINER_OF(node, struct observe_node, wheel_node);
+
 		/*
-		 * 1. scan the observer list
-		 * 2. For each notify event found, scan the observer list
-		 * 3. For each observer match, generate a NOTIFY message,
-		 *    attaching the notify response handler
+		 * manual notify: a change was reported since the last
+		 * notification, otherwise pmax expired
 		 */
-		timestamp = k_uptime_get();
-		SYS_SLIST_FOR_EACH_CONTAINER(&engine_observer_list, obs, node) {
-			/*
-			 * manual notify requirements:
-			 * - event_timestamp > last_timestamp
-			 * - current timestamp > last_timestamp + min_period_sec
-			 */
-			if (obs->event_timestamp > obs->last_timestamp &&
-			    timestamp > obs->last_timestamp +
-					K_SECONDS(obs->min_period_sec)) {
-				obs->last_timestamp = k_uptime_get();
-				generate_notify_message(obs, true);
+		manual_trigger = obs->event_timestamp > obs->last_timestamp;
+		obs->last_timestamp = k_uptime_get();
+		generate_notify_message(obs, manual_trigger);
 
-			/*
-			 * automatic time-based notify requirements:
-			 * - current timestamp > last_timestamp + max_period_sec
-			 */
-			} else if (timestamp > obs->last_timestamp +
-					K_SECONDS(obs->min_period_sec)) {
-				obs->last_timestamp = k_uptime_get();
-				generate_notify_message(obs, false);
+		key = irq_lock();
+		if (obs->used) {
+			observe_schedule(obs, observe_deadline(obs));
+		}
+
+		irq_unlock(key);
+	}
+}
+
+static s64_t observe_next_timestamp(s64_t max_timestamp)
+{
+	struct observe_node *obs;
+	s64_t tick, slot_end, next = max_timestamp;
+	int key, slots;
+
+	key = irq_lock();
+
+	for (tick = observe_wheel_tick, slots = 0; slots < WHEEL_SLOTS;
+	     tick++, slots++) {
+		slot_end = (tick + 1) * WHEEL_TICK;
+		if (slot_end - WHEEL_TICK >= next) {
+			break;
+		}
+
+		/* skip entries belonging to a later turn of the wheel */
+		SYS_DLIST_FOR_EACH_CONTAINER(&observe_wheel[tick % WHEEL_SLOTS],
+					     obs, wheel_node) {
+			if (obs->next_timestamp < slot_end &&
+			    obs->next_timestamp < next) {
+				next = obs->next_timestamp;
 			}
+		}
 
+		if (next < slot_end) {
+			break;
 		}
+	}
+
+	irq_unlock(key);
+
+	return next;
+}
+
+/* TODO: this needs to be triggered via work_queue */
+static void lwm2m_engine_service(void)
+{
+	struct service_node *srv;
+	s64_t timestamp, service_due_timestamp, next_timestamp;
+	s32_t timeout;
+	int key;
+
+	while (true) {
+		/*
+		 * Send the notifications whose pmin / pmax deadline
+		 * expired in the observation scheduler
+		 */
+		observe_service(k_uptime_get());
 
 		timestamp = k_uptime_get();
 		SYS_SLIST_FOR_EACH_CONTAINER(&engine_service_list, srv, node) {
@@ -3194,7 +3488,17 @@ static void lwm2m_engine_service(void)
 		}
 
 		/* calculate how long to sleep till the next service */
-		k_sleep(engine_next_service_timeout_ms(ENGINE_UPDATE_INTERVAL));
+		timeout = engine_next_service_timeout_ms(ENGINE_UPDATE_INTERVAL);
+		timestamp = k_uptime_get();
+		next_timestamp = observe_next_timestamp(timestamp + timeout);
+		timeout = max(next_timestamp - timestamp, 0);
+
+		/* notifiers wake us up when a deadline moves before this */
+		key = irq_lock();
+		engine_wakeup_timestamp = next_timestamp;
+		irq_unlock(key);
+
+		k_sleep(timeout);
 	}
 }
 
@@ -3301,9 +3605,17 @@ error_start:
 
 static int lwm2m_engine_init(struct device *dev)
 {
+	int i;
+
 	memset(block1_contexts, 0,
 	       sizeof(struct block_context) * NUM_BLOCK1_CONTEXT);
 
+	for (i = 0; i < WHEEL_SLOTS; i++) {
+		sys_dlist_init(&observe_wheel[i]);
+	}
+
+	observe_wheel_tick = k_uptime_get() / WHEEL_TICK;
+
 	/* start thread to handle OBSERVER / NOTIFY events */
 	k_thread_create(&engine_thread_data,
 			&engine_thread_stack[0],
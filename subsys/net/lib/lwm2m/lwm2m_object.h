@@ -180,6 +180,8 @@ struct lwm2m_engine_obj {
 		     NULL, NULL, NULL, ex_cb)
 
 struct lwm2m_engine_res_inst {
+	sys_snode_t index_node;
+	struct lwm2m_engine_obj_inst *obj_inst;
 	char path[MAX_RESOURCE_LEN]; /* 3/0/0 */
 	u16_t  res_id;
 	u8_t   *multi_count_var;
@@ -196,6 +198,7 @@ struct lwm2m_engine_res_inst {
 
 struct lwm2m_engine_obj_inst {
 	sys_snode_t node;
+	sys_snode_t index_node;
 	char path[MAX_RESOURCE_LEN]; /* 3/0 */
 	struct lwm2m_engine_obj *obj;
 	u16_t obj_inst_id;
@@ -228,10 +228,43 @@ ssize_t zsock_send(int sock, const void *buf, size_t len, int flags)
 	return zsock_sendto(sock, buf, len, flags, NULL, 0);
 }
 
+/* Queue a packet built by zsock_sendto() or zsock_sendmsg() */
+static ssize_t zsock_send_pkt(struct net_context *ctx,
+			      struct net_pkt *send_pkt, size_t len,
+			      const struct sockaddr *dest_addr,
+			      socklen_t addrlen, s32_t timeout)
+{
+	int err;
+
+	/* Register the callback before sending in order to receive the response
+	 * from the peer.
+	 */
+	err = net_context_recv(ctx, zsock_received_cb, K_NO_WAIT, NULL);
+	if (err < 0) {
+		net_pkt_unref(send_pkt);
+		errno = -err;
+		return -1;
+	}
+
+	if (dest_addr) {
+		err = net_context_sendto(send_pkt, dest_addr, addrlen, NULL,
+					 timeout, NULL, NULL);
+	} else {
+		err = net_context_send(send_pkt, NULL, timeout, NULL, NULL);
+	}
+
+	if (err < 0) {
+		net_pkt_unref(send_pkt);
+		errno = -err;
+		return -1;
+	}
+
+	return len;
+}
+
 ssize_t zsock_sendto(int sock, const void *buf, size_t len, int flags,
 		     const struct sockaddr *dest_addr, socklen_t addrlen)
 {
-	int err;
 	struct net_pkt *send_pkt;
 	s32_t timeout = K_FOREVER;
 	struct net_context *ctx = INT_TO_POINTER(sock);
@@ -255,30 +288,57 @@ ssize_t zsock_sendto(int sock, const void *buf, size_t len, int flags,
 		return -1;
 	}
 
-	/* Register the callback before sending in order to receive the response
-	 * from the peer.
-	 */
-	err = net_context_recv(ctx, zsock_received_cb, K_NO_WAIT, NULL);
-	if (err < 0) {
-		net_pkt_unref(send_pkt);
-		errno = -err;
+	return zsock_send_pkt(ctx, send_pkt, len, dest_addr, addrlen, timeout);
+}
+
+ssize_t zsock_sendmsg(int sock, const struct zsock_msghdr *msg, int flags)
+{
+	struct net_pkt *send_pkt;
+	s32_t timeout = K_FOREVER;
+	struct net_context *ctx = INT_TO_POINTER(sock);
+	size_t len = 0;
+	size_t i;
+
+	ARG_UNUSED(flags);
+
+	if (sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	}
+
+	send_pkt = net_pkt_get_tx(ctx, timeout);
+	if (!send_pkt) {
+		errno = EAGAIN;
 		return -1;
 	}
 
-	if (dest_addr) {
-		err = net_context_sendto(send_pkt, dest_addr, addrlen, NULL,
-					 timeout, NULL, NULL);
-	} else {
-		err = net_context_send(send_pkt, NULL, timeout, NULL, NULL);
+	/* Gather all the vectors into a single packet. Like with
+	 * zsock_sendto(), a stream socket may take only part of the data.
+	 */
+	for (i = 0; i < msg->msg_iovlen; i++) {
+		size_t iov_len = msg->msg_iov[i].iov_len;
+		u16_t appended;
+
+		if (!iov_len) {
+			continue;
+		}
+
+		appended = net_pkt_append(send_pkt, min(iov_len, UINT16_MAX),
+					  msg->msg_iov[i].iov_base, timeout);
+		len += appended;
+
+		if (appended < iov_len) {
+			break;
+		}
 	}
 
-	if (err < 0) {
+	if (!len) {
 		net_pkt_unref(send_pkt);
-		errno = -err;
+		errno = EAGAIN;
 		return -1;
 	}
 
-	return len;
+	return zsock_send_pkt(ctx, send_pkt, len, msg->msg_name,
+			      msg->msg_namelen, timeout);
 }
 
 static inline ssize_t zsock_recv_stream(struct net_context *ctx,
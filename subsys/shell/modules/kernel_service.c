@@ -68,6 +68,50 @@ static int shell_cmd_tasks(int argc, char *argv[])
 #endif
 
 
+#if defined(CONFIG_THREAD_RUNTIME_STATS) && defined(CONFIG_THREAD_MONITOR)
+static u32_t cycles_to_ms(u64_t cycles)
+{
+	return (u32_t)(cycles * MSEC_PER_SEC / sys_clock_hw_cycles_per_sec);
+}
+
+static int shell_cmd_top(int argc, char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	struct k_thread_runtime_stats stats;
+	struct k_thread *thread;
+	u64_t total = 0;
+	u32_t permille;
+
+	/* The list may change while printing, totals are only a guide */
+	for (thread = SYS_THREAD_MONITOR_HEAD; thread != NULL;
+	     thread = SYS_THREAD_MONITOR_NEXT(thread)) {
+		k_thread_runtime_stats_get(thread, &stats);
+		total += stats.execution_cycles;
+	}
+
+	printk(" thread     prio   cpu%%     run ms   ready ms  switches"
+	       "  stack\n");
+
+	for (thread = SYS_THREAD_MONITOR_HEAD; thread != NULL;
+	     thread = SYS_THREAD_MONITOR_NEXT(thread)) {
+		k_thread_runtime_stats_get(thread, &stats);
+		permille = total ?
+			   (u32_t)(stats.execution_cycles * 1000 / total) : 0;
+
+		printk("%s%p %4d %3u.%u %10u %10u %9u %6u\n",
+		       (thread == k_current_get()) ? "*" : " ", thread,
+		       k_thread_priority_get(thread),
+		       permille / 10, permille % 10,
+		       cycles_to_ms(stats.execution_cycles),
+		       cycles_to_ms(stats.ready_cycles),
+		       stats.switches_in, (u32_t)stats.stack_peak);
+	}
+
+	return 0;
+}
+#endif
+
 #if defined(CONFIG_INIT_STACKS)
 static int shell_cmd_stack(int argc, char *argv[])
 {
@@ -83,6 +127,9 @@ struct shell_cmd kernel_commands[] = {
 #if defined(CONFIG_OBJECT_TRACING) && defined(CONFIG_THREAD_MONITOR)
 	{ "tasks", shell_cmd_tasks, "show running tasks" },
 #endif
+#if defined(CONFIG_THREAD_RUNTIME_STATS) && defined(CONFIG_THREAD_MONITOR)
+	{ "top", shell_cmd_top, "show CPU usage of each thread" },
+#endif
 #if defined(CONFIG_INIT_STACKS)
 	{ "stacks", shell_cmd_stack, "show system stacks" },
 #endif
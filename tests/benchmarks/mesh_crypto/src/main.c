@@ -0,0 +1,218 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure Bluetooth Mesh PDU encryption
+ *
+ * Encrypts and decrypts network PDUs (CCM with an 8-byte nonce-derived
+ * MIC followed by obfuscation) and access PDUs (CCM with a 4 or 8-byte
+ * TransMIC) in a loop, with the keys of a small network so that the key
+ * schedule cache is exercised the way it is when relaying traffic.
+ */
+
+#include <zephyr.h>
+#include <string.h>
+
+#include <net/buf.h>
+#include <tc_util.h>
+
+#include "crypto.h"
+
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+#include "timer_model.h"
+
+/* The simulated cycle counter does not advance while code runs */
+#define bench_now() hwtimer_get_host_time_ns()
+#define bench_ns(start, end) ((end) - (start))
+#else
+#define bench_now() k_cycle_get_32()
+#define bench_ns(start, end) \
+	SYS_CLOCK_HW_CYCLES_TO_NS64((u32_t)((end) - (start)))
+#endif
+
+#define ITERATIONS 2000
+#define NUM_KEYS 3
+#define IV_INDEX 0x12345678
+
+/* network header: IVI/NID, CTL/TTL, SEQ, SRC, DST */
+#define NET_HDR_LEN 9
+#define NET_PAYLOAD_LEN 16
+#define NET_MIC_LEN 4
+
+#define APP_SHORT_LEN 11
+#define APP_LONG_LEN 120
+
+static u8_t enc_keys[NUM_KEYS][16];
+static u8_t priv_keys[NUM_KEYS][16];
+static u8_t app_keys[NUM_KEYS][16];
+
+static void report(const char *name, u64_t ns)
+{
+	u64_t ns_per_op = ns / ITERATIONS;
+	u64_t per_sec = ns ? (u64_t)ITERATIONS * 1000000000ULL / ns : 0;
+
+	TC_PRINT("%-22s %8u ns/PDU %8u PDU/s\n", name, (u32_t)ns_per_op,
+		 (u32_t)per_sec);
+}
+
+static void net_pdu_init(struct net_buf_simple *buf, u32_t seq)
+{
+	int i;
+
+	net_buf_simple_init(buf, 0);
+
+	net_buf_simple_add_u8(buf, 0x68);
+	net_buf_simple_add_u8(buf, 0x03);
+	net_buf_simple_add_u8(buf, seq >> 16);
+	net_buf_simple_add_be16(buf, seq);
+	net_buf_simple_add_be16(buf, 0x1201);
+	net_buf_simple_add_be16(buf, 0xfffd);
+
+	for (i = 0; i < NET_PAYLOAD_LEN; i++) {
+		net_buf_simple_add_u8(buf, i);
+	}
+}
+
+static int bench_net(u64_t *enc_ns, u64_t *dec_ns)
+{
+	struct net_buf_simple *buf = NET_BUF_SIMPLE(29);
+	u64_t start, end;
+	int i, k, err;
+
+	*enc_ns = 0;
+	*dec_ns = 0;
+
+	for (i = 0; i < ITERATIONS; i++) {
+		k = i % NUM_KEYS;
+
+		net_pdu_init(buf, i);
+
+		start = bench_now();
+		err = bt_mesh_net_encrypt(enc_keys[k], buf, IV_INDEX, false);
+		if (!err) {
+			err = bt_mesh_net_obfuscate(buf->data, IV_INDEX,
+						    priv_keys[k]);
+		}
+		end = bench_now();
+		if (err) {
+			return err;
+		}
+
+		*enc_ns += bench_ns(start, end);
+
+		start = bench_now();
+		err = bt_mesh_net_obfuscate(buf->data, IV_INDEX, priv_keys[k]);
+		if (!err) {
+			err = bt_mesh_net_decrypt(enc_keys[k], buf, IV_INDEX,
+						  false);
+		}
+		end = bench_now();
+		if (err) {
+			return err;
+		}
+
+		*dec_ns += bench_ns(start, end);
+	}
+
+	return 0;
+}
+
+static int bench_app(size_t len, u8_t aszmic, u64_t *enc_ns, u64_t *dec_ns)
+{
+	struct net_buf_simple *buf = NET_BUF_SIMPLE(APP_LONG_LEN + 8);
+	struct net_buf_simple *out = NET_BUF_SIMPLE(APP_LONG_LEN);
+	u64_t start, end;
+	int i, k, err;
+
+	*enc_ns = 0;
+	*dec_ns = 0;
+
+	for (i = 0; i < ITERATIONS; i++) {
+		k = i % NUM_KEYS;
+
+		net_buf_simple_init(buf, 0);
+		memset(net_buf_simple_add(buf, len), i, len);
+
+		start = bench_now();
+		err = bt_mesh_app_encrypt(app_keys[k], false, aszmic, buf,
+					  NULL, 0x1201, 0xc000, i, IV_INDEX);
+		end = bench_now();
+		if (err) {
+			return err;
+		}
+
+		*enc_ns += bench_ns(start, end);
+
+		/* the decryption is given the payload without the MIC */
+		buf->len -= aszmic ? 8 : 4;
+		net_buf_simple_init(out, 0);
+
+		start = bench_now();
+		err = bt_mesh_app_decrypt(app_keys[k], false, aszmic, buf, out,
+					  NULL, 0x1201, 0xc000, i, IV_INDEX);
+		end = bench_now();
+		if (err) {
+			return err;
+		}
+
+		*dec_ns += bench_ns(start, end);
+	}
+
+	return 0;
+}
+
+void main(void)
+{
+	u64_t enc_ns, dec_ns;
+	int i, err;
+
+	for (i = 0; i < NUM_KEYS; i++) {
+		memset(enc_keys[i], 0x10 + i, 16);
+		memset(priv_keys[i], 0x20 + i, 16);
+		memset(app_keys[i], 0x30 + i, 16);
+	}
+
+	TC_START("Mesh crypto");
+
+	TC_PRINT("%u PDUs per run, %u keys in turn, %u cached schedules\n",
+		 ITERATIONS, NUM_KEYS,
+		 IS_ENABLED(CONFIG_BT_MESH_CRYPTO_SW_AES) ?
+		 CONFIG_BT_MESH_CRYPTO_KEY_CACHE : 0);
+
+	err = bench_net(&enc_ns, &dec_ns);
+	if (err) {
+		goto fail;
+	}
+
+	report("net encrypt", enc_ns);
+	report("net decrypt", dec_ns);
+
+	err = bench_app(APP_SHORT_LEN, 0, &enc_ns, &dec_ns);
+	if (err) {
+		goto fail;
+	}
+
+	report("app encrypt 11 B", enc_ns);
+	report("app decrypt 11 B", dec_ns);
+
+	err = bench_app(APP_LONG_LEN, 1, &enc_ns, &dec_ns);
+	if (err) {
+		goto fail;
+	}
+
+	report("app encrypt 120 B", enc_ns);
+	report("app decrypt 120 B", dec_ns);
+
+	TC_PRINT("Mesh crypto finished\n");
+
+	TC_END_RESULT(TC_PASS);
+	TC_END_REPORT(TC_PASS);
+	return;
+
+fail:
+	TC_ERROR("crypto operation failed (err %d)\n", err);
+	TC_END_RESULT(TC_FAIL);
+	TC_END_REPORT(TC_FAIL);
+}
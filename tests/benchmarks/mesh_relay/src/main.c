@@ -0,0 +1,135 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure Mesh relay bookkeeping with many source addresses
+ *
+ * Feeds the network message cache and the replay protection list with the
+ * traffic of a large network: every source sends messages in turn with
+ * increasing sequence numbers, and a share of them is received again, as
+ * relays repeat what they hear. Reports the cost per message of the two
+ * lookups each received message goes through, and checks that every
+ * repeated message is caught.
+ */
+
+#include <zephyr.h>
+#include <string.h>
+
+#include <net/buf.h>
+#include <bluetooth/mesh.h>
+#include <tc_util.h>
+
+#include "net.h"
+#include "transport.h"
+
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+#include "timer_model.h"
+
+/* The simulated cycle counter does not advance while code runs */
+#define bench_now() hwtimer_get_host_time_ns()
+#define bench_ns(start, end) ((end) - (start))
+#else
+#define bench_now() k_cycle_get_32()
+#define bench_ns(start, end) \
+	SYS_CLOCK_HW_CYCLES_TO_NS64((u32_t)((end) - (start)))
+#endif
+
+#define NUM_SOURCES (CONFIG_BT_MESH_CRPL - 48)
+#define ROUNDS 20
+/* Every DUP_INTERVAL-th message is heard twice */
+#define DUP_INTERVAL 4
+
+static void pdu_init(struct net_buf_simple *pdu, u16_t src, u32_t seq)
+{
+	net_buf_simple_init(pdu, 0);
+
+	net_buf_simple_add_u8(pdu, 0x68);
+	net_buf_simple_add_u8(pdu, 0x05);
+	net_buf_simple_add_u8(pdu, seq >> 16);
+	net_buf_simple_add_be16(pdu, seq);
+	net_buf_simple_add_be16(pdu, src);
+	net_buf_simple_add_be16(pdu, 0xc000);
+}
+
+/* Returns true if the message was accepted */
+static bool receive(struct net_buf_simple *pdu, u16_t src, u32_t seq,
+		    u64_t *cache_ns, u64_t *rpl_ns)
+{
+	struct bt_mesh_net_rx rx = {
+		.ctx.addr = src,
+		.seq = seq,
+		.net_if = BT_MESH_NET_IF_ADV,
+		.local_match = 1,
+	};
+	u64_t start, end;
+	bool dup;
+
+	start = bench_now();
+	dup = bt_mesh_msg_cache_check(&rx, pdu);
+	end = bench_now();
+	*cache_ns += bench_ns(start, end);
+
+	if (dup) {
+		return false;
+	}
+
+	start = bench_now();
+	dup = bt_mesh_rpl_check(&rx);
+	end = bench_now();
+	*rpl_ns += bench_ns(start, end);
+
+	return !dup;
+}
+
+void main(void)
+{
+	struct net_buf_simple *pdu = NET_BUF_SIMPLE(BT_MESH_NET_HDR_LEN);
+	u64_t cache_ns = 0, rpl_ns = 0;
+	u32_t received = 0, accepted = 0, seq;
+	u16_t src;
+	int round;
+
+	TC_START("Mesh relay");
+
+	TC_PRINT("%u sources, RPL of %u, message cache of %u\n",
+		 NUM_SOURCES, CONFIG_BT_MESH_CRPL,
+		 CONFIG_BT_MESH_MSG_CACHE_SIZE);
+
+	for (round = 0; round < ROUNDS; round++) {
+		for (src = 1; src <= NUM_SOURCES; src++) {
+			seq = round * 3 + src % 3;
+
+			pdu_init(pdu, src, seq);
+			accepted += receive(pdu, src, seq, &cache_ns, &rpl_ns);
+			received++;
+
+			if (src % DUP_INTERVAL) {
+				continue;
+			}
+
+			/* Caught by the cache while still in it, then by
+			 * the RPL
+			 */
+			pdu_init(pdu, src, seq);
+			if (receive(pdu, src, seq, &cache_ns, &rpl_ns)) {
+				TC_ERROR("replay of 0x%04x seq %u accepted\n",
+					 src, seq);
+				TC_END_RESULT(TC_FAIL);
+				TC_END_REPORT(TC_FAIL);
+				return;
+			}
+
+			received++;
+		}
+	}
+
+	TC_PRINT("%u messages, %u accepted\n", received, accepted);
+	TC_PRINT("message cache %8u ns/msg\n", (u32_t)(cache_ns / received));
+	TC_PRINT("RPL           %8u ns/msg\n", (u32_t)(rpl_ns / received));
+	TC_PRINT("Mesh relay finished\n");
+
+	TC_END_RESULT(TC_PASS);
+	TC_END_REPORT(TC_PASS);
+}
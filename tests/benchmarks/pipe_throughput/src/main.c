@@ -0,0 +1,167 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure pipe throughput
+ *
+ * Streams the same amount of data through a pipe in chunks of 16 bytes to
+ * 4 KiB, using:
+ *  1. k_pipe_put()/k_pipe_get() from one thread, through the ring buffer
+ *  2. k_pipe_put() to a higher priority thread blocked in k_pipe_get(),
+ *     which receives each chunk directly
+ *  3. k_pipe_put_window()/k_pipe_get_window() from one thread, writing
+ *     and reading the ring buffer in place
+ */
+
+#include <zephyr.h>
+#include <string.h>
+
+#include <tc_util.h>
+
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+#include "timer_model.h"
+
+/* The simulated cycle counter does not advance while code runs */
+#define bench_now() hwtimer_get_host_time_ns()
+#define bench_ns(start, end) ((end) - (start))
+#else
+#define bench_now() k_cycle_get_32()
+#define bench_ns(start, end) \
+	SYS_CLOCK_HW_CYCLES_TO_NS64((u32_t)((end) - (start)))
+#endif
+
+#define MIN_CHUNK 16
+#define MAX_CHUNK 4096
+#define PIPE_SIZE (2 * MAX_CHUNK)
+#define TOTAL_BYTES (1 << 20)
+#define STACK_SIZE 1024
+
+K_PIPE_DEFINE(bench_pipe, PIPE_SIZE, 4);
+K_SEM_DEFINE(done_sem, 0, 1);
+
+static K_THREAD_STACK_DEFINE(reader_stack, STACK_SIZE);
+static struct k_thread reader_thread;
+
+static u8_t __aligned(4) src[MAX_CHUNK];
+static u8_t __aligned(4) dst[MAX_CHUNK];
+
+/* Keeps the compiler from discarding the copies */
+static volatile u8_t sink;
+
+static void report(const char *name, size_t chunk, u64_t ns)
+{
+	u64_t ns_per_chunk = ns * chunk / TOTAL_BYTES;
+	u64_t kb_per_sec = ns ? (u64_t)TOTAL_BYTES * 1000000000ULL /
+			   1024 / ns : 0;
+
+	TC_PRINT("%4u B %-10s %8u ns/chunk %10u KiB/s\n", chunk, name,
+		 (u32_t)ns_per_chunk, (u32_t)kb_per_sec);
+}
+
+static u64_t bench_buffered(size_t chunk)
+{
+	u64_t start, end;
+	size_t done, bytes;
+	u32_t i;
+
+	start = bench_now();
+	for (i = 0; i < TOTAL_BYTES; i += chunk) {
+		k_pipe_put(&bench_pipe, src, chunk, &done, chunk, K_NO_WAIT);
+		k_pipe_get(&bench_pipe, dst, chunk, &bytes, chunk, K_NO_WAIT);
+		sink = dst[0];
+	}
+	end = bench_now();
+
+	return bench_ns(start, end);
+}
+
+static void reader(void *p1, void *p2, void *p3)
+{
+	size_t chunk = (size_t)p1;
+	size_t bytes;
+	u32_t i;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (i = 0; i < TOTAL_BYTES; i += chunk) {
+		k_pipe_get(&bench_pipe, dst, chunk, &bytes, chunk, K_FOREVER);
+		sink = dst[0];
+	}
+
+	k_sem_give(&done_sem);
+}
+
+static u64_t bench_handoff(size_t chunk)
+{
+	int prio = k_thread_priority_get(k_current_get()) - 1;
+	u64_t start, end;
+	size_t done;
+	u32_t i;
+
+	/* The reader runs first and blocks waiting for the first chunk */
+	k_thread_create(&reader_thread, reader_stack, STACK_SIZE, reader,
+			(void *)chunk, NULL, NULL, prio, 0, 0);
+
+	start = bench_now();
+	for (i = 0; i < TOTAL_BYTES; i += chunk) {
+		k_pipe_put(&bench_pipe, src, chunk, &done, chunk, K_FOREVER);
+	}
+	k_sem_take(&done_sem, K_FOREVER);
+	end = bench_now();
+
+	return bench_ns(start, end);
+}
+
+static u64_t bench_window(size_t chunk)
+{
+	u64_t start, end;
+	size_t n, len;
+	u32_t i;
+	u8_t *win;
+
+	start = bench_now();
+	for (i = 0; i < TOTAL_BYTES; i += chunk) {
+		/* A window may stop short at the end of the ring buffer */
+		for (n = 0; n < chunk; n += len) {
+			len = k_pipe_put_window(&bench_pipe, (void **)&win);
+			len = min(len, chunk - n);
+			memcpy(win, src + n, len);
+			k_pipe_put_commit(&bench_pipe, len);
+		}
+
+		for (n = 0; n < chunk; n += len) {
+			len = k_pipe_get_window(&bench_pipe, (void **)&win);
+			len = min(len, chunk - n);
+			sink = win[0];
+			k_pipe_get_release(&bench_pipe, len);
+		}
+	}
+	end = bench_now();
+
+	return bench_ns(start, end);
+}
+
+void main(void)
+{
+	size_t chunk;
+
+	memset(src, 0xa5, sizeof(src));
+
+	TC_START("Pipe throughput");
+
+	TC_PRINT("%u bytes per run, pipe of %u\n", TOTAL_BYTES, PIPE_SIZE);
+
+	for (chunk = MIN_CHUNK; chunk <= MAX_CHUNK; chunk *= 4) {
+		report("buffered", chunk, bench_buffered(chunk));
+		report("handoff", chunk, bench_handoff(chunk));
+		report("window", chunk, bench_window(chunk));
+	}
+
+	TC_PRINT("Pipe throughput finished\n");
+
+	TC_END_RESULT(TC_PASS);
+	TC_END_REPORT(TC_PASS);
+}
@@ -0,0 +1,196 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure ring buffer throughput
+ *
+ * Streams the same number of 32-bit elements through:
+ *  1. the item ring buffer, serialized with irq_lock()
+ *  2. a single-producer lock-free ring, one element per call
+ *  3. a single-producer lock-free ring, in bulk
+ *  4. a single-producer lock-free ring, with claim/finish
+ *  5. a multi-producer lock-free ring, one element per call
+ *  6. a multi-producer lock-free ring, in bulk
+ *  7. a multi-producer lock-free ring, with claim/finish
+ *
+ * Each pass fills half of the ring and drains it again, so the indices
+ * wrap around the storage many times.
+ */
+
+#include <zephyr.h>
+#include <ring_buffer.h>
+#include <lf_ring.h>
+#include <string.h>
+
+#include <tc_util.h>
+
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+#include "timer_model.h"
+
+/* The simulated cycle counter does not advance while code runs */
+#define bench_now() hwtimer_get_host_time_ns()
+#define bench_ns(start, end) ((end) - (start))
+#else
+#define bench_now() k_cycle_get_32()
+#define bench_ns(start, end) \
+	SYS_CLOCK_HW_CYCLES_TO_NS64((u32_t)((end) - (start)))
+#endif
+
+#define RING_POW 8
+#define RING_COUNT (1 << RING_POW)
+#define BATCH (RING_COUNT / 2)
+#define BULK 32
+#define NUM_ELEMS (1 << 18)
+
+SYS_RING_BUF_DECLARE_POW2(item_ring, RING_POW);
+SYS_LF_RING_DEFINE(sp_ring, sizeof(u32_t), RING_COUNT, 0);
+SYS_LF_RING_DEFINE(mp_ring, sizeof(u32_t), RING_COUNT,
+		   SYS_LF_RING_MULTI_PRODUCER);
+
+static u32_t src[BULK];
+static u32_t dst[BULK];
+
+/* Keeps the compiler from discarding the copies */
+static volatile u32_t sink;
+
+static void report(const char *name, u64_t ns)
+{
+	u64_t ps_per_elem = ns * 1000 / NUM_ELEMS;
+	u64_t kb_per_sec = ns ? (u64_t)NUM_ELEMS * sizeof(u32_t) *
+			   1000000000ULL / 1024 / ns : 0;
+
+	TC_PRINT("%-28s %6u.%03u ns/elem %10u KiB/s\n", name,
+		 (u32_t)(ps_per_elem / 1000), (u32_t)(ps_per_elem % 1000),
+		 (u32_t)kb_per_sec);
+}
+
+static u64_t bench_item_ring(void)
+{
+	u64_t start, end;
+	u32_t i, j, val;
+	u16_t type;
+	u8_t value, size32;
+	int key;
+
+	/* An item costs a header word, so only half the ring is usable */
+	start = bench_now();
+	for (i = 0; i < NUM_ELEMS; i += BATCH / 2) {
+		for (j = 0; j < BATCH / 2; j++) {
+			key = irq_lock();
+			sys_ring_buf_put(&item_ring, 0, 0, &src[0], 1);
+			irq_unlock(key);
+		}
+
+		for (j = 0; j < BATCH / 2; j++) {
+			size32 = 1;
+			key = irq_lock();
+			sys_ring_buf_get(&item_ring, &type, &value, &val,
+					 &size32);
+			irq_unlock(key);
+			sink = val;
+		}
+	}
+	end = bench_now();
+
+	return bench_ns(start, end);
+}
+
+static u64_t bench_single(struct sys_lf_ring *ring)
+{
+	u64_t start, end;
+	u32_t i, j, val;
+
+	start = bench_now();
+	for (i = 0; i < NUM_ELEMS; i += BATCH) {
+		for (j = 0; j < BATCH; j++) {
+			sys_lf_ring_put(ring, &src[0], 1);
+		}
+
+		for (j = 0; j < BATCH; j++) {
+			sys_lf_ring_get(ring, &val, 1);
+			sink = val;
+		}
+	}
+	end = bench_now();
+
+	return bench_ns(start, end);
+}
+
+static u64_t bench_bulk(struct sys_lf_ring *ring)
+{
+	u64_t start, end;
+	u32_t i, j;
+
+	start = bench_now();
+	for (i = 0; i < NUM_ELEMS; i += BATCH) {
+		for (j = 0; j < BATCH; j += BULK) {
+			sys_lf_ring_put(ring, src, BULK);
+		}
+
+		for (j = 0; j < BATCH; j += BULK) {
+			sys_lf_ring_get(ring, dst, BULK);
+			sink = dst[0];
+		}
+	}
+	end = bench_now();
+
+	return bench_ns(start, end);
+}
+
+static u64_t bench_claim(struct sys_lf_ring *ring)
+{
+	u64_t start, end;
+	u32_t i, j, k, n;
+	u32_t *span;
+
+	start = bench_now();
+	for (i = 0; i < NUM_ELEMS; i += BATCH) {
+		for (j = 0; j < BATCH; j += n) {
+			n = sys_lf_ring_put_claim(ring, (void **)&span, BULK);
+			for (k = 0; k < n; k++) {
+				span[k] = k;
+			}
+			sys_lf_ring_put_finish(ring, n);
+		}
+
+		for (j = 0; j < BATCH; j += n) {
+			n = sys_lf_ring_get_claim(ring, (void **)&span, BULK);
+			for (k = 0; k < n; k++) {
+				sink = span[k];
+			}
+			sys_lf_ring_get_finish(ring, n);
+		}
+	}
+	end = bench_now();
+
+	return bench_ns(start, end);
+}
+
+void main(void)
+{
+	int i;
+
+	for (i = 0; i < BULK; i++) {
+		src[i] = i;
+	}
+
+	TC_START("Ring buffer throughput");
+
+	TC_PRINT("%u x %u-byte elements, ring of %u\n", NUM_ELEMS,
+		 sizeof(u32_t), RING_COUNT);
+
+	report("item ring + irq_lock", bench_item_ring());
+	report("SPSC single", bench_single(&sp_ring));
+	report("SPSC bulk", bench_bulk(&sp_ring));
+	report("SPSC claim/finish", bench_claim(&sp_ring));
+	report("MPSC single", bench_single(&mp_ring));
+	report("MPSC bulk", bench_bulk(&mp_ring));
+	report("MPSC claim/finish", bench_claim(&mp_ring));
+
+	TC_PRINT("Ring buffer throughput finished\n");
+
+	TC_END_RESULT(TC_PASS);
+	TC_END_REPORT(TC_PASS);
+}
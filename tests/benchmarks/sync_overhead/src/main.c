@@ -0,0 +1,163 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure uncontended lock overhead
+ *
+ * Acquires and releases a free lock in a loop with each of the kernel's
+ * blocking primitives and with a futex mutex, whose uncontended paths are
+ * a single atomic operation. With CONFIG_USERSPACE the loops run again in
+ * a user thread, where every kernel primitive costs a system call while
+ * the futex mutex still does not.
+ */
+
+#include <zephyr.h>
+#include <misc/futex_mutex.h>
+
+#include <tc_util.h>
+
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+#include "timer_model.h"
+
+/* The simulated cycle counter does not advance while code runs */
+#define bench_now() hwtimer_get_host_time_ns()
+#define bench_ns(start, end) ((end) - (start))
+#else
+#define bench_now() k_cycle_get_32()
+#define bench_ns(start, end) \
+	SYS_CLOCK_HW_CYCLES_TO_NS64((u32_t)((end) - (start)))
+#endif
+
+#define NUM_ITER 10000
+#define STACK_SIZE 1024
+
+enum bench_lock {
+	BENCH_SEM,
+	BENCH_MUTEX,
+	BENCH_RWLOCK_READ,
+	BENCH_RWLOCK_WRITE,
+	BENCH_FUTEX_MUTEX,
+
+	BENCH_COUNT
+};
+
+static const char * const bench_names[BENCH_COUNT] = {
+	[BENCH_SEM] = "k_sem",
+	[BENCH_MUTEX] = "k_mutex",
+	[BENCH_RWLOCK_READ] = "k_rwlock rd",
+	[BENCH_RWLOCK_WRITE] = "k_rwlock wr",
+	[BENCH_FUTEX_MUTEX] = "futex mutex",
+};
+
+K_SEM_DEFINE(bench_sem, 1, 1);
+K_MUTEX_DEFINE(bench_mutex);
+K_RWLOCK_DEFINE(bench_rwlock);
+
+#ifdef CONFIG_USERSPACE
+K_SEM_DEFINE(start_sem, 0, 1);
+K_SEM_DEFINE(done_sem, 0, 1);
+
+static K_THREAD_STACK_DEFINE(user_stack, STACK_SIZE);
+static __kernel struct k_thread user_thread;
+#endif
+
+static void bench_loop(enum bench_lock lock)
+{
+	/* On the stack, so a user thread can access it directly */
+	struct sys_futex_mutex futex_mutex;
+	u32_t i;
+
+	sys_futex_mutex_init(&futex_mutex);
+
+	for (i = 0; i < NUM_ITER; i++) {
+		switch (lock) {
+		case BENCH_SEM:
+			k_sem_take(&bench_sem, K_FOREVER);
+			k_sem_give(&bench_sem);
+			break;
+		case BENCH_MUTEX:
+			k_mutex_lock(&bench_mutex, K_FOREVER);
+			k_mutex_unlock(&bench_mutex);
+			break;
+		case BENCH_RWLOCK_READ:
+			k_rwlock_read_lock(&bench_rwlock, K_FOREVER);
+			k_rwlock_read_unlock(&bench_rwlock);
+			break;
+		case BENCH_RWLOCK_WRITE:
+			k_rwlock_write_lock(&bench_rwlock, K_FOREVER);
+			k_rwlock_write_unlock(&bench_rwlock);
+			break;
+		default:
+			sys_futex_mutex_lock(&futex_mutex, K_FOREVER);
+			sys_futex_mutex_unlock(&futex_mutex);
+			break;
+		}
+	}
+}
+
+static void report(const char *mode, enum bench_lock lock, u64_t ns)
+{
+	TC_PRINT("%-10s %-12s %6u ns per lock/unlock pair\n", mode,
+		 bench_names[lock], (u32_t)(ns / NUM_ITER));
+}
+
+#ifdef CONFIG_USERSPACE
+static void user_body(void *p1, void *p2, void *p3)
+{
+	int lock;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (lock = 0; lock < BENCH_COUNT; lock++) {
+		k_sem_take(&start_sem, K_FOREVER);
+		bench_loop(lock);
+		k_sem_give(&done_sem);
+	}
+}
+#endif
+
+void main(void)
+{
+	u64_t start, end;
+	int lock;
+
+	TC_START("Uncontended lock overhead");
+
+	TC_PRINT("%u iterations\n", NUM_ITER);
+
+	for (lock = 0; lock < BENCH_COUNT; lock++) {
+		start = bench_now();
+		bench_loop(lock);
+		end = bench_now();
+		report("supervisor", lock, bench_ns(start, end));
+	}
+
+#ifdef CONFIG_USERSPACE
+	/* The cycle counter may not be readable from user mode, so each
+	 * loop of the user thread is timed from here
+	 */
+	k_thread_create(&user_thread, user_stack, STACK_SIZE, user_body,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), K_USER,
+			K_FOREVER);
+	k_thread_access_grant(&user_thread, &bench_sem, &bench_mutex,
+			      &bench_rwlock, &start_sem, &done_sem, NULL);
+	k_thread_start(&user_thread);
+
+	for (lock = 0; lock < BENCH_COUNT; lock++) {
+		start = bench_now();
+		k_sem_give(&start_sem);
+		k_sem_take(&done_sem, K_FOREVER);
+		end = bench_now();
+		report("user", lock, bench_ns(start, end));
+	}
+#endif
+
+	TC_PRINT("Uncontended lock overhead finished\n");
+
+	TC_END_RESULT(TC_PASS);
+	TC_END_REPORT(TC_PASS);
+}
@@ -14,6 +14,11 @@ struct k_fifo fifo2;
 
 static struct k_fifo sync_fifo; /* for synchronization */
 
+/* NUMBER_OF_LOOPS must be a multiple of this */
+#define BATCH_SIZE 25
+
+static int batch[BATCH_SIZE][2];
+
 
 /**
  *
@@ -257,5 +262,87 @@ int fifo_test(void)
 		k_fifo_put(&sync_fifo, (void *) element);
 	}
 
+	/* test one item per call against batches, within a single thread */
+	fprintf(output_file, sz_test_case_fmt,
+			"FIFO #4");
+	fprintf(output_file, sz_description,
+			"\n\tk_fifo_init"
+			"\n\tk_fifo_put"
+			"\n\tk_fifo_get(K_NO_WAIT)");
+	printf(sz_test_start_fmt);
+
+	fifo_test_init();
+
+	t = BENCH_START();
+
+	for (i = 0; i < NUMBER_OF_LOOPS; i += j) {
+		int *pelement;
+
+		for (j = 0; j < BATCH_SIZE; j++) {
+			batch[j][1] = i + j;
+			k_fifo_put(&fifo1, batch[j]);
+		}
+
+		for (j = 0; j < BATCH_SIZE; j++) {
+			pelement = k_fifo_get(&fifo1, K_NO_WAIT);
+			if (!pelement || pelement[1] != i + j) {
+				break;
+			}
+		}
+
+		if (j != BATCH_SIZE) {
+			break;
+		}
+	}
+
+	t = TIME_STAMP_DELTA_GET(t);
+
+	return_value += check_result(i, t);
+
+	fprintf(output_file, sz_test_case_fmt,
+			"FIFO #5");
+	fprintf(output_file, sz_description,
+			"\n\tk_fifo_init"
+			"\n\tk_fifo_put_slist"
+			"\n\tk_fifo_get_all(K_NO_WAIT)");
+	printf(sz_test_start_fmt);
+
+	fifo_test_init();
+
+	t = BENCH_START();
+
+	for (i = 0; i < NUMBER_OF_LOOPS; i += j) {
+		sys_slist_t list;
+		sys_snode_t *node;
+
+		sys_slist_init(&list);
+		for (j = 0; j < BATCH_SIZE; j++) {
+			batch[j][1] = i + j;
+			sys_slist_append(&list, (sys_snode_t *)batch[j]);
+		}
+
+		k_fifo_put_slist(&fifo1, &list);
+
+		if (k_fifo_get_all(&fifo1, &list, K_NO_WAIT) != BATCH_SIZE) {
+			break;
+		}
+
+		j = 0;
+		SYS_SLIST_FOR_EACH_NODE(&list, node) {
+			if (((int *)node)[1] != i + j) {
+				break;
+			}
+			j++;
+		}
+
+		if (j != BATCH_SIZE) {
+			break;
+		}
+	}
+
+	t = TIME_STAMP_DELTA_GET(t);
+
+	return_value += check_result(i, t);
+
 	return return_value;
 }
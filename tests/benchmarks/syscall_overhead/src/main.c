@@ -0,0 +1,87 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure system call overhead
+ *
+ * Gives and takes the same semaphore in a loop, first from a supervisor
+ * thread, where the calls go straight to the implementation, then from a
+ * user thread, where every call traps into the kernel and validates the
+ * semaphore. The difference is the cost of the system call path.
+ */
+
+#include <zephyr.h>
+
+#include <tc_util.h>
+
+#define NUM_ITER 10000
+#define STACK_SIZE 1024
+
+K_SEM_DEFINE(bench_sem, 0, 1);
+K_SEM_DEFINE(done_sem, 0, 1);
+
+static K_THREAD_STACK_DEFINE(user_stack, STACK_SIZE);
+static __kernel struct k_thread user_thread;
+
+static void bench_body(void *p1, void *p2, void *p3)
+{
+	u32_t i;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (i = 0; i < NUM_ITER; i++) {
+		k_sem_give(&bench_sem);
+		k_sem_take(&bench_sem, K_NO_WAIT);
+	}
+
+	k_sem_give(&done_sem);
+}
+
+static void report(const char *name, u32_t cycles)
+{
+	u32_t per_pair = cycles / NUM_ITER;
+
+	TC_PRINT("%-12s %6u cycles %8u ns per give/take pair\n", name,
+		 per_pair, (u32_t)SYS_CLOCK_HW_CYCLES_TO_NS(per_pair));
+}
+
+void main(void)
+{
+	u32_t supervisor_cycles, user_cycles, start;
+
+	TC_START("System call overhead");
+
+	start = k_cycle_get_32();
+	bench_body(NULL, NULL, NULL);
+	k_sem_take(&done_sem, K_FOREVER);
+	supervisor_cycles = k_cycle_get_32() - start;
+
+	/* The cycle counter may not be readable from user mode, so the
+	 * user thread is timed from here, including its start up
+	 */
+	k_thread_create(&user_thread, user_stack, STACK_SIZE, bench_body,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), K_USER,
+			K_FOREVER);
+	k_thread_access_grant(&user_thread, &bench_sem, &done_sem, NULL);
+
+	start = k_cycle_get_32();
+	k_thread_start(&user_thread);
+	k_sem_take(&done_sem, K_FOREVER);
+	user_cycles = k_cycle_get_32() - start;
+
+#ifdef CONFIG_KOBJECT_VALIDATION_CACHE
+	TC_PRINT("%u iterations, object validation cache enabled\n", NUM_ITER);
+#else
+	TC_PRINT("%u iterations, object validation cache disabled\n", NUM_ITER);
+#endif
+	report("supervisor", supervisor_cycles);
+	report("user", user_cycles);
+	report("overhead", user_cycles - supervisor_cycles);
+
+	TC_END_RESULT(TC_PASS);
+	TC_END_REPORT(TC_PASS);
+}
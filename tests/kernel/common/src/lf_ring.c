@@ -0,0 +1,294 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <lf_ring.h>
+
+#define RING_COUNT 16
+
+SYS_LF_RING_DEFINE(byte_ring, 1, RING_COUNT, 0);
+
+struct mp_elem {
+	u32_t producer;
+	u32_t seq;
+};
+
+SYS_LF_RING_DEFINE(mp_ring, sizeof(struct mp_elem), RING_COUNT,
+		   SYS_LF_RING_MULTI_PRODUCER);
+
+static const u8_t pattern[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+static void lf_ring_bulk(void)
+{
+	u8_t out[sizeof(pattern)];
+	u32_t n, i;
+
+	zassert_true(sys_lf_ring_is_empty(&byte_ring), "ring not empty");
+	zassert_equal(sys_lf_ring_space_get(&byte_ring), RING_COUNT,
+		      "wrong initial space");
+
+	/* A bulk put is truncated to the free space */
+	n = sys_lf_ring_put(&byte_ring, pattern, sizeof(pattern));
+	zassert_equal(n, RING_COUNT, "put not truncated");
+	zassert_equal(sys_lf_ring_put(&byte_ring, pattern, 1), 0,
+		      "put into a full ring");
+
+	/* Move the indices around the end of the storage a few times */
+	for (i = 0; i < 3 * RING_COUNT; i += 5) {
+		n = sys_lf_ring_get(&byte_ring, out, 5);
+		zassert_equal(n, 5, "short get");
+		n = sys_lf_ring_put(&byte_ring, pattern, 5);
+		zassert_equal(n, 5, "short put");
+	}
+
+	n = sys_lf_ring_get(&byte_ring, out, sizeof(out));
+	zassert_equal(n, RING_COUNT, "wrong used count");
+	zassert_true(memcmp(out + RING_COUNT - 5, pattern, 5) == 0,
+		     "data corrupted across wrap");
+	zassert_equal(sys_lf_ring_get(&byte_ring, out, 1), 0,
+		      "got data out of an empty ring");
+}
+
+static void lf_ring_claim(void)
+{
+	u8_t *span;
+	u32_t n, total;
+
+	/* Leave the indices in the middle of the storage */
+	sys_lf_ring_put(&byte_ring, pattern, RING_COUNT / 2 + 3);
+	sys_lf_ring_get_claim(&byte_ring, (void **)&span, RING_COUNT);
+	zassert_equal(sys_lf_ring_get_finish(&byte_ring, RING_COUNT / 2 + 3),
+		      0, "release failed");
+
+	/* Claims stop at the end of the storage */
+	n = sys_lf_ring_put_claim(&byte_ring, (void **)&span, RING_COUNT);
+	zassert_equal(n, RING_COUNT / 2 - 3, "claim crosses the end");
+	memcpy(span, pattern, n);
+	zassert_equal(sys_lf_ring_put_finish(&byte_ring, n), 0, "commit failed");
+	total = n;
+
+	n = sys_lf_ring_put_claim(&byte_ring, (void **)&span, RING_COUNT);
+	zassert_equal(n, RING_COUNT - total, "claim not at start");
+	memcpy(span, pattern + total, 4);
+	zassert_equal(sys_lf_ring_put_finish(&byte_ring, 4), 0, "commit failed");
+	total += 4;
+
+	zassert_equal(sys_lf_ring_put_finish(&byte_ring, RING_COUNT), -EINVAL,
+		      "committed more than the free space");
+	zassert_equal(sys_lf_ring_used_get(&byte_ring), total, "wrong used");
+
+	n = sys_lf_ring_get_claim(&byte_ring, (void **)&span, RING_COUNT);
+	zassert_equal(n, RING_COUNT / 2 - 3, "get claim crosses the end");
+	zassert_true(memcmp(span, pattern, n) == 0, "data corrupted");
+	sys_lf_ring_get_finish(&byte_ring, n);
+
+	n = sys_lf_ring_get_claim(&byte_ring, (void **)&span, RING_COUNT);
+	zassert_equal(n, 4, "wrong second span");
+	zassert_true(memcmp(span, pattern + total - 4, n) == 0,
+		     "data corrupted");
+	zassert_equal(sys_lf_ring_get_finish(&byte_ring, n + 1), -EINVAL,
+		      "released more than available");
+	sys_lf_ring_get_finish(&byte_ring, n);
+
+	zassert_true(sys_lf_ring_is_empty(&byte_ring), "ring not empty");
+}
+
+#define NUM_PRODUCERS 3
+#define ELEMS_PER_PRODUCER 200
+#define STACKSIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, NUM_PRODUCERS, STACKSIZE);
+static struct k_thread threads[NUM_PRODUCERS];
+
+static void producer(void *p1, void *p2, void *p3)
+{
+	u32_t id = (u32_t)(uintptr_t)p1;
+	struct mp_elem elem[2];
+	struct mp_elem *span;
+	u32_t seq = 0;
+	u32_t n;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (seq < ELEMS_PER_PRODUCER) {
+		/* Alternate between copying and claiming */
+		if (seq & 1) {
+			if (!sys_lf_ring_put_claim(&mp_ring, (void **)&span,
+						   1)) {
+				k_sleep(1);
+				continue;
+			}
+
+			span->producer = id;
+			span->seq = seq++;
+			sys_lf_ring_put_finish(&mp_ring, 1);
+			continue;
+		}
+
+		elem[0].producer = id;
+		elem[0].seq = seq;
+		elem[1].producer = id;
+		elem[1].seq = seq + 1;
+
+		/* A partial put simply resumes from the first lost seq */
+		n = sys_lf_ring_put(&mp_ring, elem, 2);
+		if (!n) {
+			k_sleep(1);
+		}
+
+		seq += n;
+	}
+}
+
+static void lf_ring_multi_producer(void)
+{
+	int prio = k_thread_priority_get(k_current_get()) + 1;
+	u32_t next[NUM_PRODUCERS] = { 0 };
+	u32_t received = 0;
+	struct mp_elem elem;
+	int i;
+
+	for (i = 0; i < NUM_PRODUCERS; i++) {
+		k_thread_create(&threads[i], stacks[i], STACKSIZE, producer,
+				(void *)(uintptr_t)i, NULL, NULL, prio, 0, 0);
+	}
+
+	while (received < NUM_PRODUCERS * ELEMS_PER_PRODUCER) {
+		if (!sys_lf_ring_get(&mp_ring, &elem, 1)) {
+			k_sleep(1);
+			continue;
+		}
+
+		zassert_true(elem.producer < NUM_PRODUCERS, "bad producer");
+		zassert_equal(elem.seq, next[elem.producer],
+			      "lost or reordered element");
+		next[elem.producer]++;
+		received++;
+	}
+
+	zassert_true(sys_lf_ring_is_empty(&mp_ring), "ring not empty");
+	zassert_equal(sys_lf_ring_space_get(&mp_ring), RING_COUNT,
+		      "reservations leaked");
+}
+
+/* Large enough for everything the producers write, so nobody consumes */
+#define STRESS_ELEMS_PER_PRODUCER 64
+#define STRESS_COUNT 256
+
+SYS_LF_RING_DEFINE(stress_ring, sizeof(struct mp_elem), STRESS_COUNT,
+		   SYS_LF_RING_MULTI_PRODUCER);
+
+static K_THREAD_STACK_ARRAY_DEFINE(stress_stacks, NUM_PRODUCERS, STACKSIZE);
+static struct k_thread stress_threads[NUM_PRODUCERS];
+static K_SEM_DEFINE(stress_done, 0, NUM_PRODUCERS);
+
+static void stress_producer(void *p1, void *p2, void *p3)
+{
+	u32_t id = (u32_t)(uintptr_t)p1;
+	struct mp_elem elem;
+	struct mp_elem *span;
+	u32_t seq;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (seq = 0; seq < STRESS_ELEMS_PER_PRODUCER; seq++) {
+		elem.producer = id;
+		elem.seq = seq;
+
+		if ((seq + id) & 1) {
+			zassert_equal(sys_lf_ring_put(&stress_ring, &elem, 1),
+				      1, "put failed");
+			continue;
+		}
+
+		/* Let the other producers reserve, fill and leave while this
+		 * one still holds a reservation below theirs.
+		 */
+		zassert_equal(sys_lf_ring_put_claim(&stress_ring,
+						    (void **)&span, 1),
+			      1, "claim failed");
+		k_yield();
+		*span = elem;
+		sys_lf_ring_put_finish(&stress_ring, 1);
+	}
+
+	k_sem_give(&stress_done);
+}
+
+static void lf_ring_multi_producer_stress(void)
+{
+	int prio = k_thread_priority_get(k_current_get()) + 1;
+	u32_t next[NUM_PRODUCERS] = { 0 };
+	u32_t total = NUM_PRODUCERS * STRESS_ELEMS_PER_PRODUCER;
+	struct mp_elem elem;
+	int i;
+
+	for (i = 0; i < NUM_PRODUCERS; i++) {
+		k_thread_create(&stress_threads[i], stress_stacks[i],
+				STACKSIZE, stress_producer,
+				(void *)(uintptr_t)i, NULL, NULL, prio, 0, 0);
+	}
+
+	for (i = 0; i < NUM_PRODUCERS; i++) {
+		k_sem_take(&stress_done, K_FOREVER);
+	}
+
+	/* Every put is visible once no producer is inside the ring */
+	zassert_equal(sys_lf_ring_used_get(&stress_ring), total,
+		      "elements left unpublished");
+	zassert_equal(sys_lf_ring_space_get(&stress_ring),
+		      STRESS_COUNT - total, "reservations leaked");
+
+	while (sys_lf_ring_get(&stress_ring, &elem, 1)) {
+		zassert_true(elem.producer < NUM_PRODUCERS, "bad producer");
+		zassert_equal(elem.seq, next[elem.producer],
+			      "lost or reordered element");
+		next[elem.producer]++;
+	}
+
+	for (i = 0; i < NUM_PRODUCERS; i++) {
+		zassert_equal(next[i], STRESS_ELEMS_PER_PRODUCER,
+			      "lost element");
+	}
+}
+
+static void lf_ring_multi_producer_full_claim(void)
+{
+	struct mp_elem elem = { .producer = 0, .seq = 0 };
+	struct mp_elem *span;
+	u32_t i;
+
+	for (i = 0; i < RING_COUNT; i++) {
+		zassert_equal(sys_lf_ring_put(&mp_ring, &elem, 1), 1,
+			      "ring filled early");
+	}
+
+	/* Finishing a failed claim must not leave the ring */
+	zassert_equal(sys_lf_ring_put_claim(&mp_ring, (void **)&span, 1), 0,
+		      "claimed in a full ring");
+	zassert_equal(sys_lf_ring_put_finish(&mp_ring, 0), 0,
+		      "empty finish failed");
+
+	for (i = 0; i < RING_COUNT; i++) {
+		zassert_equal(sys_lf_ring_get(&mp_ring, &elem, 1), 1,
+			      "short drain");
+	}
+
+	elem.seq = 1;
+	zassert_equal(sys_lf_ring_put(&mp_ring, &elem, 1), 1, "put failed");
+	zassert_equal(sys_lf_ring_used_get(&mp_ring), 1, "put not published");
+	zassert_equal(sys_lf_ring_get(&mp_ring, &elem, 1), 1, "get failed");
+	zassert_equal(elem.seq, 1, "wrong element");
+}
+
+void lf_ring_test(void)
+{
+	lf_ring_bulk();
+	lf_ring_claim();
+	lf_ring_multi_producer();
+	lf_ring_multi_producer_stress();
+	lf_ring_multi_producer_full_claim();
+}
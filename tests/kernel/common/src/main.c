@@ -15,6 +15,7 @@ extern void bitfield_test(void);
 extern void intmath_test(void);
 extern void printk_test(void);
 extern void ring_buffer_test(void);
+extern void lf_ring_test(void);
 extern void slist_test(void);
 extern void dlist_test(void);
 extern void rand32_test(void);
@@ -31,6 +32,7 @@ void test_main(void)
 			 ztest_unit_test(printk_test),
 #endif
 			 ztest_unit_test(ring_buffer_test),
+			 ztest_unit_test(lf_ring_test),
 			 ztest_unit_test(slist_test),
 			 ztest_unit_test(dlist_test),
 			 ztest_unit_test(rand32_test),
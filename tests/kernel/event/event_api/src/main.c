@@ -0,0 +1,33 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_event
+ * @{
+ * @defgroup t_event_api test_event_api
+ * @}
+ */
+
+#include <ztest.h>
+
+extern void test_event_no_wait(void);
+extern void test_event_wait_any(void);
+extern void test_event_wait_all(void);
+extern void test_event_wait_clear(void);
+extern void test_event_set(void);
+extern void test_event_timeout(void);
+
+/*test case main entry*/
+void test_main(void)
+{
+	ztest_test_suite(test_event_api,
+			 ztest_unit_test(test_event_no_wait),
+			 ztest_unit_test(test_event_wait_any),
+			 ztest_unit_test(test_event_wait_all),
+			 ztest_unit_test(test_event_wait_clear),
+			 ztest_unit_test(test_event_set),
+			 ztest_unit_test(test_event_timeout)
+			 );
+	ztest_run_test_suite(test_event_api);
+}
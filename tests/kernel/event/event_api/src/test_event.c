@@ -0,0 +1,172 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_event_api
+ * @{
+ * @defgroup t_event_wait test_event_wait
+ * @brief TestPurpose: verify event flag groups and their wait modes
+ * - API coverage
+ *   -# k_event_init K_EVENT_DEFINE
+ *   -# k_event_post k_event_set k_event_clear k_event_get
+ *   -# k_event_wait
+ * @}
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE 1024
+#define NUM_THREADS 2
+#define MAIN_PRIO K_PRIO_PREEMPT(5)
+#define TIMEOUT 50
+
+#define EV_A BIT(0)
+#define EV_B BIT(1)
+#define EV_C BIT(2)
+
+/**TESTPOINT: init via K_EVENT_DEFINE*/
+K_EVENT_DEFINE(kevent);
+static struct k_event event;
+
+static K_THREAD_STACK_ARRAY_DEFINE(tstack, NUM_THREADS, STACK_SIZE);
+static struct k_thread tdata[NUM_THREADS];
+
+/* Threads log their id and the events they got once woken */
+static int order[NUM_THREADS];
+static u32_t matched[NUM_THREADS];
+static int order_len;
+
+static void twait_entry(void *p1, void *p2, void *p3)
+{
+	int id = (int)p1;
+
+	matched[id] = k_event_wait(&event, (u32_t)p2, (unsigned int)p3,
+				   K_FOREVER);
+	order[order_len++] = id;
+}
+
+static void spawn(int id, u32_t events, unsigned int options, int prio)
+{
+	k_thread_create(&tdata[id], tstack[id], STACK_SIZE, twait_entry,
+			(void *)id, (void *)events, (void *)options, prio, 0, 0);
+}
+
+static void setup(void)
+{
+	k_thread_priority_set(k_current_get(), MAIN_PRIO);
+	k_event_init(&event);
+	order_len = 0;
+}
+
+/*test cases*/
+void test_event_no_wait(void)
+{
+	setup();
+
+	zassert_equal(k_event_get(&kevent), 0, NULL);
+	zassert_equal(k_event_wait(&kevent, EV_A, K_EVENT_WAIT_ANY,
+				   K_NO_WAIT), 0, NULL);
+
+	/**TESTPOINT: posted events add up until cleared */
+	k_event_post(&kevent, EV_A);
+	k_event_post(&kevent, EV_C);
+	zassert_equal(k_event_get(&kevent), EV_A | EV_C, NULL);
+	zassert_equal(k_event_wait(&kevent, EV_A | EV_B, K_EVENT_WAIT_ANY,
+				   K_NO_WAIT), EV_A, NULL);
+	zassert_equal(k_event_wait(&kevent, EV_A | EV_B, K_EVENT_WAIT_ALL,
+				   K_NO_WAIT), 0, NULL);
+
+	k_event_clear(&kevent, EV_A);
+	zassert_equal(k_event_get(&kevent), EV_C, NULL);
+
+	/**TESTPOINT: a satisfied wait clears what it matched */
+	zassert_equal(k_event_wait(&kevent, EV_C,
+				   K_EVENT_WAIT_ANY | K_EVENT_WAIT_CLEAR,
+				   K_NO_WAIT), EV_C, NULL);
+	zassert_equal(k_event_get(&kevent), 0, NULL);
+}
+
+void test_event_wait_any(void)
+{
+	setup();
+
+	spawn(0, EV_A | EV_B, K_EVENT_WAIT_ANY, K_PRIO_PREEMPT(3));
+	spawn(1, EV_C, K_EVENT_WAIT_ANY, K_PRIO_PREEMPT(3));
+
+	/**TESTPOINT: posting wakes only the waiters it satisfies */
+	k_event_post(&event, EV_B);
+	zassert_equal(order_len, 1, NULL);
+	zassert_equal(order[0], 0, NULL);
+	zassert_equal(matched[0], EV_B, NULL);
+
+	k_event_post(&event, EV_C);
+	zassert_equal(order_len, 2, NULL);
+	zassert_equal(matched[1], EV_C, NULL);
+	zassert_equal(k_event_get(&event), EV_B | EV_C, NULL);
+}
+
+void test_event_wait_all(void)
+{
+	setup();
+
+	spawn(0, EV_A | EV_B, K_EVENT_WAIT_ALL, K_PRIO_PREEMPT(3));
+
+	/**TESTPOINT: a wait for all events needs every one of them */
+	k_event_post(&event, EV_A);
+	zassert_equal(order_len, 0, NULL);
+	k_event_post(&event, EV_C);
+	zassert_equal(order_len, 0, NULL);
+	k_event_post(&event, EV_B);
+	zassert_equal(order_len, 1, NULL);
+	zassert_equal(matched[0], EV_A | EV_B, NULL);
+}
+
+void test_event_wait_clear(void)
+{
+	setup();
+
+	spawn(0, EV_A, K_EVENT_WAIT_ANY | K_EVENT_WAIT_CLEAR,
+	      K_PRIO_PREEMPT(4));
+	spawn(1, EV_A, K_EVENT_WAIT_ANY | K_EVENT_WAIT_CLEAR,
+	      K_PRIO_PREEMPT(3));
+
+	/**TESTPOINT: a clearing waiter consumes the event for the others */
+	k_event_post(&event, EV_A);
+	zassert_equal(order_len, 1, NULL);
+	zassert_equal(order[0], 1, NULL);
+	zassert_equal(k_event_get(&event), 0, NULL);
+
+	k_event_post(&event, EV_A);
+	zassert_equal(order_len, 2, NULL);
+	zassert_equal(order[1], 0, NULL);
+	zassert_equal(k_event_get(&event), 0, NULL);
+}
+
+void test_event_set(void)
+{
+	setup();
+
+	k_event_post(&event, EV_A | EV_B);
+	spawn(0, EV_C, K_EVENT_WAIT_ANY, K_PRIO_PREEMPT(3));
+
+	/**TESTPOINT: setting events replaces the previous ones */
+	k_event_set(&event, EV_C);
+	zassert_equal(k_event_get(&event), EV_C, NULL);
+	zassert_equal(order_len, 1, NULL);
+	zassert_equal(matched[0], EV_C, NULL);
+}
+
+void test_event_timeout(void)
+{
+	setup();
+
+	k_event_post(&event, EV_A);
+
+	/**TESTPOINT: an unsatisfied wait times out */
+	zassert_equal(k_event_wait(&event, EV_B, K_EVENT_WAIT_ANY, TIMEOUT),
+		      0, NULL);
+	zassert_equal(k_event_wait(&event, EV_A | EV_B, K_EVENT_WAIT_ALL,
+				   TIMEOUT), 0, NULL);
+	zassert_equal(k_event_get(&event), EV_A, NULL);
+}
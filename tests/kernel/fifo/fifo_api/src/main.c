@@ -20,6 +20,8 @@ extern void test_fifo_loop(void);
 extern void test_fifo_cancel_wait(void);
 extern void test_fifo_is_empty_thread(void);
 extern void test_fifo_is_empty_isr(void);
+extern void test_fifo_get_batch(void);
+extern void test_fifo_get_all_wait(void);
 
 /*test case main entry*/
 void test_main(void)
@@ -32,6 +34,8 @@ void test_main(void)
 			 ztest_unit_test(test_fifo_loop),
 			 ztest_unit_test(test_fifo_cancel_wait),
 			 ztest_unit_test(test_fifo_is_empty_thread),
-			 ztest_unit_test(test_fifo_is_empty_isr));
+			 ztest_unit_test(test_fifo_is_empty_isr),
+			 ztest_unit_test(test_fifo_get_batch),
+			 ztest_unit_test(test_fifo_get_all_wait));
 	ztest_run_test_suite(test_fifo_api);
 }
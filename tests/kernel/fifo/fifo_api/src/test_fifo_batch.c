@@ -0,0 +1,101 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "test_fifo.h"
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define LIST_LEN 8
+#define BATCH 3
+
+static struct k_fifo fifo;
+static fdata_t data[LIST_LEN];
+
+static K_THREAD_STACK_DEFINE(tstack, STACK_SIZE);
+static struct k_thread thread;
+
+static void put_all(void)
+{
+	sys_slist_t list;
+	int i;
+
+	sys_slist_init(&list);
+	for (i = 0; i < LIST_LEN; i++) {
+		data[i].data = i;
+		sys_slist_append(&list, &data[i].snode);
+	}
+
+	k_fifo_put_slist(&fifo, &list);
+}
+
+static void check_list(sys_slist_t *list, int first, int count)
+{
+	fdata_t *rx;
+	int i = first;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(list, rx, snode) {
+		zassert_equal(rx->data, i, "data out of order");
+		i++;
+	}
+
+	zassert_equal(i - first, count, "wrong list length");
+}
+
+static void t_put_entry(void *p1, void *p2, void *p3)
+{
+	k_sleep(50);
+	put_all();
+}
+
+/*test cases*/
+void test_fifo_get_batch(void)
+{
+	sys_slist_t list;
+	int n, i;
+
+	k_fifo_init(&fifo);
+	sys_slist_init(&list);
+
+	/**TESTPOINT: nothing to take without waiting*/
+	zassert_equal(k_fifo_get_batch(&fifo, &list, BATCH, K_NO_WAIT), 0,
+		      NULL);
+	zassert_true(sys_slist_is_empty(&list), NULL);
+
+	/**TESTPOINT: batches keep their order and respect max*/
+	put_all();
+	for (i = 0; i < LIST_LEN; i += n) {
+		sys_slist_init(&list);
+		n = k_fifo_get_batch(&fifo, &list, BATCH, K_NO_WAIT);
+		zassert_equal(n, min(BATCH, LIST_LEN - i), "wrong batch size");
+		check_list(&list, i, n);
+	}
+
+	zassert_true(k_fifo_is_empty(&fifo), NULL);
+
+	/**TESTPOINT: get_all appends to a non-empty list*/
+	put_all();
+	sys_slist_init(&list);
+	zassert_equal(k_fifo_get_batch(&fifo, &list, 1, K_NO_WAIT), 1, NULL);
+	zassert_equal(k_fifo_get_all(&fifo, &list, K_NO_WAIT), LIST_LEN - 1,
+		      NULL);
+	check_list(&list, 0, LIST_LEN);
+	zassert_true(k_fifo_is_empty(&fifo), NULL);
+}
+
+void test_fifo_get_all_wait(void)
+{
+	sys_slist_t list;
+	k_tid_t tid;
+
+	k_fifo_init(&fifo);
+	sys_slist_init(&list);
+
+	tid = k_thread_create(&thread, tstack, STACK_SIZE, t_put_entry,
+			      NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, 0);
+
+	/**TESTPOINT: a waiter gets the whole list appended at once*/
+	zassert_equal(k_fifo_get_all(&fifo, &list, 500), LIST_LEN, NULL);
+	check_list(&list, 0, LIST_LEN);
+
+	k_thread_abort(tid);
+}
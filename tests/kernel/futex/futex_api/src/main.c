@@ -0,0 +1,29 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_futex
+ * @{
+ * @defgroup t_futex_api test_futex_api
+ * @}
+ */
+
+#include <ztest.h>
+
+extern void test_futex_wait_value(void);
+extern void test_futex_wake(void);
+extern void test_futex_wake_all(void);
+extern void test_futex_mutex(void);
+
+/*test case main entry*/
+void test_main(void)
+{
+	ztest_test_suite(test_futex_api,
+			 ztest_unit_test(test_futex_wait_value),
+			 ztest_unit_test(test_futex_wake),
+			 ztest_unit_test(test_futex_wake_all),
+			 ztest_unit_test(test_futex_mutex)
+			 );
+	ztest_run_test_suite(test_futex_api);
+}
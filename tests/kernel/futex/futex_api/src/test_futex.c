@@ -0,0 +1,137 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_futex_api
+ * @{
+ * @defgroup t_futex_wait test_futex_wait
+ * @brief TestPurpose: verify futex wait/wake and the futex mutex
+ * - API coverage
+ *   -# k_futex_wait k_futex_wake
+ *   -# sys_futex_mutex_lock sys_futex_mutex_unlock
+ * @}
+ */
+
+#include <ztest.h>
+#include <misc/futex_mutex.h>
+#include <string.h>
+
+#define STACK_SIZE 1024
+#define NUM_THREADS 3
+#define MAIN_PRIO K_PRIO_PREEMPT(5)
+#define TIMEOUT 50
+#define LOOPS 100
+
+/* Far enough apart to share a wait queue in the kernel */
+static atomic_t futex[9];
+
+static K_THREAD_STACK_ARRAY_DEFINE(tstack, NUM_THREADS, STACK_SIZE);
+static struct k_thread tdata[NUM_THREADS];
+
+static int order[NUM_THREADS];
+static int order_len;
+
+SYS_FUTEX_MUTEX_DEFINE(fmutex);
+static int counter;
+
+static void twait_entry(void *p1, void *p2, void *p3)
+{
+	zassert_false(k_futex_wait(p1, 0, K_FOREVER), NULL);
+	order[order_len++] = (int)p2;
+}
+
+static void tcount_entry(void *p1, void *p2, void *p3)
+{
+	int i, val;
+
+	for (i = 0; i < LOOPS; i++) {
+		zassert_false(sys_futex_mutex_lock(&fmutex, K_FOREVER), NULL);
+		val = counter;
+		/* let the other thread run into the held mutex */
+		k_yield();
+		counter = val + 1;
+		sys_futex_mutex_unlock(&fmutex);
+	}
+}
+
+static void spawn(int id, k_thread_entry_t entry, void *arg, int prio)
+{
+	k_thread_create(&tdata[id], tstack[id], STACK_SIZE, entry,
+			arg, (void *)id, NULL, prio, 0, 0);
+}
+
+static void setup(void)
+{
+	k_thread_priority_set(k_current_get(), MAIN_PRIO);
+	memset(futex, 0, sizeof(futex));
+	order_len = 0;
+}
+
+/*test cases*/
+void test_futex_wait_value(void)
+{
+	setup();
+
+	atomic_set(&futex[0], 1);
+
+	/**TESTPOINT: no wait unless the futex holds the expected value */
+	zassert_equal(k_futex_wait(&futex[0], 0, K_FOREVER), -EAGAIN, NULL);
+	zassert_equal(k_futex_wait(&futex[0], 1, K_NO_WAIT), -ETIMEDOUT,
+		      NULL);
+	zassert_equal(k_futex_wait(&futex[0], 1, TIMEOUT), -ETIMEDOUT, NULL);
+	zassert_equal(k_futex_wake(&futex[0], 0), 0, NULL);
+}
+
+void test_futex_wake(void)
+{
+	setup();
+
+	spawn(0, twait_entry, &futex[0], K_PRIO_PREEMPT(3));
+	spawn(1, twait_entry, &futex[0], K_PRIO_PREEMPT(2));
+	spawn(2, twait_entry, &futex[8], K_PRIO_PREEMPT(1));
+
+	/**TESTPOINT: waiters of a futex are woken by priority */
+	zassert_equal(k_futex_wake(&futex[0], 0), 1, NULL);
+	zassert_equal(order_len, 1, NULL);
+	zassert_equal(order[0], 1, NULL);
+	zassert_equal(k_futex_wake(&futex[0], 0), 1, NULL);
+	zassert_equal(order[1], 0, NULL);
+
+	/**TESTPOINT: waiters of another futex are left alone */
+	zassert_equal(k_futex_wake(&futex[0], 0), 0, NULL);
+	zassert_equal(order_len, 2, NULL);
+	zassert_equal(k_futex_wake(&futex[8], 0), 1, NULL);
+	zassert_equal(order[2], 2, NULL);
+}
+
+void test_futex_wake_all(void)
+{
+	int i;
+
+	setup();
+
+	for (i = 0; i < NUM_THREADS; i++) {
+		spawn(i, twait_entry, &futex[1], K_PRIO_PREEMPT(3));
+	}
+
+	/**TESTPOINT: all the waiters of a futex are woken at once */
+	zassert_equal(k_futex_wake(&futex[1], 1), NUM_THREADS, NULL);
+	zassert_equal(order_len, NUM_THREADS, NULL);
+}
+
+void test_futex_mutex(void)
+{
+	setup();
+
+	/**TESTPOINT: the futex mutex excludes contending threads */
+	spawn(0, tcount_entry, NULL, K_PRIO_PREEMPT(6));
+	spawn(1, tcount_entry, NULL, K_PRIO_PREEMPT(6));
+	k_sleep(TIMEOUT);
+	zassert_equal(counter, 2 * LOOPS, NULL);
+
+	zassert_false(sys_futex_mutex_lock(&fmutex, K_NO_WAIT), NULL);
+	zassert_equal(sys_futex_mutex_lock(&fmutex, K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(sys_futex_mutex_lock(&fmutex, TIMEOUT), -EAGAIN, NULL);
+	sys_futex_mutex_unlock(&fmutex);
+}
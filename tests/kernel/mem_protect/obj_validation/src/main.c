@@ -15,6 +15,7 @@ K_SEM_DEFINE(sem1, 0, 1);
 static __kernel struct k_sem sem2;
 static __kernel char bad_sem[sizeof(struct k_sem)];
 static struct k_sem sem3;
+static __kernel struct k_sem sem4;
 
 static int test_object(struct k_sem *sem, int retval)
 {
@@ -78,9 +79,55 @@ void test_generic_object(void)
 	}
 }
 
+void test_validation_cache(void)
+{
+	k_object_access_grant(&sem4, k_current_get());
+	k_sem_init(&sem4, 0, 1);
+
+	zassert_false(_k_object_check(&sem4, K_OBJ_SEM, _OBJ_INIT_TRUE),
+		      "first check failed");
+	zassert_false(_k_object_check(&sem4, K_OBJ_SEM, _OBJ_INIT_TRUE),
+		      "repeated check failed");
+	zassert_equal(_k_object_check(&sem4, K_OBJ_MUTEX, _OBJ_INIT_TRUE),
+		      -EBADF, "type not checked on a repeated check");
+
+	/* Losing the permission must not be hidden by a cached check */
+	zassert_false(_k_object_check(&sem4, K_OBJ_SEM, _OBJ_INIT_TRUE),
+		      NULL);
+	k_object_access_revoke(&sem4, k_current_get());
+	zassert_equal(_k_object_check(&sem4, K_OBJ_SEM, _OBJ_INIT_TRUE),
+		      -EPERM, "revoked permission still cached");
+}
+
+void test_dynamic_object(void)
+{
+	struct k_sem *sem;
+
+	zassert_is_null(k_object_alloc(K_OBJ_THREAD),
+			"threads can not be allocated");
+
+	sem = k_object_alloc(K_OBJ_SEM);
+	zassert_not_null(sem, "allocation failed");
+
+	/* The allocating thread has access, but it is not initialized */
+	zassert_false(test_object(sem, -EINVAL), NULL);
+	k_sem_init(sem, 0, 1);
+	zassert_false(test_object(sem, 0), NULL);
+
+	k_object_access_revoke(sem, k_current_get());
+	zassert_false(test_object(sem, -EPERM), NULL);
+	k_object_access_grant(sem, k_current_get());
+	zassert_false(test_object(sem, 0), NULL);
+
+	k_object_free(sem);
+	zassert_false(test_object(sem, -EBADF), "freed object still found");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(object_validation,
-			 ztest_unit_test(test_generic_object));
+			 ztest_unit_test(test_generic_object),
+			 ztest_unit_test(test_validation_cache),
+			 ztest_unit_test(test_dynamic_object));
 	ztest_run_test_suite(object_validation);
 }
@@ -17,6 +17,9 @@ extern void test_msgq_isr(void);
 extern void test_msgq_put_fail(void);
 extern void test_msgq_get_fail(void);
 extern void test_msgq_purge_when_put(void);
+extern void test_msgq_alloc_commit(void);
+extern void test_msgq_claim_two(void);
+extern void test_msgq_varlen(void);
 
 extern struct k_msgq kmsgq;
 extern struct k_msgq msgq;
@@ -35,6 +38,9 @@ void test_main(void)
 			 ztest_unit_test(test_msgq_isr),
 			 ztest_user_unit_test(test_msgq_put_fail),
 			 ztest_user_unit_test(test_msgq_get_fail),
-			 ztest_user_unit_test(test_msgq_purge_when_put));
+			 ztest_user_unit_test(test_msgq_purge_when_put),
+			 ztest_unit_test(test_msgq_alloc_commit),
+			 ztest_unit_test(test_msgq_claim_two),
+			 ztest_unit_test(test_msgq_varlen));
 	ztest_run_test_suite(test_msgq_api);
 }
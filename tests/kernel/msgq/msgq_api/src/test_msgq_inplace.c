@@ -0,0 +1,213 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_msgq_api
+ * @{
+ * @defgroup t_msgq_inplace test_msgq_inplace
+ * @brief TestPurpose: verify in-place and variable-length msgq messages
+ * @}
+ */
+
+#include "test_msgq.h"
+
+#define VARLEN_SIZE 32
+
+K_MSGQ_DEFINE(inplace_msgq, MSG_SIZE, MSGQ_LEN, 4);
+K_MSGQ_VARLEN_DEFINE(varlen_msgq, VARLEN_SIZE);
+
+static K_THREAD_STACK_DEFINE(inplace_stack, STACK_SIZE);
+static struct k_thread inplace_thread;
+static K_THREAD_STACK_DEFINE(claimer_stack, STACK_SIZE);
+static struct k_thread claimer_thread;
+
+K_SEM_DEFINE(release_sema, 0, 2);
+static u32_t claimed_msg[2];
+static int release_rc[2];
+
+static void claim_entry(void *p1, void *p2, void *p3)
+{
+	struct k_msgq *q = p1;
+	u32_t *msg;
+	size_t len;
+
+	/**TESTPOINT: a blocked claim is granted by the commit */
+	zassert_false(k_msgq_peek_claim(q, (void **)&msg, &len, K_FOREVER),
+		      NULL);
+	zassert_equal(len, MSG_SIZE, NULL);
+	zassert_equal(*msg, MSG1, NULL);
+	zassert_false(k_msgq_release(q), NULL);
+}
+
+static void claimer_entry(void *p1, void *p2, void *p3)
+{
+	int id = POINTER_TO_INT(p2);
+	u32_t *msg;
+	size_t len;
+
+	zassert_false(k_msgq_peek_claim(p1, (void **)&msg, &len, K_FOREVER),
+		      NULL);
+	claimed_msg[id] = *msg;
+
+	k_sem_take(&release_sema, K_FOREVER);
+	release_rc[id] = k_msgq_release(p1);
+}
+
+void test_msgq_alloc_commit(void)
+{
+	u32_t *msg, *first;
+	u32_t rx_data;
+	size_t len;
+
+	zassert_false(k_msgq_alloc(&inplace_msgq, (void **)&msg, MSG_SIZE),
+		      NULL);
+	/**TESTPOINT: one allocation at a time, put blocked behind it */
+	zassert_equal(k_msgq_alloc(&inplace_msgq, (void **)&first, MSG_SIZE),
+		      -EBUSY, NULL);
+	rx_data = MSG1;
+	zassert_equal(k_msgq_put(&inplace_msgq, &rx_data, K_NO_WAIT), -EBUSY,
+		      NULL);
+	zassert_equal(k_msgq_num_used_get(&inplace_msgq), 0, NULL);
+	*msg = MSG0;
+	zassert_false(k_msgq_commit(&inplace_msgq, MSG_SIZE), NULL);
+	first = msg;
+
+	/**TESTPOINT: a zero length commit discards the allocation */
+	zassert_false(k_msgq_alloc(&inplace_msgq, (void **)&msg, MSG_SIZE),
+		      NULL);
+	zassert_false(k_msgq_commit(&inplace_msgq, 0), NULL);
+	zassert_equal(k_msgq_commit(&inplace_msgq, MSG_SIZE), -EINVAL, NULL);
+
+	zassert_false(k_msgq_alloc(&inplace_msgq, (void **)&msg, MSG_SIZE),
+		      NULL);
+	*msg = MSG1;
+	zassert_false(k_msgq_commit(&inplace_msgq, MSG_SIZE), NULL);
+	zassert_equal(k_msgq_alloc(&inplace_msgq, (void **)&msg, MSG_SIZE),
+		      -ENOMSG, NULL);
+
+	/**TESTPOINT: the claimed message is the one written in place */
+	zassert_false(k_msgq_peek_claim(&inplace_msgq, (void **)&msg, &len,
+					K_NO_WAIT), NULL);
+	zassert_equal(msg, first, NULL);
+	zassert_equal(*msg, MSG0, NULL);
+	zassert_equal(k_msgq_get(&inplace_msgq, &rx_data, K_NO_WAIT), -EBUSY,
+		      NULL);
+	zassert_false(k_msgq_release(&inplace_msgq), NULL);
+	zassert_equal(k_msgq_release(&inplace_msgq), -EINVAL, NULL);
+
+	zassert_false(k_msgq_get(&inplace_msgq, &rx_data, K_NO_WAIT), NULL);
+	zassert_equal(rx_data, MSG1, NULL);
+
+	k_thread_create(&inplace_thread, inplace_stack, STACK_SIZE,
+			claim_entry, &inplace_msgq, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(TIMEOUT);
+
+	zassert_false(k_msgq_alloc(&inplace_msgq, (void **)&msg, MSG_SIZE),
+		      NULL);
+	*msg = MSG1;
+	zassert_false(k_msgq_commit(&inplace_msgq, MSG_SIZE), NULL);
+	k_sleep(TIMEOUT);
+
+	zassert_equal(k_msgq_num_used_get(&inplace_msgq), 0, NULL);
+	k_thread_abort(&inplace_thread);
+}
+
+void test_msgq_claim_two(void)
+{
+	u32_t data;
+
+	claimed_msg[0] = claimed_msg[1] = 0;
+	release_rc[0] = release_rc[1] = -1;
+	k_msgq_purge(&inplace_msgq);
+
+	k_thread_create(&inplace_thread, inplace_stack, STACK_SIZE,
+			claimer_entry, &inplace_msgq, INT_TO_POINTER(0), NULL,
+			K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(TIMEOUT);
+	k_thread_create(&claimer_thread, claimer_stack, STACK_SIZE,
+			claimer_entry, &inplace_msgq, INT_TO_POINTER(1), NULL,
+			K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(TIMEOUT);
+
+	/**TESTPOINT: only one of two blocked claimers gets the claim */
+	data = MSG0;
+	zassert_false(k_msgq_put(&inplace_msgq, &data, K_NO_WAIT), NULL);
+	data = MSG1;
+	zassert_false(k_msgq_put(&inplace_msgq, &data, K_NO_WAIT), NULL);
+	k_sleep(TIMEOUT);
+	zassert_equal(claimed_msg[0], MSG0, NULL);
+	zassert_equal(claimed_msg[1], 0, "second claim on a claimed queue");
+	zassert_equal(k_msgq_num_used_get(&inplace_msgq), 2, NULL);
+
+	/**TESTPOINT: the release hands the next message to the other one */
+	k_sem_give(&release_sema);
+	k_sleep(TIMEOUT);
+	zassert_equal(release_rc[0], 0, NULL);
+	zassert_equal(claimed_msg[1], MSG1, NULL);
+	zassert_equal(k_msgq_num_used_get(&inplace_msgq), 1, NULL);
+
+	k_sem_give(&release_sema);
+	k_sleep(TIMEOUT);
+	zassert_equal(release_rc[1], 0, NULL);
+	zassert_equal(k_msgq_num_used_get(&inplace_msgq), 0, NULL);
+
+	k_thread_abort(&inplace_thread);
+	k_thread_abort(&claimer_thread);
+}
+
+static void varlen_send(size_t size, size_t len, u8_t fill)
+{
+	u8_t *msg;
+
+	zassert_false(k_msgq_alloc(&varlen_msgq, (void **)&msg, size), NULL);
+	memset(msg, fill, len);
+	zassert_false(k_msgq_commit(&varlen_msgq, len), NULL);
+}
+
+static void varlen_receive(size_t len, u8_t fill)
+{
+	u8_t *msg;
+	size_t rx_len, i;
+
+	zassert_false(k_msgq_peek_claim(&varlen_msgq, (void **)&msg, &rx_len,
+					K_NO_WAIT), NULL);
+	zassert_equal(rx_len, len, NULL);
+	zassert_equal((uintptr_t)msg & 3, 0, "unaligned message");
+	for (i = 0; i < len; i++) {
+		zassert_equal(msg[i], fill, NULL);
+	}
+	zassert_false(k_msgq_release(&varlen_msgq), NULL);
+}
+
+void test_msgq_varlen(void)
+{
+	u8_t *msg;
+	u32_t rx_data;
+	size_t len;
+
+	/**TESTPOINT: copying APIs are rejected */
+	zassert_equal(k_msgq_get(&varlen_msgq, &rx_data, K_NO_WAIT), -EINVAL,
+		      NULL);
+	zassert_equal(k_msgq_alloc(&varlen_msgq, (void **)&msg,
+				   VARLEN_SIZE), -EINVAL, NULL);
+
+	/**TESTPOINT: a short commit gives the rest of the allocation back */
+	varlen_send(VARLEN_SIZE - 4, 5, 'a');
+	varlen_send(8, 8, 'b');
+	zassert_equal(k_msgq_alloc(&varlen_msgq, (void **)&msg, 12), -ENOMSG,
+		      NULL);
+	varlen_send(4, 1, 'c');
+	zassert_equal(k_msgq_num_used_get(&varlen_msgq), 3, NULL);
+
+	/**TESTPOINT: a message that does not fit at the end wraps */
+	varlen_receive(5, 'a');
+	varlen_send(6, 6, 'd');
+	varlen_receive(8, 'b');
+	varlen_receive(1, 'c');
+	varlen_receive(6, 'd');
+
+	zassert_equal(k_msgq_peek_claim(&varlen_msgq, (void **)&msg, &len,
+					K_NO_WAIT), -ENOMSG, NULL);
+}
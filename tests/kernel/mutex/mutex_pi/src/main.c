@@ -0,0 +1,29 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_mutex
+ * @{
+ * @defgroup t_mutex_pi test_mutex_pi
+ * @}
+ */
+
+#include <ztest.h>
+
+extern void test_mutex_pi_chain(void);
+extern void test_mutex_pi_unordered_release(void);
+extern void test_mutex_ceiling(void);
+extern void test_mutex_inversion_stats(void);
+
+/*test case main entry*/
+void test_main(void)
+{
+	ztest_test_suite(test_mutex_pi,
+			 ztest_unit_test(test_mutex_pi_chain),
+			 ztest_unit_test(test_mutex_pi_unordered_release),
+			 ztest_unit_test(test_mutex_ceiling),
+			 ztest_unit_test(test_mutex_inversion_stats)
+			 );
+	ztest_run_test_suite(test_mutex_pi);
+}
@@ -0,0 +1,210 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_mutex_pi
+ * @{
+ * @defgroup t_mutex_pi_api test_mutex_pi_api
+ * @brief TestPurpose: verify mutex priority inheritance and ceilings
+ * - API coverage
+ *   -# k_mutex_lock k_mutex_unlock
+ *   -# k_mutex_ceiling_set
+ *   -# k_mutex_inversion_stats_get
+ * @}
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE 1024
+#define CHAIN_LEN 5
+#define LOW_PRIO K_PRIO_PREEMPT(10)
+
+static K_THREAD_STACK_ARRAY_DEFINE(tstack, CHAIN_LEN, STACK_SIZE);
+static struct k_thread tdata[CHAIN_LEN];
+
+static struct k_mutex chain[CHAIN_LEN];
+static int prio_after_release[CHAIN_LEN];
+static u32_t release_start, release_end;
+
+/*
+ * Link @a n of the chain owns chain[n] and waits for chain[n - 1], which
+ * the previous link owns. Releasing its own mutex first, before the one it
+ * waited for, is the opposite of nested order.
+ */
+static void tlink_entry(void *p1, void *p2, void *p3)
+{
+	int n = (int)p1;
+
+	k_mutex_lock(&chain[n], K_FOREVER);
+	k_mutex_lock(&chain[n - 1], K_FOREVER);
+
+	k_mutex_unlock(&chain[n]);
+	prio_after_release[n] = k_thread_priority_get(k_current_get());
+	k_mutex_unlock(&chain[n - 1]);
+}
+
+/* The head of the chain only waits */
+static void thead_entry(void *p1, void *p2, void *p3)
+{
+	int n = (int)p1;
+
+	k_mutex_lock(&chain[n - 1], K_FOREVER);
+	release_end = k_cycle_get_32();
+	k_mutex_unlock(&chain[n - 1]);
+}
+
+static void tlock_entry(void *p1, void *p2, void *p3)
+{
+	k_mutex_lock((struct k_mutex *)p1, K_FOREVER);
+	k_mutex_unlock((struct k_mutex *)p1);
+}
+
+static void spawn(int n, k_thread_entry_t entry, void *arg, int prio)
+{
+	k_thread_create(&tdata[n], tstack[n], STACK_SIZE, entry,
+			arg, NULL, NULL, prio, 0, 0);
+}
+
+/*test cases*/
+void test_mutex_pi_chain(void)
+{
+	int i, j;
+
+	k_thread_priority_set(k_current_get(), LOW_PRIO);
+
+	for (i = 0; i < CHAIN_LEN; i++) {
+		k_mutex_init(&chain[i]);
+	}
+
+	k_mutex_lock(&chain[0], K_FOREVER);
+
+	/* Each new link runs right away and blocks behind the previous one */
+	for (i = 1; i < CHAIN_LEN; i++) {
+		spawn(i, i == CHAIN_LEN - 1 ? thead_entry : tlink_entry,
+		      (void *)i, LOW_PRIO - i);
+
+		/**TESTPOINT: the boost reaches every owner down the chain */
+		zassert_equal(k_thread_priority_get(k_current_get()),
+			      LOW_PRIO - i, NULL);
+		for (j = 1; j < i; j++) {
+			zassert_equal(k_thread_priority_get(&tdata[j]),
+				      LOW_PRIO - i, NULL);
+		}
+	}
+
+	release_start = k_cycle_get_32();
+	k_mutex_unlock(&chain[0]);
+
+	/* Every other thread has a higher priority and ran to completion */
+	TC_PRINT("chain of %d released in %u cycles\n", CHAIN_LEN,
+		 release_end - release_start);
+
+	/**TESTPOINT: unordered release restores the unboosted priority */
+	zassert_equal(k_thread_priority_get(k_current_get()), LOW_PRIO, NULL);
+	for (i = 1; i < CHAIN_LEN - 1; i++) {
+		zassert_equal(prio_after_release[i], LOW_PRIO - i, NULL);
+	}
+}
+
+void test_mutex_pi_unordered_release(void)
+{
+	struct k_mutex a, b;
+
+	k_thread_priority_set(k_current_get(), LOW_PRIO);
+
+	k_mutex_init(&a);
+	k_mutex_init(&b);
+
+	k_mutex_lock(&a, K_FOREVER);
+	k_mutex_lock(&b, K_FOREVER);
+
+	spawn(0, tlock_entry, &a, K_PRIO_PREEMPT(5));
+	spawn(1, tlock_entry, &b, K_PRIO_PREEMPT(3));
+	zassert_equal(k_thread_priority_get(k_current_get()),
+		      K_PRIO_PREEMPT(3), NULL);
+
+	/**TESTPOINT: b still boosts its owner after a is released first */
+	k_mutex_unlock(&a);
+	zassert_equal(k_thread_priority_get(k_current_get()),
+		      K_PRIO_PREEMPT(3), NULL);
+
+	k_mutex_unlock(&b);
+	zassert_equal(k_thread_priority_get(k_current_get()), LOW_PRIO, NULL);
+}
+
+void test_mutex_ceiling(void)
+{
+	struct k_mutex ceil, plain;
+
+	k_thread_priority_set(k_current_get(), LOW_PRIO);
+
+	k_mutex_init(&ceil);
+	k_mutex_init(&plain);
+
+	zassert_false(k_mutex_ceiling_set(&ceil, K_PRIO_PREEMPT(2)), NULL);
+
+	/**TESTPOINT: the owner of a mutex runs at least at its ceiling */
+	k_mutex_lock(&ceil, K_FOREVER);
+	zassert_equal(k_thread_priority_get(k_current_get()),
+		      K_PRIO_PREEMPT(2), NULL);
+	zassert_equal(k_mutex_ceiling_set(&ceil, K_PRIO_PREEMPT(1)), -EBUSY,
+		      NULL);
+
+	/**TESTPOINT: a lower priority waiter does not lower the ceiling */
+	k_mutex_lock(&plain, K_FOREVER);
+	spawn(0, tlock_entry, &plain, K_PRIO_PREEMPT(6));
+	zassert_equal(k_thread_priority_get(k_current_get()),
+		      K_PRIO_PREEMPT(2), NULL);
+
+	k_mutex_unlock(&ceil);
+	zassert_equal(k_thread_priority_get(k_current_get()),
+		      K_PRIO_PREEMPT(6), NULL);
+
+	k_mutex_unlock(&plain);
+	zassert_equal(k_thread_priority_get(k_current_get()), LOW_PRIO, NULL);
+
+	zassert_false(k_mutex_ceiling_set(&ceil, K_LOWEST_THREAD_PRIO), NULL);
+	k_mutex_lock(&ceil, K_FOREVER);
+	zassert_equal(k_thread_priority_get(k_current_get()), LOW_PRIO, NULL);
+	k_mutex_unlock(&ceil);
+}
+
+void test_mutex_inversion_stats(void)
+{
+	struct k_mutex_inversion_stats stats;
+	struct k_mutex m;
+
+	k_thread_priority_set(k_current_get(), LOW_PRIO);
+
+	k_mutex_init(&m);
+
+	zassert_false(k_mutex_inversion_stats_get(&m, &stats), NULL);
+	zassert_equal(stats.count, 0, NULL);
+
+	/* A waiter at a lower priority is no inversion */
+	k_mutex_lock(&m, K_FOREVER);
+	spawn(0, tlock_entry, &m, LOW_PRIO + 1);
+	k_sleep(10);
+	k_mutex_unlock(&m);
+	k_sleep(10);
+
+	k_mutex_inversion_stats_get(&m, &stats);
+	zassert_equal(stats.count, 0, NULL);
+
+	/**TESTPOINT: an inversion in progress is accounted for */
+	k_mutex_lock(&m, K_FOREVER);
+	spawn(0, tlock_entry, &m, K_PRIO_PREEMPT(5));
+	k_busy_wait(1000);
+
+	k_mutex_inversion_stats_get(&m, &stats);
+	zassert_equal(stats.count, 1, NULL);
+	zassert_true(stats.max_cycles > 0, NULL);
+	zassert_equal(stats.total_cycles, stats.max_cycles, NULL);
+
+	/**TESTPOINT: the inversion ends when the owner releases the mutex */
+	k_mutex_unlock(&m);
+	k_mutex_inversion_stats_get(&m, &stats);
+	zassert_equal(stats.count, 1, NULL);
+	zassert_true(stats.max_cycles > 0, NULL);
+}
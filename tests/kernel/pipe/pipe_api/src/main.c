@@ -18,6 +18,7 @@ extern void test_pipe_get_fail(void);
 extern void test_pipe_block_put(void);
 extern void test_pipe_block_put_sema(void);
 extern void test_pipe_get_put(void);
+extern void test_pipe_window(void);
 
 /*test case main entry*/
 void test_main(void)
@@ -28,6 +29,7 @@ void test_main(void)
 			 ztest_unit_test(test_pipe_get_fail),
 			 ztest_unit_test(test_pipe_block_put),
 			 ztest_unit_test(test_pipe_block_put_sema),
-			 ztest_unit_test(test_pipe_get_put));
+			 ztest_unit_test(test_pipe_get_put),
+			 ztest_unit_test(test_pipe_window));
 	ztest_run_test_suite(test_pipe_api);
 }
@@ -0,0 +1,116 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_pipe_api
+ * @{
+ * @defgroup t_pipe_window test_pipe_window
+ * @brief TestPurpose: verify in-place access to the pipe ring buffer
+ * - API coverage
+ *   -# k_pipe_put_window k_pipe_put_commit
+ *   -# k_pipe_get_window k_pipe_get_release
+ * @}
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE 1024
+#define PIPE_LEN 16
+#define CHUNK 6
+
+static const unsigned char pattern[] = "0123456789abcdefghijklmnopqrstuv";
+
+K_PIPE_DEFINE(wpipe, PIPE_LEN, 4);
+
+static K_THREAD_STACK_DEFINE(wstack, STACK_SIZE);
+static struct k_thread wdata;
+
+static void reader_entry(void *p1, void *p2, void *p3)
+{
+	unsigned char rx[CHUNK];
+	size_t rd_byte;
+
+	/**TESTPOINT: a blocked reader is served by a commit */
+	zassert_false(k_pipe_get(&wpipe, rx, CHUNK, &rd_byte, CHUNK,
+				 K_FOREVER), NULL);
+	zassert_equal(rd_byte, CHUNK, NULL);
+	zassert_true(memcmp(rx, pattern, CHUNK) == 0, NULL);
+}
+
+static void writer_entry(void *p1, void *p2, void *p3)
+{
+	size_t wt_byte;
+
+	/**TESTPOINT: a blocked writer is served by a release */
+	zassert_false(k_pipe_put(&wpipe, (void *)pattern, CHUNK, &wt_byte,
+				 CHUNK, K_FOREVER), NULL);
+	zassert_equal(wt_byte, CHUNK, NULL);
+}
+
+void test_pipe_window(void)
+{
+	unsigned char rx[PIPE_LEN];
+	unsigned char *win;
+	size_t len, wt_byte, rd_byte;
+
+	/* Leave the indices in the middle of the ring buffer */
+	zassert_false(k_pipe_put(&wpipe, (void *)pattern, CHUNK, &wt_byte,
+				 CHUNK, K_NO_WAIT), NULL);
+	zassert_false(k_pipe_get(&wpipe, rx, CHUNK, &rd_byte, CHUNK,
+				 K_NO_WAIT), NULL);
+
+	/**TESTPOINT: a write window stops at the end of the ring buffer */
+	len = k_pipe_put_window(&wpipe, (void **)&win);
+	zassert_equal(len, PIPE_LEN - CHUNK, NULL);
+	memcpy(win, pattern, len);
+	zassert_equal(k_pipe_put_commit(&wpipe, len + 1), -EINVAL, NULL);
+	zassert_false(k_pipe_put_commit(&wpipe, len), NULL);
+
+	len = k_pipe_put_window(&wpipe, (void **)&win);
+	zassert_equal(len, CHUNK, NULL);
+	memcpy(win, pattern + PIPE_LEN - CHUNK, len);
+	zassert_false(k_pipe_put_commit(&wpipe, len), NULL);
+	zassert_equal(k_pipe_put_window(&wpipe, (void **)&win), 0, NULL);
+
+	k_thread_create(&wdata, wstack, STACK_SIZE, writer_entry,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(100);
+
+	/**TESTPOINT: read windows see the data in order */
+	len = k_pipe_get_window(&wpipe, (void **)&win);
+	zassert_equal(len, PIPE_LEN - CHUNK, NULL);
+	zassert_true(memcmp(win, pattern, len) == 0, NULL);
+	zassert_equal(k_pipe_get_release(&wpipe, len + 1), -EINVAL, NULL);
+	zassert_false(k_pipe_get_release(&wpipe, len), NULL);
+	k_sleep(100);
+
+	len = k_pipe_get_window(&wpipe, (void **)&win);
+	zassert_equal(len, CHUNK * 2, NULL);
+	zassert_true(memcmp(win, pattern + PIPE_LEN - CHUNK, CHUNK) == 0,
+		     NULL);
+	zassert_true(memcmp(win + CHUNK, pattern, CHUNK) == 0, NULL);
+	zassert_false(k_pipe_get_release(&wpipe, CHUNK * 2), NULL);
+	zassert_equal(k_pipe_get_window(&wpipe, (void **)&win), 0, NULL);
+	k_thread_abort(&wdata);
+
+	k_thread_create(&wdata, wstack, STACK_SIZE, reader_entry,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(100);
+
+	/* The reader takes what is there and keeps waiting for the rest */
+	len = k_pipe_put_window(&wpipe, (void **)&win);
+	zassert_equal(len, PIPE_LEN - CHUNK * 2, NULL);
+	memcpy(win, pattern, len);
+	zassert_false(k_pipe_put_commit(&wpipe, len), NULL);
+	zassert_equal(k_pipe_get_window(&wpipe, (void **)&win), 0, NULL);
+
+	zassert_equal(k_pipe_put_window(&wpipe, (void **)&win), PIPE_LEN,
+		      NULL);
+	memcpy(win, pattern + len, CHUNK - len);
+	zassert_false(k_pipe_put_commit(&wpipe, CHUNK - len), NULL);
+	k_sleep(100);
+
+	zassert_equal(k_pipe_get_window(&wpipe, (void **)&win), 0, NULL);
+	k_thread_abort(&wdata);
+}
@@ -0,0 +1,219 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_poll_api
+ * @{
+ * @defgroup t_poll_api_set test_poll_api_set
+ * @brief TestPurpose: verify polling of more kernel objects and poll sets
+ * - API coverage
+ *   -# k_poll on message queues, pipes, mutexes and timers
+ *   -# k_poll_set_init k_poll_set_wait k_poll_set_cleanup
+ *   -# a poll set and k_poll sharing an object
+ * @}
+ */
+
+#include <ztest.h>
+#include <kernel.h>
+
+#define STACK_SIZE 1024
+#define MAIN_PRIO K_PRIO_PREEMPT(5)
+#define SLEEP 50
+#define MSG_VALUE 0x600dcafe
+#define LOOPS 5
+
+K_MSGQ_DEFINE(poll_msgq, sizeof(u32_t), 4, 4);
+K_PIPE_DEFINE(poll_pipe, 16, 4);
+K_MUTEX_DEFINE(poll_mutex);
+K_TIMER_DEFINE(poll_timer, NULL, NULL);
+K_SEM_DEFINE(go_sem, 0, 1);
+K_SEM_DEFINE(shared_sem, 0, 2);
+
+static struct k_poll_signal set_signal;
+
+static K_THREAD_STACK_DEFINE(tstack, STACK_SIZE);
+static struct k_thread tdata;
+
+static void tmsgq_entry(void *p1, void *p2, void *p3)
+{
+	u32_t data = MSG_VALUE;
+
+	zassert_false(k_msgq_put(&poll_msgq, &data, K_NO_WAIT), NULL);
+}
+
+static void tpipe_entry(void *p1, void *p2, void *p3)
+{
+	u32_t data = MSG_VALUE;
+	size_t written;
+
+	zassert_false(k_pipe_put(&poll_pipe, &data, sizeof(data), &written,
+				 sizeof(data), K_NO_WAIT), NULL);
+}
+
+static void tmutex_entry(void *p1, void *p2, void *p3)
+{
+	zassert_false(k_mutex_lock(&poll_mutex, K_FOREVER), NULL);
+	k_sleep(SLEEP);
+	k_mutex_unlock(&poll_mutex);
+}
+
+static void tsignal_entry(void *p1, void *p2, void *p3)
+{
+	int i;
+
+	for (i = 0; i < LOOPS; i++) {
+		k_sem_take(&go_sem, K_FOREVER);
+		k_poll_signal(&set_signal, i);
+	}
+}
+
+static volatile int shared_polled;
+
+static void tshared_entry(void *p1, void *p2, void *p3)
+{
+	struct k_poll_event event;
+
+	k_poll_event_init(&event, K_POLL_TYPE_SEM_AVAILABLE,
+			  K_POLL_MODE_NOTIFY_ONLY, &shared_sem);
+	zassert_false(k_poll(&event, 1, K_FOREVER), NULL);
+	shared_polled = 1;
+}
+
+static void spawn(k_thread_entry_t entry, int prio)
+{
+	k_thread_create(&tdata, tstack, STACK_SIZE, entry,
+			NULL, NULL, NULL, prio, 0, 0);
+}
+
+/* polls one object, which another thread makes available */
+static void poll_one(u32_t type, void *obj, u32_t state)
+{
+	struct k_poll_event event;
+
+	k_poll_event_init(&event, type, K_POLL_MODE_NOTIFY_ONLY, obj);
+	zassert_equal(k_poll(&event, 1, K_NO_WAIT), -EAGAIN, NULL);
+	zassert_false(k_poll(&event, 1, K_FOREVER), NULL);
+	zassert_equal(event.state, state, NULL);
+
+	/* the condition is met from now on */
+	event.state = K_POLL_STATE_NOT_READY;
+	zassert_false(k_poll(&event, 1, K_NO_WAIT), NULL);
+	zassert_equal(event.state, state, NULL);
+}
+
+/*test cases*/
+void test_poll_objects(void)
+{
+	u32_t data;
+	size_t read;
+
+	k_thread_priority_set(k_current_get(), MAIN_PRIO);
+
+	/**TESTPOINT: poll a message queue */
+	spawn(tmsgq_entry, K_PRIO_PREEMPT(6));
+	poll_one(K_POLL_TYPE_MSGQ_DATA_AVAILABLE, &poll_msgq,
+		 K_POLL_STATE_MSGQ_DATA_AVAILABLE);
+	zassert_false(k_msgq_get(&poll_msgq, &data, K_NO_WAIT), NULL);
+	zassert_equal(data, MSG_VALUE, NULL);
+
+	/**TESTPOINT: poll a pipe */
+	spawn(tpipe_entry, K_PRIO_PREEMPT(6));
+	poll_one(K_POLL_TYPE_PIPE_DATA_AVAILABLE, &poll_pipe,
+		 K_POLL_STATE_PIPE_DATA_AVAILABLE);
+	zassert_false(k_pipe_get(&poll_pipe, &data, sizeof(data), &read,
+				 sizeof(data), K_NO_WAIT), NULL);
+	zassert_equal(data, MSG_VALUE, NULL);
+
+	/**TESTPOINT: poll a mutex */
+	spawn(tmutex_entry, K_PRIO_PREEMPT(3));
+	poll_one(K_POLL_TYPE_MUTEX_AVAILABLE, &poll_mutex,
+		 K_POLL_STATE_MUTEX_AVAILABLE);
+	zassert_false(k_mutex_lock(&poll_mutex, K_NO_WAIT), NULL);
+	k_mutex_unlock(&poll_mutex);
+
+	/**TESTPOINT: poll a timer */
+	k_timer_start(&poll_timer, SLEEP, 0);
+	poll_one(K_POLL_TYPE_TIMER_EXPIRED, &poll_timer,
+		 K_POLL_STATE_TIMER_EXPIRED);
+	zassert_equal(k_timer_status_get(&poll_timer), 1, NULL);
+}
+
+void test_poll_set(void)
+{
+	struct k_poll_event events[2];
+	struct k_poll_set set;
+	u32_t data = MSG_VALUE;
+	int i;
+
+	k_thread_priority_set(k_current_get(), MAIN_PRIO);
+	k_poll_signal_init(&set_signal);
+	k_msgq_purge(&poll_msgq);
+
+	k_poll_event_init(&events[0], K_POLL_TYPE_SIGNAL,
+			  K_POLL_MODE_NOTIFY_ONLY, &set_signal);
+	k_poll_event_init(&events[1], K_POLL_TYPE_MSGQ_DATA_AVAILABLE,
+			  K_POLL_MODE_NOTIFY_ONLY, &poll_msgq);
+	k_poll_set_init(&set, events, ARRAY_SIZE(events));
+
+	zassert_equal(k_poll_set_wait(&set, K_NO_WAIT), -EAGAIN, NULL);
+	zassert_equal(k_poll_set_wait(&set, SLEEP), -EAGAIN, NULL);
+
+	/**TESTPOINT: registrations survive each wake-up */
+	spawn(tsignal_entry, K_PRIO_PREEMPT(6));
+	for (i = 0; i < LOOPS; i++) {
+		k_sem_give(&go_sem);
+		zassert_false(k_poll_set_wait(&set, K_FOREVER), NULL);
+		zassert_equal(events[0].state, K_POLL_STATE_SIGNALED, NULL);
+		zassert_equal(events[1].state, K_POLL_STATE_NOT_READY, NULL);
+		zassert_equal(set_signal.result, i, NULL);
+
+		set_signal.signaled = 0;
+		events[0].state = K_POLL_STATE_NOT_READY;
+	}
+
+	/**TESTPOINT: a signal while not waiting is kept for the next wait */
+	zassert_false(k_msgq_put(&poll_msgq, &data, K_NO_WAIT), NULL);
+	zassert_equal(events[1].state, K_POLL_STATE_MSGQ_DATA_AVAILABLE, NULL);
+	zassert_false(k_poll_set_wait(&set, K_NO_WAIT), NULL);
+	zassert_equal(k_poll_set_wait(&set, K_NO_WAIT), -EAGAIN, NULL);
+	k_msgq_purge(&poll_msgq);
+	events[1].state = K_POLL_STATE_NOT_READY;
+
+	/**TESTPOINT: no signal reaches the set after cleanup */
+	k_poll_set_cleanup(&set);
+	k_poll_signal(&set_signal, 0);
+	zassert_equal(events[0].state, K_POLL_STATE_NOT_READY, NULL);
+	zassert_equal(k_poll_set_wait(&set, K_NO_WAIT), -EAGAIN, NULL);
+}
+
+void test_poll_set_shared(void)
+{
+	struct k_poll_event event;
+	struct k_poll_set set;
+
+	k_thread_priority_set(k_current_get(), MAIN_PRIO);
+	shared_polled = 0;
+
+	k_poll_event_init(&event, K_POLL_TYPE_SEM_AVAILABLE,
+			  K_POLL_MODE_NOTIFY_ONLY, &shared_sem);
+	k_poll_set_init(&set, &event, 1);
+
+	/* a lower priority poller registers behind the set */
+	spawn(tshared_entry, K_PRIO_PREEMPT(6));
+	k_sleep(SLEEP);
+
+	/**TESTPOINT: the set does not take every signal of the object */
+	k_sem_give(&shared_sem);
+	zassert_equal(event.state, K_POLL_STATE_SEM_AVAILABLE, NULL);
+	k_sleep(SLEEP);
+	zassert_false(shared_polled, NULL);
+
+	k_sem_give(&shared_sem);
+	k_sleep(SLEEP);
+	zassert_true(shared_polled, "k_poll() waiter not woken");
+
+	zassert_false(k_poll_set_wait(&set, K_NO_WAIT), NULL);
+	k_poll_set_cleanup(&set);
+	k_sem_reset(&shared_sem);
+}
@@ -0,0 +1,137 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <irq_offload.h>
+#include <logging/tracing.h>
+
+#define NUM_RECORDS CONFIG_TRACING_BUFFER_SIZE
+
+static struct sys_trace_record records[NUM_RECORDS];
+
+K_SEM_DEFINE(trace_sem, 0, 1);
+K_SEM_DEFINE(isr_sem, 0, 1);
+K_MUTEX_DEFINE(trace_mutex);
+K_QUEUE_DEFINE(trace_queue);
+
+static void trace_discard(void)
+{
+	int ctx;
+
+	for (ctx = 0; ctx < SYS_TRACE_CONTEXT_COUNT; ctx++) {
+		while (sys_trace_get(ctx, records, NUM_RECORDS)) {
+		}
+	}
+}
+
+/* Returns the index of the first record after start matching id and arg */
+static int trace_find(u32_t count, int start, u16_t id, void *arg)
+{
+	u32_t i;
+
+	for (i = start; i < count; i++) {
+		if (records[i].id == id &&
+		    records[i].arg == (u32_t)(uintptr_t)arg) {
+			return i + 1;
+		}
+	}
+
+	return -1;
+}
+
+static void isr_handler(void *param)
+{
+	k_sem_give(&isr_sem);
+}
+
+static void test_trace_objects(void)
+{
+	static const struct {
+		u16_t id;
+		void *obj;
+	} expected[] = {
+		{ SYS_TRACE_SEM_GIVE, &trace_sem },
+		{ SYS_TRACE_SEM_TAKE, &trace_sem },
+		{ SYS_TRACE_MUTEX_LOCK, &trace_mutex },
+		{ SYS_TRACE_MUTEX_UNLOCK, &trace_mutex },
+		{ SYS_TRACE_QUEUE_PUT, &trace_queue },
+		{ SYS_TRACE_QUEUE_GET, &trace_queue },
+	};
+	static void *item[2];
+	u32_t count, i;
+	int pos = 0;
+
+	trace_discard();
+
+	k_sem_give(&trace_sem);
+	k_sem_take(&trace_sem, K_NO_WAIT);
+	k_mutex_lock(&trace_mutex, K_NO_WAIT);
+	k_mutex_unlock(&trace_mutex);
+	k_queue_append(&trace_queue, item);
+	k_queue_get(&trace_queue, K_NO_WAIT);
+
+	count = sys_trace_get(SYS_TRACE_CONTEXT_THREAD, records, NUM_RECORDS);
+
+	/**TESTPOINT: operations are recorded in order */
+	for (i = 0; i < ARRAY_SIZE(expected); i++) {
+		pos = trace_find(count, pos, expected[i].id, expected[i].obj);
+		zassert_true(pos > 0, "event missing from the trace");
+	}
+
+	/**TESTPOINT: timestamps of a context never go backwards */
+	for (i = 1; i < count; i++) {
+		zassert_true((s32_t)(records[i].timestamp -
+				     records[i - 1].timestamp) >= 0,
+			     "timestamps out of order");
+	}
+}
+
+static void test_trace_isr_context(void)
+{
+	u32_t count;
+
+	trace_discard();
+
+	irq_offload(isr_handler, NULL);
+	zassert_false(k_sem_take(&isr_sem, K_NO_WAIT), NULL);
+
+	/**TESTPOINT: events raised in an ISR go to the ISR buffer */
+	count = sys_trace_get(SYS_TRACE_CONTEXT_ISR, records, NUM_RECORDS);
+	zassert_true(trace_find(count, 0, SYS_TRACE_SEM_GIVE, &isr_sem) > 0,
+		     "ISR event missing");
+
+	count = sys_trace_get(SYS_TRACE_CONTEXT_THREAD, records, NUM_RECORDS);
+	zassert_true(trace_find(count, 0, SYS_TRACE_SEM_TAKE, &isr_sem) > 0,
+		     "thread event missing");
+	zassert_equal(trace_find(count, 0, SYS_TRACE_SEM_GIVE, &isr_sem), -1,
+		      "ISR event in the thread buffer");
+}
+
+static void test_trace_overflow(void)
+{
+	u32_t dropped, i;
+
+	trace_discard();
+	dropped = sys_trace_dropped_get();
+
+	for (i = 0; i < NUM_RECORDS + 10; i++) {
+		k_sem_give(&trace_sem);
+	}
+	k_sem_take(&trace_sem, K_NO_WAIT);
+
+	/**TESTPOINT: a full buffer drops and counts new records */
+	zassert_equal(sys_trace_dropped_get() - dropped, 11, NULL);
+	zassert_equal(sys_trace_get(SYS_TRACE_CONTEXT_THREAD, records,
+				    NUM_RECORDS), NUM_RECORDS, NULL);
+	zassert_equal(records[0].id, SYS_TRACE_SEM_GIVE, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(tracing,
+			 ztest_unit_test(test_trace_objects),
+			 ztest_unit_test(test_trace_isr_context),
+			 ztest_unit_test(test_trace_overflow));
+	ztest_run_test_suite(tracing);
+}
@@ -0,0 +1,31 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_rwlock
+ * @{
+ * @defgroup t_rwlock_api test_rwlock_api
+ * @}
+ */
+
+#include <ztest.h>
+
+extern void test_rwlock_readers_share(void);
+extern void test_rwlock_writer_excludes(void);
+extern void test_rwlock_writer_preference(void);
+extern void test_rwlock_priority(void);
+extern void test_rwlock_writer_timeout(void);
+
+/*test case main entry*/
+void test_main(void)
+{
+	ztest_test_suite(test_rwlock_api,
+			 ztest_unit_test(test_rwlock_readers_share),
+			 ztest_unit_test(test_rwlock_writer_excludes),
+			 ztest_unit_test(test_rwlock_writer_preference),
+			 ztest_unit_test(test_rwlock_priority),
+			 ztest_unit_test(test_rwlock_writer_timeout)
+			 );
+	ztest_run_test_suite(test_rwlock_api);
+}
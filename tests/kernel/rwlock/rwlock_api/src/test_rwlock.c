@@ -0,0 +1,163 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_rwlock_api
+ * @{
+ * @defgroup t_rwlock_lock test_rwlock_lock
+ * @brief TestPurpose: verify reader-writer lock exclusion and ordering
+ * - API coverage
+ *   -# k_rwlock_init K_RWLOCK_DEFINE
+ *   -# k_rwlock_read_lock k_rwlock_read_unlock
+ *   -# k_rwlock_write_lock k_rwlock_write_unlock
+ * @}
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE 1024
+#define NUM_THREADS 3
+#define MAIN_PRIO K_PRIO_PREEMPT(5)
+#define TIMEOUT 50
+
+/**TESTPOINT: init via K_RWLOCK_DEFINE*/
+K_RWLOCK_DEFINE(krwlock);
+static struct k_rwlock rwlock;
+
+static K_THREAD_STACK_ARRAY_DEFINE(tstack, NUM_THREADS, STACK_SIZE);
+static struct k_thread tdata[NUM_THREADS];
+
+/* Threads log their id here once they hold the lock */
+static int order[NUM_THREADS];
+static int order_len;
+static int ret_val[NUM_THREADS];
+
+static void treader_entry(void *p1, void *p2, void *p3)
+{
+	int id = (int)p2;
+
+	ret_val[id] = k_rwlock_read_lock(p1, (s32_t)p3);
+	if (ret_val[id] == 0) {
+		order[order_len++] = id;
+		k_rwlock_read_unlock(p1);
+	}
+}
+
+static void twriter_entry(void *p1, void *p2, void *p3)
+{
+	int id = (int)p2;
+
+	ret_val[id] = k_rwlock_write_lock(p1, (s32_t)p3);
+	if (ret_val[id] == 0) {
+		order[order_len++] = id;
+		k_rwlock_write_unlock(p1);
+	}
+}
+
+static void spawn(int id, k_thread_entry_t entry, int prio, s32_t timeout)
+{
+	k_thread_create(&tdata[id], tstack[id], STACK_SIZE, entry,
+			&rwlock, (void *)id, (void *)timeout, prio, 0, 0);
+}
+
+static void setup(void)
+{
+	k_thread_priority_set(k_current_get(), MAIN_PRIO);
+	k_rwlock_init(&rwlock);
+	order_len = 0;
+}
+
+/*test cases*/
+void test_rwlock_readers_share(void)
+{
+	setup();
+
+	/**TESTPOINT: readers hold the lock together */
+	zassert_false(k_rwlock_read_lock(&krwlock, K_NO_WAIT), NULL);
+	zassert_false(k_rwlock_read_lock(&krwlock, K_NO_WAIT), NULL);
+	zassert_equal(k_rwlock_write_lock(&krwlock, K_NO_WAIT), -EBUSY, NULL);
+	k_rwlock_read_unlock(&krwlock);
+	zassert_equal(k_rwlock_write_lock(&krwlock, K_NO_WAIT), -EBUSY, NULL);
+	k_rwlock_read_unlock(&krwlock);
+
+	/**TESTPOINT: a writer holds the lock alone */
+	zassert_false(k_rwlock_write_lock(&krwlock, K_NO_WAIT), NULL);
+	zassert_equal(k_rwlock_read_lock(&krwlock, K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(k_rwlock_read_lock(&krwlock, TIMEOUT), -EAGAIN, NULL);
+	k_rwlock_write_unlock(&krwlock);
+	zassert_false(k_rwlock_read_lock(&krwlock, K_NO_WAIT), NULL);
+	k_rwlock_read_unlock(&krwlock);
+}
+
+void test_rwlock_writer_excludes(void)
+{
+	setup();
+
+	zassert_false(k_rwlock_write_lock(&rwlock, K_FOREVER), NULL);
+	spawn(0, treader_entry, K_PRIO_PREEMPT(3), K_FOREVER);
+	spawn(1, twriter_entry, K_PRIO_PREEMPT(3), K_FOREVER);
+	zassert_equal(order_len, 0, NULL);
+
+	/**TESTPOINT: waiters get the lock once the writer releases it */
+	k_rwlock_write_unlock(&rwlock);
+	zassert_equal(order_len, 2, NULL);
+	zassert_false(ret_val[0], NULL);
+	zassert_false(ret_val[1], NULL);
+}
+
+void test_rwlock_writer_preference(void)
+{
+	setup();
+
+	zassert_false(k_rwlock_read_lock(&rwlock, K_FOREVER), NULL);
+	spawn(0, twriter_entry, K_PRIO_PREEMPT(3), K_FOREVER);
+
+	/**TESTPOINT: new readers queue up behind a waiting writer */
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), -EBUSY, NULL);
+	spawn(1, treader_entry, K_PRIO_PREEMPT(4), K_FOREVER);
+	zassert_equal(order_len, 0, NULL);
+
+	k_rwlock_read_unlock(&rwlock);
+	zassert_equal(order_len, 2, NULL);
+	zassert_equal(order[0], 0, NULL);
+	zassert_equal(order[1], 1, NULL);
+}
+
+void test_rwlock_priority(void)
+{
+	setup();
+
+	zassert_false(k_rwlock_write_lock(&rwlock, K_FOREVER), NULL);
+	spawn(0, twriter_entry, K_PRIO_PREEMPT(4), K_FOREVER);
+	spawn(1, treader_entry, K_PRIO_PREEMPT(2), K_FOREVER);
+	spawn(2, treader_entry, K_PRIO_PREEMPT(6), K_FOREVER);
+
+	/**TESTPOINT: only readers that outrank the first writer go first */
+	k_rwlock_write_unlock(&rwlock);
+	k_sleep(TIMEOUT);
+	zassert_equal(order_len, 3, NULL);
+	zassert_equal(order[0], 1, NULL);
+	zassert_equal(order[1], 0, NULL);
+	zassert_equal(order[2], 2, NULL);
+}
+
+void test_rwlock_writer_timeout(void)
+{
+	setup();
+
+	zassert_false(k_rwlock_read_lock(&rwlock, K_FOREVER), NULL);
+	spawn(0, twriter_entry, K_PRIO_PREEMPT(3), TIMEOUT);
+	spawn(1, treader_entry, K_PRIO_PREEMPT(4), K_FOREVER);
+	zassert_equal(order_len, 0, NULL);
+
+	/**TESTPOINT: readers held back by a writer that gave up get in */
+	k_sleep(TIMEOUT * 2);
+	zassert_equal(ret_val[0], -EAGAIN, NULL);
+	zassert_equal(order_len, 1, NULL);
+	zassert_equal(order[0], 1, NULL);
+
+	k_rwlock_read_unlock(&rwlock);
+	zassert_false(k_rwlock_write_lock(&rwlock, K_NO_WAIT), NULL);
+	k_rwlock_write_unlock(&rwlock);
+}
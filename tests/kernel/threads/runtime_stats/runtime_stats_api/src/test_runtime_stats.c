@@ -0,0 +1,108 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define NUM_WAKES 5
+#define BUSY_US 10000
+
+static K_THREAD_STACK_DEFINE(tstack, STACK_SIZE);
+static struct k_thread tdata;
+
+K_SEM_DEFINE(wake_sem, 0, 1);
+
+static u32_t us_to_cycles(u32_t us)
+{
+	return (u32_t)((u64_t)us * sys_clock_hw_cycles_per_sec / USEC_PER_SEC);
+}
+
+static void waker_entry(void *p1, void *p2, void *p3)
+{
+	int i;
+
+	for (i = 0; i < NUM_WAKES; i++) {
+		k_sem_take(&wake_sem, K_FOREVER);
+	}
+}
+
+static void busy_entry(void *p1, void *p2, void *p3)
+{
+	k_busy_wait(BUSY_US);
+}
+
+/**
+ * @ingroup t_runtime_stats_api
+ * @brief test switch counts of a thread woken several times
+ */
+void test_runtime_stats_switches(void)
+{
+	struct k_thread_runtime_stats stats;
+	int i;
+
+	k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(0));
+
+	/* Runs at once, then blocks until each give */
+	k_thread_create(&tdata, tstack, STACK_SIZE, waker_entry,
+			NULL, NULL, NULL, K_PRIO_COOP(1), 0, 0);
+
+	for (i = 0; i < NUM_WAKES; i++) {
+		k_sem_give(&wake_sem);
+	}
+
+	/** TESTPOINT: one switch in at start and one per wake up */
+	zassert_false(k_thread_runtime_stats_get(&tdata, &stats), NULL);
+	zassert_equal(stats.switches_in, NUM_WAKES + 1, NULL);
+	zassert_equal(stats.switches_out, NUM_WAKES + 1, NULL);
+
+	/** TESTPOINT: the stack high water mark is within the stack */
+	zassert_true(stats.stack_peak > 0, NULL);
+	zassert_true(stats.stack_peak <= STACK_SIZE, NULL);
+}
+
+/**
+ * @ingroup t_runtime_stats_api
+ * @brief test execution and ready cycle accounting
+ */
+void test_runtime_stats_cycles(void)
+{
+	struct k_thread_runtime_stats before, after;
+	int prio = K_PRIO_PREEMPT(0);
+
+	k_thread_priority_set(k_current_get(), prio);
+	zassert_false(k_thread_runtime_stats_get(k_current_get(), &before),
+		      NULL);
+
+	/* Same priority, so the new thread waits for the yield */
+	k_thread_create(&tdata, tstack, STACK_SIZE, busy_entry,
+			NULL, NULL, NULL, prio, 0, 0);
+	k_busy_wait(BUSY_US);
+
+	/** TESTPOINT: the running thread sees its current slice */
+	zassert_false(k_thread_runtime_stats_get(k_current_get(), &after),
+		      NULL);
+	zassert_true(after.execution_cycles - before.execution_cycles >=
+		     us_to_cycles(BUSY_US), NULL);
+
+	/** TESTPOINT: the other thread was ready all that time */
+	k_thread_runtime_stats_get(&tdata, &after);
+	zassert_equal(after.switches_in, 0, NULL);
+	zassert_true(after.ready_cycles >= us_to_cycles(BUSY_US), NULL);
+	zassert_equal(after.execution_cycles, 0, NULL);
+
+	k_yield();
+
+	/** TESTPOINT: the time it ran is charged to it */
+	k_thread_runtime_stats_get(&tdata, &after);
+	zassert_equal(after.switches_in, 1, NULL);
+	zassert_true(after.execution_cycles >= us_to_cycles(BUSY_US), NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_runtime_stats_api,
+			 ztest_unit_test(test_runtime_stats_switches),
+			 ztest_unit_test(test_runtime_stats_cycles));
+	ztest_run_test_suite(test_runtime_stats_api);
+}
@@ -0,0 +1,157 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define NUM_WORKERS 2
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define WORK_ITEM_WAIT 100
+#define NUM_ORDERED 4
+
+K_WORK_POOL_DEFINE(pool, NUM_WORKERS);
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, NUM_WORKERS, STACK_SIZE);
+
+static struct k_work items[4];
+static struct k_delayed_work delayed;
+static struct k_work_class cls;
+static struct k_work ordered[NUM_ORDERED];
+
+static atomic_t done;
+static atomic_t running;
+static int order[NUM_ORDERED];
+static int num_ordered;
+static bool overlap;
+
+static void sleep_handler(struct k_work *work)
+{
+	k_sleep(WORK_ITEM_WAIT);
+	atomic_inc(&done);
+}
+
+static void quick_handler(struct k_work *work)
+{
+	atomic_inc(&done);
+}
+
+static void ordered_handler(struct k_work *work)
+{
+	if (atomic_inc(&running)) {
+		overlap = true;
+	}
+
+	/* Give the other worker a chance to run the next item */
+	k_sleep(10);
+	order[num_ordered++] = work - ordered;
+
+	atomic_dec(&running);
+}
+
+static void test_pool_start(void)
+{
+	int i;
+
+	for (i = 0; i < NUM_WORKERS; i++) {
+		k_work_pool_start_worker(&pool, i, stacks[i], STACK_SIZE, i + 1);
+	}
+}
+
+static void test_pool_parallel(void)
+{
+	atomic_set(&done, 0);
+	k_work_init(&items[0], sleep_handler);
+	k_work_init(&items[1], sleep_handler);
+
+	k_work_pool_submit(&pool, &items[0]);
+	k_work_pool_submit(&pool, &items[1]);
+
+	/* Both items sleep at the same time on different workers */
+	k_sleep(WORK_ITEM_WAIT + WORK_ITEM_WAIT / 2);
+	zassert_equal(atomic_get(&done), 2, "items did not run in parallel");
+}
+
+static void test_pool_steal(void)
+{
+	struct k_work_pool_stats stats;
+	int i;
+
+	k_work_pool_stats_get(&pool, &stats, true);
+
+	atomic_set(&done, 0);
+	k_work_init(&items[0], sleep_handler);
+	for (i = 1; i < ARRAY_SIZE(items); i++) {
+		k_work_init(&items[i], quick_handler);
+	}
+
+	/* Items are spread round-robin, so some of them land behind the
+	 * sleeping one and have to be taken by the other worker.
+	 */
+	for (i = 0; i < ARRAY_SIZE(items); i++) {
+		k_work_pool_submit(&pool, &items[i]);
+	}
+
+	k_sleep(WORK_ITEM_WAIT / 2);
+	zassert_equal(atomic_get(&done), ARRAY_SIZE(items) - 1,
+		      "quick items waited for the slow one");
+
+	k_sleep(WORK_ITEM_WAIT);
+	zassert_equal(atomic_get(&done), ARRAY_SIZE(items), "item lost");
+
+	k_work_pool_stats_get(&pool, &stats, false);
+	zassert_equal(stats.completed, ARRAY_SIZE(items), "wrong count");
+	zassert_true(stats.stolen > 0, "nothing was stolen");
+	zassert_true(stats.run_max >= stats.wait_max, "wrong times");
+}
+
+static void test_pool_ordered(void)
+{
+	int i;
+
+	k_work_class_init(&cls, &pool);
+	for (i = 0; i < NUM_ORDERED; i++) {
+		k_work_init(&ordered[i], ordered_handler);
+	}
+
+	for (i = 0; i < NUM_ORDERED; i++) {
+		k_work_class_submit(&cls, &ordered[i]);
+	}
+
+	k_sleep(NUM_ORDERED * 10 * 2);
+
+	zassert_false(overlap, "ordered items overlapped");
+	zassert_equal(num_ordered, NUM_ORDERED, "ordered item lost");
+	for (i = 0; i < NUM_ORDERED; i++) {
+		zassert_equal(order[i], i, "ordered items reordered");
+	}
+}
+
+static void test_pool_delayed(void)
+{
+	atomic_set(&done, 0);
+	k_delayed_work_init(&delayed, quick_handler);
+
+	zassert_equal(k_delayed_work_submit_to_pool(&pool, &delayed,
+						    WORK_ITEM_WAIT), 0, NULL);
+	zassert_equal(k_delayed_work_submit(&delayed, WORK_ITEM_WAIT),
+		      -EADDRINUSE, "submitted to a queue and a pool");
+	zassert_equal(k_delayed_work_cancel(&delayed), 0, NULL);
+
+	k_sleep(2 * WORK_ITEM_WAIT);
+	zassert_equal(atomic_get(&done), 0, "canceled item ran");
+
+	zassert_equal(k_delayed_work_submit_to_pool(&pool, &delayed,
+						    WORK_ITEM_WAIT), 0, NULL);
+	k_sleep(2 * WORK_ITEM_WAIT);
+	zassert_equal(atomic_get(&done), 1, "delayed item did not run");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_work_pool,
+			 ztest_unit_test(test_pool_start),
+			 ztest_unit_test(test_pool_parallel),
+			 ztest_unit_test(test_pool_steal),
+			 ztest_unit_test(test_pool_ordered),
+			 ztest_unit_test(test_pool_delayed));
+	ztest_run_test_suite(test_work_pool);
+}
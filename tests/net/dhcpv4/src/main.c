@@ -152,15 +152,42 @@ struct dhcp_msg {
 	u8_t type;
 };
 
-static void test_result(bool pass)
+static K_SEM_DEFINE(addr_added, 0, 1);
+static int discover_count;
+
+static struct net_dhcpv4_lease stored_lease;
+static bool lease_stored;
+
+static int lease_load(struct net_if *iface, struct net_dhcpv4_lease *lease)
 {
-	if (pass) {
-		TC_END_REPORT(TC_PASS);
-	} else {
-		TC_END_REPORT(TC_PASS);
+	if (!lease_stored) {
+		return -ENOENT;
+	}
+
+	memcpy(lease, &stored_lease, sizeof(*lease));
+
+	return 0;
+}
+
+static int lease_store(struct net_if *iface,
+		       const struct net_dhcpv4_lease *lease)
+{
+	if (!lease) {
+		lease_stored = false;
+		return 0;
 	}
+
+	memcpy(&stored_lease, lease, sizeof(stored_lease));
+	lease_stored = true;
+
+	return 0;
 }
 
+static const struct net_dhcpv4_lease_storage lease_storage = {
+	.load = lease_load,
+	.store = lease_store,
+};
+
 struct net_dhcpv4_context {
 	u8_t mac_addr[sizeof(struct net_eth_addr)];
 	struct net_linkaddr ll_addr;
@@ -478,6 +505,8 @@ static int tester_send(struct net_if *iface, struct net_pkt *pkt)
 	parse_dhcp_message(pkt, &msg);
 
 	if (msg.type == DISCOVER) {
+		discover_count++;
+
 		/* Reply with DHCPv4 offer message */
 		rpkt = prepare_dhcp_offer(iface, msg.xid);
 		if (!rpkt) {
@@ -523,11 +552,12 @@ static struct net_mgmt_event_callback rx_cb;
 static void receiver_cb(struct net_mgmt_event_callback *cb,
 			u32_t nm_event, struct net_if *iface)
 {
-	test_result(true);
+	k_sem_give(&addr_added);
 }
 
 void test_dhcp(void)
 {
+	struct in_addr leased = { { { 10, 237, 72, 158 } } };
 	struct net_if *iface;
 
 	k_thread_priority_set(k_current_get(), K_PRIO_COOP(7));
@@ -542,15 +572,48 @@ void test_dhcp(void)
 		return;
 	}
 
+	net_dhcpv4_set_lease_storage(&lease_storage);
+
+	net_dhcpv4_start(iface);
+
+	zassert_equal(k_sem_take(&addr_added, K_SECONDS(20)), 0,
+		      "No address from DHCPv4");
+	zassert_equal(iface->dhcpv4.state, NET_DHCPV4_BOUND, "Not bound");
+	zassert_true(lease_stored, "Lease was not stored");
+	zassert_true(net_ipv4_addr_cmp(&stored_lease.addr, &leased),
+		     "Wrong lease stored");
+}
+
+void test_dhcp_init_reboot(void)
+{
+	struct net_if *iface, *addr_iface = NULL;
+
+	iface = net_if_get_default();
+	zassert_not_null(iface, "Interface not available");
+
+	net_dhcpv4_stop(iface);
+	zassert_false(net_if_ipv4_addr_lookup(&stored_lease.addr,
+					      &addr_iface),
+		      "Address not removed");
+
+	/* The lease must be confirmed with a single REQUEST and without
+	 * the initial random delay.
+	 */
+	discover_count = 0;
+
 	net_dhcpv4_start(iface);
 
-	k_yield();
+	zassert_equal(k_sem_take(&addr_added, K_MSEC(500)), 0,
+		      "Lease was not confirmed");
+	zassert_equal(discover_count, 0, "DISCOVER sent in INIT-REBOOT");
+	zassert_equal(iface->dhcpv4.state, NET_DHCPV4_BOUND, "Not bound");
 }
 
 /**test case main entry */
 void test_main(void)
 {
 	ztest_test_suite(test_dhcpv4,
-			ztest_unit_test(test_dhcp));
+			ztest_unit_test(test_dhcp),
+			ztest_unit_test(test_dhcp_init_reboot));
 	ztest_run_test_suite(test_dhcpv4);
 }
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2017 Linaro Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <zephyr/types.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <net/lwm2m.h>
+
+#include <ztest.h>
+
+#include "lwm2m_engine.h"
+
+#define IPSO_OBJECT_TEMP_SENSOR_ID	3303
+
+#define TEMP_SENSOR_VALUE_ID		5700
+#define TEMP_UNITS_ID			5701
+#define TEMP_MIN_MEASURED_VALUE_ID	5601
+
+#define INSTANCES CONFIG_LWM2M_IPSO_TEMP_SENSOR_INSTANCE_COUNT
+
+static char *path(int obj_inst_id, int res_id)
+{
+	static char buf[32];
+
+	snprintf(buf, sizeof(buf), "%u/%u/%u", IPSO_OBJECT_TEMP_SENSOR_ID,
+		 obj_inst_id, res_id);
+
+	return buf;
+}
+
+static void test_create(void)
+{
+	struct lwm2m_engine_obj_inst *obj_inst;
+	int i;
+
+	for (i = 0; i < INSTANCES; i++) {
+		zassert_equal(lwm2m_create_obj_inst(IPSO_OBJECT_TEMP_SENSOR_ID,
+						    i, &obj_inst), 0,
+			      "Cannot create instance");
+	}
+}
+
+static void test_set_res(void)
+{
+	float32_value_t value, read;
+	int i;
+
+	for (i = 0; i < INSTANCES; i++) {
+		value.val1 = 20 + i;
+		value.val2 = 500000;
+
+		zassert_equal(lwm2m_engine_set_res(IPSO_OBJECT_TEMP_SENSOR_ID,
+						   i, TEMP_SENSOR_VALUE_ID,
+						   &value, sizeof(value)), 0,
+			      "Cannot set resource");
+	}
+
+	for (i = 0; i < INSTANCES; i++) {
+		memset(&read, 0, sizeof(read));
+		zassert_equal(lwm2m_engine_get_float32(
+				      path(i, TEMP_SENSOR_VALUE_ID), &read), 0,
+			      "Cannot get resource");
+		zassert_equal(read.val1, 20 + i, "Wrong instance written");
+		zassert_equal(read.val2, 500000, "Wrong value written");
+
+		/* The post write callback of the object still runs */
+		memset(&read, 0, sizeof(read));
+		zassert_equal(lwm2m_engine_get_res(IPSO_OBJECT_TEMP_SENSOR_ID,
+						   i, TEMP_MIN_MEASURED_VALUE_ID,
+						   &read, sizeof(read)), 0,
+			      "Cannot get resource");
+		zassert_equal(read.val1, 20 + i, "Callback not run");
+	}
+}
+
+static void test_get_res(void)
+{
+	char units[8];
+	int i;
+
+	for (i = 0; i < INSTANCES; i++) {
+		char str[8];
+
+		snprintf(str, sizeof(str), "C%d", i);
+		zassert_equal(lwm2m_engine_set_string(path(i, TEMP_UNITS_ID),
+						      str), 0,
+			      "Cannot set resource");
+	}
+
+	for (i = 0; i < INSTANCES; i++) {
+		char str[8];
+
+		snprintf(str, sizeof(str), "C%d", i);
+		memset(units, 0, sizeof(units));
+		zassert_equal(lwm2m_engine_get_res(IPSO_OBJECT_TEMP_SENSOR_ID,
+						   i, TEMP_UNITS_ID,
+						   units, sizeof(units)), 0,
+			      "Cannot get resource");
+		zassert_true(!strcmp(units, str), "Wrong instance read");
+	}
+}
+
+static void test_missing(void)
+{
+	float32_value_t value = { 0 };
+
+	zassert_equal(lwm2m_engine_get_res(IPSO_OBJECT_TEMP_SENSOR_ID,
+					   INSTANCES, TEMP_SENSOR_VALUE_ID,
+					   &value, sizeof(value)), -ENOENT,
+		      "Missing instance found");
+	zassert_equal(lwm2m_engine_set_res(IPSO_OBJECT_TEMP_SENSOR_ID,
+					   INSTANCES, TEMP_SENSOR_VALUE_ID,
+					   &value, sizeof(value)), -ENOENT,
+		      "Missing instance written");
+	zassert_equal(lwm2m_engine_get_res(IPSO_OBJECT_TEMP_SENSOR_ID,
+					   0, 9999, &value, sizeof(value)),
+		      -ENOENT, "Missing resource found");
+	zassert_equal(lwm2m_engine_get_res(9999, 0, TEMP_SENSOR_VALUE_ID,
+					   &value, sizeof(value)), -ENOENT,
+		      "Missing object found");
+}
+
+static void test_delete(void)
+{
+	struct lwm2m_engine_obj_inst *obj_inst;
+	float32_value_t value;
+	int i;
+
+	zassert_equal(lwm2m_delete_obj_inst(IPSO_OBJECT_TEMP_SENSOR_ID, 1), 0,
+		      "Cannot delete instance");
+
+	zassert_equal(lwm2m_engine_get_res(IPSO_OBJECT_TEMP_SENSOR_ID, 1,
+					   TEMP_SENSOR_VALUE_ID,
+					   &value, sizeof(value)), -ENOENT,
+		      "Deleted instance found");
+
+	/* Instances sharing a bucket with the deleted one are still found */
+	for (i = 0; i < INSTANCES; i++) {
+		if (i == 1) {
+			continue;
+		}
+
+		zassert_equal(lwm2m_engine_get_res(IPSO_OBJECT_TEMP_SENSOR_ID,
+						   i, TEMP_SENSOR_VALUE_ID,
+						   &value, sizeof(value)), 0,
+			      "Instance lost");
+		zassert_equal(value.val1, 20 + i, "Wrong instance read");
+	}
+
+	zassert_equal(lwm2m_create_obj_inst(IPSO_OBJECT_TEMP_SENSOR_ID, 1,
+					    &obj_inst), 0,
+		      "Cannot create instance again");
+
+	zassert_equal(lwm2m_engine_get_res(IPSO_OBJECT_TEMP_SENSOR_ID, 1,
+					   TEMP_SENSOR_VALUE_ID,
+					   &value, sizeof(value)), 0,
+		      "New instance not found");
+	zassert_equal(value.val1, 0, "Stale instance read");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(lwm2m_engine_tests,
+			 ztest_unit_test(test_create),
+			 ztest_unit_test(test_set_res),
+			 ztest_unit_test(test_get_res),
+			 ztest_unit_test(test_missing),
+			 ztest_unit_test(test_delete));
+
+	ztest_run_test_suite(lwm2m_engine_tests);
+}
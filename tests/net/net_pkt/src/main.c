@@ -1072,6 +1072,68 @@ static void test_fragment_split(void)
 		      "Frag_b data mismatch");
 }
 
+static int ext_free_count;
+static const u8_t *ext_freed_data;
+
+static void ext_free_cb(const u8_t *data, void *user_data)
+{
+	zassert_equal_ptr(user_data, &ext_free_count, "Invalid user data");
+
+	ext_freed_data = data;
+	ext_free_count++;
+}
+
+static void test_pkt_append_ext(void)
+{
+	const u8_t *ext = (const u8_t *)example_data;
+	u8_t read_buf[sizeof(example_data)];
+	struct net_buf *frag;
+	struct net_pkt *pkt;
+	u16_t len, pos;
+
+	pkt = net_pkt_get_reserve_tx(0, K_FOREVER);
+
+	len = net_pkt_append(pkt, 10, ext, K_FOREVER);
+	zassert_equal(len, 10, "Cannot append data");
+
+	len = net_pkt_append_ext(pkt, sizeof(example_data) - 10, ext + 10,
+				 ext_free_cb, &ext_free_count, K_FOREVER);
+	zassert_equal(len, sizeof(example_data) - 10,
+		      "Cannot append external data");
+
+	frag = net_buf_frag_last(pkt->frags);
+	zassert_equal_ptr(frag->data, ext + 10, "External data was copied");
+	zassert_equal(net_buf_tailroom(frag), 0, "External tailroom");
+	zassert_equal(net_buf_headroom(frag), 0, "External headroom");
+
+	/* Appending more must not write to the external data */
+	len = net_pkt_append(pkt, 2, ext, K_FOREVER);
+	zassert_equal(len, 2, "Cannot append data after external data");
+	zassert_not_equal(frag, net_buf_frag_last(pkt->frags),
+			  "Data appended to external fragment");
+
+	/* Compacting moves external data to the first fragment but
+	 * must leave the external data untouched.
+	 */
+	net_pkt_compact(pkt);
+
+	zassert_equal(net_pkt_get_len(pkt), sizeof(example_data) + 2,
+		      "Invalid length after compact");
+
+	frag = net_frag_read(pkt->frags, 0, &pos, sizeof(example_data),
+			     read_buf);
+	zassert_false(!frag && pos == 0xffff, "Cannot read data");
+	zassert_false(memcmp(read_buf, example_data, sizeof(example_data)),
+		      "Data mismatch");
+
+	zassert_equal(ext_free_count, 0, "External data freed too early");
+
+	net_pkt_unref(pkt);
+
+	zassert_equal(ext_free_count, 1, "External data not freed");
+	zassert_equal_ptr(ext_freed_data, ext + 10, "Invalid data freed");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(net_pkt_tests,
@@ -1080,7 +1142,8 @@ void test_main(void)
 			 ztest_unit_test(test_pkt_read_append),
 			 ztest_unit_test(test_pkt_read_write_insert),
 			 ztest_unit_test(test_fragment_compact),
-			 ztest_unit_test(test_fragment_split)
+			 ztest_unit_test(test_fragment_split),
+			 ztest_unit_test(test_pkt_append_ext)
 			 );
 
 	ztest_run_test_suite(net_pkt_tests);
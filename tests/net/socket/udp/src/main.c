@@ -292,6 +292,64 @@ void test_send_recv_2_sock(void)
 	zassert_equal(cmp, 0, "Invalid recv data");
 }
 
+void test_v4_sendmsg_recvfrom(void)
+{
+	int rv;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	struct iovec iov[3];
+	struct msghdr msg;
+	char rx_buf[30] = {0};
+	ssize_t sent;
+	ssize_t recved;
+
+	prepare_sock_v4(CONFIG_NET_APP_MY_IPV4_ADDR,
+			CLIENT_PORT,
+			&client_sock,
+			&client_addr);
+
+	prepare_sock_v4(CONFIG_NET_APP_MY_IPV4_ADDR,
+			SERVER_PORT,
+			&server_sock,
+			&server_addr);
+
+	rv = bind(server_sock,
+		  (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	/* The vectors must be gathered into a single datagram */
+	iov[0].iov_base = TEST_STR_SMALL;
+	iov[0].iov_len = 2;
+	iov[1].iov_base = NULL;
+	iov[1].iov_len = 0;
+	iov[2].iov_base = TEST_STR_SMALL + 2;
+	iov[2].iov_len = STRLEN(TEST_STR_SMALL) - 2;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_name = &server_addr;
+	msg.msg_namelen = sizeof(server_addr);
+	msg.msg_iov = iov;
+	msg.msg_iovlen = ARRAY_SIZE(iov);
+
+	sent = sendmsg(client_sock, &msg, 0);
+	zassert_equal(sent, STRLEN(TEST_STR_SMALL), "sendmsg failed");
+
+	recved = recvfrom(server_sock, rx_buf, sizeof(rx_buf), 0, NULL, NULL);
+	zassert_equal(recved, STRLEN(TEST_STR_SMALL),
+		      "unexpected received bytes");
+	zassert_equal(strncmp(rx_buf, TEST_STR_SMALL, STRLEN(TEST_STR_SMALL)),
+		      0, "unexpected data");
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(socket_udp,
@@ -299,7 +357,8 @@ void test_main(void)
 			 ztest_unit_test(test_v4_sendto_recvfrom),
 			 ztest_unit_test(test_v6_sendto_recvfrom),
 			 ztest_unit_test(test_v4_bind_sendto),
-			 ztest_unit_test(test_v6_bind_sendto));
+			 ztest_unit_test(test_v6_bind_sendto),
+			 ztest_unit_test(test_v4_sendmsg_recvfrom));
 
 	ztest_run_test_suite(socket_udp);
 }
@@ -0,0 +1,433 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <stdlib.h>
+#include <net/buf.h>
+
+#define CONFIG_BT_CONN 1
+#define CONFIG_BT_MAX_CONN 2
+#define CONFIG_BT_MAX_PAIRED 1
+#define CONFIG_BT_CONN_TX_MAX 16
+#define CONFIG_BT_HCI_RESERVE 1
+#define CONFIG_BT_L2CAP_TX_MTU 100
+#define CONFIG_BT_L2CAP_TX_BUF_COUNT 16
+#define CONFIG_BT_L2CAP_TX_FRAG_COUNT 16
+#define CONFIG_BT_L2CAP_TX_USER_DATA_SIZE 4
+#define CONFIG_NET_BUF_USER_DATA_SIZE 4
+
+/* The kernel logging glue stays out of the host build */
+#define __BT_LOG_H
+#define BT_DBG(fmt, ...)
+#define BT_WARN(fmt, ...)
+#define BT_ERR(fmt, ...)
+#define BT_INFO(fmt, ...)
+#define BT_ASSERT(cond) zassert_true(!!(cond), #cond)
+
+/* Buffers find their pool by its index in the pool list, so the pools
+ * are collected in one section as the linker script does on target.
+ */
+#undef __in_section
+#define __in_section(a, b, c) __attribute__((section("net_buf_pool")))
+#define _net_buf_pool_list __start_net_buf_pool
+
+unsigned int irq_lock(void)
+{
+	return 0;
+}
+
+void irq_unlock(unsigned int key)
+{
+}
+
+#include <net/buf.c>
+#include <bluetooth/host/conn.c>
+
+/* Controller ACL buffers and their length */
+#define CTLR_PKTS 8
+#define CTLR_MTU 27
+
+struct bt_dev bt_dev;
+
+/* ACL fragments handed to the driver, in order */
+static struct {
+	u16_t handle;
+	u8_t flags;
+	u16_t len;
+} sent[64];
+static int sent_count;
+
+static struct bt_conn *conn[CONFIG_BT_MAX_CONN];
+
+static u32_t uptime;
+
+/* The queues hold their items in a list, without waiting */
+void k_queue_init(struct k_queue *queue)
+{
+	sys_slist_init(&queue->data_q);
+}
+
+void k_queue_append(struct k_queue *queue, void *data)
+{
+	sys_slist_append(&queue->data_q, data);
+}
+
+void k_queue_prepend(struct k_queue *queue, void *data)
+{
+	sys_slist_prepend(&queue->data_q, data);
+}
+
+void k_queue_append_list(struct k_queue *queue, void *head, void *tail)
+{
+	sys_slist_append_list(&queue->data_q, head, tail);
+}
+
+void *k_queue_get(struct k_queue *queue, s32_t timeout)
+{
+	return sys_slist_get(&queue->data_q);
+}
+
+int k_is_in_isr(void)
+{
+	return 0;
+}
+
+void k_sem_init(struct k_sem *sem, unsigned int initial_count,
+		unsigned int limit)
+{
+	sem->count = initial_count;
+	sem->limit = limit;
+}
+
+int k_sem_take(struct k_sem *sem, s32_t timeout)
+{
+	zassert_equal(timeout, K_NO_WAIT, "TX thread blocked");
+
+	if (!sem->count) {
+		return -EBUSY;
+	}
+
+	sem->count--;
+
+	return 0;
+}
+
+void k_sem_give(struct k_sem *sem)
+{
+	if (sem->count < sem->limit) {
+		sem->count++;
+	}
+}
+
+void k_delayed_work_init(struct k_delayed_work *work, k_work_handler_t handler)
+{
+}
+
+int k_delayed_work_cancel(struct k_delayed_work *work)
+{
+	return 0;
+}
+
+void k_poll_event_init(struct k_poll_event *event, u32_t type, int mode,
+		       void *obj)
+{
+}
+
+int k_poll_signal(struct k_poll_signal *signal, int result)
+{
+	return 0;
+}
+
+u32_t k_uptime_get_32(void)
+{
+	return uptime;
+}
+
+atomic_val_t atomic_get(const atomic_t *target)
+{
+	return *target;
+}
+
+atomic_val_t atomic_set(atomic_t *target, atomic_val_t value)
+{
+	atomic_val_t old = *target;
+
+	*target = value;
+
+	return old;
+}
+
+atomic_val_t atomic_inc(atomic_t *target)
+{
+	return (*target)++;
+}
+
+atomic_val_t atomic_dec(atomic_t *target)
+{
+	return (*target)--;
+}
+
+atomic_val_t atomic_or(atomic_t *target, atomic_val_t value)
+{
+	atomic_val_t old = *target;
+
+	*target |= value;
+
+	return old;
+}
+
+atomic_val_t atomic_and(atomic_t *target, atomic_val_t value)
+{
+	atomic_val_t old = *target;
+
+	*target &= value;
+
+	return old;
+}
+
+/* The rest of the host, which sending ACL data does not reach */
+void bt_att_init(void) {}
+void bt_l2cap_init(void) {}
+void bt_l2cap_connected(struct bt_conn *conn) {}
+void bt_l2cap_disconnected(struct bt_conn *conn) {}
+
+int bt_smp_init(void)
+{
+	return 0;
+}
+
+int bt_le_scan_update(bool fast_scan)
+{
+	return 0;
+}
+
+void bt_l2cap_recv(struct bt_conn *conn, struct net_buf *buf)
+{
+	net_buf_unref(buf);
+}
+
+int bt_l2cap_update_conn_param(struct bt_conn *conn,
+			       const struct bt_le_conn_param *param)
+{
+	return -ENOTSUP;
+}
+
+bool bt_le_conn_params_valid(const struct bt_le_conn_param *param)
+{
+	return true;
+}
+
+struct net_buf *bt_hci_cmd_create(u16_t opcode, u8_t param_len)
+{
+	return NULL;
+}
+
+int bt_hci_cmd_send(u16_t opcode, struct net_buf *buf)
+{
+	return -ENOTSUP;
+}
+
+int bt_send(struct net_buf *buf)
+{
+	struct bt_hci_acl_hdr *hdr = (void *)buf->data;
+	u16_t handle = sys_le16_to_cpu(hdr->handle);
+
+	zassert_true(sent_count < ARRAY_SIZE(sent), "Too many fragments");
+	zassert_true(buf->len - sizeof(*hdr) <= CTLR_MTU, "Fragment too long");
+
+	sent[sent_count].handle = bt_acl_handle(handle);
+	sent[sent_count].flags = bt_acl_flags(handle);
+	sent[sent_count].len = sys_le16_to_cpu(hdr->len);
+	sent_count++;
+
+	net_buf_unref(buf);
+
+	return 0;
+}
+
+/* The controller reports every fragment of a connection as completed */
+static void complete(struct bt_conn *conn)
+{
+	sys_snode_t *node;
+
+	while ((node = sys_slist_get(&conn->tx_pending))) {
+		tx_free(CONTAINER_OF(node, struct bt_conn_tx, node));
+		k_sem_give(bt_conn_get_pkts(conn));
+	}
+}
+
+static void send(int i, u16_t len)
+{
+	struct net_buf *buf;
+
+	buf = bt_conn_create_pdu(NULL, 0);
+	zassert_not_null(buf, "Out of buffers");
+
+	memset(net_buf_add(buf, len), i, len);
+
+	zassert_equal(bt_conn_send_cb(conn[i], buf, NULL), 0, "Send failed");
+}
+
+/* Fragment at the given position of the driver log */
+static void check(int pos, int i, u8_t flags, u16_t len)
+{
+	zassert_true(pos < sent_count, "Fragment not sent");
+	zassert_equal(sent[pos].handle, conn[i]->handle, "Wrong connection");
+	zassert_equal(sent[pos].flags, flags, "Wrong flags");
+	zassert_equal(sent[pos].len, len, "Wrong length");
+}
+
+static void reset(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(conn); i++) {
+		complete(conn[i]);
+	}
+
+	sent_count = 0;
+
+	/* Turns start with the first connection */
+	tx_turn_conn = 0;
+	tx_turn_frags = 0;
+}
+
+static void test_setup(void)
+{
+	int i;
+
+	bt_dev.le.mtu = CTLR_MTU;
+	k_sem_init(&bt_dev.le.pkts, CTLR_PKTS, CTLR_PKTS);
+
+	zassert_equal(bt_conn_init(), 0, "Init failed");
+
+	for (i = 0; i < ARRAY_SIZE(conn); i++) {
+		conn[i] = conn_new();
+		zassert_not_null(conn[i], "No connection");
+
+		conn[i]->handle = 0x0040 + i;
+		conn[i]->state = BT_CONN_CONNECTED;
+		k_fifo_init(&conn[i]->tx_queue);
+	}
+
+	zassert_equal(bt_conn_set_tx_weight(conn[0], 0), -EINVAL,
+		      "Zero weight accepted");
+}
+
+static void test_round_robin(void)
+{
+	reset();
+
+	/* A long packet does not hold back a short one */
+	send(0, 100);
+	send(1, 20);
+
+	bt_conn_process_tx();
+
+	zassert_equal(sent_count, 5, "Wrong number of fragments");
+	check(0, 0, BT_ACL_START_NO_FLUSH, 27);
+	check(1, 1, BT_ACL_START_NO_FLUSH, 20);
+	check(2, 0, BT_ACL_CONT, 27);
+	check(3, 0, BT_ACL_CONT, 27);
+	check(4, 0, BT_ACL_CONT, 19);
+}
+
+static void test_weight(void)
+{
+	reset();
+
+	zassert_equal(bt_conn_set_tx_weight(conn[0], 2), 0, "Weight failed");
+
+	send(0, 100);
+	send(1, 100);
+
+	bt_conn_process_tx();
+
+	zassert_equal(sent_count, 8, "Wrong number of fragments");
+	check(0, 0, BT_ACL_START_NO_FLUSH, 27);
+	check(1, 0, BT_ACL_CONT, 27);
+	check(2, 1, BT_ACL_START_NO_FLUSH, 27);
+	check(3, 0, BT_ACL_CONT, 27);
+	check(4, 0, BT_ACL_CONT, 19);
+	check(5, 1, BT_ACL_CONT, 27);
+	check(6, 1, BT_ACL_CONT, 27);
+	check(7, 1, BT_ACL_CONT, 19);
+
+	bt_conn_set_tx_weight(conn[0], 1);
+}
+
+static void test_no_buffers(void)
+{
+	reset();
+
+	/* Six of the controller buffers stay in use */
+	send(0, 27 * 6);
+	bt_conn_process_tx();
+	zassert_equal(sent_count, 6, "Wrong number of fragments");
+
+	sent_count = 0;
+
+	send(0, 40);
+	send(1, 40);
+
+	/* The TX thread does not wait for a buffer but returns */
+	bt_conn_process_tx();
+	zassert_equal(sent_count, 2, "Wrong number of fragments");
+	check(0, 1, BT_ACL_START_NO_FLUSH, 27);
+	check(1, 0, BT_ACL_START_NO_FLUSH, 27);
+
+	bt_conn_process_tx();
+	zassert_equal(sent_count, 2, "Sent without buffers");
+
+	/* Each connection resumes where it stopped */
+	complete(conn[0]);
+	bt_conn_process_tx();
+	zassert_equal(sent_count, 4, "Wrong number of fragments");
+	check(2, 1, BT_ACL_CONT, 13);
+	check(3, 0, BT_ACL_CONT, 13);
+}
+
+static void test_stats(void)
+{
+	struct bt_conn_tx_stats stats, last;
+
+	reset();
+
+	bt_conn_get_tx_stats(conn[1], &last);
+
+	uptime = 1000;
+	send(1, 20);
+	send(1, 20);
+	send(1, 20);
+
+	bt_conn_get_tx_stats(conn[1], &stats);
+	zassert_equal(stats.queued, 3, "Wrong queue depth");
+	zassert_true(stats.queued_max >= 3, "Wrong maximum queue depth");
+
+	/* Each packet waits at the head of the queue for 10 ms */
+	uptime = 1010;
+	send_next_frag(conn[1]);
+	uptime = 1020;
+	send_next_frag(conn[1]);
+	uptime = 1030;
+	send_next_frag(conn[1]);
+
+	bt_conn_get_tx_stats(conn[1], &stats);
+	zassert_equal(stats.queued, 0, "Wrong queue depth");
+	zassert_equal(stats.sent - last.sent, 3, "Wrong packet count");
+	zassert_equal(stats.frags - last.frags, 3, "Wrong fragment count");
+	zassert_equal(stats.latency_max, 10, "Wrong maximum latency");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_conn_tx,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_round_robin),
+			 ztest_unit_test(test_weight),
+			 ztest_unit_test(test_no_buffers),
+			 ztest_unit_test(test_stats));
+
+	ztest_run_test_suite(test_conn_tx);
+}
@@ -0,0 +1,318 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <time.h>
+#include <stdlib.h>
+
+#define CONFIG_BT_GATT_DB_INDEX 512
+
+#include <bluetooth/host/uuid.c>
+#include <bluetooth/host/gatt_db.c>
+
+/* Every tenth service is a secondary one */
+#define SVC_COUNT 30
+#define CHRC_COUNT 4
+#define SVC_ATTRS (1 + 2 * CHRC_COUNT + 1)
+#define DB_ATTRS (SVC_COUNT * SVC_ATTRS)
+
+/* Services a client finds with MTU 23 */
+#define GROUPS_PER_RSP 3
+#define CHRCS_PER_RSP 3
+#define INFOS_PER_RSP 5
+
+#define DISCOVERY_RUNS 200
+
+static struct bt_uuid_16 primary_uuid =
+	BT_UUID_INIT_16(BT_UUID_GATT_PRIMARY_VAL);
+static struct bt_uuid_16 secondary_uuid =
+	BT_UUID_INIT_16(BT_UUID_GATT_SECONDARY_VAL);
+static struct bt_uuid_16 chrc_uuid = BT_UUID_INIT_16(BT_UUID_GATT_CHRC_VAL);
+static struct bt_uuid_16 ccc_uuid = BT_UUID_INIT_16(BT_UUID_GATT_CCC_VAL);
+
+static struct bt_uuid_16 value_uuid[CHRC_COUNT] = {
+	BT_UUID_INIT_16(0x2a19),
+	BT_UUID_INIT_16(0x2a37),
+	BT_UUID_INIT_16(0x2a38),
+	BT_UUID_INIT_16(0x2a39),
+};
+
+/* 0x2a37 in its 128-bit form */
+static struct bt_uuid_128 value_uuid128 = BT_UUID_INIT_128(
+	0xfb, 0x34, 0x9b, 0x5f, 0x80, 0x00, 0x00, 0x80,
+	0x00, 0x10, 0x00, 0x00, 0x37, 0x2a, 0x00, 0x00);
+
+static struct bt_gatt_attr db_attrs[DB_ATTRS];
+static struct bt_gatt_service db_svcs[SVC_COUNT];
+
+static void db_register(struct bt_gatt_service *svc)
+{
+	u16_t handle = bt_gatt_db_last_handle();
+	int i;
+
+	for (i = 0; i < svc->attr_count; i++) {
+		svc->attrs[i].handle = ++handle;
+	}
+
+	bt_gatt_db_add(svc);
+}
+
+static void db_init(void)
+{
+	int s, c;
+
+	for (s = 0; s < SVC_COUNT; s++) {
+		struct bt_gatt_attr *attr = &db_attrs[s * SVC_ATTRS];
+
+		db_svcs[s].attrs = attr;
+		db_svcs[s].attr_count = SVC_ATTRS;
+
+		attr++->uuid = s % 10 == 9 ? &secondary_uuid.uuid :
+					     &primary_uuid.uuid;
+
+		for (c = 0; c < CHRC_COUNT; c++) {
+			attr++->uuid = &chrc_uuid.uuid;
+			attr++->uuid = &value_uuid[c].uuid;
+		}
+
+		attr->uuid = &ccc_uuid.uuid;
+
+		db_register(&db_svcs[s]);
+	}
+
+	/* Same type as the second characteristic of every service */
+	db_attrs[4].uuid = &value_uuid128.uuid;
+}
+
+struct discover {
+	u16_t handles[GROUPS_PER_RSP * 2];
+	int count;
+	int max;
+	u16_t end_handle;
+	bool group;
+};
+
+static u8_t discover_cb(const struct bt_gatt_attr *attr, void *user_data)
+{
+	struct discover *d = user_data;
+
+	d->handles[d->count++] = attr->handle;
+	if (d->group) {
+		d->handles[d->count++] =
+			bt_gatt_attr_group_end(attr, d->end_handle);
+	}
+
+	return d->count < d->max ? BT_GATT_ITER_CONTINUE : BT_GATT_ITER_STOP;
+}
+
+/* Runs the requests of a client discovering every primary service,
+ * characteristic and descriptor, and returns a checksum of the handles
+ * found.
+ */
+static u32_t discover_all(void)
+{
+	u16_t svc_start[SVC_COUNT], svc_end[SVC_COUNT];
+	struct discover d;
+	int svcs = 0, s, i;
+	u32_t sum = 0;
+	u16_t start;
+
+	/* Read By Group Type */
+	for (start = 0x0001;;) {
+		d.count = 0;
+		d.max = GROUPS_PER_RSP * 2;
+		d.end_handle = 0xffff;
+		d.group = true;
+		bt_gatt_foreach_attr_type(start, 0xffff, BT_UUID_GATT_PRIMARY,
+					  discover_cb, &d);
+		if (!d.count) {
+			break;
+		}
+
+		for (i = 0; i < d.count; i += 2) {
+			svc_start[svcs] = d.handles[i];
+			svc_end[svcs++] = d.handles[i + 1];
+			sum = sum * 31 + d.handles[i];
+			sum = sum * 31 + d.handles[i + 1];
+		}
+
+		start = d.handles[d.count - 1] + 1;
+	}
+
+	for (s = 0; s < svcs; s++) {
+		/* Read By Type */
+		for (start = svc_start[s];;) {
+			d.count = 0;
+			d.max = CHRCS_PER_RSP;
+			d.group = false;
+			bt_gatt_foreach_attr_type(start, svc_end[s],
+						  BT_UUID_GATT_CHRC,
+						  discover_cb, &d);
+			if (!d.count) {
+				break;
+			}
+
+			for (i = 0; i < d.count; i++) {
+				sum = sum * 31 + d.handles[i];
+			}
+
+			start = d.handles[d.count - 1] + 1;
+		}
+
+		/* Find Information */
+		for (start = svc_start[s]; start <= svc_end[s];) {
+			d.count = 0;
+			d.max = INFOS_PER_RSP;
+			d.group = false;
+			bt_gatt_foreach_attr(start, svc_end[s], discover_cb,
+					     &d);
+			if (!d.count) {
+				break;
+			}
+
+			for (i = 0; i < d.count; i++) {
+				sum = sum * 31 + d.handles[i];
+			}
+
+			start = d.handles[d.count - 1] + 1;
+		}
+	}
+
+	return sum;
+}
+
+static u64_t time_discovery(u32_t *sum)
+{
+	struct timespec t0, t1;
+	int i;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (i = 0; i < DISCOVERY_RUNS; i++) {
+		*sum = discover_all();
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	return (t1.tv_sec - t0.tv_sec) * 1000000000ULL +
+	       t1.tv_nsec - t0.tv_nsec;
+}
+
+static u8_t count_cb(const struct bt_gatt_attr *attr, void *user_data)
+{
+	int *count = user_data;
+
+	(*count)++;
+
+	return BT_GATT_ITER_CONTINUE;
+}
+
+static void test_lookup(void)
+{
+	struct bt_gatt_attr *next;
+	int count;
+
+	zassert_equal(attr_count, DB_ATTRS, "Attributes not indexed");
+	zassert_false(overflow, "Index overflow");
+
+	/* Services 9, 19 and 29 are secondary */
+	count = 0;
+	bt_gatt_foreach_attr_type(0x0001, 0xffff, BT_UUID_GATT_PRIMARY,
+				  count_cb, &count);
+	zassert_equal(count, SVC_COUNT - 3, "Wrong primary service count");
+
+	/* Matches the attribute with the 128-bit form of the UUID */
+	count = 0;
+	bt_gatt_foreach_attr_type(0x0001, 0xffff, &value_uuid[1].uuid,
+				  count_cb, &count);
+	zassert_equal(count, SVC_COUNT, "Wrong characteristic count");
+
+	count = 0;
+	bt_gatt_foreach_attr_type(0x0001, 0xffff, &value_uuid128.uuid,
+				  count_cb, &count);
+	zassert_equal(count, SVC_COUNT, "Wrong 128-bit UUID count");
+
+	count = 0;
+	bt_gatt_foreach_attr(0x0005, 0x0014, count_cb, &count);
+	zassert_equal(count, 16, "Wrong handle range count");
+
+	next = bt_gatt_attr_next(&db_attrs[41]);
+	zassert_equal_ptr(next, &db_attrs[42], "Wrong next attribute");
+	zassert_is_null(bt_gatt_attr_next(&db_attrs[DB_ATTRS - 1]),
+			"Attribute after the last one");
+
+	/* Groups end before the next service, or at the requested end */
+	zassert_equal(bt_gatt_attr_group_end(&db_attrs[0], 0xffff),
+		      SVC_ATTRS, "Wrong group end");
+	zassert_equal(bt_gatt_attr_group_end(&db_attrs[80], 0xffff),
+		      90, "Wrong group end before a secondary service");
+	zassert_equal(bt_gatt_attr_group_end(&db_attrs[DB_ATTRS - SVC_ATTRS],
+					     0xffff),
+		      DB_ATTRS, "Wrong group end of the last service");
+	zassert_equal(bt_gatt_attr_group_end(&db_attrs[0], 4), 4,
+		      "Wrong group end within the range");
+}
+
+static void test_unregister(void)
+{
+	u32_t sum, sum_walk;
+	int count;
+
+	zassert_equal(bt_gatt_db_remove(&db_svcs[1]), 0, NULL);
+	zassert_equal(bt_gatt_db_remove(&db_svcs[1]), -ENOENT, NULL);
+	zassert_equal(attr_count, DB_ATTRS - SVC_ATTRS, NULL);
+
+	/* The group of the first service does not grow over the gap */
+	zassert_equal(bt_gatt_attr_group_end(&db_attrs[0], 0xffff),
+		      SVC_ATTRS, "Wrong group end before a gap");
+
+	count = 0;
+	bt_gatt_foreach_attr(SVC_ATTRS + 1, 2 * SVC_ATTRS, count_cb, &count);
+	zassert_equal(count, 0, "Unregistered attributes found");
+
+	sum = discover_all();
+	overflow = true;
+	sum_walk = discover_all();
+	index_rebuild();
+	zassert_equal(sum, sum_walk, "Index and services differ");
+	zassert_false(overflow, "Index not rebuilt");
+
+	/* Registered again after the last service */
+	db_register(&db_svcs[1]);
+	zassert_equal(db_svcs[1].attrs[0].handle, DB_ATTRS + 1, NULL);
+	zassert_equal(attr_count, DB_ATTRS, NULL);
+
+	count = 0;
+	bt_gatt_foreach_attr_type(0x0001, 0xffff, BT_UUID_GATT_PRIMARY,
+				  count_cb, &count);
+	zassert_equal(count, SVC_COUNT - 3, "Wrong primary service count");
+}
+
+static void test_discovery(void)
+{
+	u32_t sum, sum_walk;
+	u64_t indexed, walk;
+
+	indexed = time_discovery(&sum);
+
+	/* Lookups walk the services while the index does not fit them */
+	overflow = true;
+	walk = time_discovery(&sum_walk);
+	index_rebuild();
+
+	PRINT("%d attributes, %d discoveries: indexed %llu us, walk %llu us\n",
+	      DB_ATTRS, DISCOVERY_RUNS, indexed / 1000, walk / 1000);
+
+	zassert_equal(sum, sum_walk, "Index and services differ");
+	zassert_true(indexed < walk, "Index is not faster");
+}
+
+void test_main(void)
+{
+	db_init();
+
+	ztest_test_suite(test_gatt_db,
+			 ztest_unit_test(test_lookup),
+			 ztest_unit_test(test_unregister),
+			 ztest_unit_test(test_discovery));
+	ztest_run_test_suite(test_gatt_db);
+}
@@ -0,0 +1,406 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <stdlib.h>
+#include <net/buf.h>
+
+#define CONFIG_BT_MAX_CONN 1
+#define CONFIG_BT_MAX_PAIRED 1
+#define CONFIG_BT_DEVICE_NAME "test"
+#define CONFIG_BT_DEVICE_APPEARANCE 0
+#define CONFIG_BT_L2CAP_TX_MTU 23
+#define CONFIG_BT_ATT_PREPARE_COUNT 0
+#define CONFIG_BT_GATT_NOTIFY_MULTIPLE
+#define CONFIG_BT_GATT_NOTIFY_MULTIPLE_LATENCY 10
+#define CONFIG_NET_BUF_USER_DATA_SIZE 4
+
+/* The kernel logging glue stays out of the host build */
+#define __BT_LOG_H
+#define BT_DBG(fmt, ...)
+#define BT_WARN(fmt, ...)
+#define BT_ERR(fmt, ...)
+#define BT_INFO(fmt, ...)
+
+struct net_buf_pool _net_buf_pool_list[1];
+
+unsigned int irq_lock(void)
+{
+	return 0;
+}
+
+void irq_unlock(unsigned int key)
+{
+}
+
+#include <net/buf.c>
+#include <bluetooth/host/uuid.c>
+#include <bluetooth/host/gatt.c>
+
+#define MTU 23
+
+/* Every PDU of a test gets a fresh buffer */
+#define PDU_COUNT 32
+
+NET_BUF_POOL_DEFINE(pdu_pool, PDU_COUNT, MTU, CONFIG_NET_BUF_USER_DATA_SIZE,
+		    NULL);
+
+/* PDUs handed to L2CAP, in order */
+static u8_t sent[8][MTU];
+static u16_t sent_len[8];
+static int sent_count;
+
+static struct bt_conn conn;
+
+static struct bt_gatt_attr chrc[] = {
+	{ .handle = 0x0010 },
+	{ .handle = 0x0020 },
+	{ .handle = 0x0030 },
+};
+
+void k_queue_init(struct k_queue *queue) {}
+void k_queue_append_list(struct k_queue *queue, void *head, void *tail) {}
+void k_queue_append(struct k_queue *queue, void *data) {}
+void k_queue_prepend(struct k_queue *queue, void *data) {}
+
+void *k_queue_get(struct k_queue *queue, s32_t timeout)
+{
+	return NULL;
+}
+
+int k_is_in_isr(void)
+{
+	return 0;
+}
+
+void k_sem_init(struct k_sem *sem, unsigned int initial_count,
+		unsigned int limit)
+{
+}
+
+int k_sem_take(struct k_sem *sem, s32_t timeout)
+{
+	return 0;
+}
+
+void k_sem_give(struct k_sem *sem)
+{
+}
+
+struct k_work_q k_sys_work_q;
+
+void k_delayed_work_init(struct k_delayed_work *work, k_work_handler_t handler)
+{
+}
+
+int k_delayed_work_submit_to_queue(struct k_work_q *work_q,
+				   struct k_delayed_work *work, s32_t delay)
+{
+	return 0;
+}
+
+int k_delayed_work_cancel(struct k_delayed_work *work)
+{
+	return 0;
+}
+
+atomic_val_t atomic_get(const atomic_t *target)
+{
+	return *target;
+}
+
+atomic_val_t atomic_or(atomic_t *target, atomic_val_t value)
+{
+	atomic_val_t old = *target;
+
+	*target |= value;
+
+	return old;
+}
+
+atomic_val_t atomic_and(atomic_t *target, atomic_val_t value)
+{
+	atomic_val_t old = *target;
+
+	*target &= value;
+
+	return old;
+}
+
+/* The attribute database and the rest of the host, which sending a
+ * notification to a known connection does not reach.
+ */
+u16_t bt_gatt_db_last_handle(void)
+{
+	return 0;
+}
+
+void bt_gatt_db_add(struct bt_gatt_service *svc)
+{
+}
+
+int bt_gatt_db_remove(struct bt_gatt_service *svc)
+{
+	return 0;
+}
+
+void bt_gatt_foreach_attr(u16_t start_handle, u16_t end_handle,
+			  bt_gatt_attr_func_t func, void *user_data)
+{
+}
+
+void bt_gatt_foreach_attr_type(u16_t start_handle, u16_t end_handle,
+			       const struct bt_uuid *uuid,
+			       bt_gatt_attr_func_t func, void *user_data)
+{
+}
+
+struct bt_gatt_attr *bt_gatt_attr_next(const struct bt_gatt_attr *attr)
+{
+	return NULL;
+}
+
+u16_t bt_gatt_attr_group_end(const struct bt_gatt_attr *attr,
+			     u16_t end_handle)
+{
+	return attr->handle;
+}
+
+bool bt_addr_le_is_bonded(const bt_addr_le_t *addr)
+{
+	return false;
+}
+
+int bt_conn_addr_le_cmp(const struct bt_conn *conn, const bt_addr_le_t *peer)
+{
+	return 0;
+}
+
+struct bt_conn *bt_conn_lookup_addr_le(const bt_addr_le_t *peer)
+{
+	return NULL;
+}
+
+void bt_conn_unref(struct bt_conn *conn)
+{
+}
+
+int bt_att_req_send(struct bt_conn *conn, struct bt_att_req *req)
+{
+	return -ENOTCONN;
+}
+
+int bt_att_send(struct bt_conn *conn, struct net_buf *buf)
+{
+	return -ENOTCONN;
+}
+
+u16_t bt_att_get_mtu(struct bt_conn *conn)
+{
+	return MTU;
+}
+
+struct net_buf *bt_att_create_pdu(struct bt_conn *conn, u8_t op, size_t len)
+{
+	struct bt_att_hdr *hdr;
+	struct net_buf *buf;
+
+	zassert_true(sizeof(*hdr) + len <= MTU, "PDU exceeds the MTU");
+
+	buf = net_buf_alloc(&pdu_pool, K_NO_WAIT);
+	zassert_not_null(buf, "Out of PDUs");
+
+	hdr = net_buf_add(buf, sizeof(*hdr));
+	hdr->code = op;
+
+	return buf;
+}
+
+void bt_l2cap_send_cb(struct bt_conn *conn, u16_t cid, struct net_buf *buf,
+		      bt_conn_tx_cb_t cb)
+{
+	zassert_equal(cid, BT_L2CAP_CID_ATT, "Not an ATT PDU");
+	zassert_true(buf->len <= MTU, "PDU exceeds the MTU");
+	zassert_true(sent_count < ARRAY_SIZE(sent), "Too many PDUs");
+
+	memcpy(sent[sent_count], buf->data, buf->len);
+	sent_len[sent_count++] = buf->len;
+}
+
+static struct bt_gatt_attr *cf_attr(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(gatt_attrs); i++) {
+		if (!bt_uuid_cmp(gatt_attrs[i].uuid,
+				 BT_UUID_GATT_CLIENT_FEATURES) &&
+		    gatt_attrs[i].write) {
+			return &gatt_attrs[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void notify(int i, u8_t val, u16_t len)
+{
+	u8_t data[MTU];
+
+	memset(data, val, len);
+	zassert_equal(bt_gatt_notify(&conn, &chrc[i], data, len), 0,
+		      "Notification failed");
+}
+
+/* A plain notification of a characteristic */
+static void check_notify(int pdu, int i, u8_t val, u16_t len)
+{
+	u8_t *data = sent[pdu];
+	int j;
+
+	zassert_true(pdu < sent_count, "PDU not sent");
+	zassert_equal(data[0], BT_ATT_OP_NOTIFY, "Not a notification");
+	zassert_equal(sent_len[pdu], 3 + len, "Wrong length");
+	zassert_equal(sys_get_le16(&data[1]), chrc[i].handle, "Wrong handle");
+
+	for (j = 0; j < len; j++) {
+		zassert_equal(data[3 + j], val, "Wrong value");
+	}
+}
+
+/* A value at the given offset of a Multiple Handle Value Notification */
+static int check_notify_mult(int pdu, int off, int i, u8_t val, u16_t len)
+{
+	u8_t *data = sent[pdu];
+	int j;
+
+	zassert_true(pdu < sent_count, "PDU not sent");
+	zassert_equal(data[0], BT_ATT_OP_NOTIFY_MULT, "Not a multiple one");
+	zassert_equal(sys_get_le16(&data[off]), chrc[i].handle,
+		      "Wrong handle");
+	zassert_equal(sys_get_le16(&data[off + 2]), len, "Wrong length");
+
+	for (j = 0; j < len; j++) {
+		zassert_equal(data[off + 4 + j], val, "Wrong value");
+	}
+
+	return off + 4 + len;
+}
+
+static void timeout(void)
+{
+	nfy_mult_timeout(&cf_cfg[0].nfy_work.work);
+}
+
+static void test_disabled(void)
+{
+	sent_count = 0;
+
+	notify(0, 0xaa, 4);
+	notify(1, 0xbb, 4);
+
+	/* Clients without the feature get each value right away */
+	zassert_equal(sent_count, 2, "Notifications held back");
+	check_notify(0, 0, 0xaa, 4);
+	check_notify(1, 1, 0xbb, 4);
+}
+
+static void test_features(void)
+{
+	struct bt_gatt_attr *attr = cf_attr();
+	u8_t val, read;
+
+	zassert_not_null(attr, "No Client Supported Features");
+
+	/* Unknown bits are ignored */
+	val = 0xff;
+	zassert_equal(attr->write(&conn, attr, &val, 1, 0, 0), 1,
+		      "Write failed");
+	zassert_equal(attr->read(&conn, attr, &read, 1, 0), 1, "Read failed");
+	zassert_equal(read, BT_GATT_CLIENT_FEAT_MULTI_NOTIFY,
+		      "Wrong features");
+
+	/* Features cannot be disabled */
+	val = 0x00;
+	zassert_equal(attr->write(&conn, attr, &val, 1, 0, 0), 1,
+		      "Write failed");
+	zassert_equal(attr->read(&conn, attr, &read, 1, 0), 1, "Read failed");
+	zassert_equal(read, BT_GATT_CLIENT_FEAT_MULTI_NOTIFY,
+		      "Feature disabled");
+}
+
+static void test_single(void)
+{
+	sent_count = 0;
+
+	notify(0, 0x11, 4);
+	zassert_equal(sent_count, 0, "Notification not held back");
+
+	/* A lone value goes out as a plain notification */
+	timeout();
+	zassert_equal(sent_count, 1, "Notification not sent");
+	check_notify(0, 0, 0x11, 4);
+
+	timeout();
+	zassert_equal(sent_count, 1, "Notification sent twice");
+}
+
+static void test_pack(void)
+{
+	int off;
+
+	sent_count = 0;
+
+	/* 1 + 2 * (4 + 4) leaves no room for a third value of 4 bytes */
+	notify(0, 0x21, 4);
+	notify(1, 0x22, 4);
+	zassert_equal(sent_count, 1, "Full PDU held back");
+
+	off = check_notify_mult(0, 1, 0, 0x21, 4);
+	off = check_notify_mult(0, off, 1, 0x22, 4);
+	zassert_equal(sent_len[0], off, "Wrong length");
+
+	timeout();
+	zassert_equal(sent_count, 1, "Empty PDU sent");
+
+	/* Smaller values are packed until the next one cannot fit */
+	notify(0, 0x31, 2);
+	notify(1, 0x32, 2);
+	notify(2, 0x33, 7);
+	zassert_equal(sent_count, 2, "PDU sent too early");
+
+	off = check_notify_mult(1, 1, 0, 0x31, 2);
+	off = check_notify_mult(1, off, 1, 0x32, 2);
+	zassert_equal(sent_len[1], off, "Wrong length");
+
+	timeout();
+	zassert_equal(sent_count, 3, "Pending value lost");
+	check_notify(2, 2, 0x33, 7);
+}
+
+static void test_order(void)
+{
+	sent_count = 0;
+
+	notify(0, 0x41, 4);
+
+	/* Too long to be packed, sent after the pending value */
+	notify(1, 0x42, MTU - 4);
+	zassert_equal(sent_count, 2, "Wrong number of PDUs");
+	check_notify(0, 0, 0x41, 4);
+	check_notify(1, 1, 0x42, MTU - 4);
+}
+
+void test_main(void)
+{
+	bt_gatt_init();
+
+	ztest_test_suite(test_gatt_notify,
+			 ztest_unit_test(test_disabled),
+			 ztest_unit_test(test_features),
+			 ztest_unit_test(test_single),
+			 ztest_unit_test(test_pack),
+			 ztest_unit_test(test_order));
+
+	ztest_run_test_suite(test_gatt_notify);
+}
@@ -0,0 +1,279 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define CONFIG_BT_CTLR_MAYFLY_STATS
+
+#include <util/memq.c>
+#include <util/mayfly.c>
+
+#define CALLER MAYFLY_CALL_ID_0
+#define CALLEE MAYFLY_CALL_ID_1
+
+static u8_t enabled[MAYFLY_CALLEE_COUNT];
+static u32_t pend_count;
+static u32_t cycles;
+
+static char trace[16];
+static u8_t trace_len;
+
+static memq_link_t links[8];
+static struct mayfly mfs[8];
+static u8_t repend;
+
+void mayfly_enable_cb(u8_t caller_id, u8_t callee_id, u8_t enable)
+{
+	ARG_UNUSED(caller_id);
+
+	enabled[callee_id] = enable;
+}
+
+u32_t mayfly_is_enabled(u8_t caller_id, u8_t callee_id)
+{
+	ARG_UNUSED(caller_id);
+
+	return enabled[callee_id];
+}
+
+u32_t mayfly_prio_is_equal(u8_t caller_id, u8_t callee_id)
+{
+	return caller_id == callee_id;
+}
+
+void mayfly_pend(u8_t caller_id, u8_t callee_id)
+{
+	ARG_UNUSED(caller_id);
+	ARG_UNUSED(callee_id);
+
+	pend_count++;
+}
+
+u32_t mayfly_cycles_get(void)
+{
+	return cycles;
+}
+
+static void record(void *param)
+{
+	trace[trace_len++] = (char)(uintptr_t)param;
+}
+
+static void record_repend(void *param)
+{
+	record(param);
+
+	if (repend) {
+		repend--;
+		mayfly_enqueue(CALLEE, CALLEE, 1, &mfs[0]);
+	}
+}
+
+static struct mayfly *mayfly_setup(u8_t i, char tag, u8_t prio)
+{
+	mfs[i] = (struct mayfly){ 0, 0, &links[i], (void *)(uintptr_t)tag,
+				  record, prio };
+
+	return &mfs[i];
+}
+
+static void setup(void)
+{
+	mayfly_init();
+	mayfly_stats_clear();
+
+	memset(enabled, 1, sizeof(enabled));
+	memset(trace, 0, sizeof(trace));
+	trace_len = 0;
+	pend_count = 0;
+	cycles = 0;
+	repend = 0;
+}
+
+void test_inline(void)
+{
+	struct mayfly_stats stats;
+
+	setup();
+
+	mayfly_enqueue(CALLEE, CALLEE, 0, mayfly_setup(0, 'a', 0));
+	zassert_equal(strcmp(trace, "a"), 0, "not called inline");
+	zassert_equal(pend_count, 0, "callee pended");
+
+	mayfly_stats_get(CALLEE, CALLEE, &stats);
+	zassert_equal(stats.histogram[0], 1, "inline not counted");
+	zassert_equal(stats.latency_max, 0, NULL);
+}
+
+void test_drain(void)
+{
+	setup();
+
+	mayfly_enqueue(CALLER, CALLEE, 0, mayfly_setup(0, 'a', 0));
+	mayfly_enqueue(CALLER, CALLEE, 0, mayfly_setup(1, 'b', 0));
+	mayfly_enqueue(CALLER, CALLEE, 0, mayfly_setup(2, 'c', 0));
+	zassert_equal(trace_len, 0, "called inline across priorities");
+	zassert_equal(pend_count, 3, NULL);
+
+	mayfly_run(CALLEE);
+	zassert_equal(strcmp(trace, "abc"), 0, "not drained in order");
+	zassert_equal(pend_count, 3, "pended again after drain");
+}
+
+void test_priority(void)
+{
+	setup();
+
+	mayfly_enqueue(MAYFLY_CALL_ID_2, CALLEE, 1,
+		       mayfly_setup(0, 'a', MAYFLY_PRIO_NORMAL));
+	mayfly_enqueue(CALLER, CALLEE, 1,
+		       mayfly_setup(1, 'b', MAYFLY_PRIO_NORMAL));
+	mayfly_enqueue(CALLER, CALLEE, 1,
+		       mayfly_setup(2, 'c', MAYFLY_PRIO_HIGH));
+	mayfly_enqueue(MAYFLY_CALL_ID_PROGRAM, CALLEE, 1,
+		       mayfly_setup(3, 'd', MAYFLY_PRIO_HIGH));
+
+	mayfly_run(CALLEE);
+	zassert_equal(strcmp(trace, "dcab"), 0, "order %s", trace);
+}
+
+void test_repend(void)
+{
+	u32_t pend_before;
+
+	setup();
+
+	mayfly_setup(0, 'a', 0)->fp = record_repend;
+	mayfly_enqueue(CALLER, CALLEE, 1, &mfs[0]);
+	mayfly_enqueue(CALLER, CALLEE, 1, mayfly_setup(1, 'b', 0));
+	mayfly_enqueue(MAYFLY_CALL_ID_2, CALLEE, 1, mayfly_setup(2, 'c', 0));
+	repend = 2;
+
+	/* re-pended mayfly holds its own queue only */
+	pend_before = pend_count;
+	mayfly_run(CALLEE);
+	zassert_equal(strcmp(trace, "ca"), 0, "order %s", trace);
+	zassert_true(pend_count > pend_before, "callee not pended again");
+
+	mayfly_run(CALLEE);
+	zassert_equal(strcmp(trace, "caa"), 0, "order %s", trace);
+
+	pend_before = pend_count;
+	mayfly_run(CALLEE);
+	zassert_equal(strcmp(trace, "caaab"), 0, "order %s", trace);
+	zassert_equal(pend_count, pend_before, "pended after drain");
+
+	/* queue is empty and the mayfly idle again */
+	mayfly_run(CALLEE);
+	zassert_equal(trace_len, 5, NULL);
+	zassert_equal(mfs[0]._req, mfs[0]._ack, "not idle");
+}
+
+void test_requeue(void)
+{
+	u32_t ret;
+
+	setup();
+
+	/* already ready mayflies are not queued twice */
+	ret = mayfly_enqueue(CALLER, CALLEE, 1, mayfly_setup(0, 'a', 0));
+	zassert_equal(ret, 0, NULL);
+	ret = mayfly_enqueue(CALLER, CALLEE, 1, &mfs[0]);
+	zassert_equal(ret, 1, "queued twice");
+
+	/* inline call of a queued mayfly marks it done in the queue */
+	mayfly_enqueue(CALLEE, CALLEE, 1, mayfly_setup(1, 'b', 0));
+	mayfly_enqueue(CALLEE, CALLEE, 0, &mfs[1]);
+	zassert_equal(strcmp(trace, "b"), 0, "not called inline");
+
+	mayfly_run(CALLEE);
+	zassert_equal(strcmp(trace, "ba"), 0, "order %s", trace);
+
+	/* and it can be queued again */
+	mayfly_enqueue(CALLEE, CALLEE, 1, &mfs[1]);
+	mayfly_run(CALLEE);
+	zassert_equal(strcmp(trace, "bab"), 0, "order %s", trace);
+}
+
+void test_stats(void)
+{
+	struct mayfly_stats stats;
+
+	setup();
+
+	cycles = 100;
+	mayfly_enqueue(CALLER, CALLEE, 1, mayfly_setup(0, 'a', 0));
+	mayfly_enqueue(MAYFLY_CALL_ID_2, CALLEE, 1, mayfly_setup(1, 'b', 0));
+	cycles = 103;
+	mayfly_enqueue(CALLER, CALLEE, 1, mayfly_setup(2, 'c', 0));
+	cycles = 104;
+	mayfly_enqueue(CALLER, CALLEE, 1, mayfly_setup(3, 'd', 0));
+	cycles = 104 + 1000;
+
+	mayfly_run(CALLEE);
+
+	mayfly_stats_get(CALLER, CALLEE, &stats);
+	zassert_equal(stats.latency_max, 1004, NULL);
+	zassert_equal(stats.histogram[MAYFLY_STATS_BUCKETS - 1], 3,
+		      "long latencies not saturated");
+
+	mayfly_stats_clear();
+
+	/* latency 1 in bucket 1, 2 and 3 in bucket 2 */
+	cycles = 0;
+	mayfly_enqueue(CALLER, CALLEE, 1, mayfly_setup(0, 'a', 0));
+	cycles = 1;
+	mayfly_enqueue(CALLER, CALLEE, 1, mayfly_setup(1, 'b', 0));
+	cycles = 2;
+	mayfly_enqueue(CALLER, CALLEE, 1, mayfly_setup(2, 'c', 0));
+	cycles = 3;
+	mayfly_run(CALLEE);
+
+	mayfly_stats_get(CALLER, CALLEE, &stats);
+	zassert_equal(stats.histogram[0], 0, NULL);
+	zassert_equal(stats.histogram[1], 1, NULL);
+	zassert_equal(stats.histogram[2], 2, NULL);
+	zassert_equal(stats.latency_max, 3, NULL);
+
+	/* other pairs are accounted separately */
+	mayfly_stats_get(MAYFLY_CALL_ID_2, CALLEE, &stats);
+	zassert_equal(stats.latency_max, 0, "not cleared");
+	zassert_equal(stats.histogram[MAYFLY_STATS_BUCKETS - 1], 0, NULL);
+}
+
+void test_disable(void)
+{
+	setup();
+
+	/* callee disabled: even same priority callers queue */
+	enabled[CALLEE] = 0;
+	mayfly_enqueue(CALLEE, CALLEE, 0, mayfly_setup(0, 'a', 0));
+	zassert_equal(trace_len, 0, "called inline while disabled");
+
+	mayfly_enable(CALLER, CALLEE, 1);
+	zassert_equal(enabled[CALLEE], 1, NULL);
+	mayfly_run(CALLEE);
+	zassert_equal(strcmp(trace, "a"), 0, NULL);
+
+	/* disable is acknowledged and the callee disabled once drained */
+	mayfly_enqueue(CALLER, CALLEE, 1, mayfly_setup(1, 'b', 0));
+	mayfly_enable(CALLER, CALLEE, 0);
+	zassert_equal(enabled[CALLEE], 1, "disabled before drain");
+	mayfly_run(CALLEE);
+	zassert_equal(strcmp(trace, "ab"), 0, NULL);
+	zassert_equal(enabled[CALLEE], 0, "not disabled");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_mayfly,
+			 ztest_unit_test(test_inline),
+			 ztest_unit_test(test_drain),
+			 ztest_unit_test(test_priority),
+			 ztest_unit_test(test_repend),
+			 ztest_unit_test(test_requeue),
+			 ztest_unit_test(test_stats),
+			 ztest_unit_test(test_disable));
+	ztest_run_test_suite(test_mayfly);
+}
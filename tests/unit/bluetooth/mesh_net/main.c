@@ -0,0 +1,411 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <net/buf.h>
+
+#define CONFIG_BT_MESH 1
+#define CONFIG_BT_MESH_FRIEND 1
+#define CONFIG_BT_MESH_FRIEND_LPN_COUNT 2
+#define CONFIG_BT_MESH_SUBNET_COUNT 3
+#define CONFIG_BT_MESH_APP_KEY_COUNT 1
+#define CONFIG_BT_MESH_MODEL_KEY_COUNT 1
+#define CONFIG_BT_MESH_MODEL_GROUP_COUNT 1
+#define CONFIG_BT_MESH_CRPL 4
+#define CONFIG_BT_MESH_MSG_CACHE_SIZE 4
+#define CONFIG_BT_MESH_IVU_DIVIDER 4
+#define CONFIG_BT_MESH_ADV_BUF_COUNT 4
+#define CONFIG_BT_MESH_TX_SEG_MAX 2
+#define CONFIG_BT_MESH_RX_SEG_MAX 2
+#define CONFIG_BT_MESH_LOOPBACK_BUFS 2
+#define CONFIG_BT_MESH_FRIEND_QUEUE_SIZE 4
+#define CONFIG_BT_MESH_FRIEND_SUB_LIST_SIZE 2
+#define CONFIG_BT_MESH_FRIEND_SEG_RX 1
+#define CONFIG_NET_BUF_USER_DATA_SIZE 4
+
+/* The kernel logging glue stays out of the host build */
+#define __BT_LOG_H
+#define BT_DBG(fmt, ...)
+#define BT_WARN(fmt, ...)
+#define BT_ERR(fmt, ...)
+#define BT_INFO(fmt, ...)
+
+const char *bt_hex(const void *buf, size_t len)
+{
+	return "";
+}
+
+struct net_buf_pool _net_buf_pool_list[1];
+
+unsigned int irq_lock(void)
+{
+	return 0;
+}
+
+void irq_unlock(unsigned int key)
+{
+}
+
+#include <net/buf.c>
+#include <bluetooth/host/mesh/net.c>
+
+void k_queue_init(struct k_queue *queue) {}
+void k_queue_append_list(struct k_queue *queue, void *head, void *tail) {}
+void k_queue_append(struct k_queue *queue, void *data) {}
+void k_queue_prepend(struct k_queue *queue, void *data) {}
+
+void *k_queue_get(struct k_queue *queue, s32_t timeout)
+{
+	return NULL;
+}
+
+int k_is_in_isr(void)
+{
+	return 0;
+}
+
+struct k_work_q k_sys_work_q;
+
+void k_delayed_work_init(struct k_delayed_work *work, k_work_handler_t handler)
+{
+}
+
+int k_delayed_work_submit_to_queue(struct k_work_q *work_q,
+				   struct k_delayed_work *work, s32_t delay)
+{
+	return 0;
+}
+
+int k_delayed_work_cancel(struct k_delayed_work *work)
+{
+	return 0;
+}
+
+s64_t k_uptime_get(void)
+{
+	return 0;
+}
+
+atomic_val_t atomic_or(atomic_t *target, atomic_val_t value)
+{
+	atomic_val_t old = *target;
+
+	*target |= value;
+
+	return old;
+}
+
+atomic_val_t atomic_and(atomic_t *target, atomic_val_t value)
+{
+	atomic_val_t old = *target;
+
+	*target &= value;
+
+	return old;
+}
+
+/* The rest of the mesh stack, which decoding a PDU does not reach */
+bool bt_mesh_tx_in_progress(void)
+{
+	return false;
+}
+
+void bt_mesh_rpl_reset(void) {}
+void bt_mesh_rpl_clear(void) {}
+void bt_mesh_beacon_ivu_initiator(bool enable) {}
+void bt_mesh_friend_sec_update(u16_t net_idx) {}
+
+void bt_mesh_adv_send(struct net_buf *buf, const struct bt_mesh_send_cb *cb,
+		      void *cb_data)
+{
+}
+
+struct net_buf *bt_mesh_adv_create(enum bt_mesh_adv_type type, u8_t xmit_count,
+				   u8_t xmit_int, s32_t timeout)
+{
+	return NULL;
+}
+
+int bt_mesh_trans_recv(struct net_buf_simple *buf, struct bt_mesh_net_rx *rx)
+{
+	return 0;
+}
+
+bool bt_mesh_fixed_group_match(u16_t addr)
+{
+	return false;
+}
+
+struct bt_mesh_elem *bt_mesh_elem_find(u16_t addr)
+{
+	return NULL;
+}
+
+u16_t bt_mesh_primary_addr(void)
+{
+	return 0x0002;
+}
+
+bool bt_mesh_is_provisioned(void)
+{
+	return true;
+}
+
+u8_t bt_mesh_gatt_proxy_get(void)
+{
+	return BT_MESH_GATT_PROXY_NOT_SUPPORTED;
+}
+
+u8_t bt_mesh_relay_get(void)
+{
+	return BT_MESH_RELAY_NOT_SUPPORTED;
+}
+
+u8_t bt_mesh_default_ttl_get(void)
+{
+	return 7;
+}
+
+u8_t bt_mesh_relay_retransmit_get(void)
+{
+	return 0;
+}
+
+u8_t bt_mesh_net_transmit_get(void)
+{
+	return 0;
+}
+
+int bt_mesh_net_encrypt(const u8_t key[16], struct net_buf_simple *buf,
+			u32_t iv_index, bool proxy)
+{
+	return -EIO;
+}
+
+int bt_mesh_beacon_auth(const u8_t beacon_key[16], u8_t flags,
+			const u8_t net_id[16], u32_t iv_index, u8_t auth[8])
+{
+	return -EIO;
+}
+
+int bt_mesh_id128(const u8_t n[16], const char *s, u8_t out[16])
+{
+	return -EIO;
+}
+
+int bt_mesh_k3(const u8_t n[16], u8_t out[8])
+{
+	return -EIO;
+}
+
+#define NID_A 0x10
+#define NID_B 0x20
+
+/* Credential the decryption succeeds with, and the ones tried */
+static const u8_t *accept;
+static const u8_t *tried[8];
+static int tried_count;
+
+/* NID bt_mesh_k2() derives for friendship credentials */
+static u8_t friend_nid;
+
+int bt_mesh_net_decrypt(const u8_t key[16], struct net_buf_simple *buf,
+			u32_t iv_index, bool proxy)
+{
+	zassert_true(tried_count < ARRAY_SIZE(tried), "Too many attempts");
+
+	tried[tried_count++] = key;
+
+	return key == accept ? 0 : -EBADMSG;
+}
+
+int bt_mesh_net_obfuscate(u8_t *pdu, u32_t iv_index,
+			  const u8_t privacy_key[16])
+{
+	return 0;
+}
+
+int bt_mesh_k2(const u8_t n[16], const u8_t *p, size_t p_len, u8_t net_id[1],
+	       u8_t enc_key[16], u8_t priv_key[16])
+{
+	net_id[0] = friend_nid;
+
+	return 0;
+}
+
+/* Network PDU from 0x0001 to 0x0002 */
+static void decode(u8_t nid, int expected)
+{
+	const u8_t hdr[] = {
+		nid, 0x05, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x02,
+	};
+	struct net_buf_simple *data = NET_BUF_SIMPLE(BT_MESH_NET_MIN_PDU_LEN);
+	struct net_buf_simple *buf = NET_BUF_SIMPLE(29);
+	struct bt_mesh_net_rx rx = { 0 };
+	int err;
+
+	net_buf_simple_init(data, 0);
+	net_buf_simple_add_mem(data, hdr, sizeof(hdr));
+	memset(net_buf_simple_add(data, net_buf_simple_tailroom(data)), 0,
+	       BT_MESH_NET_MIN_PDU_LEN - sizeof(hdr));
+
+	tried_count = 0;
+
+	err = bt_mesh_net_decode(data, BT_MESH_NET_IF_LOCAL, &rx, buf);
+	zassert_equal(err, expected, "Unexpected decode result");
+
+	if (!err) {
+		zassert_equal(rx.ctx.addr, 0x0001, "Wrong source");
+		zassert_equal(rx.dst, 0x0002, "Wrong destination");
+	}
+}
+
+static struct bt_mesh_subnet *subnet_add(int i, u16_t net_idx, u8_t nid)
+{
+	struct bt_mesh_subnet *sub = &bt_mesh.sub[i];
+
+	sub->net_idx = net_idx;
+	sub->kr_phase = BT_MESH_KR_NORMAL;
+	sub->keys[0].nid = nid;
+
+	return sub;
+}
+
+static void test_setup(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(bt_mesh.sub); i++) {
+		bt_mesh.sub[i].net_idx = BT_MESH_KEY_UNUSED;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(friend_cred); i++) {
+		friend_cred[i].net_idx = BT_MESH_KEY_UNUSED;
+		friend_cred[i].addr = BT_MESH_ADDR_UNASSIGNED;
+	}
+
+	subnet_add(0, 0x000, NID_A);
+	subnet_add(1, 0x001, NID_B);
+	subnet_add(2, 0x002, NID_A);
+
+	bt_mesh_net_creds_update();
+	bt_mesh_net_stats_reset();
+}
+
+static void test_nid_lookup(void)
+{
+	struct bt_mesh_subnet *sub = &bt_mesh.sub[1];
+	struct bt_mesh_net_stats stats;
+
+	accept = sub->keys[0].enc;
+	decode(NID_B, 0);
+
+	/* Only the subnet with the NID of the PDU is tried */
+	zassert_equal(tried_count, 1, "Other NIDs tried");
+	zassert_equal_ptr(tried[0], sub->keys[0].enc, "Wrong key tried");
+
+	bt_mesh_net_stats_get(&stats);
+	zassert_equal(stats.rx, 1, "PDU not counted");
+	zassert_equal(stats.decrypt, 1, "Attempt not counted");
+	zassert_equal(stats.decrypt_failed, 0, "Failure counted");
+
+	decode(0x30, -ENOENT);
+	zassert_equal(tried_count, 0, "Unknown NID tried");
+}
+
+static void test_nid_collision(void)
+{
+	struct bt_mesh_net_stats stats;
+
+	bt_mesh_net_stats_reset();
+
+	/* Subnets sharing a NID are tried in subnet order */
+	accept = bt_mesh.sub[2].keys[0].enc;
+	decode(NID_A, 0);
+
+	zassert_equal(tried_count, 2, "Wrong number of attempts");
+	zassert_equal_ptr(tried[0], bt_mesh.sub[0].keys[0].enc,
+			  "Wrong key order");
+	zassert_equal_ptr(tried[1], bt_mesh.sub[2].keys[0].enc,
+			  "Wrong key order");
+
+	bt_mesh_net_stats_get(&stats);
+	zassert_equal(stats.decrypt, 2, "Attempts not counted");
+	zassert_equal(stats.decrypt_failed, 1, "Failure not counted");
+
+	accept = NULL;
+	decode(NID_A, -ENOENT);
+	zassert_equal(tried_count, 2, "Wrong number of attempts");
+}
+
+static void test_key_refresh(void)
+{
+	struct bt_mesh_subnet *sub = &bt_mesh.sub[1];
+
+	sub->kr_phase = BT_MESH_KR_PHASE_2;
+	sub->keys[1].nid = NID_B;
+	bt_mesh_net_creds_update();
+
+	/* The old key is tried before the new one */
+	accept = sub->keys[1].enc;
+	decode(NID_B, 0);
+	zassert_equal(tried_count, 2, "New key not tried");
+	zassert_equal_ptr(tried[0], sub->keys[0].enc, "Wrong key order");
+	zassert_equal_ptr(tried[1], sub->keys[1].enc, "Wrong key order");
+
+	/* A new key with another NID is only tried for that NID */
+	sub->keys[1].nid = 0x30;
+	bt_mesh_net_creds_update();
+
+	decode(NID_B, -ENOENT);
+	zassert_equal(tried_count, 1, "New key tried for the old NID");
+
+	decode(0x30, 0);
+	zassert_equal(tried_count, 1, "Wrong number of attempts");
+
+	sub->kr_phase = BT_MESH_KR_NORMAL;
+	bt_mesh_net_creds_update();
+
+	decode(0x30, -ENOENT);
+	zassert_equal(tried_count, 0, "New key tried after Key Refresh");
+}
+
+static void test_friend_cred(void)
+{
+	struct bt_mesh_subnet *sub = &bt_mesh.sub[0];
+	struct friend_cred *cred;
+
+	friend_nid = NID_A;
+	cred = friend_cred_create(sub, 0x0003, 1, 2);
+	zassert_not_null(cred, "Cannot create friend credentials");
+
+	/* Friendship credentials come before the subnet key */
+	accept = sub->keys[0].enc;
+	decode(NID_A, 0);
+	zassert_equal(tried_count, 2, "Wrong number of attempts");
+	zassert_equal_ptr(tried[0], cred->cred[0].enc, "Wrong key order");
+	zassert_equal_ptr(tried[1], sub->keys[0].enc, "Wrong key order");
+
+	accept = cred->cred[0].enc;
+	decode(NID_A, 0);
+	zassert_equal(tried_count, 1, "Wrong number of attempts");
+
+	friend_cred_clear(cred);
+
+	accept = sub->keys[0].enc;
+	decode(NID_A, 0);
+	zassert_equal(tried_count, 1, "Cleared credentials tried");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_mesh_net,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_nid_lookup),
+			 ztest_unit_test(test_nid_collision),
+			 ztest_unit_test(test_key_refresh),
+			 ztest_unit_test(test_friend_cred));
+
+	ztest_run_test_suite(test_mesh_net);
+}
@@ -0,0 +1,532 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <stdlib.h>
+
+/* Controller asserts fail the test, and the kernel logging glue stays out
+ * of the host build.
+ */
+#define CONFIG_BT_CTLR_ASSERT_HANDLER
+#define __BT_LOG_H
+
+#include <ticker/ticker.c>
+
+#define INSTANCE 0
+#define USER_ID MAYFLY_CALL_ID_PROGRAM
+
+#define NODES 128
+#define USER_OPS 8
+
+#define TICKS_MASK 0x00FFFFFF
+
+struct expiry {
+	u32_t count;
+	u32_t ticks_at_expire;
+	u16_t lazy_max;
+};
+
+static struct ticker_node nodes[NODES];
+static struct ticker_user users[MAYFLY_CALLER_COUNT];
+static struct ticker_user_op user_ops[MAYFLY_CALLER_COUNT][USER_OPS];
+
+static struct expiry expiry[NODES];
+static u32_t expiry_ticks_last;
+static u32_t expiry_count;
+
+/* Virtual RTC, counts only while started, like the nRF5 RTC */
+static u32_t cnt;
+static u32_t cnt_cmp;
+static bool cnt_cmp_set;
+static u8_t cnt_refcount;
+
+static struct mayfly *pending[8];
+static u8_t pending_first;
+static u8_t pending_last;
+
+void bt_ctlr_assert_handle(char *file, u32_t line)
+{
+	zassert_unreachable("Assert in %s:%u", file, line);
+}
+
+void cntr_init(void)
+{
+}
+
+u32_t cntr_start(void)
+{
+	return cnt_refcount++ ? 1 : 0;
+}
+
+u32_t cntr_stop(void)
+{
+	zassert_true(cnt_refcount, "Counter not started");
+
+	return --cnt_refcount ? 1 : 0;
+}
+
+u32_t cntr_cnt_get(void)
+{
+	return cnt & TICKS_MASK;
+}
+
+void cntr_cmp_set(u8_t cmp, u32_t value)
+{
+	zassert_equal(cmp, INSTANCE, "Wrong compare register");
+
+	cnt_cmp = value;
+	cnt_cmp_set = true;
+}
+
+/* Mayflies run in the order enqueued, none pre-empts another */
+u32_t mayfly_enqueue(u8_t caller_id, u8_t callee_id, u8_t chain,
+		     struct mayfly *m)
+{
+	u8_t last;
+
+	if (m->_req != m->_ack) {
+		return 0;
+	}
+	m->_req++;
+
+	last = (pending_last + 1) % ARRAY_SIZE(pending);
+	zassert_not_equal(last, pending_first, "Mayfly queue full");
+
+	pending[pending_last] = m;
+	pending_last = last;
+
+	return 0;
+}
+
+static void mayfly_drain(void)
+{
+	while (pending_first != pending_last) {
+		struct mayfly *m = pending[pending_first];
+
+		pending_first = (pending_first + 1) % ARRAY_SIZE(pending);
+
+		m->_ack = m->_req;
+		m->fp(m->param);
+	}
+}
+
+static void run(u32_t ticks)
+{
+	mayfly_drain();
+
+	while (ticks && cnt_refcount) {
+		if (cnt_cmp_set) {
+			u32_t ticks_cmp = (cnt_cmp - cnt) & TICKS_MASK;
+
+			if (ticks_cmp <= ticks) {
+				cnt += ticks_cmp;
+				ticks -= ticks_cmp;
+				cnt_cmp_set = false;
+
+				ticker_trigger(INSTANCE);
+				mayfly_drain();
+
+				continue;
+			}
+		}
+
+		cnt += ticks;
+		ticks = 0;
+	}
+}
+
+static void timeout(u32_t ticks_at_expire, u32_t remainder, u16_t lazy,
+		    void *context)
+{
+	struct expiry *e = context;
+
+	zassert_false(ticker_ticks_diff_get(ticks_at_expire,
+					    expiry_ticks_last) & BIT(23),
+		      "Expired out of order");
+	expiry_ticks_last = ticks_at_expire;
+	expiry_count++;
+
+	e->count++;
+	e->ticks_at_expire = ticks_at_expire;
+	if (lazy > e->lazy_max) {
+		e->lazy_max = lazy;
+	}
+}
+
+static void op_done(u32_t status, void *op_context)
+{
+	*((u32_t *)op_context) = status;
+}
+
+static u32_t op_wait(u32_t ret, u32_t *status)
+{
+	zassert_true((ret == TICKER_STATUS_SUCCESS) ||
+		     (ret == TICKER_STATUS_BUSY), "Op not queued");
+
+	mayfly_drain();
+
+	return *status;
+}
+
+static u32_t start(u8_t id, u32_t ticks_first, u32_t ticks_periodic,
+		   u16_t ticks_slot)
+{
+	u32_t status = TICKER_STATUS_BUSY;
+	u32_t ret;
+
+	ret = ticker_start(INSTANCE, USER_ID, id, cntr_cnt_get(), ticks_first,
+			   ticks_periodic, TICKER_NULL_REMAINDER,
+			   TICKER_NULL_LAZY, ticks_slot, timeout, &expiry[id],
+			   op_done, &status);
+
+	return op_wait(ret, &status);
+}
+
+static u32_t stop(u8_t id)
+{
+	u32_t status = TICKER_STATUS_BUSY;
+	u32_t ret;
+
+	ret = ticker_stop(INSTANCE, USER_ID, id, op_done, &status);
+
+	return op_wait(ret, &status);
+}
+
+static u32_t priority_set(u8_t id, s8_t priority, u16_t lazy_max)
+{
+	u32_t status = TICKER_STATUS_BUSY;
+	u32_t ret;
+
+	ret = ticker_priority_set(INSTANCE, USER_ID, id, priority, lazy_max,
+				  op_done, &status);
+
+	return op_wait(ret, &status);
+}
+
+static u8_t tree_check(struct ticker_node *node, u8_t id, u8_t parent,
+		       u8_t *in_order)
+{
+	u8_t height_left;
+	u8_t height_right;
+
+	if (id == TICKER_NULL) {
+		return 0;
+	}
+
+	zassert_equal(node[id].parent, parent, "Wrong parent of %u", id);
+
+	height_left = tree_check(node, node[id].left, id, in_order);
+
+	/* in-order walk follows the next chain */
+	zassert_equal(*in_order, id, "Tree and list order differ");
+	*in_order = node[id].next;
+
+	height_right = tree_check(node, node[id].right, id, in_order);
+
+	zassert_true(abs(height_left - height_right) <= 1,
+		     "Unbalanced at %u", id);
+	zassert_equal(node[id].height, 1 + max(height_left, height_right),
+		      "Wrong height of %u", id);
+
+	return node[id].height;
+}
+
+static void timeline_check(void)
+{
+	struct ticker_instance *instance = &_instance[INSTANCE];
+	struct ticker_node *node = instance->node;
+	u32_t ticks_at;
+	u8_t in_order;
+	u8_t count;
+	u8_t height;
+	u8_t id;
+	int nodes_min[2];
+
+	/* keys match the expiry the list encodes */
+	count = 0;
+	ticks_at = instance->ticks_current;
+	for (id = instance->ticker_id_head; id != TICKER_NULL;
+	     id = node[id].next) {
+		ticks_at = (ticks_at + node[id].ticks_to_expire) & TICKS_MASK;
+		zassert_equal(node[id].ticks_at, ticks_at,
+			      "Wrong key of %u", id);
+		count++;
+	}
+
+	in_order = instance->ticker_id_head;
+	height = tree_check(node, instance->ticker_id_root, TICKER_NULL,
+			    &in_order);
+	zassert_equal(in_order, TICKER_NULL, "Tree is missing tickers");
+
+	/* an AVL tree of height h holds at least N(h-1) + N(h-2) + 1 */
+	nodes_min[0] = 0;
+	nodes_min[1] = 1;
+	while (height > 1) {
+		int nodes_next = nodes_min[0] + nodes_min[1] + 1;
+
+		nodes_min[0] = nodes_min[1];
+		nodes_min[1] = nodes_next;
+		height--;
+	}
+	zassert_true(!height || (count >= nodes_min[1]),
+		     "Tree too high for %u tickers", count);
+}
+
+static void setup(void)
+{
+	int i;
+
+	memset(nodes, 0, sizeof(nodes));
+	memset(expiry, 0, sizeof(expiry));
+	memset(_instance, 0, sizeof(_instance));
+
+	for (i = 0; i < MAYFLY_CALLER_COUNT; i++) {
+		users[i].count_user_op = USER_OPS;
+	}
+
+	zassert_equal(ticker_init(INSTANCE, NODES, nodes, MAYFLY_CALLER_COUNT,
+				  users, MAYFLY_CALLER_COUNT * USER_OPS,
+				  user_ops), TICKER_STATUS_SUCCESS,
+		      "Node or op layout differs from the size defines");
+
+	cnt = 0;
+	cnt_cmp_set = false;
+	cnt_refcount = 0;
+	expiry_ticks_last = 0;
+	expiry_count = 0;
+}
+
+static void test_timeline(void)
+{
+	u32_t ticks_first[NODES];
+	bool stopped[NODES];
+	int i;
+
+	setup();
+	srand(7);
+
+	for (i = 0; i < NODES; i++) {
+		ticks_first[i] = 10 + (rand() % 20000);
+		stopped[i] = false;
+
+		zassert_equal(start(i, ticks_first[i], 0, 0),
+			      TICKER_STATUS_SUCCESS, "Start %u failed", i);
+		timeline_check();
+	}
+
+	for (i = 0; i < NODES / 4; i++) {
+		u8_t id = rand() % NODES;
+
+		zassert_equal(stop(id), stopped[id] ? TICKER_STATUS_FAILURE :
+			      TICKER_STATUS_SUCCESS, "Stop %u", id);
+		stopped[id] = true;
+		timeline_check();
+	}
+
+	run(30000);
+	timeline_check();
+
+	for (i = 0; i < NODES; i++) {
+		if (stopped[i]) {
+			zassert_equal(expiry[i].count, 0, "Stopped %u ran", i);
+			continue;
+		}
+
+		zassert_equal(expiry[i].count, 1, "%u did not expire", i);
+		zassert_equal(expiry[i].ticks_at_expire, ticks_first[i],
+			      "%u expired late", i);
+	}
+}
+
+static void test_periodic(void)
+{
+	int i;
+
+	setup();
+
+	/* back-to-back slots, none collides */
+	for (i = 0; i < 4; i++) {
+		zassert_equal(start(i, 100 + (25 * i), 100, 25),
+			      TICKER_STATUS_SUCCESS, NULL);
+	}
+	timeline_check();
+
+	run((100 * 50) + 75);
+	timeline_check();
+
+	for (i = 0; i < 4; i++) {
+		zassert_equal(expiry[i].count, 50, "%u skipped", i);
+		zassert_equal(expiry[i].lazy_max, 0, "%u skipped", i);
+	}
+}
+
+static void test_next_slot(void)
+{
+	u32_t ticks_to_expire;
+	u32_t ticks_current;
+	u8_t ticker_id;
+	u32_t status;
+	u32_t ret;
+
+	setup();
+
+	start(0, 300, 0, 10);
+	start(1, 100, 0, 0);
+	start(2, 200, 0, 10);
+	start(3, 250, 0, 0);
+	start(4, 400, 0, 10);
+
+	ticker_id = TICKER_NULL;
+	ticks_current = 0;
+	ticks_to_expire = 0;
+
+	status = TICKER_STATUS_BUSY;
+	ret = ticker_next_slot_get(INSTANCE, USER_ID, &ticker_id,
+				   &ticks_current, &ticks_to_expire,
+				   op_done, &status);
+	zassert_equal(op_wait(ret, &status), TICKER_STATUS_SUCCESS, NULL);
+	zassert_equal(ticker_id, 2, "Wrong first slot");
+	zassert_equal(ticks_to_expire, 200, NULL);
+
+	status = TICKER_STATUS_BUSY;
+	ret = ticker_next_slot_get(INSTANCE, USER_ID, &ticker_id,
+				   &ticks_current, &ticks_to_expire,
+				   op_done, &status);
+	zassert_equal(op_wait(ret, &status), TICKER_STATUS_SUCCESS, NULL);
+	zassert_equal(ticker_id, 0, "Wrong second slot");
+	zassert_equal(ticks_to_expire, 300, NULL);
+
+	status = TICKER_STATUS_BUSY;
+	ret = ticker_next_slot_get(INSTANCE, USER_ID, &ticker_id,
+				   &ticks_current, &ticks_to_expire,
+				   op_done, &status);
+	zassert_equal(op_wait(ret, &status), TICKER_STATUS_SUCCESS, NULL);
+	zassert_equal(ticker_id, 4, "Wrong third slot");
+	zassert_equal(ticks_to_expire, 400, NULL);
+}
+
+static void test_collision_single(void)
+{
+	setup();
+
+	zassert_equal(start(0, 100, 0, 50), TICKER_STATUS_SUCCESS, NULL);
+
+	/* a single shot cannot move to a later interval */
+	zassert_equal(start(1, 120, 0, 50), TICKER_STATUS_FAILURE, NULL);
+	zassert_equal(start(1, 60, 0, 50), TICKER_STATUS_FAILURE, NULL);
+	zassert_equal(start(1, 150, 0, 50), TICKER_STATUS_SUCCESS, NULL);
+	zassert_equal(start(2, 50, 0, 50), TICKER_STATUS_SUCCESS, NULL);
+	timeline_check();
+}
+
+static void test_collision_priority(void)
+{
+	setup();
+
+	zassert_equal(start(0, 90, 100, 40), TICKER_STATUS_SUCCESS, NULL);
+
+	/* the higher priority ticker takes the overlapping slot */
+	zassert_equal(priority_set(1, -1, TICKER_NULL_LAZY_MAX),
+		      TICKER_STATUS_SUCCESS, NULL);
+	zassert_equal(start(1, 100, 100, 40), TICKER_STATUS_SUCCESS, NULL);
+	timeline_check();
+
+	run(100 * 40);
+	timeline_check();
+
+	zassert_equal(expiry[1].count, 40, "Priority ticker skipped");
+	zassert_equal(expiry[1].lazy_max, 0, "Priority ticker skipped");
+	zassert_equal(expiry[0].count, 0, "Low priority ticker ran");
+}
+
+static void test_collision_budget(void)
+{
+	setup();
+
+	/* may be skipped three times in a row before it takes its slot */
+	zassert_equal(priority_set(0, TICKER_PRIORITY_DEFAULT, 3),
+		      TICKER_STATUS_SUCCESS, NULL);
+	zassert_equal(start(0, 90, 100, 40), TICKER_STATUS_SUCCESS, NULL);
+
+	zassert_equal(priority_set(1, -1, TICKER_NULL_LAZY_MAX),
+		      TICKER_STATUS_SUCCESS, NULL);
+	zassert_equal(start(1, 100, 100, 40), TICKER_STATUS_SUCCESS, NULL);
+
+	run(100 * 40);
+	timeline_check();
+
+	zassert_equal(expiry[0].lazy_max, 3, "Budget not used up");
+	zassert_equal(expiry[0].count, 10, "Budget not honoured");
+	zassert_equal(expiry[1].lazy_max, 1, NULL);
+	zassert_equal(expiry[1].count, 30, NULL);
+}
+
+static void test_churn(void)
+{
+	u8_t running = 0;
+	int i;
+
+	setup();
+	srand(11);
+
+	for (i = 0; i < 2000; i++) {
+		u8_t id = rand() % 32;
+		u32_t status;
+		u32_t ret;
+
+		switch (rand() % 4) {
+		case 0:
+			if (start(id, 20 + rand() % 500, 100 + rand() % 400,
+				  rand() % 30) == TICKER_STATUS_SUCCESS) {
+				running++;
+			}
+			break;
+
+		case 1:
+			if (stop(id) == TICKER_STATUS_SUCCESS) {
+				running--;
+			}
+			break;
+
+		case 2:
+			status = TICKER_STATUS_BUSY;
+			ret = ticker_update(INSTANCE, USER_ID, id,
+					    rand() % 50, 0, rand() % 10,
+					    rand() % 10, rand() % 3, 0,
+					    op_done, &status);
+			op_wait(ret, &status);
+			break;
+
+		default:
+			run(rand() % 300);
+			break;
+		}
+
+		timeline_check();
+	}
+
+	zassert_true(expiry_count > 1000, "Tickers did not run");
+
+	for (i = 0; i < 32; i++) {
+		if (stop(i) == TICKER_STATUS_SUCCESS) {
+			running--;
+		}
+	}
+	zassert_equal(running, 0, NULL);
+	zassert_equal(_instance[INSTANCE].ticker_id_root, TICKER_NULL, NULL);
+	zassert_equal(cnt_refcount, 0, "Counter not stopped");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_ticker,
+			 ztest_unit_test(test_timeline),
+			 ztest_unit_test(test_periodic),
+			 ztest_unit_test(test_next_slot),
+			 ztest_unit_test(test_collision_single),
+			 ztest_unit_test(test_collision_priority),
+			 ztest_unit_test(test_collision_budget),
+			 ztest_unit_test(test_churn));
+	ztest_run_test_suite(test_ticker);
+}
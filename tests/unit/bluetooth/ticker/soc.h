@@ -0,0 +1,6 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* On target BIT() comes in through the SoC headers */
+#include <misc/util.h>